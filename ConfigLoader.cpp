@@ -0,0 +1,240 @@
+#include "ConfigLoader.hpp"
+
+#include <yaml-cpp/yaml.h>
+
+/**
+ * @brief Parses an outputs list (top level or per source)
+ */
+static std::vector<OutputSink> parse_outputs(const YAML::Node &outputs) {
+    std::vector<OutputSink> sinks;
+    for (const YAML::Node &node : outputs) {
+        OutputSink sink;
+        sink.type = node["type"].as<std::string>();
+        if (node["location"]) sink.location = node["location"].as<std::string>();
+        if (node["width"]) sink.width = node["width"].as<int>();
+        if (node["height"]) sink.height = node["height"].as<int>();
+        if (node["fps"]) sink.fps = node["fps"].as<int>();
+        sinks.push_back(sink);
+    }
+    return sinks;
+}
+
+/**
+ * @brief Loads YAML configuration file and creates Config object
+ *
+ * @param[in] yaml_path Path to the YAML configuration file
+ * @return Config object populated with loaded settings
+ */
+Config load_config(const std::string& yaml_path) {
+        YAML::Node config = YAML::LoadFile(yaml_path);
+        Config cfg;
+        
+        // camera
+        cfg.device = config["device"].as<std::string>();
+        
+        // model
+        cfg.hef_path = config["model"]["hef_path"].as<std::string>();
+        cfg.model_width = config["model"]["input_size"]["width"].as<int>();
+        cfg.model_height = config["model"]["input_size"]["height"].as<int>();
+        cfg.network_group = config["model"]["network_group"] ? config["model"]["network_group"].as<std::string>() : "";
+        cfg.model_priority = config["model"]["priority"] ? config["model"]["priority"].as<int>() : 16;
+
+        // 추가 모델 (optional): depth와 같은 장치를 시분할로 나눠 쓴다
+        if (YAML::Node models = config["models"]) {
+            for (const YAML::Node &node : models) {
+                ModelSpec model;
+                model.name = node["name"] ? node["name"].as<std::string>() : "model" + std::to_string(cfg.models.size());
+                if (node["hef_path"]) model.hef_path = node["hef_path"].as<std::string>();
+                if (node["network_group"]) model.network_group = node["network_group"].as<std::string>();
+                if (node["input_size"]) {
+                    model.width = node["input_size"]["width"].as<int>();
+                    model.height = node["input_size"]["height"].as<int>();
+                }
+                if (node["priority"]) model.priority = node["priority"].as<int>();
+                if (node["batch_size"]) model.batch_size = node["batch_size"].as<int>();
+                if (node["fps"]) model.fps = node["fps"].as<double>();
+                if (node["timeout_ms"]) model.timeout_ms = node["timeout_ms"].as<double>();
+                if (node["cpu_latency_ms"]) model.cpu_latency_ms = node["cpu_latency_ms"].as<double>();
+                if (node["ring"]) model.ring = node["ring"].as<std::string>();
+                cfg.models.push_back(model);
+            }
+        }
+        
+        // 해상도 사다리 (optional): 시작할 때 모두 올려 두고 부하에 따라 프레임 사이에서 전환
+        if (YAML::Node ladder = config["model"]["ladder"]) {
+            for (const YAML::Node &node : ladder) {
+                ModelRung rung;
+                if (node["hef_path"]) rung.hef_path = node["hef_path"].as<std::string>();
+                rung.width = node["width"].as<int>();
+                rung.height = node["height"].as<int>();
+                if (node["cpu_latency_ms"]) rung.cpu_latency_ms = node["cpu_latency_ms"].as<double>();
+                cfg.ladder.push_back(rung);
+            }
+        }
+        
+        // video input size
+        cfg.video_inWidth = config["video"]["input"]["width"].as<int>();
+        cfg.video_inHeight = config["video"]["input"]["height"].as<int>();
+        
+        // video output size
+        cfg.video_outWidth = config["video"]["output"]["width"].as<int>();
+        cfg.video_outHeight = config["video"]["output"]["height"].as<int>();
+        cfg.output_name = config["video"]["output"]["file"].as<std::string>();
+        cfg.frame_rate = config["video"]["framerate"].as<int>();
+
+        // output branches (optional): 없으면 기존 구성 = 화면 + 파일
+        if (YAML::Node outputs = config["outputs"]) {
+            cfg.outputs = parse_outputs(outputs);
+        } else {
+            cfg.outputs = {OutputSink{"display"}, OutputSink{"file"}};
+        }
+
+        // multi-source (optional): 카메라마다 appsink, 추론 엔진은 하나를 나눠 쓴다
+        if (YAML::Node sources = config["sources"]) {
+            for (const YAML::Node &node : sources) {
+                VideoSource source;
+                source.type = node["type"].as<std::string>();
+                source.name = node["name"] ? node["name"].as<std::string>() : "source" + std::to_string(cfg.sources.size());
+                if (node["location"]) source.location = node["location"].as<std::string>();
+                if (node["width"]) source.width = node["width"].as<int>();
+                if (node["height"]) source.height = node["height"].as<int>();
+                if (node["fps"]) source.fps = node["fps"].as<int>();
+                if (node["weight"]) source.weight = node["weight"].as<int>();
+                if (node["drop_policy"]) source.drop_policy = node["drop_policy"].as<std::string>();
+                if (node["queue_depth"]) source.queue_depth = node["queue_depth"].as<int>();
+                if (YAML::Node outputs = node["outputs"]) {
+                    source.has_outputs = true;
+                    source.outputs = parse_outputs(outputs);
+                }
+                cfg.sources.push_back(source);
+            }
+        }
+        
+        // preprocess (optional)
+        cfg.preprocess = "antialias";
+        if (config["preprocess"] && config["preprocess"]["method"]) {
+            cfg.preprocess = config["preprocess"]["method"].as<std::string>();
+        }
+        
+        // encoder config
+        cfg.encode_speed = config["encoder"]["speed_preset"].as<int>();
+        cfg.tune = config["encoder"]["tune"].as<int>();
+        
+        // inference config (optional)
+        cfg.frames_in_flight = 1;
+        cfg.batch_size = 1;
+        cfg.batch_timeout_ms = 50.0;
+        cfg.backend = "hailo";
+        cfg.cpu_latency_ms = 39.0;
+        cfg.cpu_jitter_ms = 1.5;
+        cfg.cpu_switch_ms = 2.0;
+        if (YAML::Node inference = config["inference"]) {
+            if (inference["frames_in_flight"]) cfg.frames_in_flight = inference["frames_in_flight"].as<int>();
+            if (inference["batch_size"]) cfg.batch_size = inference["batch_size"].as<int>();
+            if (inference["batch_timeout_ms"]) cfg.batch_timeout_ms = inference["batch_timeout_ms"].as<double>();
+            if (inference["backend"]) cfg.backend = inference["backend"].as<std::string>();
+            if (YAML::Node cpu = inference["cpu"]) {
+                if (cpu["latency_ms"]) cfg.cpu_latency_ms = cpu["latency_ms"].as<double>();
+                if (cpu["jitter_ms"]) cfg.cpu_jitter_ms = cpu["jitter_ms"].as<double>();
+                if (cpu["latency_log"]) cfg.cpu_latency_log = cpu["latency_log"].as<std::string>();
+                if (cpu["switch_ms"]) cfg.cpu_switch_ms = cpu["switch_ms"].as<double>();
+            }
+        }
+        
+        // inference service (optional): depth_service가 만들고 backend: service 클라이언트가 붙는다
+        cfg.service_name = "/hailodepth_service";
+        cfg.service_backend = "hailo";
+        cfg.service_clients = 4;
+        cfg.service_slots = 4;
+        if (YAML::Node service = config["service"]) {
+            if (service["name"]) cfg.service_name = service["name"].as<std::string>();
+            if (service["backend"]) cfg.service_backend = service["backend"].as<std::string>();
+            if (service["clients"]) cfg.service_clients = service["clients"].as<int>();
+            if (service["slots"]) cfg.service_slots = service["slots"].as<int>();
+        }
+        
+        // pipeline config (optional)
+        cfg.staged = false;
+        cfg.stage_queue_depth = 2;
+        cfg.drop_policy = "block";
+        cfg.scheduling = "round_robin";
+        cfg.stats_interval_s = 5.0;
+        cfg.element = false;
+        if (YAML::Node pipeline = config["pipeline"]) {
+            if (pipeline["element"]) cfg.element = pipeline["element"].as<bool>();
+            if (pipeline["staged"]) cfg.staged = pipeline["staged"].as<bool>();
+            if (pipeline["queue_depth"]) cfg.stage_queue_depth = pipeline["queue_depth"].as<int>();
+            if (pipeline["drop_policy"]) cfg.drop_policy = pipeline["drop_policy"].as<std::string>();
+            if (pipeline["scheduling"]) cfg.scheduling = pipeline["scheduling"].as<std::string>();
+            if (pipeline["stats_interval_s"]) cfg.stats_interval_s = pipeline["stats_interval_s"].as<double>();
+        }
+        
+        // replay (optional): 카메라 대신 녹화 파일
+        cfg.replay_file = "";
+        cfg.replay_rate = 0.0;
+        cfg.replay_display = false;
+        if (YAML::Node replay = config["replay"]) {
+            if (replay["file"]) cfg.replay_file = replay["file"].as<std::string>();
+            if (replay["rate"]) cfg.replay_rate = replay["rate"].as<double>();
+            if (replay["display"]) cfg.replay_display = replay["display"].as<bool>();
+        }
+        
+        // latency tracking (optional)
+        cfg.output_latency_ms = 150.0;
+        cfg.latency_report_s = 10.0;
+        if (YAML::Node latency = config["latency"]) {
+            if (latency["output_ms"]) cfg.output_latency_ms = latency["output_ms"].as<double>();
+            if (latency["report_interval_s"]) cfg.latency_report_s = latency["report_interval_s"].as<double>();
+        }
+        
+        // metrics endpoint (optional)
+        cfg.metrics_enabled = false;
+        cfg.metrics_bind = "127.0.0.1";
+        cfg.metrics_port = 9464;
+        if (YAML::Node metrics = config["metrics"]) {
+            if (metrics["enabled"]) cfg.metrics_enabled = metrics["enabled"].as<bool>();
+            if (metrics["bind"]) cfg.metrics_bind = metrics["bind"].as<std::string>();
+            if (metrics["port"]) cfg.metrics_port = metrics["port"].as<int>();
+        }
+        
+        // ladder QoS controller (optional)
+        cfg.qos_interval_s = 1.0;
+        cfg.qos_max_drop_rate = 0.02;
+        cfg.qos_high_load = 0.9;
+        cfg.qos_low_load = 0.6;
+        cfg.qos_up_after = 3;
+        cfg.qos_hold_s = 3.0;
+        cfg.qos_log = "";
+        if (YAML::Node qos = config["qos"]) {
+            if (qos["interval_s"]) cfg.qos_interval_s = qos["interval_s"].as<double>();
+            if (qos["max_drop_rate"]) cfg.qos_max_drop_rate = qos["max_drop_rate"].as<double>();
+            if (qos["high_load"]) cfg.qos_high_load = qos["high_load"].as<double>();
+            if (qos["low_load"]) cfg.qos_low_load = qos["low_load"].as<double>();
+            if (qos["up_after"]) cfg.qos_up_after = qos["up_after"].as<int>();
+            if (qos["hold_s"]) cfg.qos_hold_s = qos["hold_s"].as<double>();
+            if (qos["log"]) cfg.qos_log = qos["log"].as<std::string>();
+        }
+        
+        // long file name
+        cfg.timing_log = config["logging"]["timing_log"].as<std::string>();
+        cfg.timeline_log = "";
+        if (config["logging"]["timeline"]) cfg.timeline_log = config["logging"]["timeline"].as<std::string>();
+
+        // offline output (--input 모드에서 주로 사용)
+        cfg.write_video = true;
+        cfg.depth_raw = "";
+        if (YAML::Node offline = config["offline"]) {
+            if (offline["write_video"]) cfg.write_video = offline["write_video"].as<bool>();
+            if (offline["depth_raw"]) cfg.depth_raw = offline["depth_raw"].as<std::string>();
+        }
+
+        // shared-memory depth ring (optional)
+        cfg.depth_ring = "";
+        cfg.depth_ring_slots = 8;
+        if (YAML::Node ring = config["depth_ring"]) {
+            if (ring["name"]) cfg.depth_ring = ring["name"].as<std::string>();
+            if (ring["slots"]) cfg.depth_ring_slots = ring["slots"].as<int>();
+        }
+        
+        return cfg;
+}
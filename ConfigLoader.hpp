@@ -0,0 +1,15 @@
+#pragma once
+
+#include "Hailoinfer.hpp"
+
+#include <string>
+
+/**
+ * @brief Loads the YAML configuration file shared by the pipeline and the batch tool
+ *
+ * Optional sections fall back to their defaults; missing required keys throw YAML::Exception.
+ *
+ * @param[in] yaml_path Path to the YAML configuration file
+ * @return Config object populated with loaded settings
+ */
+Config load_config(const std::string& yaml_path);
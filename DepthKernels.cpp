@@ -0,0 +1,434 @@
+#include "DepthKernels.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define DEPTH_KERNELS_NEON 1
+#elif (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <immintrin.h>
+#define DEPTH_KERNELS_X86 1
+#endif
+
+// ==================== MIN / MAX ====================
+
+static void minmax_scalar(const int8_t *src, size_t count, int8_t *min_value, int8_t *max_value)
+{
+    int8_t lo = src[0];
+    int8_t hi = src[0];
+    for (size_t i = 1; i < count; i++) {
+        lo = std::min(lo, src[i]);
+        hi = std::max(hi, src[i]);
+    }
+    *min_value = lo;
+    *max_value = hi;
+}
+
+#if DEPTH_KERNELS_X86
+__attribute__((target("sse4.1")))
+static void minmax_sse41(const int8_t *src, size_t count, int8_t *min_value, int8_t *max_value)
+{
+    __m128i vmin = _mm_set1_epi8(127);
+    __m128i vmax = _mm_set1_epi8(-128);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        vmin = _mm_min_epi8(vmin, v);
+        vmax = _mm_max_epi8(vmax, v);
+    }
+
+    alignas(16) int8_t lanes_min[16];
+    alignas(16) int8_t lanes_max[16];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes_min), vmin);
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes_max), vmax);
+    int8_t lo = 127;
+    int8_t hi = -128;
+    for (int k = 0; k < 16; k++) {
+        lo = std::min(lo, lanes_min[k]);
+        hi = std::max(hi, lanes_max[k]);
+    }
+    for (; i < count; i++) {
+        lo = std::min(lo, src[i]);
+        hi = std::max(hi, src[i]);
+    }
+    *min_value = lo;
+    *max_value = hi;
+}
+
+__attribute__((target("avx2")))
+static void minmax_avx2(const int8_t *src, size_t count, int8_t *min_value, int8_t *max_value)
+{
+    __m256i vmin = _mm256_set1_epi8(127);
+    __m256i vmax = _mm256_set1_epi8(-128);
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        vmin = _mm256_min_epi8(vmin, v);
+        vmax = _mm256_max_epi8(vmax, v);
+    }
+
+    alignas(32) int8_t lanes_min[32];
+    alignas(32) int8_t lanes_max[32];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes_min), vmin);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes_max), vmax);
+    int8_t lo = 127;
+    int8_t hi = -128;
+    for (int k = 0; k < 32; k++) {
+        lo = std::min(lo, lanes_min[k]);
+        hi = std::max(hi, lanes_max[k]);
+    }
+    for (; i < count; i++) {
+        lo = std::min(lo, src[i]);
+        hi = std::max(hi, src[i]);
+    }
+    *min_value = lo;
+    *max_value = hi;
+}
+#endif
+
+#if DEPTH_KERNELS_NEON
+static void minmax_neon(const int8_t *src, size_t count, int8_t *min_value, int8_t *max_value)
+{
+    int8x16_t vmin = vdupq_n_s8(127);
+    int8x16_t vmax = vdupq_n_s8(-128);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        int8x16_t v = vld1q_s8(src + i);
+        vmin = vminq_s8(vmin, v);
+        vmax = vmaxq_s8(vmax, v);
+    }
+
+    alignas(16) int8_t lanes_min[16];
+    alignas(16) int8_t lanes_max[16];
+    vst1q_s8(lanes_min, vmin);
+    vst1q_s8(lanes_max, vmax);
+    int8_t lo = 127;
+    int8_t hi = -128;
+    for (int k = 0; k < 16; k++) {
+        lo = std::min(lo, lanes_min[k]);
+        hi = std::max(hi, lanes_max[k]);
+    }
+    for (; i < count; i++) {
+        lo = std::min(lo, src[i]);
+        hi = std::max(hi, src[i]);
+    }
+    *min_value = lo;
+    *max_value = hi;
+}
+#endif
+
+#if DEPTH_KERNELS_X86
+static bool cpu_has_avx2()
+{
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+
+static bool cpu_has_sse41()
+{
+    static const bool supported = __builtin_cpu_supports("sse4.1");
+    return supported;
+}
+#endif
+
+void depth_minmax(const int8_t *src, size_t count, int8_t *min_value, int8_t *max_value)
+{
+#if DEPTH_KERNELS_NEON
+    minmax_neon(src, count, min_value, max_value);
+#elif DEPTH_KERNELS_X86
+    if (cpu_has_avx2()) {
+        minmax_avx2(src, count, min_value, max_value);
+    } else if (cpu_has_sse41()) {
+        minmax_sse41(src, count, min_value, max_value);
+    } else {
+        minmax_scalar(src, count, min_value, max_value);
+    }
+#else
+    minmax_scalar(src, count, min_value, max_value);
+#endif
+}
+
+const char *depth_kernel_path()
+{
+#if DEPTH_KERNELS_NEON
+    return "neon";
+#elif DEPTH_KERNELS_X86
+    if (cpu_has_avx2()) return "avx2";
+    if (cpu_has_sse41()) return "sse4.1";
+    return "scalar";
+#else
+    return "scalar";
+#endif
+}
+
+// ==================== LUT MAPPING ====================
+// frame_lut[v + 128] = 픽셀값 v(int8)의 최종 색. min/max 정규화까지 테이블에 접어 넣는다.
+
+static void map_scalar(const int8_t *src, size_t count, const uint8_t (*frame_lut)[3], uint8_t *dst)
+{
+    for (size_t i = 0; i < count; i++) {
+        const uint8_t *color = frame_lut[static_cast<uint8_t>(src[i]) ^ 0x80];
+        dst[3 * i] = color[0];
+        dst[3 * i + 1] = color[1];
+        dst[3 * i + 2] = color[2];
+    }
+}
+
+#if DEPTH_KERNELS_X86
+static inline uint32_t pack_color(const uint8_t color[3])
+{
+    return color[0] | (color[1] << 8) | (color[2] << 16);
+}
+
+__attribute__((target("sse4.1")))
+static void map_sse41(const int8_t *src, size_t count, const uint8_t (*frame_lut)[3], uint8_t *dst)
+{
+    // SSE에는 gather가 없다: packed 32비트 테이블을 스칼라로 읽어 4픽셀을 채우고
+    // pshufb로 12바이트로 압축해 한 번에 저장 (픽셀당 3번 대신 4픽셀당 1번 store)
+    alignas(16) uint32_t lut32[256];
+    for (int k = 0; k < 256; k++) {
+        lut32[k] = pack_color(frame_lut[k]);
+    }
+
+    const __m128i pack = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    const uint8_t *idx = reinterpret_cast<const uint8_t*>(src);
+
+    size_t i = 0;
+    // 16바이트를 쓰므로 뒤에 최소 4바이트(2픽셀) 여유가 있을 때만 SIMD
+    for (; i + 6 <= count; i += 4) {
+        __m128i px = _mm_setr_epi32(static_cast<int>(lut32[idx[i] ^ 0x80]),
+                                    static_cast<int>(lut32[idx[i + 1] ^ 0x80]),
+                                    static_cast<int>(lut32[idx[i + 2] ^ 0x80]),
+                                    static_cast<int>(lut32[idx[i + 3] ^ 0x80]));
+        px = _mm_shuffle_epi8(px, pack);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 3 * i), px);
+    }
+    map_scalar(src + i, count - i, frame_lut, dst + 3 * i);
+}
+
+__attribute__((target("avx2")))
+static void map_avx2(const int8_t *src, size_t count, const uint8_t (*frame_lut)[3], uint8_t *dst)
+{
+    // 32비트 packed 테이블 (c0 | c1<<8 | c2<<16) → 8픽셀씩 gather
+    alignas(32) uint32_t lut32[256];
+    for (int k = 0; k < 256; k++) {
+        lut32[k] = pack_color(frame_lut[k]);
+    }
+
+    // 레인마다 4바이트 픽셀 4개 → 앞 12바이트로 압축
+    const __m256i pack = _mm256_setr_epi8(
+        0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+        0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    const __m128i bias = _mm_set1_epi8(static_cast<char>(0x80));
+
+    size_t i = 0;
+    // 두 번째 레인은 16바이트를 쓰므로 뒤에 최소 4바이트(2픽셀) 여유가 있을 때만 SIMD
+    for (; i + 10 <= count; i += 8) {
+        __m128i raw = _mm_xor_si128(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i)), bias);
+        __m256i idx = _mm256_cvtepu8_epi32(raw);
+        __m256i px = _mm256_i32gather_epi32(reinterpret_cast<const int*>(lut32), idx, 4);
+        px = _mm256_shuffle_epi8(px, pack);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 3 * i), _mm256_castsi256_si128(px));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 3 * i + 12), _mm256_extracti128_si256(px, 1));
+    }
+    map_scalar(src + i, count - i, frame_lut, dst + 3 * i);
+}
+#endif
+
+#if DEPTH_KERNELS_NEON
+static inline uint8x16_t lookup256(const uint8x16x4_t table[4], uint8x16_t idx)
+{
+    // vqtbl4q는 64바이트 테이블: 범위를 벗어난 인덱스는 0을 돌려주므로 4조각을 OR
+    const uint8x16_t step = vdupq_n_u8(64);
+    uint8x16_t r = vqtbl4q_u8(table[0], idx);
+    idx = vsubq_u8(idx, step);
+    r = vorrq_u8(r, vqtbl4q_u8(table[1], idx));
+    idx = vsubq_u8(idx, step);
+    r = vorrq_u8(r, vqtbl4q_u8(table[2], idx));
+    idx = vsubq_u8(idx, step);
+    r = vorrq_u8(r, vqtbl4q_u8(table[3], idx));
+    return r;
+}
+
+static void map_neon(const int8_t *src, size_t count, const uint8_t (*frame_lut)[3], uint8_t *dst)
+{
+    // 채널별 256바이트 평면 테이블
+    alignas(16) uint8_t planes[3][256];
+    for (int k = 0; k < 256; k++) {
+        planes[0][k] = frame_lut[k][0];
+        planes[1][k] = frame_lut[k][1];
+        planes[2][k] = frame_lut[k][2];
+    }
+    uint8x16x4_t tables[3][4];
+    for (int c = 0; c < 3; c++) {
+        for (int q = 0; q < 4; q++) {
+            tables[c][q] = vld1q_u8_x4(planes[c] + 64 * q);
+        }
+    }
+
+    const uint8x16_t bias = vdupq_n_u8(0x80);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        uint8x16_t idx = veorq_u8(vreinterpretq_u8_s8(vld1q_s8(src + i)), bias);
+        uint8x16x3_t px;
+        px.val[0] = lookup256(tables[0], idx);
+        px.val[1] = lookup256(tables[1], idx);
+        px.val[2] = lookup256(tables[2], idx);
+        vst3q_u8(dst + 3 * i, px);
+    }
+    map_scalar(src + i, count - i, frame_lut, dst + 3 * i);
+}
+#endif
+
+/**
+ * @brief Folds the NORM_MINMAX scaling of [lo, hi] into a per-frame colour table
+ *
+ * Same formula as cv::normalize: level = u * scale + shift (u = v + 128, float), 0 for
+ * an empty range.
+ *
+ * @param[in] lut Colour of each normalized level
+ * @param[in] lo Smallest depth value of the frame
+ * @param[in] hi Largest depth value of the frame
+ * @param[out] frame_lut Colour of each raw value (index v + 128)
+ */
+static void build_frame_lut(const uint8_t (*lut)[3], int8_t lo, int8_t hi, uint8_t (*frame_lut)[3])
+{
+    const int range = static_cast<int>(hi) - static_cast<int>(lo);
+    const float scale = range > 0 ? 255.0f / range : 0.0f;
+    const float shift = -(static_cast<int>(lo) + 128) * scale;
+    for (int u = 0; u < 256; u++) {
+        int level = cvRound(u * scale + shift);
+        level = std::min(std::max(level, 0), 255);
+        std::memcpy(frame_lut[u], lut[level], 3);
+    }
+}
+
+static void map_frame(const int8_t *src, size_t count, const uint8_t (*frame_lut)[3], uint8_t *dst)
+{
+#if DEPTH_KERNELS_NEON
+    map_neon(src, count, frame_lut, dst);
+#elif DEPTH_KERNELS_X86
+    if (cpu_has_avx2()) {
+        map_avx2(src, count, frame_lut, dst);
+    } else if (cpu_has_sse41()) {
+        map_sse41(src, count, frame_lut, dst);
+    } else {
+        map_scalar(src, count, frame_lut, dst);
+    }
+#else
+    map_scalar(src, count, frame_lut, dst);
+#endif
+}
+
+// ==================== DepthColorizer ====================
+
+bool parse_colormap(const std::string &name, int &colormap)
+{
+    static const struct { const char *name; int id; } COLORMAPS[] = {
+        {"magma", cv::COLORMAP_MAGMA},
+        {"inferno", cv::COLORMAP_INFERNO},
+        {"plasma", cv::COLORMAP_PLASMA},
+        {"viridis", cv::COLORMAP_VIRIDIS},
+        {"turbo", cv::COLORMAP_TURBO},
+        {"jet", cv::COLORMAP_JET},
+    };
+    for (const auto &entry : COLORMAPS) {
+        if (name == entry.name) {
+            colormap = entry.id;
+            return true;
+        }
+    }
+    return false;
+}
+
+DepthColorizer::DepthColorizer(int colormap, bool rgb_order)
+{
+    // OpenCV 컬러맵을 256x1 램프에 한 번 적용해서 LUT로 고정
+    cv::Mat ramp(256, 1, CV_8UC1);
+    for (int k = 0; k < 256; k++) {
+        ramp.at<uchar>(k, 0) = static_cast<uchar>(k);
+    }
+    cv::Mat colors;
+    cv::applyColorMap(ramp, colors, colormap);
+
+    uint8_t bgr[256][3];
+    for (int k = 0; k < 256; k++) {
+        const cv::Vec3b &c = colors.at<cv::Vec3b>(k, 0);
+        bgr[k][0] = c[0];
+        bgr[k][1] = c[1];
+        bgr[k][2] = c[2];
+    }
+    set_table(bgr, rgb_order);
+}
+
+void DepthColorizer::set_table(const uint8_t bgr[256][3], bool rgb_order)
+{
+    for (int k = 0; k < 256; k++) {
+        m_lut[k][0] = rgb_order ? bgr[k][2] : bgr[k][0];
+        m_lut[k][1] = bgr[k][1];
+        m_lut[k][2] = rgb_order ? bgr[k][0] : bgr[k][2];
+    }
+}
+
+/**
+ * @brief Colourizes count int8 depth values into packed 3-byte pixels
+ *
+ * Pass 1 finds min/max. The NORM_MINMAX scaling is then folded into a per-frame
+ * 256-entry table (same rounding as cv::normalize), and pass 2 is a single lookup
+ * per pixel.
+ *
+ * @param[in] src Raw int8 NPU output
+ * @param[in] count Number of pixels
+ * @param[out] dst count * 3 bytes in the colorizer's channel order
+ */
+void DepthColorizer::colorize(const int8_t *src, size_t count, uint8_t *dst) const
+{
+    if (count == 0) {
+        return;
+    }
+
+    int8_t lo = 0;
+    int8_t hi = 0;
+    depth_minmax(src, count, &lo, &hi);
+
+    uint8_t frame_lut[256][3];
+    build_frame_lut(m_lut, lo, hi, frame_lut);
+    map_frame(src, count, frame_lut, dst);
+}
+
+/**
+ * @brief Colourizes a CV_8SC1 depth map into dst (CV_8UC3)
+ *
+ * A strided map (ROI or padded rows) is normalized over the whole frame like a
+ * continuous one: min/max over every row first, one frame table, then the rows
+ * are mapped through it.
+ */
+void DepthColorizer::colorize(const cv::Mat &raw_depth, cv::Mat &dst) const
+{
+    dst.create(raw_depth.rows, raw_depth.cols, CV_8UC3);
+    if (raw_depth.isContinuous() && dst.isContinuous()) {
+        colorize(reinterpret_cast<const int8_t*>(raw_depth.data), raw_depth.total(), dst.data);
+        return;
+    }
+    if (raw_depth.empty()) {
+        return;
+    }
+
+    // 행마다 정규화하면 행마다 색 기준이 달라져 띠가 생긴다: 프레임 전체 min/max로 테이블 하나
+    int8_t lo = 127;
+    int8_t hi = -128;
+    for (int y = 0; y < raw_depth.rows; y++) {
+        int8_t row_lo = 0;
+        int8_t row_hi = 0;
+        depth_minmax(raw_depth.ptr<int8_t>(y), raw_depth.cols, &row_lo, &row_hi);
+        lo = std::min(lo, row_lo);
+        hi = std::max(hi, row_hi);
+    }
+
+    uint8_t frame_lut[256][3];
+    build_frame_lut(m_lut, lo, hi, frame_lut);
+    for (int y = 0; y < raw_depth.rows; y++) {
+        map_frame(raw_depth.ptr<int8_t>(y), raw_depth.cols, frame_lut, dst.ptr<uint8_t>(y));
+    }
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Finds min and max of an int8 buffer (vectorized on NEON / SSE4.1 / AVX2)
+ *
+ * @param[in] src int8 values
+ * @param[in] count Number of values (> 0)
+ * @param[out] min_value Smallest value
+ * @param[out] max_value Largest value
+ */
+void depth_minmax(const int8_t *src, size_t count, int8_t *min_value, int8_t *max_value);
+
+/**
+ * @brief Name of the SIMD path selected at runtime ("neon", "avx2", "sse4.1" or "scalar")
+ */
+const char *depth_kernel_path();
+
+/**
+ * @brief Maps a colormap name ("magma", "inferno", "plasma", "viridis", "turbo", "jet") to its cv::COLORMAP_* id
+ *
+ * @return false if the name is unknown (colormap is left untouched)
+ */
+bool parse_colormap(const std::string &name, int &colormap);
+
+/**
+ * @brief Fused int8 depth → colour kernel
+ *
+ * Replaces the chain convertTo(+128) → normalize(NORM_MINMAX) → applyColorMap →
+ * cvtColor with two passes over the raw NPU output: a vectorized min/max, then
+ * one table lookup per pixel through a 256-entry colour LUT, written directly in
+ * the requested channel order. The per-frame table is built on the stack, so
+ * colorize() does not allocate when dst is already sized.
+ */
+class DepthColorizer {
+public:
+    /// Builds the LUT from an OpenCV colormap (e.g. cv::COLORMAP_MAGMA)
+    explicit DepthColorizer(int colormap = cv::COLORMAP_MAGMA, bool rgb_order = true);
+
+    /// Replaces the LUT with a custom BGR table (256 entries)
+    void set_table(const uint8_t bgr[256][3], bool rgb_order);
+
+    /**
+     * @brief Colourizes count int8 values into count packed 3-byte pixels
+     */
+    void colorize(const int8_t *src, size_t count, uint8_t *dst) const;
+
+    /**
+     * @brief Colourizes a CV_8SC1 depth map into dst (CV_8UC3, created if needed)
+     */
+    void colorize(const cv::Mat &raw_depth, cv::Mat &dst) const;
+
+private:
+    uint8_t m_lut[256][3];  ///< Colour of normalized value i, already in output channel order
+};
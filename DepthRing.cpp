@@ -0,0 +1,257 @@
+#include "DepthRing.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <new>
+
+namespace {
+
+constexpr size_t SLOT_ALIGN = 64;
+
+uint64_t monotonic_ns()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+size_t slot_stride(size_t frame_size)
+{
+    const size_t bytes = sizeof(DepthRingSlot) + frame_size;
+    return (bytes + SLOT_ALIGN - 1) / SLOT_ALIGN * SLOT_ALIGN;
+}
+
+}  // namespace
+
+// ==================== DepthRingWriter ====================
+
+DepthRingWriter::~DepthRingWriter()
+{
+    close();
+}
+
+bool DepthRingWriter::create(const std::string &name, uint32_t width, uint32_t height, uint32_t slot_count,
+                             bool is_signed)
+{
+    if (name.empty() || name[0] != '/' || slot_count < 2) {
+        std::cerr << "[ERROR] Depth ring needs a name like /hailodepth and at least 2 slots" << std::endl;
+        return false;
+    }
+    m_frame_size = static_cast<size_t>(width) * height;
+    const size_t stride = slot_stride(m_frame_size);
+    m_size = sizeof(DepthRingHeader) + stride * slot_count;
+
+    // 이전 실행이 남긴 링은 크기가 다를 수 있으므로 새로 만든다 (붙어 있던 reader는 closed 플래그로 알게 됨)
+    const int old_fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (old_fd >= 0) {
+        struct stat st;
+        if (fstat(old_fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(DepthRingHeader)) {
+            void *old = mmap(nullptr, sizeof(DepthRingHeader), PROT_READ | PROT_WRITE, MAP_SHARED, old_fd, 0);
+            if (old != MAP_FAILED) {
+                static_cast<DepthRingHeader*>(old)->closed.store(1, std::memory_order_release);
+                munmap(old, sizeof(DepthRingHeader));
+            }
+        }
+        ::close(old_fd);
+    }
+    shm_unlink(name.c_str());
+    const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        std::cerr << "[ERROR] shm_open(" << name << "): " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    if (ftruncate(fd, static_cast<off_t>(m_size)) < 0) {
+        std::cerr << "[ERROR] ftruncate(" << name << "): " << std::strerror(errno) << std::endl;
+        ::close(fd);
+        shm_unlink(name.c_str());
+        return false;
+    }
+    void *base = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        std::cerr << "[ERROR] mmap(" << name << "): " << std::strerror(errno) << std::endl;
+        shm_unlink(name.c_str());
+        return false;
+    }
+
+    // ftruncate로 0으로 채워진 상태: 슬롯 seq = 0 (짝수, 비어 있음)
+    m_base = static_cast<uint8_t*>(base);
+    m_header = new (m_base) DepthRingHeader();
+    m_header->width = width;
+    m_header->height = height;
+    m_header->slot_count = slot_count;
+    m_header->is_signed = is_signed ? 1 : 0;
+    m_header->slot_stride = stride;
+    m_header->version = DEPTH_RING_VERSION;
+    for (uint32_t i = 0; i < slot_count; i++) {
+        new (m_base + sizeof(DepthRingHeader) + stride * i) DepthRingSlot();
+    }
+    m_header->published.store(0, std::memory_order_relaxed);
+    m_header->closed.store(0, std::memory_order_relaxed);
+    // magic은 마지막에: reader는 magic이 보이면 레이아웃이 완성된 것으로 본다
+    m_header->magic.store(DEPTH_RING_MAGIC, std::memory_order_release);
+
+    m_name = name;
+    m_next = 0;
+    std::cout << "깊이 링: /dev/shm" << name << " (" << slot_count << " 슬롯, " << width << "x" << height << ")" << std::endl;
+    return true;
+}
+
+void DepthRingWriter::close()
+{
+    if (!m_base) {
+        return;
+    }
+    m_header->closed.store(1, std::memory_order_release);
+    munmap(m_base, m_size);
+    shm_unlink(m_name.c_str());
+    m_base = nullptr;
+    m_header = nullptr;
+}
+
+void DepthRingWriter::publish(const uint8_t *data, uint64_t frame_id, uint64_t capture_ns)
+{
+    if (!m_base) {
+        return;
+    }
+    const uint64_t index = m_next++;
+    DepthRingSlot *slot = reinterpret_cast<DepthRingSlot*>(
+        m_base + sizeof(DepthRingHeader) + m_header->slot_stride * (index % m_header->slot_count));
+
+    // seqlock: 홀수 동안 쓰는 중, reader는 전후 seq가 같고 짝수일 때만 받아들인다
+    const uint32_t seq = slot->seq.load(std::memory_order_relaxed);
+    slot->seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot->index = index;
+    slot->frame_id = frame_id;
+    slot->capture_ns = capture_ns;
+    slot->publish_ns = monotonic_ns();
+    slot->scale = m_scale;
+    slot->zero_point = m_zero_point;
+    std::memcpy(reinterpret_cast<uint8_t*>(slot) + sizeof(DepthRingSlot), data, m_frame_size);
+
+    slot->seq.store(seq + 2, std::memory_order_release);
+    m_header->published.store(index + 1, std::memory_order_release);
+}
+
+// ==================== DepthRingReader ====================
+
+DepthRingReader::~DepthRingReader()
+{
+    close();
+}
+
+bool DepthRingReader::open(const std::string &name)
+{
+    close();
+    const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0 || static_cast<size_t>(st.st_size) < sizeof(DepthRingHeader)) {
+        ::close(fd);
+        return false;
+    }
+    void *base = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        return false;
+    }
+
+    const DepthRingHeader *header = static_cast<const DepthRingHeader*>(base);
+    const bool ready = header->magic.load(std::memory_order_acquire) == DEPTH_RING_MAGIC;
+    if (!ready || header->version != DEPTH_RING_VERSION ||
+        sizeof(DepthRingHeader) + header->slot_stride * header->slot_count > static_cast<size_t>(st.st_size)) {
+        munmap(base, static_cast<size_t>(st.st_size));
+        return false;
+    }
+
+    m_base = static_cast<const uint8_t*>(base);
+    m_size = static_cast<size_t>(st.st_size);
+    m_header = header;
+    m_last = 0;
+    return true;
+}
+
+void DepthRingReader::close()
+{
+    if (m_base) {
+        munmap(const_cast<uint8_t*>(m_base), m_size);
+    }
+    m_base = nullptr;
+    m_header = nullptr;
+}
+
+const DepthRingSlot *DepthRingReader::slot_at(uint64_t index) const
+{
+    return reinterpret_cast<const DepthRingSlot*>(
+        m_base + sizeof(DepthRingHeader) + m_header->slot_stride * (index % m_header->slot_count));
+}
+
+bool DepthRingReader::latest(DepthFrame &frame)
+{
+    if (!m_header) {
+        return false;
+    }
+    const uint64_t published = m_header->published.load(std::memory_order_acquire);
+    if (published == 0 || published == m_last) {
+        return false;
+    }
+    const uint64_t index = published - 1;
+    const DepthRingSlot *slot = slot_at(index);
+
+    const uint32_t seq = slot->seq.load(std::memory_order_acquire);
+    if (seq & 1) {
+        return false;  // 한 바퀴 돌아 다시 쓰는 중
+    }
+    frame.index = slot->index;
+    frame.frame_id = slot->frame_id;
+    frame.capture_ns = slot->capture_ns;
+    frame.publish_ns = slot->publish_ns;
+    frame.scale = slot->scale;
+    frame.zero_point = slot->zero_point;
+    frame.width = m_header->width;
+    frame.height = m_header->height;
+    frame.is_signed = m_header->is_signed != 0;
+    frame.data = reinterpret_cast<const uint8_t*>(slot) + sizeof(DepthRingSlot);
+    frame.slot = slot;
+    frame.seq = seq;
+    if (frame.index != index || !valid(frame)) {
+        return false;
+    }
+    m_last = published;
+    return true;
+}
+
+bool DepthRingReader::valid(const DepthFrame &frame) const
+{
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return frame.slot && frame.slot->seq.load(std::memory_order_relaxed) == frame.seq;
+}
+
+bool DepthRingReader::copy_latest(DepthFrame &frame, uint8_t *dst)
+{
+    if (!latest(frame)) {
+        return false;
+    }
+    std::memcpy(dst, frame.data, static_cast<size_t>(frame.width) * frame.height);
+    if (!valid(frame)) {
+        return false;
+    }
+    frame.data = dst;
+    return true;
+}
+
+bool DepthRingReader::closed() const
+{
+    return !m_header || m_header->closed.load(std::memory_order_acquire) != 0;
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+// 다른 프로세스(내비게이션, 로깅)에서도 쓰는 헤더: HailoRT / GStreamer / OpenCV에 의존하지 않는다
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Layout of the shared depth ring (/dev/shm/<name>)
+ *
+ * [DepthRingHeader][slot 0][slot 1]...; every slot is a DepthRingSlot followed by
+ * width * height bytes of depth, padded to slot_stride. The writer fills slot
+ * (n % slot_count) for frame n and then publishes n + 1 in header.published.
+ */
+struct alignas(64) DepthRingHeader {
+    std::atomic<uint32_t> magic;     ///< DEPTH_RING_MAGIC once the layout is complete
+    uint32_t version;
+    uint32_t slot_count;
+    uint32_t width;
+    uint32_t height;
+    uint32_t is_signed;              ///< 1 = int8 values, 0 = uint8
+    uint64_t slot_stride;            ///< Bytes from one slot header to the next
+    std::atomic<uint64_t> published; ///< Frames published so far (newest = published - 1)
+    std::atomic<uint32_t> closed;    ///< Set when the writer shuts down
+};
+
+/**
+ * @brief Per-slot seqlock header; seq is odd while the writer is filling the slot
+ */
+struct alignas(64) DepthRingSlot {
+    std::atomic<uint32_t> seq;
+    uint32_t reserved;
+    uint64_t index;        ///< Publish number this slot currently holds
+    uint64_t frame_id;     ///< Pipeline frame number (FrameTiming::frame_id)
+    uint64_t capture_ns;   ///< Capture time on CLOCK_MONOTONIC (GStreamer system clock), 0 if unknown
+    uint64_t publish_ns;   ///< CLOCK_MONOTONIC when the slot was published
+    float scale;           ///< Dequantization: depth = scale * (value - zero_point)
+    float zero_point;
+};
+
+constexpr uint32_t DEPTH_RING_MAGIC = 0x47524448;  // "HDRG"
+constexpr uint32_t DEPTH_RING_VERSION = 1;
+
+/**
+ * @brief Publishes depth maps into a memory-mapped ring that other processes read
+ *
+ * publish() never waits for readers: it overwrites the oldest slot, so a slow or
+ * stuck reader cannot stall the pipeline. Call publish() from one thread only.
+ */
+class DepthRingWriter {
+public:
+    DepthRingWriter() = default;
+    ~DepthRingWriter();
+
+    DepthRingWriter(const DepthRingWriter &) = delete;
+    DepthRingWriter &operator=(const DepthRingWriter &) = delete;
+
+    /// Creates (or replaces) the shared memory object name, e.g. "/hailodepth"
+    bool create(const std::string &name, uint32_t width, uint32_t height, uint32_t slot_count, bool is_signed);
+    /// Marks the ring closed and removes the name (mapped readers keep their view)
+    void close();
+
+    void set_quantization(float scale, float zero_point) { m_scale = scale; m_zero_point = zero_point; }
+
+    /// Copies one width x height frame into the next slot
+    void publish(const uint8_t *data, uint64_t frame_id, uint64_t capture_ns);
+
+    uint64_t published() const { return m_next; }
+
+private:
+    std::string m_name;
+    uint8_t *m_base = nullptr;
+    size_t m_size = 0;
+    DepthRingHeader *m_header = nullptr;
+    size_t m_frame_size = 0;
+    uint64_t m_next = 0;
+    float m_scale = 1.0f;
+    float m_zero_point = 0.0f;
+};
+
+/**
+ * @brief Zero-copy view of one published frame
+ *
+ * data points into the shared slot. The writer may reuse the slot once slot_count - 1
+ * newer frames are published, so check DepthRingReader::valid() after using data.
+ */
+struct DepthFrame {
+    const uint8_t *data = nullptr;   ///< width * height values (int8 if is_signed)
+    uint32_t width = 0;
+    uint32_t height = 0;
+    bool is_signed = true;
+    uint64_t index = 0;              ///< Publish number (gaps = frames this reader skipped)
+    uint64_t frame_id = 0;
+    uint64_t capture_ns = 0;
+    uint64_t publish_ns = 0;
+    float scale = 1.0f;
+    float zero_point = 0.0f;
+
+    const DepthRingSlot *slot = nullptr;
+    uint32_t seq = 0;
+};
+
+/**
+ * @brief Reader side for consumer processes (link the depthring library only)
+ *
+ * Readers never write to the ring and take no locks, so any number of them can
+ * attach. latest() returns the newest complete frame without copying it.
+ */
+class DepthRingReader {
+public:
+    DepthRingReader() = default;
+    ~DepthRingReader();
+
+    DepthRingReader(const DepthRingReader &) = delete;
+    DepthRingReader &operator=(const DepthRingReader &) = delete;
+
+    /// Maps the ring read-only; false if it does not exist (yet) or has a different layout version
+    bool open(const std::string &name);
+    void close();
+    bool is_open() const { return m_header != nullptr; }
+
+    /**
+     * @brief Newest frame newer than the last one returned
+     *
+     * @return false if nothing new was published or the slot was being rewritten
+     */
+    bool latest(DepthFrame &frame);
+    /// True while frame's slot still holds that frame (seqlock unchanged)
+    bool valid(const DepthFrame &frame) const;
+    /// latest() + copy into dst (width * height bytes), validated
+    bool copy_latest(DepthFrame &frame, uint8_t *dst);
+
+    /// The writer shut down; reopen to attach to a new writer
+    bool closed() const;
+
+    uint32_t width() const { return m_header ? m_header->width : 0; }
+    uint32_t height() const { return m_header ? m_header->height : 0; }
+
+private:
+    const DepthRingSlot *slot_at(uint64_t index) const;
+
+    const uint8_t *m_base = nullptr;
+    size_t m_size = 0;
+    const DepthRingHeader *m_header = nullptr;
+    uint64_t m_last = 0;  ///< published count at the last frame returned
+};
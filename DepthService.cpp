@@ -0,0 +1,197 @@
+#include "DepthService.hpp"
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <climits>
+#include <ctime>
+
+namespace {
+
+constexpr size_t ALIGN = 64;
+
+size_t align_up(size_t bytes)
+{
+    return (bytes + ALIGN - 1) / ALIGN * ALIGN;
+}
+
+size_t slots_bytes(uint32_t slots)
+{
+    return align_up(sizeof(ServiceChannel)) + align_up(sizeof(ServiceSlot) * slots);
+}
+
+}  // namespace
+
+size_t service_channel_stride(uint32_t slots, size_t input_size, size_t output_size)
+{
+    return slots_bytes(slots) + align_up(input_size) * slots + align_up(output_size) * slots;
+}
+
+ServiceChannel *service_channel(ServiceHeader *header, uint32_t index)
+{
+    uint8_t *base = reinterpret_cast<uint8_t*>(header) + align_up(sizeof(ServiceHeader));
+    return reinterpret_cast<ServiceChannel*>(base + header->channel_stride * index);
+}
+
+ServiceSlot *service_slot(ServiceHeader *, ServiceChannel *channel, uint32_t slot)
+{
+    uint8_t *base = reinterpret_cast<uint8_t*>(channel) + align_up(sizeof(ServiceChannel));
+    return reinterpret_cast<ServiceSlot*>(base) + slot;
+}
+
+uint8_t *service_input(ServiceHeader *header, ServiceChannel *channel, uint32_t slot)
+{
+    return reinterpret_cast<uint8_t*>(channel) + slots_bytes(header->slots) + align_up(header->input_size) * slot;
+}
+
+uint8_t *service_output(ServiceHeader *header, ServiceChannel *channel, uint32_t slot)
+{
+    return reinterpret_cast<uint8_t*>(channel) + slots_bytes(header->slots) +
+           align_up(header->input_size) * header->slots + align_up(header->output_size) * slot;
+}
+
+// 공유 메모리라 FUTEX_PRIVATE_FLAG 없이 (다른 프로세스끼리 깨움)
+void futex_wait(std::atomic<uint32_t> *word, uint32_t expected, int timeout_ms)
+{
+    timespec timeout;
+    timeout.tv_sec = timeout_ms / 1000;
+    timeout.tv_nsec = static_cast<long>(timeout_ms % 1000) * 1000000L;
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT, expected, &timeout, nullptr, 0);
+}
+
+void futex_wake(std::atomic<uint32_t> *word)
+{
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+uint64_t service_clock_ns()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+// ==================== DepthServiceClient ====================
+
+DepthServiceClient::~DepthServiceClient()
+{
+    disconnect();
+}
+
+bool DepthServiceClient::connect(const std::string &name)
+{
+    disconnect();
+    const int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0 || static_cast<size_t>(st.st_size) < sizeof(ServiceHeader)) {
+        close(fd);
+        return false;
+    }
+    void *base = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        return false;
+    }
+    m_base = static_cast<uint8_t*>(base);
+    m_size = static_cast<size_t>(st.st_size);
+    m_header = reinterpret_cast<ServiceHeader*>(m_base);
+
+    if (m_header->magic.load(std::memory_order_acquire) != DEPTH_SERVICE_MAGIC ||
+        m_header->version != DEPTH_SERVICE_VERSION || !m_header->running.load(std::memory_order_acquire)) {
+        disconnect();
+        return false;
+    }
+    // 헤더가 말하는 채널이 전부 매핑 안에 있어야 한다 (잘리거나 레이아웃이 다른 영역이면 범위 밖 접근)
+    const ServiceHeader &h = *m_header;
+    const size_t channels_offset = align_up(sizeof(ServiceHeader));
+    const bool fits = h.max_clients > 0 && h.slots > 0 && h.slots <= m_size && h.input_size <= m_size &&
+                      h.output_size <= m_size && m_size >= channels_offset &&
+                      h.channel_stride >= service_channel_stride(h.slots, h.input_size, h.output_size) &&
+                      h.channel_stride <= (m_size - channels_offset) / h.max_clients;
+    if (!fits) {
+        disconnect();
+        return false;
+    }
+
+    // 빈 채널을 CAS로 차지: 슬롯은 서비스가 채널을 회수할 때 이미 FREE로 돌려놓았다
+    for (uint32_t i = 0; i < m_header->max_clients; i++) {
+        ServiceChannel *channel = service_channel(m_header, i);
+        uint32_t expected = CHANNEL_FREE;
+        if (channel->state.compare_exchange_strong(expected, CHANNEL_CLAIMING, std::memory_order_acq_rel)) {
+            channel->pid.store(static_cast<int32_t>(getpid()), std::memory_order_relaxed);
+            channel->state.store(CHANNEL_ACTIVE, std::memory_order_release);
+            m_channel = channel;
+            return true;
+        }
+    }
+    disconnect();
+    return false;
+}
+
+void DepthServiceClient::disconnect()
+{
+    if (m_channel) {
+        m_channel->state.store(CHANNEL_CLOSING, std::memory_order_release);
+        m_header->doorbell.fetch_add(1, std::memory_order_release);
+        futex_wake(&m_header->doorbell);
+        m_channel = nullptr;
+    }
+    if (m_base) {
+        munmap(m_base, m_size);
+    }
+    m_base = nullptr;
+    m_header = nullptr;
+    m_size = 0;
+}
+
+bool DepthServiceClient::submit(uint32_t slot, uint64_t frame_id)
+{
+    ServiceSlot *s = service_slot(m_header, m_channel, slot);
+    if (s->state.load(std::memory_order_relaxed) != SLOT_FREE) {
+        return false;
+    }
+    s->frame_id = frame_id;
+    s->submit_ns = service_clock_ns();
+    s->state.store(SLOT_QUEUED, std::memory_order_release);
+    m_header->doorbell.fetch_add(1, std::memory_order_release);
+    futex_wake(&m_header->doorbell);
+    return true;
+}
+
+DepthServiceClient::Result DepthServiceClient::wait(uint32_t slot, int timeout_ms)
+{
+    ServiceSlot *s = service_slot(m_header, m_channel, slot);
+    const uint64_t deadline = service_clock_ns() + static_cast<uint64_t>(timeout_ms) * 1000000ull;
+    while (true) {
+        // completed를 먼저 읽어야 확인과 잠들기 사이의 완료를 놓치지 않는다
+        const uint32_t completed = m_channel->completed.load(std::memory_order_acquire);
+        const uint32_t state = s->state.load(std::memory_order_acquire);
+        if (state == SLOT_DONE) {
+            return Result::Done;
+        }
+        if (state == SLOT_FAILED) {
+            return Result::Failed;
+        }
+        if (!m_header->running.load(std::memory_order_acquire)) {
+            return Result::ServiceGone;
+        }
+        const uint64_t now = service_clock_ns();
+        if (now >= deadline) {
+            return Result::Timeout;
+        }
+        const uint64_t left_ms = (deadline - now) / 1000000ull + 1;
+        futex_wait(&m_channel->completed, completed, static_cast<int>(left_ms < 100 ? left_ms : 100));
+    }
+}
+
+void DepthServiceClient::release(uint32_t slot)
+{
+    service_slot(m_header, m_channel, slot)->state.store(SLOT_FREE, std::memory_order_release);
+}
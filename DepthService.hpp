@@ -0,0 +1,130 @@
+#pragma once
+
+// 서비스 프로세스와 클라이언트가 공유하는 레이아웃: HailoRT / GStreamer / OpenCV에 의존하지 않는다
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Shared-memory layout of the depth inference service (/dev/shm/<name>)
+ *
+ * [ServiceHeader][channel 0][channel 1]...; every channel belongs to one client and is
+ * [ServiceChannel][ServiceSlot x slots][input buffers][output buffers]. A client writes
+ * a frame into a slot's input buffer, marks the slot QUEUED and rings header.doorbell;
+ * the service batches queued slots of all clients, writes the depth map into the
+ * slot's output buffer, marks it DONE and bumps channel.completed. Both counters are
+ * futex words, so neither side polls.
+ */
+struct alignas(64) ServiceHeader {
+    std::atomic<uint32_t> magic;     ///< DEPTH_SERVICE_MAGIC once the layout is complete
+    uint32_t version;
+    uint32_t width;                  ///< Model input / depth width
+    uint32_t height;
+    uint64_t input_size;             ///< Bytes of one RGB input frame
+    uint64_t output_size;            ///< Bytes of one int8 depth map
+    uint32_t max_clients;
+    uint32_t slots;                  ///< Slots per client
+    uint64_t channel_stride;         ///< Bytes from one channel to the next
+    float scale;                     ///< Dequantization: depth = scale * (value - zero_point)
+    float zero_point;
+    std::atomic<int32_t> service_pid;
+    std::atomic<uint32_t> running;   ///< 0 once the service shuts down
+    std::atomic<uint32_t> doorbell;  ///< Futex word the service sleeps on; bumped by every submit
+};
+
+enum ServiceChannelState : uint32_t {
+    CHANNEL_FREE = 0,
+    CHANNEL_CLAIMING,                ///< A client is attaching
+    CHANNEL_ACTIVE,
+    CHANNEL_CLOSING,                 ///< Client left (or died); freed once its slots are no longer in flight
+};
+
+enum ServiceSlotState : uint32_t {
+    SLOT_FREE = 0,                   ///< Owned by the client
+    SLOT_QUEUED,                     ///< Input written, waiting for the service
+    SLOT_BUSY,                       ///< Taken by the service
+    SLOT_DONE,                       ///< Output valid
+    SLOT_FAILED,                     ///< Inference failed, output undefined
+};
+
+struct alignas(64) ServiceChannel {
+    std::atomic<uint32_t> state;     ///< ServiceChannelState
+    std::atomic<int32_t> pid;        ///< Client process (checked for liveness by the service)
+    std::atomic<uint32_t> completed; ///< Futex word the client sleeps on; bumped by every completion
+    std::atomic<uint64_t> frames;    ///< Frames completed for this client
+};
+
+struct alignas(64) ServiceSlot {
+    std::atomic<uint32_t> state;     ///< ServiceSlotState
+    uint32_t reserved;
+    uint64_t frame_id;               ///< Client's frame ID, carried through unchanged
+    uint64_t submit_ns;              ///< CLOCK_MONOTONIC at submit
+    uint64_t done_ns;                ///< CLOCK_MONOTONIC when the output was written
+};
+
+constexpr uint32_t DEPTH_SERVICE_MAGIC = 0x53445448;  // "HTDS"
+constexpr uint32_t DEPTH_SERVICE_VERSION = 1;
+
+/// Bytes of one channel for the given slot count and frame sizes (64-byte aligned parts)
+size_t service_channel_stride(uint32_t slots, size_t input_size, size_t output_size);
+ServiceChannel *service_channel(ServiceHeader *header, uint32_t index);
+ServiceSlot *service_slot(ServiceHeader *header, ServiceChannel *channel, uint32_t slot);
+uint8_t *service_input(ServiceHeader *header, ServiceChannel *channel, uint32_t slot);
+uint8_t *service_output(ServiceHeader *header, ServiceChannel *channel, uint32_t slot);
+
+/// Sleeps while *word == expected (at most timeout_ms); works across processes
+void futex_wait(std::atomic<uint32_t> *word, uint32_t expected, int timeout_ms);
+/// Wakes every process sleeping on word
+void futex_wake(std::atomic<uint32_t> *word);
+
+uint64_t service_clock_ns();  ///< CLOCK_MONOTONIC in ns
+
+/**
+ * @brief Client side of the depth inference service (link the depthclient library only)
+ *
+ * connect() maps the service region and claims a free channel, which takes well under
+ * a millisecond because the service already holds the configured network group.
+ * Each slot is used as: write input(slot) → submit(slot) → wait(slot) → read
+ * output(slot) → release(slot). Use one client per thread, or serialize access.
+ */
+class DepthServiceClient {
+public:
+    enum class Result { Done, Failed, Timeout, ServiceGone };
+
+    DepthServiceClient() = default;
+    ~DepthServiceClient();
+
+    DepthServiceClient(const DepthServiceClient &) = delete;
+    DepthServiceClient &operator=(const DepthServiceClient &) = delete;
+
+    /// @return false if the service is not running, its region is smaller than the header says, or every channel is taken
+    bool connect(const std::string &name);
+    /// Gives the channel back (the service frees it once nothing is in flight)
+    void disconnect();
+    bool connected() const { return m_channel != nullptr; }
+
+    uint32_t width() const { return m_header->width; }
+    uint32_t height() const { return m_header->height; }
+    size_t input_size() const { return m_header->input_size; }
+    size_t output_size() const { return m_header->output_size; }
+    uint32_t slots() const { return m_header->slots; }
+    float scale() const { return m_header->scale; }
+    float zero_point() const { return m_header->zero_point; }
+
+    uint8_t *input(uint32_t slot) { return service_input(m_header, m_channel, slot); }
+    const uint8_t *output(uint32_t slot) { return service_output(m_header, m_channel, slot); }
+
+    /// Queues slot (its input must be written) and wakes the service
+    bool submit(uint32_t slot, uint64_t frame_id);
+    /// Waits until the service finished slot
+    Result wait(uint32_t slot, int timeout_ms);
+    /// Makes a finished slot available for the next submit
+    void release(uint32_t slot);
+
+private:
+    ServiceHeader *m_header = nullptr;
+    ServiceChannel *m_channel = nullptr;
+    uint8_t *m_base = nullptr;
+    size_t m_size = 0;
+};
@@ -0,0 +1,220 @@
+#include "FrameBatcher.hpp"
+#include "Timeline.hpp"
+
+#include <iostream>
+
+FrameBatcher::FrameBatcher(InferenceBackend &backend, size_t batch_size,
+                           std::chrono::microseconds deadline, InferCallback callback) :
+    m_backend(backend),
+    m_batch_size(batch_size > 0 ? batch_size : 1),
+    m_deadline(deadline),
+    m_callback(std::move(callback))
+{}
+
+FrameBatcher::~FrameBatcher()
+{
+    stop();
+}
+
+/**
+ * @brief Allocates both batch buffers and starts the worker thread
+ *
+ * @return HAILO_SUCCESS, or HAILO_OUT_OF_HOST_MEMORY if a buffer cannot be allocated
+ */
+hailo_status FrameBatcher::start()
+{
+    if (m_running) {
+        return HAILO_SUCCESS;
+    }
+
+    const size_t input_size = m_backend.input_frame_size();
+    const size_t output_size = m_backend.output_frame_size();
+
+    for (size_t b = 0; b < 2; b++) {
+        Batch &batch = m_batches[b];
+        batch.input = make_aligned_buffer(input_size * m_batch_size);
+        batch.output = make_aligned_buffer(output_size * m_batch_size);
+        if (!batch.input || !batch.output) {
+            std::cerr << "[ERROR] Failed to allocate batch buffers" << std::endl;
+            return HAILO_OUT_OF_HOST_MEMORY;
+        }
+
+        // 잡의 포인터는 배치 버퍼 안의 고정 위치를 가리킨다
+        batch.jobs.resize(m_batch_size);
+        for (size_t i = 0; i < m_batch_size; i++) {
+            batch.jobs[i] = InferJob{b * m_batch_size + i, 0,
+                                     batch.input.get() + i * input_size,
+                                     batch.output.get() + i * output_size,
+                                     input_size, output_size, HAILO_SUCCESS, nullptr, TIMELINE_NO_FRAME};
+        }
+        batch.count = 0;
+        batch.state = State::FILLING;
+    }
+
+    m_fill = 0;
+    m_stop = false;
+    m_running = true;
+    m_worker = std::thread(&FrameBatcher::worker_loop, this);
+    return HAILO_SUCCESS;
+}
+
+/**
+ * @brief Flushes the partially filled batch, waits for it to complete and joins the worker
+ */
+void FrameBatcher::stop()
+{
+    if (!m_running) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+        m_pending = false;
+    }
+    m_cv.notify_all();
+    m_worker.join();
+    m_running = false;
+}
+
+/**
+ * @brief Hands out the next free slot of the batch being filled
+ *
+ * Blocks while both batches are busy (one on the device, one waiting for it).
+ *
+ * @return Job to fill, or nullptr once the batcher is stopping
+ */
+InferJob *FrameBatcher::acquire()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [this] {
+        return m_stop || (!m_pending && m_batches[m_fill].state == State::FILLING);
+    });
+    if (m_stop) {
+        return nullptr;
+    }
+
+    Batch &batch = m_batches[m_fill];
+    InferJob *job = &batch.jobs[batch.count];
+    job->frame_id = m_next_frame_id++;
+    job->trace_id = TIMELINE_NO_FRAME;
+    job->status = HAILO_SUCCESS;
+    job->user_data = nullptr;
+    m_pending = true;
+    return job;
+}
+
+/**
+ * @brief Adds the acquired job to the current batch; a full batch is handed to the worker
+ *
+ * @param[in] job Job returned by the last acquire(), with its input filled
+ * @return HAILO_SUCCESS, or HAILO_INVALID_OPERATION if job is not the pending one
+ */
+hailo_status FrameBatcher::submit(InferJob *job)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Batch &batch = m_batches[m_fill];
+        if (!m_pending || job != &batch.jobs[batch.count]) {
+            std::cerr << "[ERROR] submit() without matching acquire()" << std::endl;
+            return HAILO_INVALID_OPERATION;
+        }
+        m_pending = false;
+
+        if (batch.count == 0) {
+            batch.first_frame = std::chrono::steady_clock::now();
+        }
+        batch.count++;
+        if (batch.count == m_batch_size) {
+            batch.state = State::READY;
+            m_fill ^= 1;
+        }
+    }
+    m_cv.notify_all();
+    return HAILO_SUCCESS;
+}
+
+/**
+ * @brief Sends the partially filled batch right away and waits until both batches are delivered
+ */
+void FrameBatcher::flush()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!m_running) {
+        return;
+    }
+    m_flush = true;
+    m_cv.notify_all();
+    m_cv.wait(lock, [this] {
+        return m_batches[0].count == 0 && m_batches[1].count == 0 &&
+               m_batches[0].state == State::FILLING && m_batches[1].state == State::FILLING;
+    });
+    m_flush = false;
+}
+
+void FrameBatcher::worker_loop()
+{
+    while (true) {
+        Batch *batch = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            while (true) {
+                Batch &other = m_batches[m_fill ^ 1];
+                Batch &filling = m_batches[m_fill];
+                if (other.state == State::READY) {
+                    batch = &other;
+                    break;
+                }
+
+                // 마감 시간 초과 또는 종료 시: 채우던 배치를 부분 배치로 내보낸다
+                const bool expired = filling.count > 0 &&
+                    std::chrono::steady_clock::now() >= filling.first_frame + m_deadline;
+                if ((expired || m_stop || m_flush) && filling.count > 0 && !m_pending &&
+                    other.state == State::FILLING) {
+                    filling.state = State::READY;
+                    m_fill ^= 1;
+                    batch = &filling;
+                    break;
+                }
+
+                if (m_stop && filling.count == 0 && other.state == State::FILLING) {
+                    return;
+                }
+
+                if (filling.count > 0 && !m_pending) {
+                    m_cv.wait_until(lock, filling.first_frame + m_deadline);
+                } else {
+                    m_cv.wait(lock);
+                }
+            }
+            batch->state = State::RUNNING;
+        }
+
+        // ==================== BATCH INFERENCE ====================
+        const size_t count = batch->count;
+        hailo_status status;
+        {
+            TimelineScope span(TimelineSpan::BatchInfer, batch->jobs[0].trace_id);
+            status = m_backend.infer(
+                MemoryView(batch->input.get(), m_backend.input_frame_size() * count),
+                MemoryView(batch->output.get(), m_backend.output_frame_size() * count),
+                count);
+        }
+        if (status != HAILO_SUCCESS) {
+            std::cerr << "[ERROR] Batch inference (" << count << " frames) failed with status: " << status << std::endl;
+        }
+
+        // 프레임별로 원래 순서대로 결과를 돌려준다
+        for (size_t i = 0; i < count; i++) {
+            batch->jobs[i].status = status;
+            m_callback(batch->jobs[i]);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            batch->count = 0;
+            batch->state = State::FILLING;
+        }
+        m_cv.notify_all();
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "InferEngine.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Temporal batcher: groups up to batch_size frames into one backend infer() call
+ *
+ * Two batch buffers alternate, so the producer fills one while the other is on the
+ * device. A batch is flushed when it is full, or early once the oldest frame in it
+ * has waited longer than the deadline. Results are fanned back out to the completion
+ * callback one frame at a time, in submit order, on the batcher's worker thread.
+ */
+class FrameBatcher : public InferQueue {
+public:
+    FrameBatcher(InferenceBackend &backend, size_t batch_size,
+                 std::chrono::microseconds deadline, InferCallback callback);
+    ~FrameBatcher();
+
+    FrameBatcher(const FrameBatcher &) = delete;
+    FrameBatcher &operator=(const FrameBatcher &) = delete;
+
+    hailo_status start();
+    void stop() override;
+
+    InferJob *acquire() override;
+    hailo_status submit(InferJob *job) override;
+    void flush() override;
+
+    size_t capacity() const override { return 2 * m_batch_size; }
+
+private:
+    enum class State { FILLING, READY, RUNNING };
+
+    struct Batch {
+        AlignedBuffer input;   ///< batch_size input frames back to back
+        AlignedBuffer output;  ///< batch_size output frames back to back
+        std::vector<InferJob> jobs;
+        size_t count = 0;
+        State state = State::FILLING;
+        std::chrono::steady_clock::time_point first_frame;
+    };
+
+    void worker_loop();
+
+    InferenceBackend &m_backend;
+    size_t m_batch_size;
+    std::chrono::microseconds m_deadline;
+    InferCallback m_callback;
+
+    Batch m_batches[2];
+    size_t m_fill = 0;        ///< Index of the batch being filled
+    bool m_pending = false;   ///< A job is acquired but not yet submitted
+    uint64_t m_next_frame_id = 0;
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    bool m_running = false;
+    bool m_stop = false;
+    bool m_flush = false;     ///< Send the partial batch now instead of waiting for the deadline
+    std::thread m_worker;
+};
@@ -10,6 +10,7 @@
  **/
 
 #include "Hailoinfer.hpp"
+#include "InferBackend.hpp"
 #include <opencv2/opencv.hpp>
 #include <iostream>
 #include <gst/gst.h>
@@ -19,6 +20,9 @@
 #include <cstdio>
 #include <memory>
 #include <array>
+#include <algorithm>
+#include <cstring>
+#include <unistd.h>
 
 #include "hailo/hailort.hpp"
 #include "hailo/hailort_common.hpp" 
@@ -31,8 +35,12 @@ using namespace hailort;
 /**
  * @brief Loads HEF file and configures network group on VDevice
  *
+ * A HEF holding several network groups needs config.network_group; only that group
+ * is configured. Calling this again on the same VDevice adds another network group
+ * that the HailoRT model scheduler time-slices with the ones already configured.
+ *
  * @param[in] vdevice Hailo VDevice object (bundle of physical devices)
- * @param[in] config Configuration struct containing HEF file path
+ * @param[in] config Configuration struct containing HEF file path, network group and batch size
  * @return On success, returns shared_ptr to ConfiguredNetworkGroup
  *         On failure, returns hailo_status error code
  */
@@ -49,7 +57,7 @@ Expected<std::shared_ptr<ConfiguredNetworkGroup>> configure_network_group(
     auto& hef_values = hef.value();
 
     auto names = hef_values.get_network_groups_names();
-    auto input_infos = hef_values.get_input_vstream_infos();
+    auto input_infos = hef_values.get_input_vstream_infos(config.network_group);
     if (input_infos) {
         for (const auto& info : input_infos.value()) {
             std::cout << "=== Input VStream ===" << std::endl;
@@ -63,13 +71,39 @@ Expected<std::shared_ptr<ConfiguredNetworkGroup>> configure_network_group(
         }
     }
 
+    // 여러 network group이 든 HEF는 model.network_group으로 하나만 골라 configure
+    // (다른 모델과 장치를 나눠 쓸 때 필요 없는 group까지 올리지 않도록)
+    const std::string group_name = config.network_group;
+    if (group_name.empty() && names.size() != 1) {
+        std::cerr << "[ERROR] " << hef_file << " has " << names.size() << " network groups, set network_group to one of:";
+        for (const auto &name : names) {
+            std::cerr << " " << name;
+        }
+        std::cerr << std::endl;
+        return make_unexpected(HAILO_INVALID_ARGUMENT);
+    }
+    if (!group_name.empty() && std::find(names.begin(), names.end(), group_name) == names.end()) {
+        std::cerr << "[ERROR] Network group " << group_name << " not found in " << hef_file << std::endl;
+        return make_unexpected(HAILO_NOT_FOUND);
+    }
+
     //Creates the default configure params for the Hef. 
     auto configure_params = vdevice.create_configure_params(hef.value());
     if (!configure_params) {
         return make_unexpected(configure_params.status());
     }
 
-    auto network_groups = vdevice.configure(hef.value(), configure_params.value());
+    // NPU 배치 크기: infer(..., frames_count) 한 번에 batch_size 프레임을 처리
+    NetworkGroupsParamsMap selected;
+    for (auto &params : configure_params.value()) {
+        if (!group_name.empty() && params.first != group_name) {
+            continue;
+        }
+        params.second.batch_size = static_cast<uint16_t>(std::max(config.batch_size, 1));
+        selected.insert(params);
+    }
+
+    auto network_groups = vdevice.configure(hef.value(), selected);
     if (!network_groups) {
         return make_unexpected(network_groups.status());
     }
@@ -83,204 +117,112 @@ Expected<std::shared_ptr<ConfiguredNetworkGroup>> configure_network_group(
 }
 
 /**
- * @brief Performs depth estimation inference on NPU and converts result to uint8 grayscale
- * 
- * @param[in] pipeline Inference pipeline containing input/output VStreams
- * @param[in] input_img Input image from GStreamer (RGB/BGR format)
- * @param[in] config Configuration containing model dimensions (height, width) and batch size
- * @return Grayscale depth map as uint8 (CV_8U, range 0~255)
- *         Returns empty cv::Mat on failure
+ * @brief Allocates a zero-filled buffer aligned to the system page size
+ *
+ * @param[in] size Buffer size in bytes
+ * @return Owning pointer, or nullptr on allocation failure
  */
-cv::Mat infer(InferVStreams &pipeline, cv::Mat input_img, Config config){
-    // 1. CPU: input_data 생성 (Rasp RAM)
-    // 2. CPU → NPU: PCIe write (데이터 복사)
-    // 3. NPU: 연산 실행
-    // 4. CPU ← NPU: PCIe read (결과 복사)
-    // 5. CPU: output_data에 저장 (Rasp RAM)
-    
-    const size_t frames_count = config.encode_speed;
-    
-    // ==================== INPUT SETUP ====================
-    auto input_vstreams = pipeline.get_input_vstreams();
-    
-    if (input_vstreams.empty()) {
-        std::cerr << "[ERROR] No input vstreams found!" << std::endl;
-        return cv::Mat();
+AlignedBuffer make_aligned_buffer(size_t size)
+{
+    const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    // 페이지 단위로 올림 → DMA 전송 시 페이지 경계에서 잘리지 않도록
+    const size_t alloc_size = ((size + page_size - 1) / page_size) * page_size;
+
+    void *ptr = nullptr;
+    if (posix_memalign(&ptr, page_size, alloc_size) != 0) {
+        return AlignedBuffer();
     }
-    
-    // 스트림 이름을 key로, 필요한 만큼의 버퍼를 value로 map에 저장
-    std::map<std::string, std::vector<uint8_t>> input_data;
-    for (const auto &input_vstream : input_vstreams) {
-        input_data.emplace(
-            input_vstream.get().name(), 
-            std::vector<uint8_t>(input_vstream.get().get_frame_size() * frames_count)
-        );
+    std::memset(ptr, 0, alloc_size);
+    return AlignedBuffer(static_cast<uint8_t*>(ptr));
+}
+
+InferSession::InferSession(InferenceBackend &backend, size_t frames_count) :
+    m_backend(backend),
+    m_frames_count(frames_count)
+{}
+
+/**
+ * @brief Allocates the session's I/O buffers for the backend's frame sizes
+ *
+ * @param[in] backend Inference backend (must outlive the session)
+ * @param[in] config Configuration containing model dimensions and batch size
+ * @return On success, returns the session
+ *         On failure, returns hailo_status error code
+ */
+Expected<std::unique_ptr<InferSession>> InferSession::create(InferenceBackend &backend, const Config &config)
+{
+    const size_t frames_count = 1;  // 세션은 프레임 단위, 배치는 FrameBatcher가 담당
+    std::unique_ptr<InferSession> session(new InferSession(backend, frames_count));
+
+    // ==================== BUFFER SETUP ====================
+    session->m_input_size = backend.input_frame_size() * frames_count;
+    session->m_output_size = backend.output_frame_size() * frames_count;
+    session->m_input_buffer = make_aligned_buffer(session->m_input_size);
+    session->m_output_buffer = make_aligned_buffer(session->m_output_size);
+    if (!session->m_input_buffer || !session->m_output_buffer) {
+        return make_unexpected(HAILO_OUT_OF_HOST_MEMORY);
     }
-    
-    std::string stream_name = input_vstreams[0].get().name();
-    auto input_vstream_info = input_vstreams[0].get().get_info();
-    
-    if(MONITORING){
-        std::cout << "\n========== INPUT INFO ==========" << std::endl;
-        std::cout << "Input shape: " 
-                << input_vstream_info.shape.height << "x"
-                << input_vstream_info.shape.width << "x"
-                << input_vstream_info.shape.features << std::endl;    
-        std::cout << "Input stream name: " << stream_name << std::endl;
-        std::cout << "Expected size: " << input_data[stream_name].size() << std::endl;
-        std::cout << "Normalized size: " << input_img.total() * input_img.channels() << std::endl;
+
+    // 크기 검증: 출력은 model_height x model_width int8 depth map
+    const size_t expected_size = static_cast<size_t>(config.model_height) * config.model_width;
+    if (backend.output_frame_size() != expected_size) {
+        std::cerr << "[ERROR] Output frame size mismatch! Frame: "
+                  << backend.output_frame_size()
+                  << ", Expected: " << expected_size << std::endl;
+        return make_unexpected(HAILO_INVALID_ARGUMENT);
     }
 
-    auto input_info = input_vstreams[0].get().get_info();
-    if(MONITORING){
-        std::cout << "Format type: " << input_info.format.type << std::endl;
-        std::cout << "Format order: " << input_info.format.order << std::endl;
+    if (MONITORING) {
+        std::cout << "\n========== SESSION INFO ==========" << std::endl;
+        std::cout << "Input buffer: " << session->m_input_size << " bytes" << std::endl;
+        std::cout << "Output buffer: " << session->m_output_size << " bytes" << std::endl;
+        std::cout << "Frames per call: " << frames_count << std::endl;
     }
 
+    // ==================== MAT SETUP ====================
+    // 입출력 버퍼 위에 헤더만 씌워 둔다
+    session->m_input_mat = cv::Mat(config.model_height, config.model_width, CV_8UC3,
+                                   session->m_input_buffer.get());
+    session->m_raw_depth = cv::Mat(config.model_height, config.model_width, CV_8SC1,
+                                   session->m_output_buffer.get());
+
+    return std::move(session);
+}
+
+/**
+ * @brief Performs depth estimation inference on NPU
+ *
+ * @param[in] input_img Model-sized input image (CV_8UC3, continuous). Pass input_mat()
+ *                      after resizing into it to avoid the staging copy.
+ * @return Raw int8 depth map (CV_8SC1) over the session's output buffer, overwritten by the next call
+ *         Returns empty cv::Mat on failure
+ */
+cv::Mat InferSession::infer(const cv::Mat &input_img)
+{
     // 크기 검증
-    if (input_data[stream_name].size() != input_img.total() * input_img.channels()) {
+    if (!input_img.isContinuous() || input_img.total() * input_img.elemSize() != m_input_size) {
         std::cerr << "[ERROR] Size mismatch! Cannot copy data safely." << std::endl;
         return cv::Mat();
     }
-    
-    std::memcpy(
-        input_data[stream_name].data(),
-        input_img.data,
-        input_data[stream_name].size()
-    );
-    
-    // 메모리에 있는 값을 바로 헤일로의 NPU 캐시로 보내라
-    std::map<std::string, MemoryView> input_data_mem_views;
-    for (const auto &input_vstream : input_vstreams) {
-        auto &input_buffer = input_data[input_vstream.get().name()];
-        input_data_mem_views.emplace(input_vstream.get().name(), 
-                                      MemoryView(input_buffer.data(), input_buffer.size()));
-    }
-    
-    // ==================== OUTPUT SETUP ====================
-    auto output_vstreams = pipeline.get_output_vstreams();
-    
-    if (output_vstreams.empty()) {
-        std::cerr << "[ERROR] No output vstreams found!" << std::endl;
-        return cv::Mat();
-    }
-    
-    std::map<std::string, std::vector<uint8_t>> output_data;
-    for (const auto &output_vstream : output_vstreams) {
-        output_data.emplace(output_vstream.get().name(), 
-                           std::vector<uint8_t>(output_vstream.get().get_frame_size() * frames_count));
-    }
-    
-    std::map<std::string, MemoryView> output_data_mem_views;
-    for (const auto &output_vstream : output_vstreams) {
-        auto &output_buffer = output_data[output_vstream.get().name()];
-        output_data_mem_views.emplace(output_vstream.get().name(), 
-                                      MemoryView(output_buffer.data(), output_buffer.size()));
+
+    // input_mat()에 이미 써 넣은 프레임이면 복사 없이 그대로 NPU로 보낸다
+    m_bytes_copied = 0;
+    if (input_img.data != m_input_buffer.get()) {
+        std::memcpy(m_input_buffer.get(), input_img.data, m_input_size);
+        m_bytes_copied = m_input_size;
     }
-    
+
     // ==================== INFERENCE ====================
-    std::cout << "\n[INFERENCE] Starting..." << std::endl;
-    hailo_status status = pipeline.infer(input_data_mem_views, output_data_mem_views, frames_count);
-    
+    hailo_status status = m_backend.infer(MemoryView(m_input_buffer.get(), m_input_size),
+                                          MemoryView(m_output_buffer.get(), m_output_size),
+                                          m_frames_count);
     if (status != HAILO_SUCCESS) {
         std::cerr << "[ERROR] Inference failed with status: " << status << std::endl;
         return cv::Mat();
     }
-    std::cout << "[INFERENCE] Completed successfully" << std::endl;
-
-    // ==================== OUTPUT PROCESSING ====================
-    std::string out_name = output_vstreams[0].get().name();
-    auto& result_buffer = output_data[out_name];
-
-    if (result_buffer.empty()) {
-        std::cerr << "[ERROR] Output buffer is empty!" << std::endl;
-        return cv::Mat();
-    }
-
-    if(MONITORING){
-    std::cout << "\n========== OUTPUT INFO ==========" << std::endl;
-        std::cout << "Output stream: " << out_name << std::endl;
-        std::cout << "Buffer size: " << result_buffer.size() << " bytes" << std::endl;
-        std::cout << "Frame size: " << output_vstreams[0].get().get_frame_size() << " bytes" << std::endl;
-        std::cout << "Expected size: " << config.model_height * config.model_width << " bytes" << std::endl;
-    }
-
-    // ==================== DEBUG CHECKS ====================
-    if(MONITORING){
-        std::cout << "\n========== DEBUG CHECKS ==========" << std::endl;
-        
-        // 1. 버퍼 포인터 유효성
-        std::cout << "[1] Buffer pointer: " << (void*)result_buffer.data() << std::endl;
-        std::cout << "[1] Pointer valid: " << std::boolalpha 
-                << (result_buffer.data() != nullptr) << std::endl;
-        
-        // 2. 첫 10바이트 값 확인
-        std::cout << "[2] First 10 bytes (int8): ";
-        for(int i = 0; i < std::min(10, (int)result_buffer.size()); i++) {
-            std::cout << (int)(int8_t)result_buffer[i] << " ";
-        }
-        std::cout << std::endl;
-        
-        // 3. 크기 검증
-        size_t expected_size = config.model_height * config.model_width;
-        std::cout << "[3] Size check - Buffer: " << result_buffer.size() 
-                << ", Expected: " << expected_size << std::endl;
-        
-        if (result_buffer.size() != expected_size) {
-            std::cerr << "[ERROR] Output buffer size mismatch!" << std::endl;
-            return cv::Mat();
-        }
-    }
-    // ==================== MAT CONVERSION ====================
-    if(MONITORING){ std::cout << "\n========== MAT CONVERSION ==========" << std::endl; }
-
-    try {
-        // Step 1: cv::Mat 생성 (int8 타입)
-        if(MONITORING){
-            std::cout << "[Step 1] Creating depth_map (CV_8SC1)..." << std::endl;
-        }
-        cv::Mat depth_map(config.model_height, config.model_width, CV_8SC1, result_buffer.data());
-        
-        if (depth_map.empty()) {
-            std::cerr << "[ERROR] depth_map is empty!" << std::endl;
-            return cv::Mat();
-        }
-        if(MONITORING){
-            std::cout << "  - Size: " << depth_map.size() << std::endl;
-            std::cout << "  - Type: " << depth_map.type() << std::endl;
-        }
-
-        // Step 2: 메모리를 미리 할당하고 변환
-        if(MONITORING){std::cout << "[Step 2] Pre-allocating result memory..." << std::endl;}
-        cv::Mat result(config.model_height, config.model_width, CV_8U);
-        
-        if(MONITORING){std::cout << "[Step 3] Converting to uint8 with copyTo..." << std::endl;}
-        depth_map.convertTo(result, CV_8U, 1.0, 128); // saturate_cast<CV_8U>(1.0 * depth_map(x,y) + 128)
-
-        if (result.empty()) {
-            std::cerr << "[ERROR] result is empty!" << std::endl;
-            return cv::Mat();
-        }
-        if(MONITORING){
-            std::cout << "  - Conversion successful" << std::endl;
-            std::cout << "  - Size: " << result.size() << std::endl;
-            std::cout << "  - Type: " << result.type() << std::endl;
-            std::cout << "========== CONVERSION COMPLETE ==========" << std::endl;
-        }
-
-        return result;
-        
-    } catch (const cv::Exception& e) {
-        std::cerr << "\n[EXCEPTION] OpenCV error: " << e.what() << std::endl;
-        return cv::Mat();
-    } catch (const std::exception& e) {
-        std::cerr << "\n[EXCEPTION] Standard error: " << e.what() << std::endl;
-        return cv::Mat();
-    } catch (...) {
-        std::cerr << "\n[EXCEPTION] Unknown error occurred" << std::endl;
-        return cv::Mat();
-    }
 
+    // int8 그대로 반환: uint8 변환/정규화/컬러맵은 DepthColorizer 한 번에 처리
+    return m_raw_depth;
 }
 
 
@@ -3,8 +3,68 @@
 #include "hailo/hailort.hpp"
 #include <opencv2/opencv.hpp>
 
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
 using namespace hailort;
 
+/**
+ * @brief One branch of the output pipeline (outputs list in config.yaml)
+ */
+struct OutputSink {
+    std::string type;            ///< "display", "file" (x264/mp4), "shm" (shmsink) or "fake" (fakesink)
+    std::string location;        ///< file: path (empty = output_name), shm: socket path
+    int width = 0;               ///< Branch width in pixels (0 = video.output size)
+    int height = 0;              ///< Branch height in pixels (0 = video.output size)
+    int fps = 0;                 ///< Branch frame rate, frames are only dropped (0 = every frame)
+};
+
+/**
+ * @brief One camera of a multi-source rig (sources list in config.yaml)
+ */
+struct VideoSource {
+    std::string name;            ///< Label for logs and per-source output names
+    std::string type;            ///< "v4l2" (camera), "test" (videotestsrc) or "file" (recording)
+    std::string location;        ///< v4l2: device, test: videotestsrc pattern, file: path
+    int width = 0;               ///< Capture width in pixels (0 = video.input size)
+    int height = 0;              ///< Capture height in pixels (0 = video.input size)
+    int fps = 0;                 ///< test: frame rate (0 = video.framerate), file: pacing (0 = unthrottled)
+    int weight = 1;              ///< Share of NPU slots under weighted scheduling
+    std::string drop_policy;     ///< Full queue behaviour (empty = pipeline.drop_policy)
+    int queue_depth = 0;         ///< Frames waiting for the NPU (0 = pipeline.queue_depth)
+    bool has_outputs = false;    ///< outputs given for this source (otherwise the top-level list, renamed per source)
+    std::vector<OutputSink> outputs;
+};
+
+/**
+ * @brief A second network sharing the device with the depth model (models list in config.yaml)
+ */
+struct ModelSpec {
+    std::string name;            ///< Label for logs and stats
+    std::string hef_path;        ///< HEF file (hailo backend)
+    std::string network_group;   ///< Network group to configure from a multi-group HEF (empty = the only one)
+    int width = 0;               ///< Model input width in pixels (RGB, camera frames are resized to it)
+    int height = 0;              ///< Model input height in pixels
+    int priority = 16;           ///< Device scheduler priority, 0..31 (higher wins when both have frames ready)
+    int batch_size = 1;          ///< Frames per infer() call, also the scheduler threshold
+    double fps = 0.0;            ///< Camera frames per second handed to the model (0 = every frame)
+    double timeout_ms = -1.0;    ///< Scheduler timeout for a partial batch (<0 = inference.batch_timeout_ms)
+    double cpu_latency_ms = -1.0; ///< CPU stand-in: simulated latency (<0 = inference.cpu.latency_ms)
+    std::string ring;            ///< Shared-memory ring the raw outputs are published to (empty = off)
+};
+
+/**
+ * @brief One resolution of the depth model in the preloaded ladder (model.ladder in config.yaml)
+ */
+struct ModelRung {
+    std::string hef_path;        ///< HEF compiled for this input size (hailo backend)
+    int width = 0;               ///< Model input width in pixels; the depth output has the same size
+    int height = 0;              ///< Model input height in pixels
+    double cpu_latency_ms = -1.0; ///< CPU stand-in: simulated latency (<0 = inference.cpu.latency_ms scaled by area)
+};
+
 /**
  * @brief Configuration structure for depth estimation pipeline
  * 
@@ -13,6 +73,8 @@ using namespace hailort;
 struct Config {
     std::string device;          ///< Hailo device ID (e.g., "0")
     std::string hef_path;        ///< Path to HEF model file
+    std::string network_group;   ///< Network group of a multi-group HEF (empty = the HEF must have exactly one)
+    int model_priority;          ///< Device scheduler priority of the depth model when models share the device
     
     int model_width;             ///< Model input width in pixels (e.g., 256)
     int model_height;            ///< Model input height in pixels (e.g., 256)
@@ -24,15 +86,118 @@ struct Config {
     int video_outHeight;         ///< Display output height in pixels
     
     std::string output_name;     ///< Output VStream name
+    std::vector<OutputSink> outputs; ///< Output branches behind the appsrc tee (empty = publish nowhere)
+    std::vector<VideoSource> sources; ///< Cameras sharing one inference engine (empty = device / replay only)
+    std::vector<ModelSpec> models;   ///< Extra networks time-sliced with the depth model on one device
+    std::vector<ModelRung> ladder;   ///< Depth model resolutions preloaded for QoS switching (empty = hef_path only)
     
     int frame_rate;              ///< Target frame rate (FPS)
-    int encode_speed;            ///< Batch size (number of frames processed simultaneously)
+    std::string preprocess;      ///< Camera → model resize: "antialias", "area" or "blur_resize" (legacy)
+    int encode_speed;            ///< x264enc speed-preset
     int tune;                    ///< Encoding tuning parameter
     
-    std::string timing_log;      ///< Path to performance measurement log file
+    int frames_in_flight;        ///< Frames queued on the NPU at once (1 = synchronous inference)
+    int batch_size;              ///< Frames per NPU infer() call (1 = no temporal batching)
+    double batch_timeout_ms;     ///< Flush a partial batch once its oldest frame waited this long
+    std::string backend;         ///< Inference backend: "hailo" (NPU), "cpu" (simulated) or "service" (depth_service)
+    double cpu_latency_ms;       ///< CPU backend: mean simulated inference latency
+    double cpu_jitter_ms;        ///< CPU backend: standard deviation of the simulated latency
+    std::string cpu_latency_log; ///< CPU backend: timing log whose Infer(ms) column is replayed (empty = off)
+    double cpu_switch_ms;        ///< CPU backend: simulated cost of switching the device to another model
+    std::string service_name;    ///< Inference service region, e.g. "/hailodepth_service"
+    std::string service_backend; ///< Backend the depth_service daemon runs: "hailo" or "cpu"
+    int service_clients;         ///< depth_service: clients attached at once
+    int service_slots;           ///< depth_service: frames each client can have queued
+    
+    bool staged;                 ///< Run each pipeline stage on its own thread (StagedPipeline)
+    int stage_queue_depth;       ///< Capacity of each queue between stages
+    std::string drop_policy;     ///< Full queue behaviour: "block", "drop" or "latest"
+    std::string scheduling;      ///< NPU sharing between sources: "round_robin" or "weighted"
+    double stats_interval_s;     ///< Period of the per-stage counter report (0 = only at exit)
+    bool element;                ///< Run everything in one pipeline through the hailodepth element
+    
+    std::string replay_file;     ///< Recorded video / raw RGB dump fed instead of the camera (empty = camera)
+    double replay_rate;          ///< Replay fps (0 = unthrottled with backpressure, no drops)
+    bool replay_display;         ///< Keep the display window while replaying (false = fakesink)
+    bool write_video;            ///< Encode the side-by-side output to output_name (false = fakesink only)
+    std::string depth_raw;       ///< Raw int8 depth frames appended per frame (empty = off)
+    std::string depth_ring;      ///< Shared-memory depth ring name, e.g. "/hailodepth" (empty = off)
+    int depth_ring_slots;        ///< Slots in the depth ring (frames a reader can lag before being overwritten)
+    
+    double qos_interval_s;       ///< Period the ladder controller evaluates the load over
+    double qos_max_drop_rate;    ///< Dropped share of camera frames above which the controller steps down
+    double qos_high_load;        ///< Stage p90 / frame period above which the controller steps down
+    double qos_low_load;         ///< Stage p90 / frame period below which the controller may step up
+    int qos_up_after;            ///< Consecutive calm intervals needed before stepping up
+    double qos_hold_s;           ///< Minimum time between two switches
+    std::string qos_log;         ///< CSV of every switch (empty = console only)
+    
+    double output_latency_ms;    ///< Latency the output pipeline renders capture-stamped frames with
+    double latency_report_s;     ///< Period of the capture→X percentile report (0 = only at exit)
+    
+    bool metrics_enabled;        ///< Serve Prometheus metrics over HTTP
+    std::string metrics_bind;    ///< Metrics listen address ("127.0.0.1" = local only)
+    int metrics_port;            ///< Metrics listen port
+    
+    std::string timing_log;      ///< Binary per-frame timing trace (convert with trace_convert)
+    std::string timeline_log;    ///< Chrome trace-event JSON of per-thread stage spans (empty = off)
+};
+
+
+/**
+ * @brief Deleter for page-aligned buffers allocated with posix_memalign
+ */
+struct AlignedFree {
+    void operator()(uint8_t *ptr) const { std::free(ptr); }
 };
+using AlignedBuffer = std::unique_ptr<uint8_t, AlignedFree>;
+
+AlignedBuffer make_aligned_buffer(size_t size);
+
+class InferenceBackend;
+
+/**
+ * @brief Persistent inference session bound to one InferenceBackend
+ *
+ * Created once next to the backend. Owns page-aligned I/O buffers sized for the
+ * batch and Mat headers over them. After create(), infer() does
+ * no heap allocation and no map lookups on the host side.
+ */
+class InferSession {
+public:
+    /// Allocates every per-frame buffer for the backend's frame sizes
+    static Expected<std::unique_ptr<InferSession>> create(InferenceBackend &backend, const Config &config);
+
+    InferSession(const InferSession &) = delete;
+    InferSession &operator=(const InferSession &) = delete;
+
+    /// Runs one frame; the returned Mat aliases session memory until the next call
+    cv::Mat infer(const cv::Mat &input_img);
+
+    /// Header over the session's page-aligned input buffer. Resize straight into it
+    /// and infer() skips the staging copy.
+    cv::Mat input_mat() const { return m_input_mat; }
+    /// Host bytes memcpy'd by the last infer() (0 when the frame was already in input_mat())
+    size_t bytes_copied() const { return m_bytes_copied; }
 
+    size_t input_frame_size() const { return m_input_size; }   ///< Bytes of the input buffer (all frames)
+    size_t output_frame_size() const { return m_output_size; } ///< Bytes of the output buffer (all frames)
+
+private:
+    InferSession(InferenceBackend &backend, size_t frames_count);
+
+    InferenceBackend &m_backend;
+    size_t m_frames_count;
+    size_t m_input_size = 0;
+    size_t m_output_size = 0;
+    size_t m_bytes_copied = 0;
+
+    AlignedBuffer m_input_buffer;
+    AlignedBuffer m_output_buffer;
+
+    cv::Mat m_input_mat; ///< CV_8UC3 header over the input buffer
+    cv::Mat m_raw_depth; ///< CV_8SC1 header over the output buffer
+};
 
 Expected<std::shared_ptr<ConfiguredNetworkGroup>> configure_network_group(VDevice &vdevice, Config config);
-cv::Mat infer(InferVStreams &pipeline, cv::Mat input_img,Config config);
 
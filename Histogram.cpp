@@ -0,0 +1,164 @@
+#include "Histogram.hpp"
+#include "gstreaming.hpp"
+
+#include <algorithm>
+#include <iomanip>
+
+LatencyHistogram::LatencyHistogram() :
+    m_last_counts(BUCKET_COUNT, 0)
+{
+    for (auto &count : m_counts) {
+        count.store(0, std::memory_order_relaxed);
+    }
+}
+
+size_t LatencyHistogram::bucket_of(uint64_t value_us)
+{
+    if (value_us < SUB_BUCKETS) {
+        return static_cast<size_t>(value_us);
+    }
+    value_us = std::min<uint64_t>(value_us, (uint64_t(1) << MAX_VALUE_BITS) - 1);
+    // 최상위 비트 아래 6비트를 선형 인덱스로: 2^k 구간마다 64칸
+    int msb = 63;
+    while (!(value_us >> msb)) {
+        msb--;
+    }
+    const int shift = msb - (SUB_BUCKET_BITS - 1);
+    return static_cast<size_t>(shift) * HALF_SUB_BUCKETS + static_cast<size_t>(value_us >> shift);
+}
+
+uint64_t LatencyHistogram::bucket_value(size_t bucket)
+{
+    if (bucket < SUB_BUCKETS) {
+        return bucket;
+    }
+    const int shift = static_cast<int>(bucket / HALF_SUB_BUCKETS) - 1;
+    const uint64_t top = bucket % HALF_SUB_BUCKETS + HALF_SUB_BUCKETS;
+    const uint64_t lower = top << shift;
+    return lower + ((uint64_t(1) << shift) >> 1);
+}
+
+void LatencyHistogram::record(uint64_t value_us)
+{
+    m_counts[bucket_of(value_us)].fetch_add(1, std::memory_order_relaxed);
+    m_sum_us.fetch_add(value_us, std::memory_order_relaxed);
+
+    // 최대값은 CAS 루프 (대부분 첫 비교에서 끝난다)
+    uint64_t max = m_max_us.load(std::memory_order_relaxed);
+    while (value_us > max && !m_max_us.compare_exchange_weak(max, value_us, std::memory_order_relaxed)) {
+    }
+    max = m_interval_max_us.load(std::memory_order_relaxed);
+    while (value_us > max && !m_interval_max_us.compare_exchange_weak(max, value_us, std::memory_order_relaxed)) {
+    }
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::summarize(const std::vector<uint64_t> &counts, uint64_t sum_us,
+                                                       uint64_t max_us) const
+{
+    Snapshot snapshot = {};
+    for (uint64_t count : counts) {
+        snapshot.count += count;
+    }
+    snapshot.max_us = max_us;
+    if (snapshot.count == 0) {
+        return snapshot;
+    }
+    snapshot.mean_us = static_cast<double>(sum_us) / snapshot.count;
+
+    // 누적 개수가 각 백분위 순위를 넘는 버킷
+    const double quantiles[4] = {0.50, 0.90, 0.99, 0.999};
+    uint64_t *results[4] = {&snapshot.p50_us, &snapshot.p90_us, &snapshot.p99_us, &snapshot.p999_us};
+    int next = 0;
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < counts.size() && next < 4; bucket++) {
+        seen += counts[bucket];
+        while (next < 4 && seen >= static_cast<uint64_t>(quantiles[next] * snapshot.count + 0.999999)) {
+            *results[next] = std::min(bucket_value(bucket), max_us);
+            next++;
+        }
+    }
+    return snapshot;
+}
+
+std::vector<uint64_t> LatencyHistogram::counts() const
+{
+    std::vector<uint64_t> counts(BUCKET_COUNT);
+    for (size_t i = 0; i < BUCKET_COUNT; i++) {
+        counts[i] = m_counts[i].load(std::memory_order_relaxed);
+    }
+    return counts;
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::snapshot() const
+{
+    return summarize(counts(), m_sum_us.load(std::memory_order_relaxed), m_max_us.load(std::memory_order_relaxed));
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::interval()
+{
+    std::vector<uint64_t> counts(BUCKET_COUNT);
+    for (size_t i = 0; i < BUCKET_COUNT; i++) {
+        const uint64_t total = m_counts[i].load(std::memory_order_relaxed);
+        counts[i] = total - m_last_counts[i];
+        m_last_counts[i] = total;
+    }
+    const uint64_t sum = m_sum_us.load(std::memory_order_relaxed);
+    const uint64_t interval_sum = sum - m_last_sum_us;
+    m_last_sum_us = sum;
+    return summarize(counts, interval_sum, m_interval_max_us.exchange(0, std::memory_order_relaxed));
+}
+
+// ==================== StageHistograms ====================
+
+static uint64_t elapsed_us(std::chrono::high_resolution_clock::time_point begin,
+                           std::chrono::high_resolution_clock::time_point end)
+{
+    const auto us = std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count();
+    return us > 0 ? static_cast<uint64_t>(us) : 0;
+}
+
+void StageHistograms::record(const FrameTiming &timing)
+{
+    m_stages[PREPROCESS].record(elapsed_us(timing.t_preprocess_start, timing.t_preprocess_end));
+    m_stages[INFER].record(elapsed_us(timing.t_infer_start, timing.t_infer_end));
+    m_stages[POSTPROCESS].record(elapsed_us(timing.t_postprocess_start, timing.t_postprocess_end));
+    m_stages[PUSH].record(elapsed_us(timing.t_postprocess_end, timing.t_end));
+    m_stages[TOTAL].record(elapsed_us(timing.t_start, timing.t_end));
+}
+
+void StageHistograms::report(std::ostream &out, bool cumulative)
+{
+    const std::ios::fmtflags flags = out.flags();
+    const std::streamsize precision = out.precision();
+    out << "📈 stage        frames   mean     p50     p90     p99   p99.9     max  (ms"
+        << (cumulative ? ", since start)" : ", last interval)") << std::endl;
+    out << std::fixed << std::setprecision(2);
+    for (int s = 0; s < STAGE_COUNT; s++) {
+        const LatencyHistogram::Snapshot snap = cumulative ? m_stages[s].snapshot() : m_stages[s].interval();
+        if (snap.count == 0) {
+            continue;
+        }
+        out << "   " << std::left << std::setw(12) << stage_name(static_cast<Stage>(s)) << std::right
+            << std::setw(7) << snap.count
+            << std::setw(7) << snap.mean_us / 1000.0
+            << std::setw(8) << snap.p50_us / 1000.0
+            << std::setw(8) << snap.p90_us / 1000.0
+            << std::setw(8) << snap.p99_us / 1000.0
+            << std::setw(8) << snap.p999_us / 1000.0
+            << std::setw(8) << snap.max_us / 1000.0 << std::endl;
+    }
+    out.flags(flags);
+    out.precision(precision);
+}
+
+const char *StageHistograms::stage_name(Stage stage)
+{
+    switch (stage) {
+    case PREPROCESS: return "preprocess";
+    case INFER: return "infer";
+    case POSTPROCESS: return "postprocess";
+    case PUSH: return "push";
+    case TOTAL: return "total";
+    default: return "?";
+    }
+}
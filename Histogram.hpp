@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+struct FrameTiming;
+
+/**
+ * @brief Lock-free log-linear (HDR-style) histogram of microsecond durations
+ *
+ * Values below 128 µs get exact buckets; above that every power of two is split into
+ * 64 buckets, so any reported percentile is within 1.6% of the true value, from 1 µs
+ * up to ~71 minutes. record() is a couple of relaxed atomic increments and can be
+ * called from any number of threads; snapshots read the buckets without stopping them.
+ */
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BUCKET_BITS = 7;
+    static constexpr uint64_t SUB_BUCKETS = 1u << SUB_BUCKET_BITS;      ///< 128
+    static constexpr uint64_t HALF_SUB_BUCKETS = SUB_BUCKETS / 2;       ///< 64
+    static constexpr int MAX_VALUE_BITS = 32;                           ///< Larger values are clamped
+    static constexpr size_t BUCKET_COUNT = (MAX_VALUE_BITS - SUB_BUCKET_BITS + 2) * HALF_SUB_BUCKETS;
+
+    struct Snapshot {
+        uint64_t count;
+        double mean_us;
+        uint64_t p50_us;
+        uint64_t p90_us;
+        uint64_t p99_us;
+        uint64_t p999_us;
+        uint64_t max_us;
+    };
+
+    LatencyHistogram();
+
+    void record(uint64_t value_us);
+
+    /// Everything recorded since construction
+    Snapshot snapshot() const;
+
+    /**
+     * @brief Only what was recorded since the previous interval() call
+     *
+     * Must be called from one reporting thread.
+     */
+    Snapshot interval();
+
+    /// Raw bucket counts since construction (index with bucket_of())
+    std::vector<uint64_t> counts() const;
+    uint64_t sum_us() const { return m_sum_us.load(std::memory_order_relaxed); }
+
+    static size_t bucket_of(uint64_t value_us);
+    /// Representative value of a bucket (midpoint of its range)
+    static uint64_t bucket_value(size_t bucket);
+
+private:
+    Snapshot summarize(const std::vector<uint64_t> &counts, uint64_t sum_us, uint64_t max_us) const;
+
+    std::atomic<uint64_t> m_counts[BUCKET_COUNT];
+    std::atomic<uint64_t> m_sum_us{0};
+    std::atomic<uint64_t> m_max_us{0};
+    std::atomic<uint64_t> m_interval_max_us{0};
+
+    // interval() 기준점 (보고 스레드 전용)
+    std::vector<uint64_t> m_last_counts;
+    uint64_t m_last_sum_us = 0;
+};
+
+/**
+ * @brief One histogram per pipeline stage, fed from FrameTiming
+ */
+class StageHistograms {
+public:
+    enum Stage { PREPROCESS, INFER, POSTPROCESS, PUSH, TOTAL, STAGE_COUNT };
+
+    /// Records every stage of a finished frame (lock-free, any thread)
+    void record(const FrameTiming &timing);
+
+    LatencyHistogram &stage(Stage stage) { return m_stages[stage]; }
+    const LatencyHistogram &stage(Stage stage) const { return m_stages[stage]; }
+
+    /**
+     * @brief Prints p50 / p90 / p99 / p99.9 / max per stage
+     *
+     * @param[in] cumulative true: since start, false: since the previous interval report
+     */
+    void report(std::ostream &out, bool cumulative);
+
+    static const char *stage_name(Stage stage);
+
+private:
+    LatencyHistogram m_stages[STAGE_COUNT];
+};
@@ -0,0 +1,834 @@
+#include "InferBackend.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+constexpr hailo_format_type_t FORMAT_TYPE = HAILO_FORMAT_TYPE_AUTO;
+
+/**
+ * @brief Creates the backend selected by Config::backend
+ *
+ * @param[in] config Configuration; backend is "hailo" (default), "cpu" or "service"
+ * @return On success, returns the backend
+ *         On failure, returns hailo_status error code
+ */
+Expected<std::unique_ptr<InferenceBackend>> create_backend(const Config &config)
+{
+    if (config.backend == "cpu") {
+        auto backend = CpuBackend::create(config);
+        if (!backend) {
+            return make_unexpected(backend.status());
+        }
+        return std::unique_ptr<InferenceBackend>(backend.release());
+    }
+
+    if (config.backend == "service") {
+        auto backend = ServiceBackend::create(config);
+        if (!backend) {
+            return make_unexpected(backend.status());
+        }
+        return std::unique_ptr<InferenceBackend>(backend.release());
+    }
+
+    if (config.backend.empty() || config.backend == "hailo") {
+        auto backend = HailoBackend::create(config);
+        if (!backend) {
+            return make_unexpected(backend.status());
+        }
+        return std::unique_ptr<InferenceBackend>(backend.release());
+    }
+
+    std::cerr << "[ERROR] Unknown inference backend: " << config.backend << std::endl;
+    return make_unexpected(HAILO_INVALID_ARGUMENT);
+}
+
+// ==================== HailoBackend ====================
+
+/**
+ * @brief Creates the VDevice, configures the HEF and builds the InferVStreams pipeline
+ *
+ * @param[in] config Configuration containing HEF path and batch size
+ * @param[in] vdevice Device shared with other network groups (nullptr = open one for this backend)
+ * @return On success, returns the backend
+ *         On failure, returns hailo_status error code
+ */
+Expected<std::unique_ptr<HailoBackend>> HailoBackend::create(const Config &config, std::shared_ptr<VDevice> vdevice)
+{
+    std::unique_ptr<HailoBackend> backend(new HailoBackend());
+
+    if (!vdevice) {
+        auto created = VDevice::create();
+        if (!created) {
+            std::cerr << "Failed to create vdevice, status = " << created.status() << std::endl;
+            return make_unexpected(created.status());
+        }
+        vdevice = std::shared_ptr<VDevice>(created.release());
+    }
+    backend->m_vdevice = std::move(vdevice);
+
+    auto network_group = configure_network_group(*backend->m_vdevice, config);
+    if (!network_group) {
+        std::cerr << "Failed to configure network group " << config.hef_path << std::endl;
+        return make_unexpected(network_group.status());
+    }
+    backend->m_network_group = network_group.release();
+
+    auto input_params = backend->m_network_group->make_input_vstream_params({}, FORMAT_TYPE, HAILO_DEFAULT_VSTREAM_TIMEOUT_MS, HAILO_DEFAULT_VSTREAM_QUEUE_SIZE);
+    if (!input_params) {
+        std::cerr << "Failed make_input_vstream_params " << input_params.status() << std::endl;
+        return make_unexpected(input_params.status());
+    }
+
+    auto output_params = backend->m_network_group->make_output_vstream_params({}, FORMAT_TYPE, HAILO_DEFAULT_VSTREAM_TIMEOUT_MS, HAILO_DEFAULT_VSTREAM_QUEUE_SIZE);
+    if (!output_params) {
+        std::cerr << "Failed make_output_vstream_params " << output_params.status() << std::endl;
+        return make_unexpected(output_params.status());
+    }
+
+    auto pipeline = InferVStreams::create(*backend->m_network_group, input_params.value(), output_params.value());
+    if (!pipeline) {
+        std::cerr << "Failed to create inference pipeline " << pipeline.status() << std::endl;
+        return make_unexpected(pipeline.status());
+    }
+    backend->m_pipeline.reset(new InferVStreams(pipeline.release()));
+
+    // ==================== VSTREAM VIEWS ====================
+    // 첫 번째 입출력은 호출마다 MemoryView만 바꿔 끼우고, 나머지는 scratch 버퍼에 고정
+    backend->m_max_frames = std::max(config.batch_size, 1);
+
+    auto input_vstreams = backend->m_pipeline->get_input_vstreams();
+    auto output_vstreams = backend->m_pipeline->get_output_vstreams();
+    if (input_vstreams.empty() || output_vstreams.empty()) {
+        std::cerr << "[ERROR] No input/output vstreams found!" << std::endl;
+        return make_unexpected(HAILO_INVALID_OPERATION);
+    }
+    backend->m_input = &input_vstreams[0].get();
+    backend->m_output = &output_vstreams[0].get();
+
+    for (size_t i = 0; i < input_vstreams.size(); i++) {
+        MemoryView view;
+        if (i > 0) {
+            const size_t size = input_vstreams[i].get().get_frame_size() * backend->m_max_frames;
+            backend->m_scratch.push_back(make_aligned_buffer(size));
+            view = MemoryView(backend->m_scratch.back().get(), size);
+        }
+        backend->m_input_views.emplace(input_vstreams[i].get().name(), view);
+    }
+    for (size_t i = 0; i < output_vstreams.size(); i++) {
+        MemoryView view;
+        if (i > 0) {
+            const size_t size = output_vstreams[i].get().get_frame_size() * backend->m_max_frames;
+            backend->m_scratch.push_back(make_aligned_buffer(size));
+            view = MemoryView(backend->m_scratch.back().get(), size);
+        }
+        backend->m_output_views.emplace(output_vstreams[i].get().name(), view);
+    }
+    backend->m_primary_input = backend->m_input_views.find(backend->m_input->name());
+    backend->m_primary_output = backend->m_output_views.find(backend->m_output->name());
+
+    return std::move(backend);
+}
+
+size_t HailoBackend::input_frame_size() const
+{
+    return m_input->get_frame_size();
+}
+
+size_t HailoBackend::output_frame_size() const
+{
+    return m_output->get_frame_size();
+}
+
+/**
+ * @brief Runs a blocking InferVStreams::infer() over frames laid out back to back
+ *
+ * @param[in] input frames_count input frames
+ * @param[out] output Room for frames_count output frames
+ * @param[in] frames_count Number of frames in the call
+ * @return HAILO_SUCCESS, or the inference error status
+ */
+hailo_status HailoBackend::infer(const MemoryView &input, MemoryView output, size_t frames_count)
+{
+    if (frames_count > m_max_frames && m_scratch.size() > 0) {
+        std::cerr << "[ERROR] frames_count exceeds scratch capacity" << std::endl;
+        return HAILO_INVALID_ARGUMENT;
+    }
+
+    m_primary_input->second = input;
+    m_primary_output->second = output;
+    return m_pipeline->infer(m_input_views, m_output_views, frames_count);
+}
+
+/**
+ * @brief Writes one frame to the input vstream (CPU → NPU, PCIe write)
+ *
+ * @param[in] frame Buffer holding exactly one input frame
+ * @return HAILO_SUCCESS, or the vstream error status
+ */
+hailo_status HailoBackend::write_input(const MemoryView &frame)
+{
+    hailo_status status = m_input->write(frame);
+    if (status != HAILO_SUCCESS && status != HAILO_STREAM_ABORT) {
+        std::cerr << "[ERROR] Input vstream write failed with status: " << status << std::endl;
+    }
+    return status;
+}
+
+/**
+ * @brief Reads one frame from the output vstream (NPU → CPU, PCIe read)
+ *
+ * @param[out] frame Buffer receiving exactly one output frame
+ * @return HAILO_SUCCESS, or the vstream error status
+ */
+hailo_status HailoBackend::read_output(MemoryView frame)
+{
+    hailo_status status = m_output->read(frame);
+    if (status != HAILO_SUCCESS && status != HAILO_STREAM_ABORT) {
+        std::cerr << "[ERROR] Output vstream read failed with status: " << status << std::endl;
+    }
+    return status;
+}
+
+hailo_status HailoBackend::set_scheduling(int priority, uint32_t threshold, std::chrono::milliseconds timeout)
+{
+    hailo_status status = m_network_group->set_scheduler_priority(
+        static_cast<uint8_t>(std::min(std::max(priority, static_cast<int>(HAILO_SCHEDULER_PRIORITY_MIN)),
+                                      static_cast<int>(HAILO_SCHEDULER_PRIORITY_MAX))));
+    if (status != HAILO_SUCCESS) {
+        std::cerr << "[ERROR] set_scheduler_priority failed with status: " << status << std::endl;
+        return status;
+    }
+    // threshold/timeout은 1보다 큰 값만 의미가 있다 (1 = 프레임이 오면 바로)
+    if (threshold > 1) {
+        status = m_network_group->set_scheduler_threshold(threshold);
+        if (status != HAILO_SUCCESS) {
+            std::cerr << "[ERROR] set_scheduler_threshold failed with status: " << status << std::endl;
+            return status;
+        }
+        status = m_network_group->set_scheduler_timeout(timeout);
+        if (status != HAILO_SUCCESS) {
+            std::cerr << "[ERROR] set_scheduler_timeout failed with status: " << status << std::endl;
+            return status;
+        }
+    }
+    return HAILO_SUCCESS;
+}
+
+void HailoBackend::abort()
+{
+    m_input->abort();
+    m_output->abort();
+}
+
+void HailoBackend::output_quantization(float &scale, float &zero_point) const
+{
+    const hailo_quant_info_t &quant = m_output->get_info().quant_info;
+    scale = quant.qp_scale;
+    zero_point = quant.qp_zp;
+}
+
+// ==================== LatencyModel ====================
+
+LatencyModel::LatencyModel(double mean_ms, double jitter_ms) :
+    m_mean_ms(mean_ms),
+    m_jitter_ms(jitter_ms),
+    m_rng(42)  // 고정 시드: 같은 설정이면 같은 지연 시퀀스
+{}
+
+/**
+ * @brief Loads the Infer(ms) column of a timing CSV (trace_convert --csv output)
+ *
+ * @param[in] path Path to the timing CSV
+ * @return true if at least one sample was loaded
+ */
+bool LatencyModel::load_timing_log(const std::string &path)
+{
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "[ERROR] Failed to open latency log: " << path << std::endl;
+        return false;
+    }
+
+    std::string line;
+    int infer_column = -1;
+    std::vector<double> samples;
+    while (std::getline(file, line)) {
+        std::stringstream ss(line);
+        std::string cell;
+        std::vector<std::string> cells;
+        while (std::getline(ss, cell, ',')) {
+            cells.push_back(cell);
+        }
+
+        // 헤더는 여러 번 append 되었을 수 있으므로 매번 확인
+        if (!cells.empty() && cells[0].rfind("Timestamp", 0) == 0) {
+            for (size_t i = 0; i < cells.size(); i++) {
+                if (cells[i].rfind("Infer", 0) == 0) {
+                    infer_column = static_cast<int>(i);
+                }
+            }
+            continue;
+        }
+        if (infer_column < 0 || infer_column >= static_cast<int>(cells.size())) {
+            continue;
+        }
+        try {
+            samples.push_back(std::stod(cells[infer_column]));
+        } catch (const std::exception &) {
+            // 깨진 줄은 건너뛴다
+        }
+    }
+
+    if (samples.empty()) {
+        std::cerr << "[ERROR] No Infer samples in latency log: " << path << std::endl;
+        return false;
+    }
+    m_samples_ms = std::move(samples);
+    return true;
+}
+
+/**
+ * @brief Draws one simulated inference latency
+ *
+ * @return A replayed sample if a timing log is loaded, otherwise mean ± normal jitter (never negative)
+ */
+std::chrono::microseconds LatencyModel::sample()
+{
+    double ms = m_mean_ms;
+    if (!m_samples_ms.empty()) {
+        std::uniform_int_distribution<size_t> pick(0, m_samples_ms.size() - 1);
+        ms = m_samples_ms[pick(m_rng)];
+    } else if (m_jitter_ms > 0.0) {
+        std::normal_distribution<double> jitter(m_mean_ms, m_jitter_ms);
+        ms = std::max(0.0, jitter(m_rng));
+    }
+    return std::chrono::microseconds(static_cast<int64_t>(ms * 1000.0));
+}
+
+// ==================== SimDevice ====================
+
+SimDevice::SimDevice(double switch_ms) :
+    m_switch_ms(switch_ms),
+    m_created(std::chrono::steady_clock::now()),
+    m_thread(&SimDevice::run, this)
+{}
+
+SimDevice::~SimDevice()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+        for (Model &model : m_models) {
+            model.aborted = true;
+        }
+    }
+    m_work.notify_all();
+    m_done.notify_all();
+    m_thread.join();
+}
+
+size_t SimDevice::add_model(int priority, size_t threshold, std::chrono::milliseconds timeout)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Model model;
+    model.priority = priority;
+    model.threshold = std::max<size_t>(threshold, 1);
+    model.timeout = timeout;
+    m_models.push_back(std::move(model));
+    return m_models.size() - 1;
+}
+
+void SimDevice::submit(size_t model, std::chrono::microseconds duration)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_models[model].pending.emplace_back(duration, std::chrono::steady_clock::now());
+    }
+    m_work.notify_one();
+}
+
+bool SimDevice::wait(size_t model, uint64_t count)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    Model &m = m_models[model];
+    m_done.wait(lock, [&] { return m.aborted || m.completed >= count; });
+    return m.completed >= count;
+}
+
+void SimDevice::abort(size_t model)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_models[model].aborted = true;
+    }
+    m_done.notify_all();
+}
+
+SimDevice::Usage SimDevice::usage(size_t model) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_models[model].usage;
+}
+
+double SimDevice::switch_total_ms() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_switch_total_ms;
+}
+
+double SimDevice::elapsed_ms() const
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_created).count();
+}
+
+int SimDevice::pick(std::chrono::steady_clock::time_point now, std::chrono::steady_clock::time_point &wake_at) const
+{
+    int best = -1;
+    const size_t count = m_models.size();
+    wake_at = std::chrono::steady_clock::time_point::max();
+    // 마지막으로 돌린 모델 다음부터 훑어서 같은 우선순위끼리는 round-robin
+    for (size_t n = 1; n <= count; n++) {
+        const size_t i = (static_cast<size_t>(m_current + 1) + n - 1) % count;
+        const Model &model = m_models[i];
+        if (model.pending.empty()) {
+            continue;
+        }
+        const auto timeout_at = model.pending.front().second + model.timeout;
+        if (model.pending.size() < model.threshold && now < timeout_at) {
+            wake_at = std::min(wake_at, timeout_at);
+            continue;
+        }
+        if (best < 0 || model.priority > m_models[best].priority) {
+            best = static_cast<int>(i);
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief Device thread: picks a model, pays the switch, runs up to threshold of its frames
+ */
+void SimDevice::run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_stop) {
+        std::chrono::steady_clock::time_point wake_at;
+        const int next = pick(std::chrono::steady_clock::now(), wake_at);
+        if (next < 0) {
+            if (wake_at == std::chrono::steady_clock::time_point::max()) {
+                m_work.wait(lock);
+            } else {
+                m_work.wait_until(lock, wake_at);
+            }
+            continue;
+        }
+
+        Model &model = m_models[next];
+        const bool switched = m_current != next;
+        if (switched) {
+            model.usage.switches++;
+        }
+        m_current = next;
+        std::vector<std::chrono::microseconds> burst;
+        while (!model.pending.empty() && burst.size() < model.threshold) {
+            burst.push_back(model.pending.front().first);
+            model.pending.pop_front();
+        }
+
+        lock.unlock();
+        if (switched && m_switch_ms > 0.0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(static_cast<int64_t>(m_switch_ms * 1000.0)));
+        }
+        lock.lock();
+        if (switched) {
+            m_switch_total_ms += m_switch_ms;
+        }
+
+        // 프레임마다 완료를 알려 read_output()이 순서대로 깨어난다
+        for (const std::chrono::microseconds &duration : burst) {
+            lock.unlock();
+            std::this_thread::sleep_for(duration);
+            lock.lock();
+            model.completed++;
+            model.usage.frames++;
+            model.usage.busy_ms += duration.count() / 1000.0;
+            m_done.notify_all();
+        }
+    }
+}
+
+// ==================== 공유 장치 ====================
+
+/**
+ * @brief SimDevice for the cpu backend, otherwise a VDevice with the model scheduler on
+ *
+ * @param[in] config Configuration; backend is "cpu" or "hailo"
+ * @return On success, returns the device
+ *         On failure, returns hailo_status error code
+ */
+Expected<SharedDevice> create_shared_device(const Config &config)
+{
+    SharedDevice device;
+    if (config.backend == "cpu") {
+        device.sim = std::make_shared<SimDevice>(config.cpu_switch_ms);
+        return device;
+    }
+    // 모델 스케줄러: 여러 network group을 한 장치에 올려 두고 프레임이 온 쪽을 번갈아 실행
+    hailo_vdevice_params_t params;
+    hailo_init_vdevice_params(&params);
+    params.scheduling_algorithm = HAILO_SCHEDULING_ALGORITHM_ROUND_ROBIN;
+    auto created = VDevice::create(params);
+    if (!created) {
+        std::cerr << "Failed to create vdevice, status = " << created.status() << std::endl;
+        return make_unexpected(created.status());
+    }
+    device.vdevice = std::shared_ptr<VDevice>(created.release());
+    return device;
+}
+
+// ==================== CpuBackend ====================
+
+CpuBackend::CpuBackend(const Config &config, LatencyModel latency) :
+    m_width(config.model_width),
+    m_height(config.model_height),
+    m_input_size(static_cast<size_t>(config.model_width) * config.model_height * 3),
+    m_output_size(static_cast<size_t>(config.model_width) * config.model_height),
+    m_latency(std::move(latency))
+{}
+
+/**
+ * @brief Creates the CPU reference backend and its latency model
+ *
+ * @param[in] config Configuration containing model size and cpu_* latency settings
+ * @return On success, returns the backend
+ *         On failure, returns hailo_status error code
+ */
+Expected<std::unique_ptr<CpuBackend>> CpuBackend::create(const Config &config)
+{
+    LatencyModel latency(config.cpu_latency_ms, config.cpu_jitter_ms);
+    if (!config.cpu_latency_log.empty() && !latency.load_timing_log(config.cpu_latency_log)) {
+        return make_unexpected(HAILO_OPEN_FILE_FAILURE);
+    }
+
+    std::unique_ptr<CpuBackend> backend(new CpuBackend(config, std::move(latency)));
+    for (size_t i = 0; i < QUEUE_SIZE; i++) {
+        backend->m_queue.push_back(make_aligned_buffer(backend->m_output_size));
+        if (!backend->m_queue.back()) {
+            return make_unexpected(HAILO_OUT_OF_HOST_MEMORY);
+        }
+    }
+    backend->m_ready.resize(QUEUE_SIZE);
+    backend->m_tickets.resize(QUEUE_SIZE);
+    backend->m_busy_until = std::chrono::steady_clock::now();
+
+    std::cout << "CPU backend: " << backend->m_width << "x" << backend->m_height;
+    if (backend->m_latency.samples() > 0) {
+        std::cout << ", latency replay (" << backend->m_latency.samples() << " samples)" << std::endl;
+    } else {
+        std::cout << ", latency " << config.cpu_latency_ms << " ± " << config.cpu_jitter_ms << " ms" << std::endl;
+    }
+    return std::move(backend);
+}
+
+/**
+ * @brief Produces a depth-shaped int8 map: vertical ramp (near at the bottom) plus luminance
+ *
+ * @param[in] input RGB frame (model_height x model_width x 3)
+ * @param[out] output int8 depth map (model_height x model_width)
+ */
+void CpuBackend::compute(const uint8_t *input, uint8_t *output) const
+{
+    for (int y = 0; y < m_height; y++) {
+        const int ramp = (m_height > 1) ? (y * 255) / (m_height - 1) : 0;
+        const uint8_t *src = input + static_cast<size_t>(y) * m_width * 3;
+        int8_t *dst = reinterpret_cast<int8_t*>(output) + static_cast<size_t>(y) * m_width;
+        for (int x = 0; x < m_width; x++) {
+            const int lum = (src[3 * x] + 2 * src[3 * x + 1] + src[3 * x + 2]) >> 2;
+            dst[x] = static_cast<int8_t>(((ramp * 3 + lum) >> 2) - 128);
+        }
+    }
+}
+
+hailo_status CpuBackend::infer(const MemoryView &input, MemoryView output, size_t frames_count)
+{
+    if (input.size() < m_input_size * frames_count || output.size() < m_output_size * frames_count) {
+        std::cerr << "[ERROR] CPU backend buffer size mismatch" << std::endl;
+        return HAILO_INVALID_ARGUMENT;
+    }
+
+    if (m_device) {
+        uint64_t ticket = 0;
+        for (size_t i = 0; i < frames_count; i++) {
+            compute(input.data() + i * m_input_size, output.data() + i * m_output_size);
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_device->submit(m_model, m_latency.sample());
+            ticket = ++m_submitted;
+        }
+        return m_device->wait(m_model, ticket) ? HAILO_SUCCESS : HAILO_STREAM_ABORT;
+    }
+
+    auto deadline = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < frames_count; i++) {
+        compute(input.data() + i * m_input_size, output.data() + i * m_output_size);
+        // LatencyModel의 RNG는 write_input()과 공유하므로 락 안에서 뽑는다
+        std::lock_guard<std::mutex> lock(m_mutex);
+        deadline += m_latency.sample();
+    }
+    std::this_thread::sleep_until(deadline);
+    return HAILO_SUCCESS;
+}
+
+/**
+ * @brief Moves this backend onto a SimDevice shared with other models
+ *
+ * Call before the first frame. Frames then wait for the shared device's scheduler
+ * instead of the backend's own serial timeline.
+ */
+void CpuBackend::share_device(std::shared_ptr<SimDevice> device, size_t model)
+{
+    m_device = std::move(device);
+    m_model = model;
+}
+
+hailo_status CpuBackend::write_input(const MemoryView &frame)
+{
+    if (frame.size() != m_input_size) {
+        return HAILO_INVALID_ARGUMENT;
+    }
+
+    uint8_t *slot = nullptr;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cv.wait(lock, [this] { return m_aborted || m_tail - m_head < QUEUE_SIZE; });
+        if (m_aborted) {
+            return HAILO_STREAM_ABORT;
+        }
+        slot = m_queue[m_tail % QUEUE_SIZE].get();
+    }
+
+    // 단일 writer라 예약된 슬롯은 tail을 올리기 전까지 reader가 건드리지 않는다
+    compute(frame.data(), slot);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_device) {
+            // 공유 장치: 실행 순서는 장치 스케줄러가 정한다
+            m_device->submit(m_model, m_latency.sample());
+            m_tickets[m_tail % QUEUE_SIZE] = ++m_submitted;
+            m_tail++;
+            m_cv.notify_all();
+            return HAILO_SUCCESS;
+        }
+        // 가상 NPU는 한 번에 한 프레임만 처리: 앞 프레임이 끝난 뒤부터 지연 시작
+        auto start = std::max(std::chrono::steady_clock::now(), m_busy_until);
+        m_busy_until = start + m_latency.sample();
+        m_ready[m_tail % QUEUE_SIZE] = m_busy_until;
+        m_tail++;
+    }
+    m_cv.notify_all();
+    return HAILO_SUCCESS;
+}
+
+hailo_status CpuBackend::read_output(MemoryView frame)
+{
+    if (frame.size() != m_output_size) {
+        return HAILO_INVALID_ARGUMENT;
+    }
+
+    const uint8_t *slot = nullptr;
+    std::chrono::steady_clock::time_point ready;
+    uint64_t ticket = 0;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cv.wait(lock, [this] { return m_aborted || m_head < m_tail; });
+        if (m_aborted) {
+            return HAILO_STREAM_ABORT;
+        }
+        slot = m_queue[m_head % QUEUE_SIZE].get();
+        ready = m_ready[m_head % QUEUE_SIZE];
+        ticket = m_tickets[m_head % QUEUE_SIZE];
+    }
+
+    if (m_device) {
+        if (!m_device->wait(m_model, ticket)) {
+            return HAILO_STREAM_ABORT;
+        }
+    } else {
+        std::this_thread::sleep_until(ready);
+    }
+    std::memcpy(frame.data(), slot, m_output_size);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_head++;
+    }
+    m_cv.notify_all();
+    return HAILO_SUCCESS;
+}
+
+void CpuBackend::abort()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_aborted = true;
+    }
+    m_cv.notify_all();
+    if (m_device) {
+        m_device->abort(m_model);
+    }
+}
+
+// ==================== ServiceBackend ====================
+
+/**
+ * @brief Attaches to the depth_service region named by config.service_name
+ *
+ * @param[in] config Configuration containing service_name and the model size
+ * @return On success, returns the backend
+ *         On failure, returns HAILO_NOT_FOUND (service not running or full) or HAILO_INVALID_ARGUMENT
+ */
+Expected<std::unique_ptr<ServiceBackend>> ServiceBackend::create(const Config &config)
+{
+    std::unique_ptr<ServiceBackend> backend(new ServiceBackend());
+    const auto t_start = std::chrono::steady_clock::now();
+    if (!backend->m_client.connect(config.service_name)) {
+        std::cerr << "[ERROR] Inference service " << config.service_name
+                  << " is not running or has no free client channel (start depth_service first)" << std::endl;
+        return make_unexpected(HAILO_NOT_FOUND);
+    }
+    if (backend->m_client.width() != static_cast<uint32_t>(config.model_width) ||
+        backend->m_client.height() != static_cast<uint32_t>(config.model_height)) {
+        std::cerr << "[ERROR] Inference service model is " << backend->m_client.width() << "x"
+                  << backend->m_client.height() << ", config expects " << config.model_width << "x"
+                  << config.model_height << std::endl;
+        return make_unexpected(HAILO_INVALID_ARGUMENT);
+    }
+    backend->m_slots = backend->m_client.slots();
+
+    const double attach_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t_start).count();
+    std::cout << "Service backend: " << config.service_name << ", " << backend->m_slots << " slots, attached in "
+              << attach_ms << " ms" << std::endl;
+    return std::move(backend);
+}
+
+hailo_status ServiceBackend::infer(const MemoryView &input, MemoryView output, size_t frames_count)
+{
+    const size_t input_size = m_client.input_size();
+    const size_t output_size = m_client.output_size();
+    if (input.size() < input_size * frames_count || output.size() < output_size * frames_count) {
+        std::cerr << "[ERROR] Service backend buffer size mismatch" << std::endl;
+        return HAILO_INVALID_ARGUMENT;
+    }
+
+    // 슬롯 수만큼 앞서 써 두어야 서비스가 이 배치를 한 번에 묶을 수 있다
+    size_t written = 0;
+    for (size_t read = 0; read < frames_count; read++) {
+        while (written < frames_count && written - read < m_slots) {
+            auto status = write_input(MemoryView(const_cast<uint8_t*>(input.data()) + written * input_size, input_size));
+            if (status != HAILO_SUCCESS) {
+                return status;
+            }
+            written++;
+        }
+        auto status = read_output(MemoryView(output.data() + read * output_size, output_size));
+        if (status != HAILO_SUCCESS) {
+            return status;
+        }
+    }
+    return HAILO_SUCCESS;
+}
+
+hailo_status ServiceBackend::write_input(const MemoryView &frame)
+{
+    if (frame.size() != m_client.input_size()) {
+        return HAILO_INVALID_ARGUMENT;
+    }
+
+    uint64_t index = 0;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cv.wait(lock, [this] { return m_aborted || m_tail - m_head < m_slots; });
+        if (m_aborted) {
+            return HAILO_STREAM_ABORT;
+        }
+        index = m_tail;
+    }
+
+    // 단일 writer라 예약된 슬롯은 tail을 올리기 전까지 reader가 건드리지 않는다
+    const uint32_t slot = static_cast<uint32_t>(index % m_slots);
+    std::memcpy(m_client.input(slot), frame.data(), frame.size());
+    if (!m_client.submit(slot, index)) {
+        std::cerr << "[ERROR] Service slot " << slot << " is still in use" << std::endl;
+        return HAILO_INVALID_OPERATION;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tail++;
+    }
+    m_cv.notify_all();
+    return HAILO_SUCCESS;
+}
+
+hailo_status ServiceBackend::read_output(MemoryView frame)
+{
+    if (frame.size() != m_client.output_size()) {
+        return HAILO_INVALID_ARGUMENT;
+    }
+
+    uint32_t slot = 0;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cv.wait(lock, [this] { return m_aborted || m_head < m_tail; });
+        if (m_aborted) {
+            return HAILO_STREAM_ABORT;
+        }
+        slot = static_cast<uint32_t>(m_head % m_slots);
+    }
+
+    DepthServiceClient::Result result;
+    while ((result = m_client.wait(slot, WAIT_SLICE_MS)) == DepthServiceClient::Result::Timeout) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_aborted) {
+            return HAILO_STREAM_ABORT;
+        }
+    }
+    if (result == DepthServiceClient::Result::ServiceGone) {
+        std::cerr << "[ERROR] Inference service stopped" << std::endl;
+        return HAILO_SHUTDOWN_EVENT_SIGNALED;
+    }
+
+    hailo_status status = HAILO_SUCCESS;
+    if (result == DepthServiceClient::Result::Done) {
+        std::memcpy(frame.data(), m_client.output(slot), frame.size());
+    } else {
+        status = HAILO_INTERNAL_FAILURE;  // 서비스에서 추론 실패: 슬롯은 반납하고 다음 프레임으로
+    }
+    m_client.release(slot);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_head++;
+    }
+    m_cv.notify_all();
+    return status;
+}
+
+void ServiceBackend::abort()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_aborted = true;
+    }
+    m_cv.notify_all();
+}
+
+void ServiceBackend::output_quantization(float &scale, float &zero_point) const
+{
+    scale = m_client.scale();
+    zero_point = m_client.zero_point();
+}
@@ -0,0 +1,285 @@
+#pragma once
+
+#include "DepthService.hpp"
+#include "Hailoinfer.hpp"
+#include "hailo/hailort.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace hailort;
+
+/**
+ * @brief Device side of the inference path, independent of where the model runs
+ *
+ * write_input() hands one frame to the device (host → device) and read_output()
+ * returns the oldest pending result (device → host). Results come back in the
+ * same order the inputs were written, like a pair of vstreams. infer() is the
+ * blocking batch call used by InferSession.
+ */
+class InferenceBackend {
+public:
+    virtual ~InferenceBackend() = default;
+
+    virtual size_t input_frame_size() const = 0;   ///< Bytes of one input frame
+    virtual size_t output_frame_size() const = 0;  ///< Bytes of one output frame
+
+    /// Runs frames_count frames laid out back to back in input/output. Blocks until done.
+    virtual hailo_status infer(const MemoryView &input, MemoryView output, size_t frames_count) = 0;
+    /// Writes one input frame. May block while the device queue is full.
+    virtual hailo_status write_input(const MemoryView &frame) = 0;
+    /// Reads the oldest pending output frame. Blocks until it is ready.
+    virtual hailo_status read_output(MemoryView frame) = 0;
+    /// Unblocks pending write_input()/read_output() calls (used on shutdown)
+    virtual void abort() = 0;
+    /// Dequantization of the output values: depth = scale * (value - zero_point)
+    virtual void output_quantization(float &scale, float &zero_point) const { scale = 1.0f; zero_point = 0.0f; }
+};
+
+/**
+ * @brief Creates the backend selected by Config::backend ("hailo", "cpu" or "service")
+ */
+Expected<std::unique_ptr<InferenceBackend>> create_backend(const Config &config);
+
+/**
+ * @brief InferenceBackend running the HEF on a Hailo device
+ *
+ * Owns the VDevice, the configured network group and the InferVStreams pipeline.
+ * Streaming calls use the first input/output vstream; any further vstreams get
+ * scratch buffers so infer() can still be called with the primary ones only.
+ */
+class HailoBackend : public InferenceBackend {
+public:
+    /// Opens its own VDevice, or configures the HEF on vdevice next to other network groups
+    static Expected<std::unique_ptr<HailoBackend>> create(const Config &config,
+                                                          std::shared_ptr<VDevice> vdevice = nullptr);
+
+    /**
+     * @brief Model scheduler settings of this network group on a shared VDevice
+     *
+     * @param[in] priority Higher priority groups get the device first when several have frames ready
+     * @param[in] threshold Frames the group waits for before it asks for the device
+     * @param[in] timeout Time after which a group below its threshold asks anyway
+     */
+    hailo_status set_scheduling(int priority, uint32_t threshold, std::chrono::milliseconds timeout);
+
+    size_t input_frame_size() const override;
+    size_t output_frame_size() const override;
+    hailo_status infer(const MemoryView &input, MemoryView output, size_t frames_count) override;
+    hailo_status write_input(const MemoryView &frame) override;
+    hailo_status read_output(MemoryView frame) override;
+    void abort() override;
+    void output_quantization(float &scale, float &zero_point) const override;
+
+private:
+    HailoBackend() = default;
+
+    std::shared_ptr<VDevice> m_vdevice;
+    std::shared_ptr<ConfiguredNetworkGroup> m_network_group;
+    std::unique_ptr<InferVStreams> m_pipeline;
+    InputVStream *m_input = nullptr;
+    OutputVStream *m_output = nullptr;
+
+    size_t m_max_frames = 1;
+    std::vector<AlignedBuffer> m_scratch;            ///< Buffers for non-primary vstreams
+    std::map<std::string, MemoryView> m_input_views;
+    std::map<std::string, MemoryView> m_output_views;
+    std::map<std::string, MemoryView>::iterator m_primary_input;
+    std::map<std::string, MemoryView>::iterator m_primary_output;
+};
+
+/**
+ * @brief Synthetic NPU latency: fixed mean with jitter, or replayed from a timing log
+ */
+class LatencyModel {
+public:
+    LatencyModel(double mean_ms = 0.0, double jitter_ms = 0.0);
+
+    /// Loads the Infer(ms) column of a timing CSV (trace_convert --csv) and samples from it
+    bool load_timing_log(const std::string &path);
+
+    std::chrono::microseconds sample();
+    size_t samples() const { return m_samples_ms.size(); }
+
+private:
+    double m_mean_ms;
+    double m_jitter_ms;
+    std::vector<double> m_samples_ms;
+    std::mt19937 m_rng;
+};
+
+/**
+ * @brief Stand-in for one NPU time-sliced between several models
+ *
+ * Mirrors the HailoRT model scheduler: each model queues frames; a model asks for
+ * the device once it has threshold frames queued (or its oldest frame waited
+ * timeout); among the models asking, the highest priority wins and ties go round
+ * robin. The winner runs up to threshold frames back to back, after switch_ms if the
+ * device last ran another model. Durations are slept on the device thread, so
+ * the host sees real contention.
+ */
+class SimDevice {
+public:
+    struct Usage {
+        uint64_t frames;          ///< Frames run for the model
+        double busy_ms;           ///< Device time spent on its frames
+        uint64_t switches;        ///< Times the device switched to the model
+    };
+
+    explicit SimDevice(double switch_ms);
+    ~SimDevice();
+
+    SimDevice(const SimDevice &) = delete;
+    SimDevice &operator=(const SimDevice &) = delete;
+
+    /// Registers a model before the first submit(); returns its id
+    size_t add_model(int priority, size_t threshold, std::chrono::milliseconds timeout);
+
+    /// Queues one frame of model that takes duration on the device
+    void submit(size_t model, std::chrono::microseconds duration);
+    /// Waits until the model's first count frames are done; false once aborted
+    bool wait(size_t model, uint64_t count);
+    /// Wakes wait() of model with false (used on shutdown)
+    void abort(size_t model);
+
+    Usage usage(size_t model) const;
+    double switch_ms() const { return m_switch_ms; }
+    /// Time the device spent switching between models
+    double switch_total_ms() const;
+    /// Time since the device was created
+    double elapsed_ms() const;
+
+private:
+    struct Model {
+        int priority;
+        size_t threshold;
+        std::chrono::milliseconds timeout;
+        std::deque<std::pair<std::chrono::microseconds, std::chrono::steady_clock::time_point>> pending;
+        uint64_t completed = 0;
+        bool aborted = false;
+        Usage usage{0, 0.0, 0};
+    };
+
+    void run();
+    /// Model to run next, or -1 (wake_at = when a waiting model times out)
+    int pick(std::chrono::steady_clock::time_point now, std::chrono::steady_clock::time_point &wake_at) const;
+
+    const double m_switch_ms;
+    const std::chrono::steady_clock::time_point m_created;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_work;
+    std::condition_variable m_done;
+    std::vector<Model> m_models;
+    int m_current = -1;          ///< Model the device last ran
+    double m_switch_total_ms = 0.0;
+    bool m_stop = false;
+    std::thread m_thread;
+};
+
+/**
+ * @brief One device shared by several network groups: exactly one member is set
+ */
+struct SharedDevice {
+    std::shared_ptr<VDevice> vdevice;  ///< hailo backend: VDevice with the round-robin model scheduler
+    std::shared_ptr<SimDevice> sim;    ///< cpu backend: simulated NPU switching after cpu_switch_ms
+};
+
+/**
+ * @brief Opens the device that ModelGroup and LadderBackend put all their models on
+ *
+ * The caller has already checked that Config::backend is "cpu", "hailo" or empty.
+ */
+Expected<SharedDevice> create_shared_device(const Config &config);
+
+/**
+ * @brief CPU reference backend producing an int8 model_height x model_width depth map
+ *
+ * The output is a cheap depth-shaped image (vertical ramp plus input luminance), so
+ * host-side pre/postprocessing sees realistic data. Each frame occupies the simulated
+ * device for a LatencyModel sample, serially, like a single NPU.
+ */
+class CpuBackend : public InferenceBackend {
+public:
+    static Expected<std::unique_ptr<CpuBackend>> create(const Config &config);
+
+    size_t input_frame_size() const override { return m_input_size; }
+    size_t output_frame_size() const override { return m_output_size; }
+    hailo_status infer(const MemoryView &input, MemoryView output, size_t frames_count) override;
+    hailo_status write_input(const MemoryView &frame) override;
+    hailo_status read_output(MemoryView frame) override;
+    void abort() override;
+
+    /// Runs this backend's frames on a device shared with other models instead of its own
+    void share_device(std::shared_ptr<SimDevice> device, size_t model);
+
+private:
+    static constexpr size_t QUEUE_SIZE = 4;  ///< Simulated device queue depth
+
+    CpuBackend(const Config &config, LatencyModel latency);
+    void compute(const uint8_t *input, uint8_t *output) const;
+
+    int m_width;
+    int m_height;
+    size_t m_input_size;
+    size_t m_output_size;
+    LatencyModel m_latency;      ///< Guarded by m_mutex (the RNG is shared by every caller)
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::vector<AlignedBuffer> m_queue;  ///< Ring of QUEUE_SIZE output frames
+    std::vector<std::chrono::steady_clock::time_point> m_ready;
+    uint64_t m_head = 0;  ///< Next frame to read
+    uint64_t m_tail = 0;  ///< Next frame to write
+    std::chrono::steady_clock::time_point m_busy_until;
+    bool m_aborted = false;
+
+    std::shared_ptr<SimDevice> m_device;  ///< Shared device (nullptr = own serial device)
+    size_t m_model = 0;
+    uint64_t m_submitted = 0;             ///< Frames handed to m_device (infer() and write_input())
+    std::vector<uint64_t> m_tickets;      ///< m_submitted after each queued frame (done once the device reached it)
+};
+
+/**
+ * @brief InferenceBackend forwarding frames to a running depth_service process
+ *
+ * Attaching takes a shared-memory map instead of a device open and HEF configure,
+ * so a restarted camera client is streaming again within milliseconds. Inputs go
+ * to the client's service slots in ring order and results are read back in the
+ * same order; the service batches them together with other clients' frames.
+ */
+class ServiceBackend : public InferenceBackend {
+public:
+    static Expected<std::unique_ptr<ServiceBackend>> create(const Config &config);
+
+    size_t input_frame_size() const override { return m_client.input_size(); }
+    size_t output_frame_size() const override { return m_client.output_size(); }
+    hailo_status infer(const MemoryView &input, MemoryView output, size_t frames_count) override;
+    hailo_status write_input(const MemoryView &frame) override;
+    hailo_status read_output(MemoryView frame) override;
+    void abort() override;
+    void output_quantization(float &scale, float &zero_point) const override;
+
+private:
+    static constexpr int WAIT_SLICE_MS = 100;  ///< abort() is noticed within this while waiting on the service
+
+    ServiceBackend() = default;
+
+    DepthServiceClient m_client;
+    uint32_t m_slots = 0;
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    uint64_t m_head = 0;  ///< Next frame to read
+    uint64_t m_tail = 0;  ///< Next frame to write
+    bool m_aborted = false;
+};
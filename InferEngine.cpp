@@ -0,0 +1,209 @@
+#include "InferEngine.hpp"
+#include "FrameBatcher.hpp"
+#include "Timeline.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+AsyncInferEngine::AsyncInferEngine(InferenceBackend &backend, size_t frames_in_flight,
+                                   InferCallback callback) :
+    m_backend(backend),
+    m_callback(std::move(callback)),
+    m_jobs(frames_in_flight > 0 ? frames_in_flight : 1)
+{}
+
+AsyncInferEngine::~AsyncInferEngine()
+{
+    stop();
+}
+
+/**
+ * @brief Allocates one input/output buffer pair per slot and starts the I/O threads
+ *
+ * @return HAILO_SUCCESS, or HAILO_OUT_OF_HOST_MEMORY if a buffer cannot be allocated
+ */
+hailo_status AsyncInferEngine::start()
+{
+    if (m_running) {
+        return HAILO_SUCCESS;
+    }
+
+    const size_t input_size = m_backend.input_frame_size();
+    const size_t output_size = m_backend.output_frame_size();
+
+    m_buffers.clear();
+    for (size_t i = 0; i < m_jobs.size(); i++) {
+        auto input = make_aligned_buffer(input_size);
+        auto output = make_aligned_buffer(output_size);
+        if (!input || !output) {
+            std::cerr << "[ERROR] Failed to allocate in-flight buffers" << std::endl;
+            return HAILO_OUT_OF_HOST_MEMORY;
+        }
+        m_jobs[i] = InferJob{i, 0, input.get(), output.get(), input_size, output_size, HAILO_SUCCESS, nullptr, TIMELINE_NO_FRAME};
+        m_buffers.push_back(std::move(input));
+        m_buffers.push_back(std::move(output));
+    }
+
+    m_stop = false;
+    m_running = true;
+    m_writer = std::thread(&AsyncInferEngine::writer_loop, this);
+    m_reader = std::thread(&AsyncInferEngine::reader_loop, this);
+    return HAILO_SUCCESS;
+}
+
+/**
+ * @brief Drains frames that are already submitted, then joins the I/O threads
+ *
+ * A job that was acquired but never submitted is discarded.
+ */
+void AsyncInferEngine::stop()
+{
+    if (!m_running) {
+        return;
+    }
+
+    flush();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+        m_acquired = m_submitted;
+    }
+    m_cv.notify_all();
+
+    m_writer.join();
+    m_reader.join();
+    m_running = false;
+}
+
+/**
+ * @brief Waits for a free slot and hands it to the producer
+ *
+ * Blocks while frames_in_flight frames are pending, which is the engine's backpressure.
+ *
+ * @return Job to fill, or nullptr once the engine is stopping
+ */
+InferJob *AsyncInferEngine::acquire()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [this] {
+        return m_stop || (m_acquired == m_submitted && m_acquired - m_completed < m_jobs.size());
+    });
+    if (m_stop) {
+        return nullptr;
+    }
+
+    InferJob *job = &m_jobs[m_acquired % m_jobs.size()];
+    job->frame_id = m_acquired;
+    job->trace_id = TIMELINE_NO_FRAME;
+    job->status = HAILO_SUCCESS;
+    job->user_data = nullptr;
+    m_acquired++;
+    return job;
+}
+
+/**
+ * @brief Queues the job returned by the last acquire() for writing
+ *
+ * @param[in] job Job whose input buffer has been filled
+ * @return HAILO_SUCCESS, or HAILO_INVALID_OPERATION if job is not the pending one
+ */
+hailo_status AsyncInferEngine::submit(InferJob *job)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!job || m_acquired != m_submitted + 1 || job->frame_id != m_submitted) {
+            std::cerr << "[ERROR] submit() without matching acquire()" << std::endl;
+            return HAILO_INVALID_OPERATION;
+        }
+        m_submitted++;
+    }
+    m_cv.notify_all();
+    return HAILO_SUCCESS;
+}
+
+/**
+ * @brief Blocks until every submitted frame has been delivered to the callback
+ */
+void AsyncInferEngine::flush()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [this] { return m_completed == m_submitted; });
+}
+
+void AsyncInferEngine::writer_loop()
+{
+    while (true) {
+        InferJob *job = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [this] { return m_stop || m_written < m_submitted; });
+            if (m_written == m_submitted) {
+                return;  // m_stop and nothing left to write
+            }
+            job = &m_jobs[m_written % m_jobs.size()];
+        }
+
+        // 락 밖에서 쓰기: 디바이스 큐가 차면 여기서 블록된다
+        {
+            TimelineScope span(TimelineSpan::NpuWrite, job->trace_id);
+            job->status = m_backend.write_input(MemoryView(job->input, job->input_size));
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_written++;
+        }
+        m_cv.notify_all();
+    }
+}
+
+void AsyncInferEngine::reader_loop()
+{
+    while (true) {
+        InferJob *job = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [this] { return (m_stop && m_completed == m_submitted) || m_completed < m_written; });
+            if (m_completed == m_written && m_completed == m_submitted) {
+                return;
+            }
+            job = &m_jobs[m_completed % m_jobs.size()];
+        }
+
+        // 쓰기에 실패한 프레임은 출력이 나오지 않으므로 읽지 않는다
+        if (job->status == HAILO_SUCCESS) {
+            TimelineScope span(TimelineSpan::NpuRead, job->trace_id);
+            job->status = m_backend.read_output(MemoryView(job->output, job->output_size));
+        }
+
+        m_callback(*job);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_completed++;
+        }
+        m_cv.notify_all();
+    }
+}
+
+Expected<std::unique_ptr<InferQueue>> create_infer_queue(InferenceBackend &backend, const Config &config,
+                                                         InferCallback callback)
+{
+    if (config.batch_size > 1) {
+        auto deadline = std::chrono::microseconds(static_cast<int64_t>(config.batch_timeout_ms * 1000.0));
+        std::unique_ptr<FrameBatcher> batcher(new FrameBatcher(backend, config.batch_size, deadline, std::move(callback)));
+        hailo_status status = batcher->start();
+        if (status != HAILO_SUCCESS) {
+            return make_unexpected(status);
+        }
+        return std::unique_ptr<InferQueue>(std::move(batcher));
+    }
+
+    const size_t frames_in_flight = static_cast<size_t>(std::max(config.frames_in_flight, 1));
+    std::unique_ptr<AsyncInferEngine> engine(new AsyncInferEngine(backend, frames_in_flight, std::move(callback)));
+    hailo_status status = engine->start();
+    if (status != HAILO_SUCCESS) {
+        return make_unexpected(status);
+    }
+    return std::unique_ptr<InferQueue>(std::move(engine));
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "Hailoinfer.hpp"
+#include "InferBackend.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief One in-flight frame owned by AsyncInferEngine
+ *
+ * The producer fills input (and user_data) between acquire() and submit();
+ * output and status are valid inside the completion callback.
+ */
+struct InferJob {
+    size_t index;          ///< Slot index in [0, frames_in_flight)
+    uint64_t frame_id;     ///< Monotonic submit sequence number
+    uint8_t *input;        ///< Page-aligned input buffer (input_frame_size bytes)
+    uint8_t *output;       ///< Page-aligned output buffer (output_frame_size bytes)
+    size_t input_size;
+    size_t output_size;
+    hailo_status status;   ///< Result of write + read for this frame
+    void *user_data;       ///< Caller context carried to the completion callback
+    uint64_t trace_id;     ///< Caller's frame ID, only used to tag timeline spans
+};
+
+using InferCallback = std::function<void(InferJob &job)>;
+
+/**
+ * @brief Producer side shared by AsyncInferEngine and FrameBatcher
+ *
+ * acquire() hands out a job whose input buffer the producer fills, submit() queues it.
+ * Each job is later passed to the completion callback, in submit order.
+ */
+class InferQueue {
+public:
+    virtual ~InferQueue() = default;
+
+    virtual InferJob *acquire() = 0;
+    virtual hailo_status submit(InferJob *job) = 0;
+    /// Blocks until every submitted job has been passed to the completion callback
+    virtual void flush() = 0;
+    virtual void stop() = 0;
+    /// Upper bound of jobs alive at once (size of the caller's per-job context array)
+    virtual size_t capacity() const = 0;
+};
+
+/**
+ * @brief Asynchronous inference engine with several frames in flight
+ *
+ * A writer thread pushes submitted frames into the backend while a reader thread
+ * pulls results back, so frame N+1's host-to-device write overlaps frame N's
+ * readback and postprocessing. Completions are delivered on the reader thread,
+ * in submit order. acquire()/submit() must be called from a single producer thread.
+ */
+class AsyncInferEngine : public InferQueue {
+public:
+    AsyncInferEngine(InferenceBackend &backend, size_t frames_in_flight, InferCallback callback);
+    ~AsyncInferEngine();
+
+    AsyncInferEngine(const AsyncInferEngine &) = delete;
+    AsyncInferEngine &operator=(const AsyncInferEngine &) = delete;
+
+    hailo_status start();
+    void stop() override;
+
+    InferJob *acquire() override;
+    hailo_status submit(InferJob *job) override;
+    void flush() override;
+
+    size_t capacity() const override { return m_jobs.size(); }
+
+private:
+    void writer_loop();
+    void reader_loop();
+
+    InferenceBackend &m_backend;
+    InferCallback m_callback;
+
+    std::vector<InferJob> m_jobs;
+    std::vector<AlignedBuffer> m_buffers;
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    uint64_t m_acquired = 0;   ///< Jobs handed to the producer
+    uint64_t m_submitted = 0;  ///< Jobs ready to be written
+    uint64_t m_written = 0;    ///< Jobs written to the backend
+    uint64_t m_completed = 0;  ///< Jobs read back and delivered
+    bool m_running = false;
+    bool m_stop = false;
+
+    std::thread m_writer;
+    std::thread m_reader;
+};
+
+/**
+ * @brief Creates and starts the queue selected by the config
+ *
+ * FrameBatcher when batch_size > 1, otherwise AsyncInferEngine with frames_in_flight slots.
+ *
+ * @param[in] backend Inference backend (must outlive the queue)
+ * @param[in] config Configuration containing batch_size, batch_timeout_ms and frames_in_flight
+ * @param[in] callback Completion callback, called on the queue's worker thread
+ * @return On success, returns the running queue
+ *         On failure, returns the start() error
+ */
+Expected<std::unique_ptr<InferQueue>> create_infer_queue(InferenceBackend &backend, const Config &config,
+                                                         InferCallback callback);
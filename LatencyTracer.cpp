@@ -0,0 +1,135 @@
+#include "LatencyTracer.hpp"
+
+#include <algorithm>
+#include <iomanip>
+
+LatencyTracer::LatencyTracer(size_t window) :
+    m_window(window > 0 ? window : 1)
+{
+    for (Series &series : m_series) {
+        series.samples.reserve(m_window);
+    }
+}
+
+void LatencyTracer::record(Point point, GstClockTime latency)
+{
+    if (!GST_CLOCK_TIME_IS_VALID(latency)) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Series &series = m_series[point];
+    if (series.samples.size() < m_window) {
+        series.samples.push_back(latency);
+    } else {
+        series.samples[series.next] = latency;
+    }
+    series.next = (series.next + 1) % m_window;
+    series.count++;
+    series.max = std::max(series.max, latency);
+    series.sum += latency;
+}
+
+LatencyTracer::Summary LatencyTracer::summary(Point point) const
+{
+    std::vector<GstClockTime> sorted;
+    Summary summary = {};
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const Series &series = m_series[point];
+        sorted = series.samples;
+        summary.count = series.count;
+        summary.max_ms = series.max / 1e6;
+        summary.sum_ms = series.sum / 1e6;
+    }
+    if (sorted.empty()) {
+        return summary;
+    }
+    std::sort(sorted.begin(), sorted.end());
+
+    // nearest-rank 백분위
+    auto percentile = [&sorted](double p) {
+        size_t rank = static_cast<size_t>(p * sorted.size() + 0.999999);
+        rank = std::min(std::max(rank, static_cast<size_t>(1)), sorted.size());
+        return sorted[rank - 1] / 1e6;
+    };
+    summary.p50_ms = percentile(0.50);
+    summary.p95_ms = percentile(0.95);
+    summary.p99_ms = percentile(0.99);
+    return summary;
+}
+
+void LatencyTracer::report(std::ostream &out) const
+{
+    const std::ios::fmtflags flags = out.flags();
+    const std::streamsize precision = out.precision();
+    for (int i = 0; i < POINT_COUNT; i++) {
+        const Point point = static_cast<Point>(i);
+        const Summary s = summary(point);
+        if (s.count == 0) {
+            continue;
+        }
+        out << "📏 capture→" << std::left << std::setw(12) << point_name(point) << std::right << std::fixed
+            << std::setprecision(1)
+            << " p50 " << s.p50_ms << "ms | p95 " << s.p95_ms << "ms | p99 " << s.p99_ms
+            << "ms | max " << s.max_ms << "ms (" << s.count << " frames)" << std::endl;
+    }
+    out.flags(flags);
+    out.precision(precision);
+}
+
+const char *LatencyTracer::point_name(Point point)
+{
+    switch (point) {
+    case INFER_START: return "infer-start";
+    case ELEMENT_IN: return "element-in";
+    case PUSH: return "push";
+    case ENCODER_OUT: return "encoder-out";
+    default: return "?";
+    }
+}
+
+// ==================== 패드 프로브 ====================
+
+struct LatencyProbe {
+    GstElement *element;
+    LatencyTracer::Point point;
+    LatencyTracer *tracer;
+};
+
+static GstPadProbeReturn latency_probe_cb(GstPad *pad, GstPadProbeInfo *info, gpointer user_data)
+{
+    LatencyProbe *probe = static_cast<LatencyProbe*>(user_data);
+    GstBuffer *buffer = GST_PAD_PROBE_INFO_BUFFER(info);
+    if (!buffer || !GST_CLOCK_TIME_IS_VALID(GST_BUFFER_PTS(buffer))) {
+        return GST_PAD_PROBE_OK;
+    }
+    GstClock *clock = gst_element_get_clock(probe->element);
+    if (!clock) {
+        return GST_PAD_PROBE_OK;  // PLAYING 전
+    }
+    const GstClockTime capture = gst_element_get_base_time(probe->element) + GST_BUFFER_PTS(buffer);
+    const GstClockTime now = gst_clock_get_time(clock);
+    gst_object_unref(clock);
+    if (now >= capture) {
+        probe->tracer->record(probe->point, now - capture);
+    }
+    return GST_PAD_PROBE_OK;
+}
+
+static void latency_probe_free(gpointer user_data)
+{
+    delete static_cast<LatencyProbe*>(user_data);
+}
+
+gulong add_latency_probe(GstElement *element, const char *pad_name, LatencyTracer::Point point,
+                         LatencyTracer *tracer)
+{
+    GstPad *pad = gst_element_get_static_pad(element, pad_name);
+    if (!pad) {
+        return 0;
+    }
+    gulong id = gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER, latency_probe_cb,
+                                  new LatencyProbe{element, point, tracer}, latency_probe_free);
+    gst_object_unref(pad);
+    return id;
+}
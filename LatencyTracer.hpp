@@ -0,0 +1,74 @@
+#pragma once
+
+#include <gst/gst.h>
+
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+/**
+ * @brief Capture-to-X latency percentiles of the most recent frames
+ *
+ * Every sample is "pipeline clock now − capture time of the frame", where the capture
+ * time is the camera buffer's base_time + PTS. Each measuring point keeps a rolling
+ * window of samples; summary() sorts a copy, so recording stays O(1) on the frame path.
+ */
+class LatencyTracer {
+public:
+    enum Point {
+        INFER_START,   ///< Frame handed to the NPU (after preprocessing)
+        ELEMENT_IN,    ///< Frame entered the hailodepth element (before preprocessing)
+        PUSH,          ///< Composed frame pushed to appsrc / left hailodepth
+        ENCODER_OUT,   ///< Encoded frame leaving x264enc
+        POINT_COUNT
+    };
+
+    struct Summary {
+        uint64_t count;   ///< Samples recorded since start (the percentiles cover the last window())
+        double p50_ms;
+        double p95_ms;
+        double p99_ms;
+        double max_ms;    ///< Worst sample since start
+        double sum_ms;    ///< Sum of every sample since start
+    };
+
+    /// Keeps the last window samples per point
+    explicit LatencyTracer(size_t window = 4096);
+
+    /// Thread-safe; GST_CLOCK_TIME_NONE samples are ignored
+    void record(Point point, GstClockTime latency);
+
+    Summary summary(Point point) const;
+
+    /// One line per point with samples: p50 / p95 / p99 / max
+    void report(std::ostream &out) const;
+
+    size_t window() const { return m_window; }
+
+    static const char *point_name(Point point);
+
+private:
+    struct Series {
+        std::vector<GstClockTime> samples;  ///< Ring of the last m_window samples
+        size_t next = 0;
+        uint64_t count = 0;
+        GstClockTime max = 0;
+        GstClockTime sum = 0;
+    };
+
+    mutable std::mutex m_mutex;
+    Series m_series[POINT_COUNT];
+    size_t m_window;
+};
+
+/**
+ * @brief Records capture→now at point for every buffer passing element's pad
+ *
+ * The buffer PTS must be in element's running time (true for any buffer stamped from
+ * the camera capture time).
+ *
+ * @return Probe id, or 0 if the pad does not exist
+ */
+gulong add_latency_probe(GstElement *element, const char *pad_name, LatencyTracer::Point point,
+                         LatencyTracer *tracer);
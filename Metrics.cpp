@@ -0,0 +1,272 @@
+#include "Metrics.hpp"
+#include "Histogram.hpp"
+#include "LatencyTracer.hpp"
+#include "StagedPipeline.hpp"
+#include "TraceLog.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+// 히스토그램 버킷 경계 (ms): 30fps 프레임 예산(33ms) 주변을 촘촘하게
+const double BUCKET_BOUNDS_MS[] = {0.5, 1, 2, 5, 10, 20, 33, 50, 75, 100, 150, 250, 500, 1000};
+
+void write_counter(std::ostringstream &out, const char *name, const char *help, uint64_t value)
+{
+    out << "# HELP " << name << " " << help << "\n"
+        << "# TYPE " << name << " counter\n"
+        << name << " " << value << "\n";
+}
+
+void write_histograms(std::ostringstream &out, const StageHistograms &histograms)
+{
+    const char *name = "hailodepth_stage_latency_seconds";
+    out << "# HELP " << name << " Per-frame stage duration\n"
+        << "# TYPE " << name << " histogram\n";
+    for (int s = 0; s < StageHistograms::STAGE_COUNT; s++) {
+        const auto stage = static_cast<StageHistograms::Stage>(s);
+        const LatencyHistogram &histogram = histograms.stage(stage);
+        const std::vector<uint64_t> counts = histogram.counts();
+        const char *label = StageHistograms::stage_name(stage);
+
+        // 누적 개수: 경계값이 속한 버킷까지 (버킷 해상도 1.6% 이내)
+        uint64_t seen = 0;
+        size_t bucket = 0;
+        for (double bound_ms : BUCKET_BOUNDS_MS) {
+            const size_t last = LatencyHistogram::bucket_of(static_cast<uint64_t>(bound_ms * 1000.0));
+            for (; bucket <= last; bucket++) {
+                seen += counts[bucket];
+            }
+            out << name << "_bucket{stage=\"" << label << "\",le=\"" << bound_ms / 1000.0 << "\"} " << seen << "\n";
+        }
+        for (; bucket < counts.size(); bucket++) {
+            seen += counts[bucket];
+        }
+        out << name << "_bucket{stage=\"" << label << "\",le=\"+Inf\"} " << seen << "\n"
+            << name << "_sum{stage=\"" << label << "\"} " << histogram.sum_us() / 1e6 << "\n"
+            << name << "_count{stage=\"" << label << "\"} " << seen << "\n";
+    }
+}
+
+void write_capture_latency(std::ostringstream &out, const LatencyTracer &latency)
+{
+    // summary: 분위수는 최근 window() 프레임, _sum / _count는 시작 이후 누적
+    const char *name = "hailodepth_capture_latency_seconds";
+    out << "# HELP " << name << " Capture-to-point latency (quantiles over the last " << latency.window()
+        << " frames)\n"
+        << "# TYPE " << name << " summary\n";
+    for (int p = 0; p < LatencyTracer::POINT_COUNT; p++) {
+        const auto point = static_cast<LatencyTracer::Point>(p);
+        const LatencyTracer::Summary summary = latency.summary(point);
+        if (summary.count == 0) {
+            continue;
+        }
+        const char *label = LatencyTracer::point_name(point);
+        out << name << "{point=\"" << label << "\",quantile=\"0.5\"} " << summary.p50_ms / 1000.0 << "\n"
+            << name << "{point=\"" << label << "\",quantile=\"0.95\"} " << summary.p95_ms / 1000.0 << "\n"
+            << name << "{point=\"" << label << "\",quantile=\"0.99\"} " << summary.p99_ms / 1000.0 << "\n"
+            << name << "_sum{point=\"" << label << "\"} " << summary.sum_ms / 1000.0 << "\n"
+            << name << "_count{point=\"" << label << "\"} " << summary.count << "\n";
+    }
+}
+
+void write_staged(std::ostringstream &out, const StagedPipeline &staged)
+{
+    const std::vector<StageStats> stats = staged.stats();
+    struct Family {
+        const char *name;
+        const char *type;
+        const char *help;
+        uint64_t StageStats::*counter;
+        size_t StageStats::*size;
+    };
+    const Family families[] = {
+        {"hailodepth_stage_frames_total", "counter", "Frames a pipeline stage handed downstream", &StageStats::frames, nullptr},
+        {"hailodepth_stage_dropped_total", "counter", "Frames discarded by the drop policy", &StageStats::dropped, nullptr},
+        {"hailodepth_stage_stalls_total", "counter", "Waits for downstream space", &StageStats::stalls, nullptr},
+        {"hailodepth_stage_queue_depth", "gauge", "Frames queued in front of the next stage", nullptr, &StageStats::queue_depth},
+        {"hailodepth_stage_queue_capacity", "gauge", "Capacity of the queue in front of the next stage", nullptr, &StageStats::queue_capacity},
+    };
+    for (const Family &family : families) {
+        out << "# HELP " << family.name << " " << family.help << "\n"
+            << "# TYPE " << family.name << " " << family.type << "\n";
+        for (const StageStats &stage : stats) {
+            out << family.name << "{stage=\"" << stage.name << "\"} "
+                << (family.counter ? stage.*family.counter : stage.*family.size) << "\n";
+        }
+    }
+}
+
+}  // namespace
+
+std::string render_metrics(const MetricsSources &sources)
+{
+    std::ostringstream out;
+    if (const PipelineMetrics *m = sources.counters) {
+        const uint64_t camera = m->camera_frames.load(std::memory_order_relaxed);
+        const uint64_t in = m->frames_in.load(std::memory_order_relaxed);
+        write_counter(out, "hailodepth_camera_frames_total", "Buffers that reached the appsink", camera);
+        write_counter(out, "hailodepth_frames_in_total", "Camera samples pulled for inference", in);
+        write_counter(out, "hailodepth_frames_out_total", "Depth frames pushed downstream",
+                      m->frames_out.load(std::memory_order_relaxed));
+        // appsink(drop=TRUE, max-buffers=1)는 조용히 버린다: 도착 − 꺼냄 − 대기 중 1장
+        write_counter(out, "hailodepth_appsink_dropped_total", "Camera buffers the appsink discarded",
+                      camera > in + 1 ? camera - in - 1 : 0);
+        write_counter(out, "hailodepth_infer_failures_total", "Inference jobs that failed",
+                      m->infer_failures.load(std::memory_order_relaxed));
+        write_counter(out, "hailodepth_push_failures_total", "Frames the output element refused",
+                      m->push_failures.load(std::memory_order_relaxed));
+        write_counter(out, "hailodepth_map_failures_total", "Camera buffers dropped because they could not be mapped",
+                      m->map_failures.load(std::memory_order_relaxed));
+    }
+    if (sources.histograms) {
+        write_histograms(out, *sources.histograms);
+    }
+    if (sources.latency) {
+        write_capture_latency(out, *sources.latency);
+    }
+    if (sources.staged) {
+        write_staged(out, *sources.staged);
+    }
+    if (sources.trace) {
+        write_counter(out, "hailodepth_trace_dropped_total", "Frames missing from the timing trace (ring full)",
+                      sources.trace->dropped());
+    }
+    return out.str();
+}
+
+static GstPadProbeReturn count_buffer_probe(GstPad *, GstPadProbeInfo *, gpointer user_data)
+{
+    static_cast<std::atomic<uint64_t>*>(user_data)->fetch_add(1, std::memory_order_relaxed);
+    return GST_PAD_PROBE_OK;
+}
+
+void add_buffer_counter(GstElement *element, const char *pad_name, std::atomic<uint64_t> *counter)
+{
+    GstPad *pad = gst_element_get_static_pad(element, pad_name);
+    if (!pad) {
+        std::cerr << "[ERROR] No pad " << pad_name << " on " << GST_ELEMENT_NAME(element) << std::endl;
+        return;
+    }
+    gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER, count_buffer_probe, counter, nullptr);
+    gst_object_unref(pad);
+}
+
+// ==================== MetricsServer ====================
+
+MetricsServer::MetricsServer(Renderer renderer) :
+    m_renderer(std::move(renderer))
+{}
+
+MetricsServer::~MetricsServer()
+{
+    stop();
+}
+
+bool MetricsServer::start(const std::string &bind_address, int port)
+{
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    if (inet_pton(AF_INET, bind_address.c_str(), &addr.sin_addr) != 1) {
+        std::cerr << "[ERROR] Invalid metrics bind address: " << bind_address << std::endl;
+        return false;
+    }
+
+    m_listen_fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (m_listen_fd < 0) {
+        std::cerr << "[ERROR] metrics socket(): " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    const int reuse = 1;
+    setsockopt(m_listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    if (bind(m_listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || listen(m_listen_fd, 4) < 0) {
+        std::cerr << "[ERROR] Failed to listen on " << bind_address << ":" << port << ": "
+                  << std::strerror(errno) << std::endl;
+        close(m_listen_fd);
+        m_listen_fd = -1;
+        return false;
+    }
+
+    m_stop = false;
+    m_thread = std::thread(&MetricsServer::serve_loop, this);
+    std::cout << "📊 Metrics: http://" << bind_address << ":" << port << "/metrics" << std::endl;
+    return true;
+}
+
+void MetricsServer::stop()
+{
+    if (m_listen_fd < 0) {
+        return;
+    }
+    m_stop = true;
+    m_thread.join();
+    close(m_listen_fd);
+    m_listen_fd = -1;
+}
+
+void MetricsServer::serve_loop()
+{
+    pollfd listen_poll = {m_listen_fd, POLLIN, 0};
+    while (!m_stop.load(std::memory_order_acquire)) {
+        // 200ms마다 종료 플래그 확인
+        if (poll(&listen_poll, 1, 200) <= 0) {
+            continue;
+        }
+        const int client = accept4(m_listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (client < 0) {
+            continue;
+        }
+        handle(client);
+        close(client);
+    }
+}
+
+void MetricsServer::handle(int client)
+{
+    // 요청 줄만 필요: 헤더 끝까지 최대 1초, 4KB
+    std::string request;
+    char buffer[1024];
+    pollfd client_poll = {client, POLLIN, 0};
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < 4096) {
+        if (poll(&client_poll, 1, 1000) <= 0) {
+            return;
+        }
+        const ssize_t n = recv(client, buffer, sizeof(buffer), 0);
+        if (n <= 0) {
+            return;
+        }
+        request.append(buffer, static_cast<size_t>(n));
+    }
+
+    std::string status = "404 Not Found";
+    std::string body = "not found\n";
+    if (request.compare(0, 13, "GET /metrics ") == 0 || request.compare(0, 13, "GET /metrics?") == 0) {
+        status = "200 OK";
+        body = m_renderer();
+    }
+    std::ostringstream response;
+    response << "HTTP/1.1 " << status << "\r\n"
+             << "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+             << "Content-Length: " << body.size() << "\r\n"
+             << "Connection: close\r\n\r\n"
+             << body;
+    const std::string data = response.str();
+    size_t sent = 0;
+    while (sent < data.size()) {
+        const ssize_t n = send(client, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) {
+            return;
+        }
+        sent += static_cast<size_t>(n);
+    }
+}
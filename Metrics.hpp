@@ -0,0 +1,83 @@
+#pragma once
+
+#include <gst/gst.h>
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+
+class StageHistograms;
+class LatencyTracer;
+class StagedPipeline;
+class TraceLog;
+
+/**
+ * @brief Pipeline counters, incremented with relaxed atomics on the frame path
+ */
+struct PipelineMetrics {
+    std::atomic<uint64_t> camera_frames{0};    ///< Buffers that reached the appsink (counted by a pad probe)
+    std::atomic<uint64_t> frames_in{0};        ///< Samples pulled from the appsink
+    std::atomic<uint64_t> frames_out{0};       ///< Frames pushed downstream successfully
+    std::atomic<uint64_t> infer_failures{0};
+    std::atomic<uint64_t> push_failures{0};
+    std::atomic<uint64_t> map_failures{0};     ///< Camera buffers dropped because they could not be mapped
+};
+
+/**
+ * @brief Where render_metrics() reads from (any pointer may be nullptr)
+ */
+struct MetricsSources {
+    const PipelineMetrics *counters;
+    const StageHistograms *histograms;
+    const LatencyTracer *latency;
+    const StagedPipeline *staged;
+    const TraceLog *trace;
+};
+
+/**
+ * @brief Renders every source in Prometheus text exposition format (version 0.0.4)
+ *
+ * Only reads atomics and snapshots, so it can run on any thread while frames flow.
+ */
+std::string render_metrics(const MetricsSources &sources);
+
+/**
+ * @brief Counts buffers passing element's pad into counter (buffer pad probe)
+ */
+void add_buffer_counter(GstElement *element, const char *pad_name, std::atomic<uint64_t> *counter);
+
+/**
+ * @brief Minimal HTTP listener serving GET /metrics from a side thread
+ *
+ * One poll()-driven thread accepts a connection at a time, answers it and closes it;
+ * nothing here runs on, or waits for, the frame path. Other paths get 404.
+ */
+class MetricsServer {
+public:
+    using Renderer = std::function<std::string()>;
+
+    explicit MetricsServer(Renderer renderer);
+    ~MetricsServer();
+
+    MetricsServer(const MetricsServer &) = delete;
+    MetricsServer &operator=(const MetricsServer &) = delete;
+
+    /**
+     * @param[in] bind_address IPv4 address to listen on ("127.0.0.1" = local only, "0.0.0.0" = all)
+     * @param[in] port TCP port
+     * @return false if the socket cannot be bound
+     */
+    bool start(const std::string &bind_address, int port);
+    void stop();
+
+private:
+    void serve_loop();
+    void handle(int client);
+
+    Renderer m_renderer;
+    int m_listen_fd = -1;
+    std::atomic<bool> m_stop{false};
+    std::thread m_thread;
+};
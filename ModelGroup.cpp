@@ -0,0 +1,429 @@
+#include "ModelGroup.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+
+// ==================== DeviceMeter ====================
+
+DeviceMeter::DeviceMeter() :
+    m_created(std::chrono::steady_clock::now())
+{}
+
+size_t DeviceMeter::add_model()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_models.emplace_back();
+    return m_models.size() - 1;
+}
+
+DeviceMeter::Token DeviceMeter::begin(size_t model)
+{
+    const auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Model &m = m_models[model];
+    bool shared = false;
+    for (size_t i = 0; i < m_models.size(); i++) {
+        shared = shared || (i != model && m_models[i].in_flight > 0);
+    }
+    if (m.in_flight++ == 0) {
+        m.busy_since = now;
+    }
+    const Token token{now, m_begins - m.begins, shared};
+    m.begins++;
+    m_begins++;
+    return token;
+}
+
+void DeviceMeter::end(size_t model, const Token &token, size_t frames)
+{
+    const auto now = std::chrono::steady_clock::now();
+    const double ms = std::chrono::duration<double, std::milli>(now - token.start).count();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Model &m = m_models[model];
+    if (--m.in_flight == 0) {
+        m.busy_s += std::chrono::duration<double>(now - m.busy_since).count();
+    }
+    // 시작할 때 다른 모델이 돌고 있었거나, 도는 동안 다른 모델 프레임이 들어왔으면 shared
+    bool shared = token.shared || (m_begins - m.begins) != token.others;
+    for (size_t i = 0; i < m_models.size() && !shared; i++) {
+        shared = i != model && m_models[i].in_flight > 0;
+    }
+    m.frames += frames;
+    if (shared) {
+        m.shared_ms += ms;
+        m.shared++;
+    } else {
+        m.solo_ms += ms;
+        m.solo++;
+    }
+}
+
+DeviceMeter::Usage DeviceMeter::usage(size_t model) const
+{
+    const auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const Model &m = m_models[model];
+    double busy_s = m.busy_s;
+    if (m.in_flight > 0) {
+        busy_s += std::chrono::duration<double>(now - m.busy_since).count();
+    }
+    const double wall_s = std::max(std::chrono::duration<double>(now - m_created).count(), 1e-6);
+    return Usage{m.frames, busy_s / wall_s,
+                 m.solo ? m.solo_ms / m.solo : 0.0, m.solo,
+                 m.shared ? m.shared_ms / m.shared : 0.0, m.shared};
+}
+
+// ==================== MeteredBackend ====================
+
+MeteredBackend::MeteredBackend(std::unique_ptr<InferenceBackend> backend, std::shared_ptr<DeviceMeter> meter,
+                               size_t model) :
+    m_backend(std::move(backend)),
+    m_meter(std::move(meter)),
+    m_model(model)
+{}
+
+hailo_status MeteredBackend::infer(const MemoryView &input, MemoryView output, size_t frames_count)
+{
+    const DeviceMeter::Token token = m_meter->begin(m_model);
+    const hailo_status status = m_backend->infer(input, output, frames_count);
+    m_meter->end(m_model, token, status == HAILO_SUCCESS ? frames_count : 0);
+    return status;
+}
+
+hailo_status MeteredBackend::write_input(const MemoryView &frame)
+{
+    {
+        // 결과는 쓴 순서대로 나오므로 read_output()이 앞에서부터 꺼낸다
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pending.push_back(m_meter->begin(m_model));
+    }
+    const hailo_status status = m_backend->write_input(frame);
+    if (status != HAILO_SUCCESS) {
+        DeviceMeter::Token token;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            token = m_pending.back();
+            m_pending.pop_back();
+        }
+        m_meter->end(m_model, token, 0);
+    }
+    return status;
+}
+
+hailo_status MeteredBackend::read_output(MemoryView frame)
+{
+    const hailo_status status = m_backend->read_output(frame);
+    if (status == HAILO_SUCCESS) {
+        DeviceMeter::Token token;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            token = m_pending.front();
+            m_pending.pop_front();
+        }
+        m_meter->end(m_model, token, 1);
+    }
+    return status;
+}
+
+// ==================== ModelRunner ====================
+
+ModelRunner::ModelRunner(const ModelSpec &spec, InferenceBackend &backend, double camera_fps) :
+    m_spec(spec),
+    m_backend(backend),
+    m_ratio((spec.fps > 0.0 && camera_fps > 0.0) ? std::min(spec.fps / camera_fps, 1.0) : 1.0),
+    m_batch(static_cast<size_t>(std::max(spec.batch_size, 1)))
+{}
+
+ModelRunner::~ModelRunner()
+{
+    stop();
+}
+
+bool ModelRunner::start()
+{
+    m_input = make_aligned_buffer(m_backend.input_frame_size() * m_batch);
+    m_output = make_aligned_buffer(m_backend.output_frame_size() * m_batch);
+    if (!m_input || !m_output) {
+        return false;
+    }
+    // 출력 텐서 형식은 모델마다 달라서 raw 바이트 한 줄로 싣는다 (width = 출력 바이트 수)
+    if (!m_spec.ring.empty()) {
+        if (!m_ring.create(m_spec.ring, static_cast<uint32_t>(m_backend.output_frame_size()), 1, 8, false)) {
+            return false;
+        }
+        float scale, zero_point;
+        m_backend.output_quantization(scale, zero_point);
+        m_ring.set_quantization(scale, zero_point);
+    }
+    m_stop = false;
+    m_thread = std::thread(&ModelRunner::run, this);
+    return true;
+}
+
+void ModelRunner::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    m_ring.close();
+}
+
+void ModelRunner::offer(const cv::Mat &frame, uint64_t frame_id, uint64_t capture_ns)
+{
+    bool wake = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stats.offered++;
+        // fps / 카메라 fps 만큼 고르게 남긴다 (15 / 30 → 한 프레임 걸러 하나)
+        m_credit += m_ratio;
+        if (m_credit < 1.0) {
+            return;
+        }
+        m_credit -= 1.0;
+        m_stats.accepted++;
+        if (m_has_pending) {
+            m_stats.skipped++;  // 러너가 아직 못 가져간 프레임은 새 프레임으로 덮어쓴다
+        }
+        frame.copyTo(m_pending);
+        m_pending_id = frame_id;
+        m_pending_capture = capture_ns;
+        m_has_pending = true;
+        wake = true;
+    }
+    if (wake) {
+        m_cv.notify_one();
+    }
+}
+
+ModelRunner::Stats ModelRunner::stats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+void ModelRunner::run()
+{
+    const size_t input_size = m_backend.input_frame_size();
+    const size_t output_size = m_backend.output_frame_size();
+    std::vector<uint64_t> frame_ids(m_batch);
+    std::vector<uint64_t> capture_ns(m_batch);
+    size_t filled = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [this] { return m_stop || m_has_pending; });
+            if (m_stop) {
+                break;
+            }
+            std::swap(m_pending, m_work);
+            frame_ids[filled] = m_pending_id;
+            capture_ns[filled] = m_pending_capture;
+            m_has_pending = false;
+        }
+
+        cv::Mat input(m_spec.height, m_spec.width, CV_8UC3, m_input.get() + filled * input_size);
+        cv::resize(m_work, input, input.size(), 0, 0, cv::INTER_AREA);
+        if (++filled < m_batch) {
+            continue;
+        }
+
+        const auto t_start = std::chrono::steady_clock::now();
+        const hailo_status status = m_backend.infer(MemoryView(m_input.get(), input_size * filled),
+                                                    MemoryView(m_output.get(), output_size * filled), filled);
+        const auto t_end = std::chrono::steady_clock::now();
+        if (status == HAILO_SUCCESS) {
+            m_infer_us.record(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::microseconds>(t_end - t_start).count()));
+            if (!m_spec.ring.empty()) {
+                for (size_t i = 0; i < filled; i++) {
+                    m_ring.publish(m_output.get() + i * output_size, frame_ids[i], capture_ns[i]);
+                }
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            (status == HAILO_SUCCESS ? m_stats.inferred : m_stats.failures) += filled;
+        }
+        filled = 0;
+    }
+}
+
+// ==================== ModelGroup ====================
+
+/**
+ * @brief Configures the depth model and every models entry on one device
+ *
+ * @param[in] config Configuration with a non-empty models list; inference.backend is hailo or cpu
+ * @return On success, returns the group (depth backend not yet released)
+ *         On failure, returns hailo_status error code
+ */
+Expected<std::unique_ptr<ModelGroup>> ModelGroup::create(const Config &config)
+{
+    const bool cpu = config.backend == "cpu";
+    if (!cpu && !config.backend.empty() && config.backend != "hailo") {
+        std::cerr << "[ERROR] models need inference.backend hailo or cpu (got " << config.backend << ")" << std::endl;
+        return make_unexpected(HAILO_INVALID_ARGUMENT);
+    }
+
+    std::unique_ptr<ModelGroup> group(new ModelGroup());
+    group->m_meter = std::make_shared<DeviceMeter>();
+
+    auto device = create_shared_device(config);
+    if (!device) {
+        return make_unexpected(device.status());
+    }
+    std::shared_ptr<VDevice> vdevice = device.value().vdevice;
+    group->m_sim = device.value().sim;
+
+    // 모델 하나를 공유 장치 위에 만들고 스케줄링 설정 + 측정 래퍼를 씌운다
+    auto make = [&](const std::string &name, const Config &model_config, int priority, double timeout_ms)
+        -> Expected<std::unique_ptr<InferenceBackend>> {
+        const uint32_t threshold = static_cast<uint32_t>(std::max(model_config.batch_size, 1));
+        const auto timeout = std::chrono::milliseconds(static_cast<int64_t>(std::max(timeout_ms, 0.0)));
+        std::unique_ptr<InferenceBackend> backend;
+        if (cpu) {
+            auto created = CpuBackend::create(model_config);
+            if (!created) {
+                return make_unexpected(created.status());
+            }
+            group->m_sim_ids.push_back(group->m_sim->add_model(priority, threshold, timeout));
+            created.value()->share_device(group->m_sim, group->m_sim_ids.back());
+            backend = created.release();
+        } else {
+            auto created = HailoBackend::create(model_config, vdevice);
+            if (!created) {
+                std::cerr << "Failed to configure " << name << " (" << model_config.hef_path << ")" << std::endl;
+                return make_unexpected(created.status());
+            }
+            const hailo_status status = created.value()->set_scheduling(priority, threshold, timeout);
+            if (status != HAILO_SUCCESS) {
+                return make_unexpected(status);
+            }
+            backend = created.release();
+        }
+        group->m_names.push_back(name);
+        return std::unique_ptr<InferenceBackend>(
+            new MeteredBackend(std::move(backend), group->m_meter, group->m_meter->add_model()));
+    };
+
+    auto depth = make("depth", config, config.model_priority, config.batch_timeout_ms);
+    if (!depth) {
+        return make_unexpected(depth.status());
+    }
+    group->m_depth = depth.release();
+
+    for (const ModelSpec &spec : config.models) {
+        if (spec.width <= 0 || spec.height <= 0) {
+            std::cerr << "[ERROR] models entry " << spec.name << " needs input_size width/height" << std::endl;
+            return make_unexpected(HAILO_INVALID_ARGUMENT);
+        }
+        Config model_config = config;
+        model_config.hef_path = spec.hef_path;
+        model_config.network_group = spec.network_group;
+        model_config.model_width = spec.width;
+        model_config.model_height = spec.height;
+        model_config.batch_size = spec.batch_size;
+        model_config.cpu_latency_ms = spec.cpu_latency_ms >= 0.0 ? spec.cpu_latency_ms : config.cpu_latency_ms;
+        model_config.cpu_latency_log.clear();  // latency_log는 depth 모델의 측정값
+
+        auto backend = make(spec.name, model_config, spec.priority,
+                            spec.timeout_ms >= 0.0 ? spec.timeout_ms : config.batch_timeout_ms);
+        if (!backend) {
+            return make_unexpected(backend.status());
+        }
+        const size_t expected_size = static_cast<size_t>(spec.width) * spec.height * 3;
+        if (backend.value()->input_frame_size() != expected_size) {
+            std::cerr << "[ERROR] " << spec.name << " input frame size mismatch! Frame: "
+                      << backend.value()->input_frame_size() << ", Expected: " << expected_size
+                      << " (RGB " << spec.width << "x" << spec.height << ")" << std::endl;
+            return make_unexpected(HAILO_INVALID_ARGUMENT);
+        }
+        group->m_runners.emplace_back(new ModelRunner(spec, *backend.value(), config.frame_rate));
+        group->m_backends.push_back(backend.release());
+    }
+
+    std::cout << "모델 그룹: depth";
+    for (const ModelSpec &spec : config.models) {
+        std::cout << " + " << spec.name;
+    }
+    if (cpu) {
+        std::cout << " | CPU 시뮬레이션 장치 (전환 " << config.cpu_switch_ms << " ms)" << std::endl;
+    } else {
+        std::cout << " | HailoRT 모델 스케줄러" << std::endl;
+    }
+    return std::move(group);
+}
+
+ModelGroup::~ModelGroup()
+{
+    stop();
+}
+
+bool ModelGroup::start()
+{
+    for (std::unique_ptr<ModelRunner> &runner : m_runners) {
+        if (!runner->start()) {
+            std::cerr << "[ERROR] Failed to start model " << runner->spec().name << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+void ModelGroup::stop()
+{
+    for (std::unique_ptr<InferenceBackend> &backend : m_backends) {
+        backend->abort();  // infer() 중인 러너를 깨운다
+    }
+    for (std::unique_ptr<ModelRunner> &runner : m_runners) {
+        runner->stop();
+    }
+}
+
+void ModelGroup::offer(const cv::Mat &frame, uint64_t frame_id, uint64_t capture_ns)
+{
+    for (std::unique_ptr<ModelRunner> &runner : m_runners) {
+        runner->offer(frame, frame_id, capture_ns);
+    }
+}
+
+void ModelGroup::report(std::ostream &out) const
+{
+    out << std::fixed << std::setprecision(1);
+    for (size_t i = 0; i < m_names.size(); i++) {
+        const DeviceMeter::Usage usage = m_meter->usage(i);
+        out << "   [" << m_names[i] << "] 프레임 " << usage.frames << " | 점유 " << usage.occupancy * 100.0
+            << "% | 지연 solo " << usage.solo_ms << " ms (" << usage.solo << ") / shared " << usage.shared_ms
+            << " ms (" << usage.shared << ")";
+        if (usage.solo > 0 && usage.shared > 0) {
+            out << " | 전환 비용 ≈ " << std::showpos << usage.shared_ms - usage.solo_ms << std::noshowpos << " ms";
+        }
+        if (i > 0) {
+            const ModelRunner &runner = *m_runners[i - 1];
+            const ModelRunner::Stats stats = runner.stats();
+            const LatencyHistogram::Snapshot infer = runner.infer_latency();
+            out << " | 입력 " << stats.accepted << "/" << stats.offered << " (건너뜀 " << stats.skipped << ", 실패 "
+                << stats.failures << ") | infer p50 " << infer.p50_us / 1000.0 << " / p99 " << infer.p99_us / 1000.0
+                << " ms";
+        }
+        out << std::endl;
+        if (m_sim) {
+            const SimDevice::Usage device = m_sim->usage(m_sim_ids[i]);
+            out << "      장치 사용 " << device.busy_ms / std::max(m_sim->elapsed_ms(), 1e-3) * 100.0 << "% | 전환 "
+                << device.switches << "회" << std::endl;
+        }
+    }
+    if (m_sim) {
+        const double switch_ms = m_sim->switch_total_ms();
+        out << "   장치 전환 합계 " << switch_ms << " ms (" << switch_ms / std::max(m_sim->elapsed_ms(), 1e-3) * 100.0
+            << "%)" << std::endl;
+    }
+    out << std::defaultfloat;
+}
@@ -0,0 +1,200 @@
+#pragma once
+
+#include "DepthRing.hpp"
+#include "Histogram.hpp"
+#include "InferBackend.hpp"
+
+#include <opencv2/opencv.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Host-side view of how several models share one device
+ *
+ * Every frame is timed from the moment it is handed to the device until its
+ * result is back. A model's occupancy is the share of wall time it has at least one
+ * frame on the device. A frame is "shared" when another model had frames on the
+ * device at any point of its life and "solo" otherwise; the difference of the two
+ * mean latencies estimates what the switching costs each frame. Works the same for
+ * the HailoRT scheduler and the CPU stand-in.
+ */
+class DeviceMeter {
+public:
+    struct Token {
+        std::chrono::steady_clock::time_point start;
+        uint64_t others;          ///< Other models' begin() count at the start
+        bool shared;              ///< Another model had frames in flight at the start
+    };
+
+    struct Usage {
+        uint64_t frames;
+        double occupancy;         ///< Share of wall time with a frame in flight (0..1)
+        double solo_ms;           ///< Mean latency of frames that had the device alone
+        uint64_t solo;
+        double shared_ms;         ///< Mean latency of frames that overlapped another model
+        uint64_t shared;
+    };
+
+    DeviceMeter();
+
+    size_t add_model();
+    /// A frame (or batch) of model is handed to the device
+    Token begin(size_t model);
+    /// Its frames results are back
+    void end(size_t model, const Token &token, size_t frames);
+    Usage usage(size_t model) const;
+
+private:
+    struct Model {
+        uint64_t in_flight = 0;
+        uint64_t begins = 0;
+        std::chrono::steady_clock::time_point busy_since;
+        double busy_s = 0.0;
+        uint64_t frames = 0;
+        double solo_ms = 0.0;
+        uint64_t solo = 0;
+        double shared_ms = 0.0;
+        uint64_t shared = 0;
+    };
+
+    const std::chrono::steady_clock::time_point m_created;
+    mutable std::mutex m_mutex;
+    std::vector<Model> m_models;
+    uint64_t m_begins = 0;        ///< begin() calls of all models
+};
+
+/**
+ * @brief InferenceBackend decorator feeding a DeviceMeter
+ */
+class MeteredBackend : public InferenceBackend {
+public:
+    MeteredBackend(std::unique_ptr<InferenceBackend> backend, std::shared_ptr<DeviceMeter> meter, size_t model);
+
+    size_t input_frame_size() const override { return m_backend->input_frame_size(); }
+    size_t output_frame_size() const override { return m_backend->output_frame_size(); }
+    hailo_status infer(const MemoryView &input, MemoryView output, size_t frames_count) override;
+    hailo_status write_input(const MemoryView &frame) override;
+    hailo_status read_output(MemoryView frame) override;
+    void abort() override { m_backend->abort(); }
+    void output_quantization(float &scale, float &zero_point) const override
+    {
+        m_backend->output_quantization(scale, zero_point);
+    }
+
+private:
+    std::unique_ptr<InferenceBackend> m_backend;
+    std::shared_ptr<DeviceMeter> m_meter;
+    size_t m_model;
+    std::mutex m_mutex;
+    std::deque<DeviceMeter::Token> m_pending;  ///< Written frames awaiting read_output(), oldest first
+};
+
+/**
+ * @brief Runs one extra model on camera frames at its target rate
+ *
+ * offer() is called on the frame path for every camera frame; it keeps fps / camera
+ * fps of them (evenly spaced) and copies the kept one into a one-frame mailbox, so a
+ * model that falls behind skips frames instead of stalling the depth pipeline. The
+ * runner thread resizes mailbox frames into its batch, runs infer() and publishes each
+ * raw output to the model's shared-memory ring.
+ */
+class ModelRunner {
+public:
+    struct Stats {
+        uint64_t offered;         ///< Camera frames seen
+        uint64_t accepted;        ///< Frames kept for the target rate
+        uint64_t skipped;         ///< Kept frames overwritten before the runner took them
+        uint64_t inferred;
+        uint64_t failures;
+    };
+
+    ModelRunner(const ModelSpec &spec, InferenceBackend &backend, double camera_fps);
+    ~ModelRunner();
+
+    ModelRunner(const ModelRunner &) = delete;
+    ModelRunner &operator=(const ModelRunner &) = delete;
+
+    bool start();
+    void stop();
+    void offer(const cv::Mat &frame, uint64_t frame_id, uint64_t capture_ns);
+
+    const ModelSpec &spec() const { return m_spec; }
+    Stats stats() const;
+    /// infer() call latency (one batch)
+    LatencyHistogram::Snapshot infer_latency() const { return m_infer_us.snapshot(); }
+
+private:
+    void run();
+
+    const ModelSpec m_spec;
+    InferenceBackend &m_backend;
+    const double m_ratio;         ///< Share of camera frames kept (1 = all)
+    const size_t m_batch;
+
+    AlignedBuffer m_input;
+    AlignedBuffer m_output;
+    DepthRingWriter m_ring;
+    LatencyHistogram m_infer_us;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    cv::Mat m_pending;            ///< Mailbox (written by offer())
+    cv::Mat m_work;               ///< Frame the runner is resizing (swapped with m_pending)
+    uint64_t m_pending_id = 0;
+    uint64_t m_pending_capture = 0;
+    bool m_has_pending = false;
+    double m_credit = 0.0;
+    Stats m_stats{0, 0, 0, 0, 0};
+    bool m_stop = false;
+    std::thread m_thread;
+};
+
+/**
+ * @brief The depth model and the models list configured on one device
+ *
+ * hailo: one VDevice with the HailoRT model scheduler; every model is its own network
+ * group with its own priority, threshold (= batch size) and timeout. cpu: the same
+ * scheduling simulated by a SimDevice, including a fixed switch cost. Every backend is
+ * wrapped in a MeteredBackend so per-model occupancy and switch cost are measured the
+ * same way on both.
+ */
+class ModelGroup {
+public:
+    static Expected<std::unique_ptr<ModelGroup>> create(const Config &config);
+    ~ModelGroup();
+
+    ModelGroup(const ModelGroup &) = delete;
+    ModelGroup &operator=(const ModelGroup &) = delete;
+
+    /// The depth model's backend on the shared device (callable once; the caller owns it)
+    std::unique_ptr<InferenceBackend> release_depth() { return std::move(m_depth); }
+
+    /// Creates the output rings and starts one thread per extra model
+    bool start();
+    void stop();
+
+    /// Hands a camera frame to every extra model (frame path, never blocks on inference)
+    void offer(const cv::Mat &frame, uint64_t frame_id, uint64_t capture_ns);
+
+    /// Per-model frames, occupancy, solo / shared latency and switch cost
+    void report(std::ostream &out) const;
+
+private:
+    ModelGroup() = default;
+
+    std::shared_ptr<DeviceMeter> m_meter;
+    std::shared_ptr<SimDevice> m_sim;                 ///< cpu backend only
+    std::vector<size_t> m_sim_ids;                    ///< SimDevice model id per meter model
+    std::vector<std::string> m_names;                 ///< Meter model order: depth first
+    std::unique_ptr<InferenceBackend> m_depth;
+    std::vector<std::unique_ptr<InferenceBackend>> m_backends;  ///< One per models entry
+    std::vector<std::unique_ptr<ModelRunner>> m_runners;
+};
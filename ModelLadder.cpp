@@ -0,0 +1,449 @@
+#include "ModelLadder.hpp"
+#include "StagedPipeline.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+// ==================== LadderBackend ====================
+
+Expected<std::unique_ptr<LadderBackend>> LadderBackend::create(const Config &config)
+{
+    const bool cpu = config.backend == "cpu";
+    if (!cpu && !config.backend.empty() && config.backend != "hailo") {
+        std::cerr << "[ERROR] model.ladder needs inference.backend hailo or cpu (got " << config.backend << ")" << std::endl;
+        return make_unexpected(HAILO_INVALID_ARGUMENT);
+    }
+
+    std::unique_ptr<LadderBackend> ladder(new LadderBackend());
+    ladder->m_specs = config.ladder;
+    for (const ModelRung &rung : ladder->m_specs) {
+        if (rung.width <= 0 || rung.height <= 0) {
+            std::cerr << "[ERROR] model.ladder entries need width/height" << std::endl;
+            return make_unexpected(HAILO_INVALID_ARGUMENT);
+        }
+    }
+    // 큰 해상도부터: 인덱스가 커질수록 가벼운 모델
+    std::stable_sort(ladder->m_specs.begin(), ladder->m_specs.end(), [](const ModelRung &a, const ModelRung &b) {
+        return a.width * a.height > b.width * b.height;
+    });
+
+    // 모든 해상도의 network group을 한 장치에 올려 둔다
+    auto device = create_shared_device(config);
+    if (!device) {
+        return make_unexpected(device.status());
+    }
+    std::shared_ptr<VDevice> vdevice = device.value().vdevice;
+    ladder->m_sim = device.value().sim;
+
+    const uint32_t threshold = static_cast<uint32_t>(std::max(config.batch_size, 1));
+    const auto timeout = std::chrono::milliseconds(static_cast<int64_t>(std::max(config.batch_timeout_ms, 0.0)));
+    const double base_area = static_cast<double>(config.model_width) * config.model_height;
+    for (const ModelRung &rung : ladder->m_specs) {
+        Config rung_config = config;
+        rung_config.hef_path = rung.hef_path.empty() ? config.hef_path : rung.hef_path;
+        rung_config.model_width = rung.width;
+        rung_config.model_height = rung.height;
+
+        std::unique_ptr<InferenceBackend> backend;
+        if (cpu) {
+            // 지정이 없으면 model.input_size 기준 지연을 입력 면적에 비례해 나눈다
+            const double area = static_cast<double>(rung.width) * rung.height;
+            const bool base = rung.width == config.model_width && rung.height == config.model_height;
+            rung_config.cpu_latency_ms = rung.cpu_latency_ms >= 0.0 ? rung.cpu_latency_ms
+                                         : base_area > 0.0 ? config.cpu_latency_ms * area / base_area
+                                         : config.cpu_latency_ms;
+            if (!base || rung.cpu_latency_ms >= 0.0) {
+                rung_config.cpu_latency_log.clear();  // latency_log는 model.input_size 모델의 측정값
+            }
+            auto created = CpuBackend::create(rung_config);
+            if (!created) {
+                return make_unexpected(created.status());
+            }
+            created.value()->share_device(ladder->m_sim,
+                                          ladder->m_sim->add_model(config.model_priority, threshold, timeout));
+            backend = created.release();
+        } else {
+            auto created = HailoBackend::create(rung_config, vdevice);
+            if (!created) {
+                std::cerr << "Failed to configure ladder rung " << rung.width << "x" << rung.height << " ("
+                          << rung_config.hef_path << ")" << std::endl;
+                return make_unexpected(created.status());
+            }
+            const hailo_status status = created.value()->set_scheduling(config.model_priority, threshold, timeout);
+            if (status != HAILO_SUCCESS) {
+                return make_unexpected(status);
+            }
+            backend = created.release();
+        }
+
+        const size_t expected_size = static_cast<size_t>(rung.width) * rung.height * 3;
+        if (backend->input_frame_size() != expected_size) {
+            std::cerr << "[ERROR] Ladder rung " << rung.width << "x" << rung.height << " input frame size mismatch! Frame: "
+                      << backend->input_frame_size() << ", Expected: " << expected_size << std::endl;
+            return make_unexpected(HAILO_INVALID_ARGUMENT);
+        }
+        ladder->m_input_sizes.push_back(backend->input_frame_size());
+        ladder->m_output_sizes.push_back(backend->output_frame_size());
+        ladder->m_input_size = std::max(ladder->m_input_size, backend->input_frame_size());
+        ladder->m_output_size = std::max(ladder->m_output_size, backend->output_frame_size());
+        ladder->m_rungs.push_back(std::move(backend));
+    }
+
+    // 배치 안에서 해상도가 섞이거나 작은 모델이면 그 모델의 프레임 크기로 모아서 넘긴다
+    ladder->m_batch_frames = static_cast<size_t>(std::max(config.batch_size, 1));
+    ladder->m_batch_input = make_aligned_buffer(ladder->m_input_size * ladder->m_batch_frames);
+    ladder->m_batch_output = make_aligned_buffer(ladder->m_output_size * ladder->m_batch_frames);
+    if (!ladder->m_batch_input || !ladder->m_batch_output) {
+        return make_unexpected(HAILO_OUT_OF_HOST_MEMORY);
+    }
+
+    std::cout << "해상도 사다리:";
+    for (const ModelRung &rung : ladder->m_specs) {
+        std::cout << " " << rung.width << "x" << rung.height;
+    }
+    std::cout << " (" << (cpu ? "cpu" : "hailo") << ", 모두 미리 구성)" << std::endl;
+    return std::move(ladder);
+}
+
+void LadderBackend::assign(const InferJob &job, size_t rung)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_input_rung[job.input] = rung;
+    m_output_rung[job.output] = rung;
+}
+
+size_t LadderBackend::input_rung(const uint8_t *buffer)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_input_rung.find(buffer);
+    return it != m_input_rung.end() ? it->second : 0;
+}
+
+size_t LadderBackend::output_rung(const uint8_t *buffer)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_output_rung.find(buffer);
+    return it != m_output_rung.end() ? it->second : 0;
+}
+
+/**
+ * @brief Runs a batch whose frames may belong to different rungs
+ *
+ * Consecutive frames of the same rung go to that rung in one call. They are passed in
+ * place when the rung uses the full frame size, otherwise packed at the rung's frame
+ * size first and unpacked afterwards.
+ */
+hailo_status LadderBackend::infer(const MemoryView &input, MemoryView output, size_t frames_count)
+{
+    if (frames_count > m_batch_frames) {
+        return HAILO_INVALID_ARGUMENT;
+    }
+    uint8_t *in = const_cast<uint8_t*>(static_cast<const uint8_t*>(input.data()));
+    uint8_t *out = static_cast<uint8_t*>(output.data());
+
+    size_t first = 0;
+    while (first < frames_count) {
+        const size_t rung = input_rung(in + first * m_input_size);
+        size_t last = first + 1;
+        while (last < frames_count && input_rung(in + last * m_input_size) == rung) {
+            last++;
+        }
+        const size_t count = last - first;
+        const size_t in_size = m_input_sizes[rung];
+        const size_t out_size = m_output_sizes[rung];
+
+        hailo_status status;
+        if (in_size == m_input_size && out_size == m_output_size) {
+            status = m_rungs[rung]->infer(MemoryView(in + first * m_input_size, count * in_size),
+                                          MemoryView(out + first * m_output_size, count * out_size), count);
+        } else {
+            for (size_t i = 0; i < count; i++) {
+                std::memcpy(m_batch_input.get() + i * in_size, in + (first + i) * m_input_size, in_size);
+            }
+            status = m_rungs[rung]->infer(MemoryView(m_batch_input.get(), count * in_size),
+                                          MemoryView(m_batch_output.get(), count * out_size), count);
+            for (size_t i = 0; status == HAILO_SUCCESS && i < count; i++) {
+                std::memcpy(out + (first + i) * m_output_size, m_batch_output.get() + i * out_size, out_size);
+            }
+        }
+        if (status != HAILO_SUCCESS) {
+            return status;
+        }
+        first = last;
+    }
+    return HAILO_SUCCESS;
+}
+
+hailo_status LadderBackend::write_input(const MemoryView &frame)
+{
+    const uint8_t *data = static_cast<const uint8_t*>(frame.data());
+    const size_t rung = input_rung(data);
+    return m_rungs[rung]->write_input(MemoryView(const_cast<uint8_t*>(data), m_input_sizes[rung]));
+}
+
+hailo_status LadderBackend::read_output(MemoryView frame)
+{
+    uint8_t *data = static_cast<uint8_t*>(frame.data());
+    const size_t rung = output_rung(data);
+    return m_rungs[rung]->read_output(MemoryView(data, m_output_sizes[rung]));
+}
+
+void LadderBackend::abort()
+{
+    for (auto &rung : m_rungs) {
+        rung->abort();
+    }
+}
+
+void LadderBackend::output_quantization(float &scale, float &zero_point) const
+{
+    m_rungs.front()->output_quantization(scale, zero_point);
+}
+
+// ==================== QosController ====================
+
+/**
+ * @brief Percentile (ms) of what a histogram recorded since last, then moves last up to now
+ */
+static double window_percentile_ms(const std::vector<uint64_t> &now, std::vector<uint64_t> &last, double percentile)
+{
+    if (last.size() != now.size()) {
+        last.assign(now.size(), 0);
+    }
+    uint64_t total = 0;
+    for (size_t i = 0; i < now.size(); i++) {
+        total += now[i] - last[i];
+    }
+    double value_ms = 0.0;
+    if (total > 0) {
+        const uint64_t target = std::max<uint64_t>(static_cast<uint64_t>(std::ceil(total * percentile / 100.0)), 1);
+        uint64_t seen = 0;
+        for (size_t i = 0; i < now.size(); i++) {
+            seen += now[i] - last[i];
+            if (seen >= target) {
+                value_ms = LatencyHistogram::bucket_value(i) / 1000.0;
+                break;
+            }
+        }
+    }
+    last = now;
+    return value_ms;
+}
+
+QosController::QosController(const Config &config, LadderBackend &ladder, ResizeMethod method,
+                             StageHistograms &histograms, PipelineMetrics &metrics) :
+    m_config(config),
+    m_ladder(ladder),
+    m_histograms(histograms),
+    m_metrics(metrics),
+    m_created(std::chrono::steady_clock::now()),
+    m_frames(new std::atomic<uint64_t>[ladder.rung_count()]),
+    m_last_switch(m_created)
+{
+    // model.input_size와 같은 해상도에서 시작 (없으면 가장 큰 해상도)
+    size_t start = 0;
+    for (size_t i = 0; i < ladder.rung_count(); i++) {
+        const ModelRung &rung = ladder.rung(i);
+        m_resizers.emplace_back(new FrameResizer(cv::Size(config.video_inWidth, config.video_inHeight),
+                                                 cv::Size(rung.width, rung.height), method));
+        m_frames[i] = 0;
+        if (rung.width == config.model_width && rung.height == config.model_height) {
+            start = i;
+        }
+    }
+    m_active = start;
+    std::cout << "QoS: " << rung_name(start) << "에서 시작, " << config.qos_interval_s << " s마다 평가" << std::endl;
+}
+
+bool QosController::open_log()
+{
+    if (m_config.qos_log.empty()) {
+        return true;
+    }
+    m_log.open(m_config.qos_log, std::ios::trunc);
+    if (!m_log.is_open()) {
+        std::cerr << "[ERROR] Failed to open QoS log: " << m_config.qos_log << std::endl;
+        return false;
+    }
+    m_log << "time_s,from,to,reason,switch_ms,max_gap_ms" << std::endl;
+    return true;
+}
+
+std::string QosController::rung_name(size_t rung) const
+{
+    const ModelRung &spec = m_ladder.rung(rung);
+    return std::to_string(spec.width) + "x" + std::to_string(spec.height);
+}
+
+size_t QosController::begin_frame(const InferJob &job)
+{
+    const size_t rung = m_active.load(std::memory_order_relaxed);
+    m_ladder.assign(job, rung);
+    return rung;
+}
+
+void QosController::frame_done(size_t rung)
+{
+    m_frames[rung].fetch_add(1, std::memory_order_relaxed);
+    const auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_pending && m_switch.latency_ms < 0.0) {
+        // 결정 이후 결과 사이 최대 간격: 재구성 멈춤이 있었다면 여기에 나타난다
+        const auto since = m_any_done && m_last_done > m_switch.decided ? m_last_done : m_switch.decided;
+        m_switch.max_gap_ms = std::max(m_switch.max_gap_ms,
+                                       std::chrono::duration<double, std::milli>(now - since).count());
+        if (rung == m_switch.to) {
+            m_switch.latency_ms = std::chrono::duration<double, std::milli>(now - m_switch.decided).count();
+        }
+    }
+    m_last_done = now;
+    m_any_done = true;
+}
+
+void QosController::switch_to(size_t rung, const std::string &reason)
+{
+    const auto now = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_switch = Switch{std::chrono::duration<double>(now - m_created).count(), m_active.load(), rung, reason,
+                          now, -1.0, 0.0};
+        m_pending = true;
+    }
+    m_active.store(rung, std::memory_order_relaxed);
+    m_last_switch = now;
+    m_calm = 0;
+    m_switches++;
+}
+
+void QosController::flush_switch(bool final)
+{
+    Switch done;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_pending || (m_switch.latency_ms < 0.0 && !final)) {
+            return;
+        }
+        done = m_switch;
+        m_pending = false;
+    }
+
+    std::cout << std::fixed << std::setprecision(1) << "🔀 QoS " << rung_name(done.from) << " → " << rung_name(done.to)
+              << " | " << done.reason << " | 전환 ";
+    if (done.latency_ms >= 0.0) {
+        std::cout << done.latency_ms << " ms (결정 → 첫 결과)";
+    } else {
+        std::cout << "미완료 (새 해상도 결과 없음)";
+    }
+    std::cout << " | 최대 출력 간격 " << done.max_gap_ms << " ms" << std::defaultfloat << std::endl;
+    if (m_log.is_open()) {
+        m_log << done.time_s << "," << rung_name(done.from) << "," << rung_name(done.to) << ",\"" << done.reason
+              << "\"," << done.latency_ms << "," << done.max_gap_ms << std::endl;
+    }
+}
+
+void QosController::evaluate()
+{
+    flush_switch(false);
+
+    // 창 동안 드롭된 카메라 프레임: appsink가 버린 것 + staged 단계가 버린 것
+    // (appsink가 들고 있는 1 프레임은 아직 꺼내지 않았을 뿐이므로 빼고 센다)
+    const uint64_t camera = m_metrics.camera_frames.load(std::memory_order_relaxed);
+    const uint64_t in = m_metrics.frames_in.load(std::memory_order_relaxed);
+    uint64_t dropped = camera > in + 1 ? camera - in - 1 : 0;
+    if (m_staged) {
+        for (const StageStats &stage : m_staged->stats()) {
+            dropped += stage.dropped;
+        }
+    }
+    const uint64_t window_camera = camera - m_last_camera;
+    const uint64_t window_in = in - m_last_in;
+    const uint64_t window_dropped = dropped > m_last_dropped ? dropped - m_last_dropped : 0;
+    m_last_camera = camera;
+    m_last_in = in;
+    m_last_dropped = std::max(m_last_dropped, dropped);
+
+    // interval()은 지연 보고 타이머 몫이라 누적 bucket의 차이로 창을 본다
+    const double pre_ms = window_percentile_ms(m_histograms.stage(StageHistograms::PREPROCESS).counts(),
+                                               m_last_counts[StageHistograms::PREPROCESS], 90.0);
+    const double post_ms = window_percentile_ms(m_histograms.stage(StageHistograms::POSTPROCESS).counts(),
+                                                m_last_counts[StageHistograms::POSTPROCESS], 90.0);
+    const double infer_ms = window_percentile_ms(m_histograms.stage(StageHistograms::INFER).counts(),
+                                                 m_last_counts[StageHistograms::INFER], 10.0);
+    if (window_camera == 0 && window_in == 0) {
+        return;  // 프레임이 없는 창 (시작 전 / EOS 뒤)
+    }
+
+    // 프레임 주기 대비 부하. infer p10은 장치가 비어 있을 때 들어간 프레임 = 장치 처리 시간이고,
+    // 배치는 batch_size 프레임 주기마다 한 번 돈다 (포화되면 대기까지 포함되어 커진다)
+    const double period_ms = 1000.0 / std::max(m_config.frame_rate, 1);
+    const double host_ms = std::max(pre_ms, post_ms);
+    const double host_load = host_ms / period_ms;
+    const double infer_load = infer_ms / (std::max(m_config.batch_size, 1) * period_ms);
+    const double load = std::max(host_load, infer_load);
+    const double drop_rate = window_camera > 0 ? static_cast<double>(window_dropped) / window_camera : 0.0;
+
+    const size_t active = m_active.load();
+    const bool holding = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_last_switch).count()
+                         < m_config.qos_hold_s;
+    bool pending;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        pending = m_pending;
+    }
+
+    std::ostringstream reason;
+    reason << std::fixed << std::setprecision(2);
+    if (drop_rate > m_config.qos_max_drop_rate || load > m_config.qos_high_load) {
+        m_calm = 0;
+        if (holding || pending || active + 1 >= m_ladder.rung_count()) {
+            return;
+        }
+        if (drop_rate > m_config.qos_max_drop_rate) {
+            reason << "drop " << drop_rate * 100.0 << "% > " << m_config.qos_max_drop_rate * 100.0 << "%";
+        } else {
+            reason << "load " << load << " > " << m_config.qos_high_load
+                   << (infer_load >= host_load ? " (infer p10 " : " (host p90 ")
+                   << (infer_load >= host_load ? infer_ms : host_ms) << " ms)";
+        }
+        switch_to(active + 1, reason.str());
+        return;
+    }
+
+    if (drop_rate <= m_config.qos_max_drop_rate / 2 && load < m_config.qos_low_load) {
+        m_calm++;
+    } else {
+        m_calm = 0;
+    }
+    if (m_calm < m_config.qos_up_after || holding || pending || active == 0) {
+        return;
+    }
+    // 큰 해상도로 올라가도 infer 부하가 low/high 중간 아래여야 한다 (면적에 비례한다고 보고,
+    // high_load 바로 아래로 올라가 곧 다시 내려오는 진동을 막는다)
+    const ModelRung &from = m_ladder.rung(active);
+    const ModelRung &to = m_ladder.rung(active - 1);
+    const double predicted = infer_load * (static_cast<double>(to.width) * to.height) / (static_cast<double>(from.width) * from.height);
+    if (predicted >= (m_config.qos_low_load + m_config.qos_high_load) / 2) {
+        return;
+    }
+    reason << "idle: load " << load << " < " << m_config.qos_low_load << " for " << m_calm << " windows, predicted "
+           << predicted;
+    switch_to(active - 1, reason.str());
+}
+
+void QosController::summary(std::ostream &out)
+{
+    flush_switch(true);
+    out << "   전환 " << m_switches << "회 | 현재 " << rung_name(m_active.load()) << " | 프레임:";
+    for (size_t i = 0; i < m_ladder.rung_count(); i++) {
+        out << " " << rung_name(i) << " " << m_frames[i].load();
+    }
+    out << std::endl;
+    if (m_log.is_open()) {
+        out << "   전환 기록: " << m_config.qos_log << std::endl;
+        m_log.close();
+    }
+}
@@ -0,0 +1,164 @@
+#pragma once
+
+#include "Histogram.hpp"
+#include "InferBackend.hpp"
+#include "InferEngine.hpp"
+#include "Metrics.hpp"
+#include "ResizeKernels.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class StagedPipeline;
+
+/**
+ * @brief InferenceBackend over several preconfigured resolutions of the depth model
+ *
+ * Every rung is created and configured at startup (hailo: one network group per HEF
+ * on a shared VDevice with the model scheduler; cpu: one CpuBackend per rung on a
+ * shared SimDevice), so a switch only changes which rung the next frame goes to:
+ * nothing is torn down or reconfigured. The producer calls assign() for each job
+ * before submitting it; the rung is keyed by the job's buffer addresses, so
+ * write_input() / read_output() / infer() route every frame to the backend it was
+ * resized for, and frames already in flight finish on their old rung. Frame sizes
+ * are those of the largest rung; a smaller rung uses the start of each buffer.
+ */
+class LadderBackend : public InferenceBackend {
+public:
+    static Expected<std::unique_ptr<LadderBackend>> create(const Config &config);
+
+    /// Rungs, largest input first
+    size_t rung_count() const { return m_specs.size(); }
+    const ModelRung &rung(size_t index) const { return m_specs[index]; }
+
+    /// Records which rung the job's buffers are filled for (producer thread, before submit)
+    void assign(const InferJob &job, size_t rung);
+
+    size_t input_frame_size() const override { return m_input_size; }
+    size_t output_frame_size() const override { return m_output_size; }
+    hailo_status infer(const MemoryView &input, MemoryView output, size_t frames_count) override;
+    hailo_status write_input(const MemoryView &frame) override;
+    hailo_status read_output(MemoryView frame) override;
+    void abort() override;
+    void output_quantization(float &scale, float &zero_point) const override;
+
+private:
+    LadderBackend() = default;
+
+    size_t input_rung(const uint8_t *buffer);
+    size_t output_rung(const uint8_t *buffer);
+
+    std::vector<ModelRung> m_specs;
+    std::vector<std::unique_ptr<InferenceBackend>> m_rungs;
+    std::vector<size_t> m_input_sizes;
+    std::vector<size_t> m_output_sizes;
+    std::shared_ptr<SimDevice> m_sim;                 ///< cpu backend only
+    size_t m_input_size = 0;
+    size_t m_output_size = 0;
+
+    std::mutex m_mutex;
+    std::unordered_map<const uint8_t*, size_t> m_input_rung;   ///< Job input buffer → rung
+    std::unordered_map<const uint8_t*, size_t> m_output_rung;  ///< Job output buffer → rung
+    size_t m_batch_frames = 0;
+    AlignedBuffer m_batch_input;   ///< infer(): frames of one rung packed at that rung's frame size
+    AlignedBuffer m_batch_output;
+};
+
+/**
+ * @brief Load-adaptive choice of the ladder rung, evaluated once per qos.interval_s
+ *
+ * Each window it reads the dropped share of camera frames (appsink drops plus
+ * staged-pipeline drops) and the stage latencies as a fraction of the frame period:
+ * preprocess and postprocess p90, and infer p10 over batch_size periods. Frames
+ * that found the device idle set the infer p10, so it tracks the device time per
+ * frame (or batch) and grows with queueing once the device saturates. Above
+ * qos.max_drop_rate or qos.high_load it steps one rung down; after qos.up_after
+ * calm windows (few drops, load below qos.low_load) it steps one rung up, if the
+ * infer load scaled by the larger input area stays below the midpoint of
+ * qos.low_load and qos.high_load. Switches are at least qos.hold_s apart.
+ *
+ * A switch takes effect with the next frame the producer resizes. Its latency is
+ * measured from the decision to the first completed frame of the new rung, along
+ * with the longest gap between two completed frames meanwhile (a reconfiguration
+ * stall would show up there). Every switch is printed with its reason and written
+ * to the qos.log CSV.
+ */
+class QosController {
+public:
+    QosController(const Config &config, LadderBackend &ladder, ResizeMethod method,
+                  StageHistograms &histograms, PipelineMetrics &metrics);
+
+    QosController(const QosController &) = delete;
+    QosController &operator=(const QosController &) = delete;
+
+    /// Opens qos.log (no-op without one)
+    bool open_log();
+    /// Staged pipeline whose stage drops count as dropped frames (nullptr = appsink only)
+    void set_staged(const StagedPipeline *staged) { m_staged = staged; }
+
+    /// Rung the next frame is resized for (producer thread, once per job in submit order)
+    size_t begin_frame(const InferJob &job);
+    FrameResizer &resizer(size_t rung) { return *m_resizers[rung]; }
+    const LadderBackend &ladder() const { return m_ladder; }
+
+    /// A frame inferred at rung is done (completion thread)
+    void frame_done(size_t rung);
+
+    /// Reads the last window and switches rung if needed (main loop timer)
+    void evaluate();
+
+    /// Switch count and frames per rung
+    void summary(std::ostream &out);
+
+private:
+    struct Switch {
+        double time_s;                ///< Decision time since start
+        size_t from;
+        size_t to;
+        std::string reason;
+        std::chrono::steady_clock::time_point decided;
+        double latency_ms;            ///< Decision → first result at the new rung (<0 = still pending)
+        double max_gap_ms;            ///< Longest gap between two results until then
+    };
+
+    void switch_to(size_t rung, const std::string &reason);
+    /// Prints / logs the pending switch once its first frame is done
+    void flush_switch(bool final);
+    std::string rung_name(size_t rung) const;
+
+    const Config &m_config;
+    LadderBackend &m_ladder;
+    StageHistograms &m_histograms;
+    PipelineMetrics &m_metrics;
+    const StagedPipeline *m_staged = nullptr;
+    std::vector<std::unique_ptr<FrameResizer>> m_resizers;
+    const std::chrono::steady_clock::time_point m_created;
+
+    std::atomic<size_t> m_active{0};
+    std::unique_ptr<std::atomic<uint64_t>[]> m_frames;   ///< Completed frames per rung
+
+    // 전환 측정 (완료 스레드와 메인 루프가 공유)
+    std::mutex m_mutex;
+    bool m_pending = false;
+    Switch m_switch{};
+    std::chrono::steady_clock::time_point m_last_done;
+    bool m_any_done = false;
+
+    // 평가 창 기준점 (메인 루프 전용)
+    uint64_t m_last_camera = 0;
+    uint64_t m_last_in = 0;
+    uint64_t m_last_dropped = 0;
+    std::vector<uint64_t> m_last_counts[StageHistograms::STAGE_COUNT];
+    std::chrono::steady_clock::time_point m_last_switch;
+    int m_calm = 0;
+    size_t m_switches = 0;
+    std::ofstream m_log;
+};
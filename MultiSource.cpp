@@ -0,0 +1,424 @@
+#include "MultiSource.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+using Clock = std::chrono::high_resolution_clock;
+
+/**
+ * @brief path with "_suffix" inserted before its extension (output.mp4 → output_front.mp4)
+ */
+static std::string with_suffix(const std::string &path, const std::string &suffix) {
+    const size_t slash = path.find_last_of('/');
+    const size_t dot = path.find_last_of('.');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+        return path + "_" + suffix;
+    }
+    return path.substr(0, dot) + "_" + suffix + path.substr(dot);
+}
+
+Config make_source_config(const Config &config, const VideoSource &source) {
+    Config cfg = config;
+    cfg.video_inWidth = source.width > 0 ? source.width : config.video_inWidth;
+    cfg.video_inHeight = source.height > 0 ? source.height : config.video_inHeight;
+    cfg.video_outWidth = 2 * cfg.video_inWidth;  // 카메라 + 깊이 나란히
+    cfg.video_outHeight = cfg.video_inHeight;
+    if (source.type == "test" && source.fps > 0) {
+        cfg.frame_rate = source.fps;
+    }
+    if (source.type == "v4l2") {
+        cfg.device = source.location;
+    }
+    // 파일 소스는 재생 경로를 그대로 쓴다 (fps 0 = 제한 없음, backpressure)
+    cfg.replay_file = source.type == "file" ? source.location : std::string();
+    cfg.replay_rate = source.type == "file" ? source.fps : 0.0;
+    cfg.replay_display = true;
+    if (!source.drop_policy.empty()) {
+        cfg.drop_policy = source.drop_policy;
+    }
+    if (source.queue_depth > 0) {
+        cfg.stage_queue_depth = source.queue_depth;
+    }
+
+    cfg.output_name = with_suffix(config.output_name, source.name);
+    if (source.has_outputs) {
+        cfg.outputs = source.outputs;
+    } else {
+        for (OutputSink &sink : cfg.outputs) {
+            if (sink.type == "file") {
+                sink.location = with_suffix(sink.location.empty() ? config.output_name : sink.location, source.name);
+            } else if (sink.type == "shm") {
+                sink.location = with_suffix(sink.location, source.name);
+            }
+        }
+    }
+    // raw 깊이 파일 / 깊이 링은 단일 카메라 전용
+    cfg.depth_raw.clear();
+    cfg.depth_ring.clear();
+    cfg.sources.clear();
+    return cfg;
+}
+
+/**
+ * @brief Bus handler of the capture pipelines: errors stop the run, EOS only ends that source
+ */
+static gboolean on_capture_message(GstBus *bus, GstMessage *message, gpointer data) {
+    GMainLoop *loop = static_cast<GMainLoop*>(data);
+    if (GST_MESSAGE_TYPE(message) == GST_MESSAGE_ERROR) {
+        GError *err;
+        gchar *debug;
+        gst_message_parse_error(message, &err, &debug);
+        std::cerr << "[ERROR] " << GST_OBJECT_NAME(GST_MESSAGE_SRC(message)) << ": " << err->message << std::endl;
+        g_error_free(err);
+        g_free(debug);
+        g_main_loop_quit(loop);
+    } else if (GST_MESSAGE_TYPE(message) == GST_MESSAGE_WARNING) {
+        on_message(bus, message, data);
+    }
+    return TRUE;
+}
+
+MultiSourcePipeline::MultiSourcePipeline(const Config &config, InferenceBackend &backend,
+                                         const DepthColorizer &colorizer) :
+    m_config(config),
+    m_backend(backend),
+    m_colorizer(colorizer)
+{}
+
+MultiSourcePipeline::~MultiSourcePipeline()
+{
+    stop();
+    for (std::unique_ptr<Source> &source : m_sources) {
+        if (source->appsink) {
+            gst_object_unref(source->appsink);
+        }
+        if (source->capture) {
+            gst_element_set_state(source->capture, GST_STATE_NULL);
+            gst_object_unref(source->capture);
+        }
+        if (source->output) {
+            gst_element_set_state(source->output, GST_STATE_NULL);
+            gst_object_unref(source->output);
+        }
+        if (source->pool) {
+            gst_buffer_pool_set_active(source->pool, FALSE);
+            gst_object_unref(source->pool);
+        }
+    }
+}
+
+bool MultiSourcePipeline::create(GstClock *clock)
+{
+    ResizeMethod resize_method;
+    if (!parse_resize_method(m_config.preprocess, resize_method)) {
+        std::cerr << "[ERROR] Unknown preprocess method: " << m_config.preprocess << std::endl;
+        return false;
+    }
+    if (m_config.scheduling != "round_robin" && m_config.scheduling != "weighted") {
+        std::cerr << "[ERROR] Unknown scheduling: " << m_config.scheduling << " (expected round_robin or weighted)" << std::endl;
+        return false;
+    }
+    const bool weighted = m_config.scheduling == "weighted";
+
+    std::vector<SourcePolicy> policies;
+    for (const VideoSource &spec : m_config.sources) {
+        std::unique_ptr<Source> source(new Source());
+        source->spec = spec;
+        source->config = make_source_config(m_config, spec);
+        const Config &cfg = source->config;
+
+        DropPolicy policy;
+        if (!parse_drop_policy(cfg.drop_policy, policy)) {
+            std::cerr << "[ERROR] Unknown drop policy for " << spec.name << ": " << cfg.drop_policy
+                      << " (expected block, drop or latest)" << std::endl;
+            return false;
+        }
+        policies.push_back(SourcePolicy{weighted ? spec.weight : 1,
+                                        static_cast<size_t>(std::max(cfg.stage_queue_depth, 1)), policy});
+
+        // 캡처: 소스 → appsink (두 파이프라인 모두 같은 clock → 캡처 시각을 출력 PTS로 옮길 수 있다)
+        source->capture = makeSourcePipeline(spec, cfg);
+        if (!source->capture) {
+            return false;
+        }
+        gst_pipeline_use_clock(GST_PIPELINE(source->capture), clock);
+        source->appsink = gst_bin_get_by_name(GST_BIN(source->capture), "app_sink");
+        g_object_set(source->appsink,
+            "emit-signals", FALSE,  // ingest 스레드가 직접 pull
+            "sync", FALSE,
+            "max-buffers", 1,
+            "drop", is_unthrottled_replay(cfg) ? FALSE : TRUE,
+            NULL);
+        add_buffer_counter(source->appsink, "sink", &source->metrics.camera_frames);
+
+        // 출력: 소스마다 appsrc → tee → 브랜치
+        if (!active_outputs(cfg).empty()) {
+            source->output = gst_pipeline_new(("output_" + spec.name).c_str());
+            gst_pipeline_use_clock(GST_PIPELINE(source->output), clock);
+            source->appsrc = makeSrcPipeline(source->output, cfg);
+            if (!source->appsrc) {
+                return false;
+            }
+            source->pool = makeOutputPool(cfg);
+            if (!source->pool) {
+                return false;
+            }
+            if (GstElement *encoder = gst_bin_get_by_name(GST_BIN(source->output), "encoder")) {
+                add_latency_probe(encoder, "src", LatencyTracer::ENCODER_OUT, &source->latency);
+                gst_object_unref(encoder);
+            }
+        }
+
+        source->resizer.reset(new FrameResizer(cv::Size(cfg.video_inWidth, cfg.video_inHeight),
+                                               cv::Size(cfg.model_width, cfg.model_height), resize_method));
+
+        CallbackData &cb = source->cb;
+        cb.infer_session = nullptr;
+        cb.infer_engine = nullptr;
+        cb.frame_contexts = nullptr;
+        cb.appsrc = source->appsrc;
+        cb.output_pool = source->pool;
+        cb.config = &source->config;
+        cb.resizer = source->resizer.get();
+        cb.staged = nullptr;
+        cb.colorizer = &m_colorizer;
+        cb.clock = clock;
+        cb.trace = nullptr;
+        cb.histograms = &source->histograms;
+        cb.metrics = &source->metrics;
+        cb.depth_out = nullptr;
+        cb.depth_ring = nullptr;
+        cb.models = nullptr;
+        cb.next_frame_id = static_cast<uint64_t>(m_sources.size()) << SOURCE_FRAME_ID_SHIFT;
+
+        m_sources.push_back(std::move(source));
+    }
+    if (m_sources.empty()) {
+        std::cerr << "[ERROR] sources list is empty" << std::endl;
+        return false;
+    }
+
+    // 버려진 프레임은 카메라 샘플만 돌려준다
+    m_scheduler.reset(new SourceScheduler<FrameContext>(policies, [](size_t, FrameContext &frame) {
+        release_frame(frame);
+    }));
+
+    auto queue = create_infer_queue(m_backend, m_config, [this](InferJob &job) { on_complete(job); });
+    if (!queue) {
+        std::cerr << "Failed to start inference queue " << queue.status() << std::endl;
+        return false;
+    }
+    m_engine = std::move(queue.value());
+    m_contexts.resize(m_engine->capacity());
+    m_job_source.resize(m_engine->capacity(), 0);
+
+    std::cout << "멀티 소스: " << m_sources.size() << "개 | 스케줄링 " << m_config.scheduling
+              << " | 배치 " << std::max(m_config.batch_size, 1) << " | in-flight " << m_engine->capacity() << std::endl;
+    for (size_t i = 0; i < m_sources.size(); i++) {
+        const Source &source = *m_sources[i];
+        std::cout << "   [" << source.spec.name << "] " << source.spec.type << " " << source.config.video_inWidth << "x"
+                  << source.config.video_inHeight << " | weight " << policies[i].weight << " | 큐 "
+                  << policies[i].capacity << " / " << source.config.drop_policy << " | 출력 "
+                  << active_outputs(source.config).size() << "개" << std::endl;
+    }
+    return true;
+}
+
+void MultiSourcePipeline::start(GMainLoop *loop)
+{
+    m_loop = loop;
+    for (std::unique_ptr<Source> &source : m_sources) {
+        GstBus *bus = gst_pipeline_get_bus(GST_PIPELINE(source->capture));
+        gst_bus_add_signal_watch(bus);
+        g_signal_connect(bus, "message", G_CALLBACK(on_capture_message), loop);
+        gst_object_unref(bus);
+        if (source->output) {
+            bus = gst_pipeline_get_bus(GST_PIPELINE(source->output));
+            gst_bus_add_signal_watch(bus);
+            g_signal_connect(bus, "message", G_CALLBACK(on_message), loop);
+            gst_object_unref(bus);
+            gst_element_set_state(source->output, GST_STATE_PLAYING);
+        }
+        gst_element_set_state(source->capture, GST_STATE_PLAYING);
+    }
+
+    m_stop = false;
+    m_finished = 0;
+    m_running = true;
+    m_last_report = std::chrono::steady_clock::now();
+    m_feeder = std::thread(&MultiSourcePipeline::feed_loop, this);
+    for (size_t i = 0; i < m_sources.size(); i++) {
+        m_sources[i]->ingest = std::thread(&MultiSourcePipeline::ingest_loop, this, i);
+    }
+}
+
+void MultiSourcePipeline::stop()
+{
+    if (!m_running) {
+        return;
+    }
+    m_running = false;
+
+    // 1. 카메라 입력 중지 (ingest는 100 ms 안에 m_stop을 본다)
+    m_stop = true;
+    for (std::unique_ptr<Source> &source : m_sources) {
+        if (source->ingest.joinable()) {
+            source->ingest.join();
+        }
+    }
+    // 2. 큐에 남은 프레임까지 추론해 각 소스의 appsrc로 내보낸다
+    m_scheduler->close();
+    if (m_feeder.joinable()) {
+        m_feeder.join();
+    }
+    m_engine->flush();
+    m_engine->stop();
+
+    // 3. 소스마다 EOS → 파일 마무리
+    for (std::unique_ptr<Source> &source : m_sources) {
+        gst_element_set_state(source->capture, GST_STATE_NULL);
+        if (!source->appsrc) {
+            continue;
+        }
+        gst_app_src_end_of_stream(GST_APP_SRC(source->appsrc));
+        GstBus *bus = gst_pipeline_get_bus(GST_PIPELINE(source->output));
+        GstMessage *msg = gst_bus_timed_pop_filtered(bus, 10 * GST_SECOND,
+                                    (GstMessageType)(GST_MESSAGE_EOS | GST_MESSAGE_ERROR));
+        std::cout << "   [" << source->spec.name << "] "
+                  << (!msg ? "✗ EOS 타임아웃!" : GST_MESSAGE_TYPE(msg) == GST_MESSAGE_EOS ? "✓ EOS 완료" : "✗ 에러로 종료")
+                  << std::endl;
+        if (msg) {
+            gst_message_unref(msg);
+        }
+        gst_object_unref(bus);
+        gst_element_set_state(source->output, GST_STATE_NULL);
+    }
+}
+
+/**
+ * @brief Ingest thread of one source: pull → capture stamp → map → scheduler queue
+ *
+ * Only the camera sample is kept here; resizing waits until the scheduler picks the
+ * frame, so frames dropped by the source's policy cost nothing but the pull.
+ */
+void MultiSourcePipeline::ingest_loop(size_t index)
+{
+    Source &source = *m_sources[index];
+    GstAppSink *appsink = GST_APP_SINK(source.appsink);
+    while (!m_stop) {
+        GstSample *sample = gst_app_sink_try_pull_sample(appsink, 100 * GST_MSECOND);
+        if (!sample) {
+            if (gst_app_sink_is_eos(appsink)) {
+                break;
+            }
+            continue;
+        }
+
+        FrameContext frame = {};
+        frame.timing.t_start = Clock::now();
+        frame.sample = sample;
+        frame.buffer = gst_sample_get_buffer(sample);
+        if (!map_camera_buffer(&source.cb, frame.buffer, frame.map)) {
+            gst_sample_unref(sample);
+            continue;
+        }
+        stamp_capture(&source.cb, source.appsink, frame.buffer, frame.timing);
+        m_scheduler->push(index, std::move(frame));
+    }
+
+    // 모든 소스가 끝나면 (파일 소스) 메인 루프 종료
+    if (!m_stop) {
+        std::cout << "소스 " << source.spec.name << " 끝 (EOS)" << std::endl;
+        if (++m_finished == m_sources.size() && m_loop) {
+            g_main_loop_quit(m_loop);
+        }
+    }
+}
+
+/**
+ * @brief Single InferQueue producer: scheduler pick → resize into the NPU slot → submit
+ */
+void MultiSourcePipeline::feed_loop()
+{
+    size_t index = 0;
+    FrameContext frame = {};
+    while (m_scheduler->pop(index, frame)) {
+        Source &source = *m_sources[index];
+        InferJob *job = m_engine->acquire();  // 모든 슬롯이 추론 중이면 대기 (그동안 소스 큐가 정책대로 찬다)
+        if (!job) {
+            release_frame(frame);
+            continue;
+        }
+        FrameContext &ctx = m_contexts[job->index];
+        ctx = frame;
+        m_job_source[job->index] = index;
+
+        FrameTiming &timing = ctx.timing;
+        timing.bytes_copied = 0;
+        timing.t_preprocess_start = Clock::now();
+        const cv::Mat raw_img(source.config.video_inHeight, source.config.video_inWidth, CV_8UC3, ctx.map.data);
+        cv::Mat input_img(m_config.model_height, m_config.model_width, CV_8UC3, job->input);
+        source.resizer->resize(raw_img, input_img);
+        timing.t_preprocess_end = Clock::now();
+        timeline_span(TimelineSpan::Preprocess, timing.frame_id, timing.t_preprocess_start, timing.t_preprocess_end);
+
+        timing.t_infer_start = Clock::now();
+        mark_infer_start(&source.cb, timing);
+        job->user_data = &ctx;
+        job->trace_id = timing.frame_id;
+        if (m_engine->submit(job) != HAILO_SUCCESS) {
+            count_infer_failure(&source.cb);
+            release_frame(ctx);
+        }
+    }
+}
+
+/**
+ * @brief InferQueue completion: compose and push to the frame's own source, then record its latency
+ */
+void MultiSourcePipeline::on_complete(InferJob &job)
+{
+    Source &source = *m_sources[m_job_source[job.index]];
+    on_infer_complete(job, &source.cb);
+    if (job.status == HAILO_SUCCESS) {
+        const FrameTiming &timing = m_contexts[job.index].timing;
+        source.latency.record(LatencyTracer::INFER_START, timing.capture_to_infer);
+        source.latency.record(LatencyTracer::PUSH, timing.capture_to_push);
+    }
+}
+
+void MultiSourcePipeline::report(std::ostream &out)
+{
+    const auto now = std::chrono::steady_clock::now();
+    const double interval_s = std::max(std::chrono::duration<double>(now - m_last_report).count(), 1e-3);
+    m_last_report = now;
+    for (size_t i = 0; i < m_sources.size(); i++) {
+        Source &source = *m_sources[i];
+        const uint64_t in = source.metrics.frames_in.load(std::memory_order_relaxed);
+        const uint64_t done = source.metrics.frames_out.load(std::memory_order_relaxed);
+        const auto queue = m_scheduler->stats(i);
+        const LatencyTracer::Summary push = source.latency.summary(LatencyTracer::PUSH);
+        out << "   [" << source.spec.name << "] 입력 " << (in - source.reported_in) / interval_s
+            << " fps | 출력 " << (done - source.reported_out) / interval_s << " fps | 큐 " << queue.depth
+            << " | 드롭 " << queue.dropped << " | capture→push p50 " << push.p50_ms << " / p99 " << push.p99_ms
+            << " ms" << std::endl;
+        source.reported_in = in;
+        source.reported_out = done;
+    }
+}
+
+void MultiSourcePipeline::summary(std::ostream &out)
+{
+    for (size_t i = 0; i < m_sources.size(); i++) {
+        Source &source = *m_sources[i];
+        const auto queue = m_scheduler->stats(i);
+        const uint64_t camera = source.metrics.camera_frames.load();
+        const uint64_t in = source.metrics.frames_in.load();
+        out << "[" << source.spec.name << "] 카메라 " << camera << " | appsink 드롭 " << (camera > in ? camera - in : 0)
+            << " | 큐 드롭 " << queue.dropped << " | 추론 " << queue.scheduled << " | 출력 "
+            << source.metrics.frames_out.load() << " | 추론 실패 " << source.metrics.infer_failures.load() << std::endl;
+        source.histograms.report(out, true);
+        source.latency.report(out);
+    }
+}
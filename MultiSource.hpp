@@ -0,0 +1,99 @@
+#pragma once
+
+#include "gstreaming.hpp"
+#include "InferBackend.hpp"
+#include "InferEngine.hpp"
+#include "SourceScheduler.hpp"
+
+#include <atomic>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// Frame IDs of source i start at i << SOURCE_FRAME_ID_SHIFT, so traces and timelines never mix sources up
+constexpr int SOURCE_FRAME_ID_SHIFT = 48;
+
+/**
+ * @brief Configuration of one source: the shared settings with its capture size, outputs and drop policy
+ *
+ * Outputs inherited from the top-level list get the source name appended to their
+ * file / socket location, so several sources never write to the same file.
+ */
+Config make_source_config(const Config &config, const VideoSource &source);
+
+/**
+ * @brief Several cameras multiplexed onto one InferQueue
+ *
+ * Each source has its own capture pipeline and ingest thread, its own queue in a
+ * SourceScheduler (with its own drop policy), its own output pipeline (appsrc → tee →
+ * outputs) and its own latency statistics. One feeder thread takes the frame the
+ * scheduler picks, resizes it straight into an NPU slot and submits it, so the NPU
+ * is shared round-robin (or by weight) and a stalled camera only delays itself.
+ * Completions are composed and pushed to the frame's own source by the shared
+ * finish path (on_infer_complete()).
+ */
+class MultiSourcePipeline {
+public:
+    MultiSourcePipeline(const Config &config, InferenceBackend &backend, const DepthColorizer &colorizer);
+    ~MultiSourcePipeline();
+
+    MultiSourcePipeline(const MultiSourcePipeline &) = delete;
+    MultiSourcePipeline &operator=(const MultiSourcePipeline &) = delete;
+
+    /// Builds every source's pipelines and pools and starts the shared InferQueue
+    bool create(GstClock *clock);
+
+    /// Sets every pipeline to PLAYING and starts the ingest and feeder threads; quits loop when all sources ended
+    void start(GMainLoop *loop);
+
+    /// Stops ingest, infers every queued frame, sends EOS to each output and waits for it
+    void stop();
+
+    /// One line per source: input / inferred fps since the last call, drops, queue and capture → push percentiles
+    void report(std::ostream &out);
+
+    /// Per-source totals, stage histograms and capture-based latency at exit
+    void summary(std::ostream &out);
+
+private:
+    struct Source {
+        VideoSource spec;
+        Config config;
+        GstElement *capture = nullptr;   ///< source → appsink pipeline
+        GstElement *appsink = nullptr;
+        GstElement *output = nullptr;    ///< appsrc → tee → outputs pipeline (nullptr without outputs)
+        GstElement *appsrc = nullptr;
+        GstBufferPool *pool = nullptr;
+        std::unique_ptr<FrameResizer> resizer;
+        CallbackData cb = {};
+        PipelineMetrics metrics;
+        StageHistograms histograms;
+        LatencyTracer latency;
+        std::thread ingest;
+        uint64_t reported_in = 0;        ///< frames_in at the last report()
+        uint64_t reported_out = 0;       ///< frames_out at the last report()
+    };
+
+    void ingest_loop(size_t index);
+    void feed_loop();
+    void on_complete(InferJob &job);
+
+    const Config &m_config;
+    InferenceBackend &m_backend;
+    const DepthColorizer &m_colorizer;
+
+    std::vector<std::unique_ptr<Source>> m_sources;
+    std::unique_ptr<SourceScheduler<FrameContext>> m_scheduler;
+    std::unique_ptr<InferQueue> m_engine;
+    std::vector<FrameContext> m_contexts;  ///< One per InferQueue job slot
+    std::vector<size_t> m_job_source;      ///< Source of the frame in each job slot
+
+    GMainLoop *m_loop = nullptr;
+    std::atomic<bool> m_stop{false};
+    std::atomic<size_t> m_finished{0};     ///< Sources whose capture reached EOS
+    std::thread m_feeder;
+    std::chrono::steady_clock::time_point m_last_report;
+    bool m_running = false;
+};
@@ -0,0 +1,308 @@
+#include "ResizeKernels.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define RESIZE_KERNELS_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define RESIZE_KERNELS_SSE2 1
+#endif
+
+// 세로 가중치 합 = 2^7 → uint8 * 가중치 합이 int16에 들어감 (255 * 128 = 32640)
+// 가로 가중치 합 = 2^14 → int16 * Q14 합이 int32에 들어감
+static const int VERTICAL_BITS = 7;
+static const int HORIZONTAL_BITS = 14;
+static const int TOTAL_BITS = VERTICAL_BITS + HORIZONTAL_BITS;
+static const int ROW_PADDING = 8;  // 마지막 픽셀에서 4-lane / 짝수 tap 로드가 넘어가는 만큼
+
+bool parse_resize_method(const std::string &name, ResizeMethod &method)
+{
+    if (name == "antialias") {
+        method = ResizeMethod::Antialias;
+    } else if (name == "area") {
+        method = ResizeMethod::Area;
+    } else if (name == "blur_resize") {
+        method = ResizeMethod::BlurResize;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char *resize_method_name(ResizeMethod method)
+{
+    switch (method) {
+        case ResizeMethod::Antialias: return "antialias";
+        case ResizeMethod::Area: return "area";
+        case ResizeMethod::BlurResize: return "blur_resize";
+    }
+    return "unknown";
+}
+
+const char *resize_kernel_path()
+{
+#if RESIZE_KERNELS_NEON
+    return "neon";
+#elif RESIZE_KERNELS_SSE2
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
+
+// ==================== FILTER TAPS ====================
+
+/**
+ * @brief Float weights of one output sample, before quantization
+ */
+static void output_weights(int out_index, int in_size, double scale, ResizeMethod method,
+                           int &first, std::vector<double> &weights)
+{
+    weights.clear();
+    const double center = (out_index + 0.5) * scale;
+
+    if (method == ResizeMethod::Area && scale > 1.0) {
+        // 출력 픽셀이 덮는 원본 구간 [lo, hi)와 각 원본 픽셀의 겹치는 길이
+        const double lo = out_index * scale;
+        const double hi = std::min(lo + scale, static_cast<double>(in_size));
+        first = static_cast<int>(std::floor(lo));
+        for (int i = first; i < in_size && i < hi; i++) {
+            weights.push_back(std::min(i + 1.0, hi) - std::max(static_cast<double>(i), lo));
+        }
+        return;
+    }
+
+    // 삼각 필터: 축소 시 폭을 scale배로 넓혀 blur를 resample에 포함, 확대 시 bilinear
+    const double support = std::max(scale, 1.0);
+    first = std::max(0, static_cast<int>(center - support + 0.5));
+    const int last = std::min(in_size, static_cast<int>(center + support + 0.5));
+    for (int i = first; i < last; i++) {
+        const double t = (i - center + 0.5) / support;
+        weights.push_back(std::max(0.0, 1.0 - std::fabs(t)));
+    }
+}
+
+/**
+ * @brief Builds fixed-point taps for one axis; each output's weights sum to exactly 1 << bits
+ */
+static FrameResizer::FilterTaps build_taps(int in_size, int out_size, ResizeMethod method, int bits)
+{
+    const double scale = static_cast<double>(in_size) / out_size;
+    const int one = 1 << bits;
+
+    std::vector<std::vector<double>> all_weights(out_size);
+    std::vector<int> firsts(out_size);
+    size_t max_count = 0;
+    for (int o = 0; o < out_size; o++) {
+        output_weights(o, in_size, scale, method, firsts[o], all_weights[o]);
+
+        // 양 끝의 0 가중치 tap 제거
+        std::vector<double> &w = all_weights[o];
+        while (w.size() > 1 && w.back() <= 0.0) {
+            w.pop_back();
+        }
+        while (w.size() > 1 && w.front() <= 0.0) {
+            w.erase(w.begin());
+            firsts[o]++;
+        }
+        max_count = std::max(max_count, w.size());
+    }
+
+    FrameResizer::FilterTaps taps;
+    taps.stride = static_cast<int>((max_count + 1) & ~static_cast<size_t>(1));
+    taps.start.resize(out_size);
+    taps.count.resize(out_size);
+    taps.weights.assign(static_cast<size_t>(out_size) * taps.stride, 0);
+
+    for (int o = 0; o < out_size; o++) {
+        const std::vector<double> &w = all_weights[o];
+        double total = 0.0;
+        for (double v : w) {
+            total += v;
+        }
+
+        int16_t *q = &taps.weights[static_cast<size_t>(o) * taps.stride];
+        int sum = 0;
+        size_t largest = 0;
+        for (size_t k = 0; k < w.size(); k++) {
+            q[k] = static_cast<int16_t>(std::lround(w[k] / total * one));
+            sum += q[k];
+            if (w[k] > w[largest]) {
+                largest = k;
+            }
+        }
+        // 반올림 오차는 가장 큰 tap에 몰아서 DC gain을 정확히 1로 유지
+        q[largest] = static_cast<int16_t>(q[largest] + (one - sum));
+
+        taps.start[o] = firsts[o];
+        taps.count[o] = static_cast<int>((w.size() + 1) & ~static_cast<size_t>(1));
+    }
+    return taps;
+}
+
+// ==================== VERTICAL PASS ====================
+// rows[k] * w[k] 누적 → Q7 int16 한 행 (폭 = width * 3)
+
+static void vertical_scalar(const uint8_t *const *rows, const int16_t *w, int taps, int width, int16_t *out,
+                            int begin)
+{
+    for (int i = begin; i < width; i++) {
+        int sum = 0;
+        for (int k = 0; k < taps; k++) {
+            sum += rows[k][i] * w[k];
+        }
+        out[i] = static_cast<int16_t>(sum);
+    }
+}
+
+#if RESIZE_KERNELS_NEON
+static void vertical_pass(const uint8_t *const *rows, const int16_t *w, int taps, int width, int16_t *out)
+{
+    int i = 0;
+    for (; i + 16 <= width; i += 16) {
+        uint8x16_t v = vld1q_u8(rows[0] + i);
+        uint8x16_t wk = vdupq_n_u8(static_cast<uint8_t>(w[0]));
+        uint16x8_t lo = vmull_u8(vget_low_u8(v), vget_low_u8(wk));
+        uint16x8_t hi = vmull_high_u8(v, wk);
+        for (int k = 1; k < taps; k++) {
+            v = vld1q_u8(rows[k] + i);
+            wk = vdupq_n_u8(static_cast<uint8_t>(w[k]));
+            lo = vmlal_u8(lo, vget_low_u8(v), vget_low_u8(wk));
+            hi = vmlal_high_u8(hi, v, wk);
+        }
+        vst1q_s16(out + i, vreinterpretq_s16_u16(lo));
+        vst1q_s16(out + i + 8, vreinterpretq_s16_u16(hi));
+    }
+    vertical_scalar(rows, w, taps, width, out, i);
+}
+#elif RESIZE_KERNELS_SSE2
+static void vertical_pass(const uint8_t *const *rows, const int16_t *w, int taps, int width, int16_t *out)
+{
+    const __m128i zero = _mm_setzero_si128();
+    int i = 0;
+    for (; i + 16 <= width; i += 16) {
+        __m128i lo = zero;
+        __m128i hi = zero;
+        for (int k = 0; k < taps; k++) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[k] + i));
+            __m128i wk = _mm_set1_epi16(w[k]);
+            lo = _mm_add_epi16(lo, _mm_mullo_epi16(_mm_unpacklo_epi8(v, zero), wk));
+            hi = _mm_add_epi16(hi, _mm_mullo_epi16(_mm_unpackhi_epi8(v, zero), wk));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), lo);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i + 8), hi);
+    }
+    vertical_scalar(rows, w, taps, width, out, i);
+}
+#else
+static void vertical_pass(const uint8_t *const *rows, const int16_t *w, int taps, int width, int16_t *out)
+{
+    vertical_scalar(rows, w, taps, width, out, 0);
+}
+#endif
+
+// ==================== HORIZONTAL PASS ====================
+// Q7 int16 RGB 행 → Q14 가중합 → uint8 RGB 출력 행
+
+#if RESIZE_KERNELS_NEON
+static void horizontal_pass(const int16_t *row, const FrameResizer::FilterTaps &taps, int out_width, uint8_t *dst)
+{
+    for (int x = 0; x < out_width; x++) {
+        const int16_t *w = &taps.weights[static_cast<size_t>(x) * taps.stride];
+        const int16_t *p = row + 3 * taps.start[x];
+        int32x4_t acc = vdupq_n_s32(0);
+        for (int k = 0; k < taps.count[x]; k++) {
+            acc = vmlal_n_s16(acc, vld1_s16(p + 3 * k), w[k]);  // R, G, B, (다음 픽셀 R)
+        }
+        int16x4_t narrow = vqmovn_s32(vrshrq_n_s32(acc, TOTAL_BITS));
+        uint8x8_t bytes = vqmovun_s16(vcombine_s16(narrow, narrow));
+        uint32_t pixel = vget_lane_u32(vreinterpret_u32_u8(bytes), 0);
+        std::memcpy(dst + 3 * x, &pixel, 3);
+    }
+}
+#elif RESIZE_KERNELS_SSE2
+static void horizontal_pass(const int16_t *row, const FrameResizer::FilterTaps &taps, int out_width, uint8_t *dst)
+{
+    const __m128i round = _mm_set1_epi32(1 << (TOTAL_BITS - 1));
+    for (int x = 0; x < out_width; x++) {
+        const int16_t *w = &taps.weights[static_cast<size_t>(x) * taps.stride];
+        const int16_t *p = row + 3 * taps.start[x];
+        __m128i acc = _mm_setzero_si128();
+        // tap 두 개씩: [R0 R1 G0 G1 B0 B1 ..] · [w0 w1 ..] → madd
+        for (int k = 0; k < taps.count[x]; k += 2) {
+            __m128i p0 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p + 3 * k));
+            __m128i p1 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p + 3 * k + 3));
+            __m128i wv = _mm_set1_epi32(static_cast<int>(static_cast<uint16_t>(w[k]) |
+                                                         (static_cast<uint32_t>(static_cast<uint16_t>(w[k + 1])) << 16)));
+            acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_unpacklo_epi16(p0, p1), wv));
+        }
+        acc = _mm_srai_epi32(_mm_add_epi32(acc, round), TOTAL_BITS);
+        __m128i narrow = _mm_packs_epi32(acc, acc);
+        uint32_t pixel = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_packus_epi16(narrow, narrow)));
+        std::memcpy(dst + 3 * x, &pixel, 3);
+    }
+}
+#else
+static void horizontal_pass(const int16_t *row, const FrameResizer::FilterTaps &taps, int out_width, uint8_t *dst)
+{
+    const int round = 1 << (TOTAL_BITS - 1);
+    for (int x = 0; x < out_width; x++) {
+        const int16_t *w = &taps.weights[static_cast<size_t>(x) * taps.stride];
+        const int16_t *p = row + 3 * taps.start[x];
+        int acc[3] = {round, round, round};
+        for (int k = 0; k < taps.count[x]; k++) {
+            acc[0] += p[3 * k] * w[k];
+            acc[1] += p[3 * k + 1] * w[k];
+            acc[2] += p[3 * k + 2] * w[k];
+        }
+        for (int c = 0; c < 3; c++) {
+            dst[3 * x + c] = static_cast<uint8_t>(std::min(255, std::max(0, acc[c] >> TOTAL_BITS)));
+        }
+    }
+}
+#endif
+
+// ==================== FRAME RESIZER ====================
+
+FrameResizer::FrameResizer(cv::Size src_size, cv::Size dst_size, ResizeMethod method)
+    : m_src_size(src_size), m_dst_size(dst_size), m_method(method)
+{
+    if (m_method == ResizeMethod::BlurResize) {
+        return;
+    }
+    m_horizontal = build_taps(src_size.width, dst_size.width, method, HORIZONTAL_BITS);
+    m_vertical = build_taps(src_size.height, dst_size.height, method, VERTICAL_BITS);
+    m_row.assign(static_cast<size_t>(src_size.width) * 3 + ROW_PADDING, 0);
+    m_rows.resize(m_vertical.stride);
+}
+
+void FrameResizer::resize(const cv::Mat &src, cv::Mat &dst)
+{
+    dst.create(m_dst_size, CV_8UC3);
+
+    if (m_method == ResizeMethod::BlurResize) {
+        // 기존 경로: 원본은 읽기 전용 매핑이므로 blur 결과는 별도 버퍼에
+        cv::GaussianBlur(src, m_blurred, cv::Size(3, 3), 0);
+        cv::resize(m_blurred, dst, m_dst_size, 0, 0, cv::INTER_LINEAR);
+        return;
+    }
+
+    const int row_width = m_src_size.width * 3;
+    for (int y = 0; y < m_dst_size.height; y++) {
+        const int first = m_vertical.start[y];
+        const int16_t *w = &m_vertical.weights[static_cast<size_t>(y) * m_vertical.stride];
+
+        // 짝수로 맞춘 패딩 tap은 가중치 0이지만 행 범위는 넘지 않게 자름
+        int taps = std::min(m_vertical.count[y], m_src_size.height - first);
+        for (int k = 0; k < taps; k++) {
+            m_rows[k] = src.ptr<uint8_t>(first + k);
+        }
+
+        vertical_pass(m_rows.data(), w, taps, row_width, m_row.data());
+        horizontal_pass(m_row.data(), m_horizontal, m_dst_size.width, dst.ptr<uint8_t>(y));
+    }
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief How a camera frame is brought down to the model input size
+ */
+enum class ResizeMethod {
+    Antialias,   ///< Fused: triangle filter widened by the scale factor (blur folded into the resample)
+    Area,        ///< Fused: pixel-area average (box filter), bilinear when upscaling
+    BlurResize,  ///< Legacy: 3x3 GaussianBlur on the full frame, then INTER_LINEAR resize
+};
+
+/**
+ * @brief Parses a preprocess.method value ("antialias", "area" or "blur_resize")
+ *
+ * @return false if the name is unknown (method is left untouched)
+ */
+bool parse_resize_method(const std::string &name, ResizeMethod &method);
+
+/**
+ * @brief config.yaml name of a method
+ */
+const char *resize_method_name(ResizeMethod method);
+
+/**
+ * @brief SIMD path used by the fused filters ("neon", "sse2" or "scalar")
+ */
+const char *resize_kernel_path();
+
+/**
+ * @brief Anti-aliased CV_8UC3 downscaler for one fixed source/destination size
+ *
+ * The fused methods read the source frame once and write only the destination:
+ * a vertical pass (Q7 weights, uint8 → int16) produces one filtered source row
+ * per output row, and a horizontal pass (Q14 weights) turns it into the output
+ * row. Filter taps are computed in the constructor, so resize() does not
+ * allocate when dst is already sized. The source is never written, which keeps
+ * read-only GstBuffer mappings safe.
+ *
+ * Holds per-call scratch, so use one instance per thread.
+ */
+class FrameResizer {
+public:
+    FrameResizer(cv::Size src_size, cv::Size dst_size, ResizeMethod method);
+
+    /**
+     * @brief Resizes src (CV_8UC3, src_size) into dst (CV_8UC3, dst_size, created if needed)
+     *
+     * When dst already has the right size and type, it is written in place, so a
+     * Mat header over an inference input buffer receives the result directly.
+     */
+    void resize(const cv::Mat &src, cv::Mat &dst);
+
+    ResizeMethod method() const { return m_method; }
+
+    /**
+     * @brief Separable filter for one axis in fixed point
+     *
+     * Output i reads count[i] source samples starting at start[i], with weights at
+     * weights[i * stride]. count[i] is rounded up to an even number (zero weights)
+     * so the SSE2 path can take taps in pairs.
+     */
+    struct FilterTaps {
+        std::vector<int> start;
+        std::vector<int> count;
+        std::vector<int16_t> weights;
+        int stride = 0;
+    };
+
+private:
+    cv::Size m_src_size;
+    cv::Size m_dst_size;
+    ResizeMethod m_method;
+    FilterTaps m_horizontal;               ///< Q14 weights over source columns
+    FilterTaps m_vertical;                 ///< Q7 weights over source rows
+    std::vector<int16_t> m_row;            ///< Vertically filtered source row (+ padding for 4-lane loads)
+    std::vector<const uint8_t*> m_rows;    ///< Source rows feeding the current output row
+    cv::Mat m_blurred;                     ///< BlurResize scratch (the source stays untouched)
+};
@@ -0,0 +1,192 @@
+#pragma once
+
+#include "StagedPipeline.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief Queue settings of one source
+ */
+struct SourcePolicy {
+    int weight;           ///< Share of the consumer's picks while the source has frames queued
+    size_t capacity;      ///< Frames queued at most
+    DropPolicy policy;    ///< What push() does when the queue is full (Latest evicts the oldest frame)
+};
+
+/**
+ * @brief Per-source bounded queues drained by one consumer in weighted round-robin order
+ *
+ * Every source pushes from its own thread into its own queue, with its own drop
+ * policy, so a camera that outruns the NPU only loses its own frames. pop() picks
+ * by smooth weighted round-robin among the sources that have a frame queued: while
+ * backlogged, a source with weight w gets w / sum(w) of the picks, spread out rather
+ * than in bursts, and an idle source banks no credit for later.
+ */
+template <typename T>
+class SourceScheduler {
+public:
+    struct Stats {
+        uint64_t pushed;      ///< Frames accepted into the queue
+        uint64_t dropped;     ///< Frames discarded by the drop policy (incoming or evicted)
+        uint64_t scheduled;   ///< Frames handed to the consumer
+        size_t depth;         ///< Frames queued now
+    };
+
+    /// on_drop releases a discarded frame; it is called without the lock held
+    SourceScheduler(const std::vector<SourcePolicy> &policies, std::function<void(size_t source, T &item)> on_drop) :
+        m_sources(policies.size()),
+        m_on_drop(std::move(on_drop))
+    {
+        for (size_t i = 0; i < policies.size(); i++) {
+            m_sources[i].policy = policies[i];
+            m_sources[i].policy.weight = std::max(policies[i].weight, 1);
+            m_sources[i].policy.capacity = std::max<size_t>(policies[i].capacity, 1);
+        }
+    }
+
+    SourceScheduler(const SourceScheduler &) = delete;
+    SourceScheduler &operator=(const SourceScheduler &) = delete;
+
+    /**
+     * @brief Producer side of source
+     *
+     * On a full queue: Block waits for space, Drop discards item, and Latest evicts the
+     * oldest queued frame to make room for item (unlike the StagedPipeline stage queues,
+     * which can only discard the incoming frame).
+     */
+    void push(size_t source, T item)
+    {
+        T dropped;
+        bool has_dropped = false;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            Queue &queue = m_sources[source];
+            if (queue.policy.policy == DropPolicy::Block) {
+                m_not_full.wait(lock, [&] { return m_closed || queue.items.size() < queue.policy.capacity; });
+            }
+            if (m_closed || (queue.items.size() >= queue.policy.capacity && queue.policy.policy == DropPolicy::Drop)) {
+                dropped = std::move(item);
+                has_dropped = true;
+            } else {
+                // latest: 가장 오래된 프레임을 버리고 새 프레임을 넣는다
+                if (queue.items.size() >= queue.policy.capacity) {
+                    dropped = std::move(queue.items.front());
+                    queue.items.pop_front();
+                    has_dropped = true;
+                    m_queued--;
+                }
+                queue.items.push_back(std::move(item));
+                queue.pushed++;
+                m_queued++;
+            }
+            if (has_dropped) {
+                queue.dropped++;
+            }
+        }
+        m_not_empty.notify_one();
+        if (has_dropped) {
+            m_on_drop(source, dropped);
+        }
+    }
+
+    /**
+     * @brief Takes the next frame (consumer side, one thread)
+     *
+     * Blocks while every queue is empty. Sources with DropPolicy::Latest skip to their
+     * newest queued frame.
+     *
+     * @return false once close() was called and every queue is drained
+     */
+    bool pop(size_t &source, T &item)
+    {
+        std::vector<T> skipped;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_not_empty.wait(lock, [this] { return m_closed || m_queued > 0; });
+            if (m_queued == 0) {
+                return false;
+            }
+
+            // smooth weighted round-robin: 대기 중인 소스만 weight만큼 credit을 얻고, 고른 소스는 합계만큼 잃는다
+            int64_t total = 0;
+            size_t best = m_sources.size();
+            for (size_t i = 0; i < m_sources.size(); i++) {
+                Queue &queue = m_sources[i];
+                if (queue.items.empty()) {
+                    continue;
+                }
+                queue.credit += queue.policy.weight;
+                total += queue.policy.weight;
+                if (best == m_sources.size() || queue.credit > m_sources[best].credit) {
+                    best = i;
+                }
+            }
+            Queue &queue = m_sources[best];
+            queue.credit -= total;
+
+            if (queue.policy.policy == DropPolicy::Latest) {
+                while (queue.items.size() > 1) {
+                    skipped.push_back(std::move(queue.items.front()));
+                    queue.items.pop_front();
+                    queue.dropped++;
+                    m_queued--;
+                }
+            }
+            source = best;
+            item = std::move(queue.items.front());
+            queue.items.pop_front();
+            queue.scheduled++;
+            m_queued--;
+        }
+        m_not_full.notify_all();
+        for (T &frame : skipped) {
+            m_on_drop(source, frame);
+        }
+        return true;
+    }
+
+    /// Wakes blocked producers (their frames are dropped) and lets pop() drain what is queued
+    void close()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_closed = true;
+        }
+        m_not_full.notify_all();
+        m_not_empty.notify_all();
+    }
+
+    Stats stats(size_t source) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const Queue &queue = m_sources[source];
+        return Stats{queue.pushed, queue.dropped, queue.scheduled, queue.items.size()};
+    }
+
+    size_t sources() const { return m_sources.size(); }
+
+private:
+    struct Queue {
+        SourcePolicy policy{1, 1, DropPolicy::Block};
+        std::deque<T> items;
+        int64_t credit = 0;
+        uint64_t pushed = 0;
+        uint64_t dropped = 0;
+        uint64_t scheduled = 0;
+    };
+
+    std::vector<Queue> m_sources;
+    std::function<void(size_t, T &)> m_on_drop;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_not_empty;
+    std::condition_variable m_not_full;
+    size_t m_queued = 0;
+    bool m_closed = false;
+};
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Bounded lock-free single-producer / single-consumer ring
+ *
+ * try_push() may only be called from one thread and try_pop() from one other
+ * thread. Neither call blocks or allocates; the slots are allocated once in the
+ * constructor. Head and tail live on separate cache lines so the two sides do
+ * not false-share, and each side caches the other's index to avoid touching it
+ * on every call.
+ */
+template <typename T>
+class SpscRing {
+public:
+    /// Holds up to capacity items (storage is rounded up to a power of two)
+    explicit SpscRing(size_t capacity) :
+        m_capacity(capacity > 0 ? capacity : 1)
+    {
+        size_t storage = 1;
+        while (storage < m_capacity) {
+            storage <<= 1;
+        }
+        m_slots.resize(storage);
+        m_mask = storage - 1;
+    }
+
+    SpscRing(const SpscRing &) = delete;
+    SpscRing &operator=(const SpscRing &) = delete;
+
+    /// Producer side. Returns false if the ring already holds capacity() items
+    bool try_push(const T &value)
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head_cache >= m_capacity) {
+            m_head_cache = m_head.load(std::memory_order_acquire);
+            if (tail - m_head_cache >= m_capacity) {
+                return false;
+            }
+        }
+        m_slots[tail & m_mask] = value;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Consumer side. Returns false if the ring is empty
+    bool try_pop(T &value)
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail_cache) {
+            m_tail_cache = m_tail.load(std::memory_order_acquire);
+            if (head == m_tail_cache) {
+                return false;
+            }
+        }
+        value = m_slots[head & m_mask];
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Approximate number of queued items (exact when both sides are idle)
+    size_t size() const
+    {
+        const size_t head = m_head.load(std::memory_order_acquire);
+        const size_t tail = m_tail.load(std::memory_order_acquire);
+        return tail - head;
+    }
+
+    size_t capacity() const { return m_capacity; }
+
+private:
+    std::vector<T> m_slots;
+    size_t m_mask = 0;
+    size_t m_capacity;
+
+    alignas(64) std::atomic<size_t> m_head{0};  ///< Next slot to pop (written by the consumer)
+    size_t m_tail_cache = 0;                    ///< Consumer's copy of m_tail
+    alignas(64) std::atomic<size_t> m_tail{0};  ///< Next slot to push (written by the producer)
+    size_t m_head_cache = 0;                    ///< Producer's copy of m_head
+};
@@ -0,0 +1,468 @@
+#include "StagedPipeline.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+using Clock = std::chrono::high_resolution_clock;
+
+static const char *STAGE_NAMES[] = {"ingest", "preprocess", "infer", "postprocess", "output"};
+
+bool parse_drop_policy(const std::string &name, DropPolicy &policy)
+{
+    if (name == "block") {
+        policy = DropPolicy::Block;
+    } else if (name == "drop") {
+        policy = DropPolicy::Drop;
+    } else if (name == "latest") {
+        policy = DropPolicy::Latest;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Wait strategy for an empty/full ring: spin with yield first, then short sleeps
+ *
+ * Keeps handoff latency in the microsecond range while a stage is busy, without
+ * burning a core while the camera is idle.
+ */
+class Backoff {
+public:
+    void wait()
+    {
+        if (m_spins < 64) {
+            m_spins++;
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+
+private:
+    int m_spins = 0;
+};
+
+StagedPipeline::StagedPipeline(CallbackData &cb_data, InferQueue &engine, GstElement *appsink,
+                               size_t queue_depth, DropPolicy policy, double stats_interval_s) :
+    m_cb(cb_data),
+    m_engine(engine),
+    m_appsink(appsink),
+    m_policy(policy),
+    m_stats_interval_s(stats_interval_s),
+    // 큐 세 개 + NPU 슬롯 + 각 단계 스레드가 손에 든 프레임
+    m_frames(3 * queue_depth + engine.capacity() + STAGE_COUNT),
+    m_in_use(new std::atomic<bool>[m_frames.size()]),
+    m_capture_queue(queue_depth),
+    m_complete_queue(queue_depth),
+    m_output_queue(queue_depth),
+    m_log_queue(256)
+{
+    const Config *config = m_cb.config;
+    for (size_t i = 0; i < m_frames.size(); i++) {
+        m_in_use[i].store(false, std::memory_order_relaxed);
+        m_frames[i] = FrameContext{};
+        m_frames[i].depth.create(config->model_height, config->model_width, CV_8SC1);
+    }
+}
+
+StagedPipeline::~StagedPipeline()
+{
+    stop();
+}
+
+void StagedPipeline::start()
+{
+    if (m_running) {
+        return;
+    }
+    m_running = true;
+    m_log = std::thread(&StagedPipeline::log_loop, this);
+    m_output = std::thread(&StagedPipeline::output_loop, this);
+    m_postprocess = std::thread(&StagedPipeline::postprocess_loop, this);
+    m_preprocess = std::thread(&StagedPipeline::preprocess_loop, this);
+    m_ingest = std::thread(&StagedPipeline::ingest_loop, this);
+}
+
+/**
+ * @brief Shuts the stages down front to back
+ *
+ * Each stage exits once its upstream is done and its input queue is empty, so
+ * every frame that was already pulled from the camera still reaches appsrc.
+ */
+void StagedPipeline::stop()
+{
+    if (!m_running) {
+        return;
+    }
+
+    m_stop_ingest = true;
+    m_ingest.join();
+    m_ingest_done = true;
+
+    m_preprocess.join();
+    m_engine.stop();  // in-flight 프레임은 on_infer_complete로 전달된 뒤 반환
+    m_infer_done = true;
+
+    m_postprocess.join();
+    m_postprocess_done = true;
+
+    m_output.join();
+    m_output_done = true;
+
+    m_log.join();
+    m_running = false;
+    print_stats();
+}
+
+// ==================== FRAME POOL / QUEUES ====================
+
+/**
+ * @brief Takes a free frame context from the pool (ingest thread only)
+ *
+ * @return Frame, or nullptr if the pool is exhausted under a drop policy or ingest is stopping
+ */
+FrameContext *StagedPipeline::acquire_frame()
+{
+    Backoff backoff;
+    while (!m_stop_ingest) {
+        for (size_t n = 0; n < m_frames.size(); n++) {
+            size_t i = (m_next_frame + n) % m_frames.size();
+            if (!m_in_use[i].load(std::memory_order_acquire)) {
+                m_in_use[i].store(true, std::memory_order_relaxed);
+                m_next_frame = i + 1;
+                return &m_frames[i];
+            }
+        }
+        if (m_policy != DropPolicy::Block) {
+            return nullptr;
+        }
+        backoff.wait();
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Unmaps the camera sample and returns the context to the pool (any thread)
+ */
+void StagedPipeline::release(FrameContext *ctx)
+{
+    release_frame(*ctx);
+    if (ctx->output) {
+        gst_buffer_unref(ctx->output);  // 합성됐지만 push 전에 버려진 프레임
+        ctx->output = nullptr;
+    }
+    m_in_use[ctx - m_frames.data()].store(false, std::memory_order_release);
+}
+
+/**
+ * @brief Hands ctx to the next stage, applying the drop policy when the queue is full
+ *
+ * @return false if the frame was dropped (and released)
+ */
+bool StagedPipeline::push(SpscRing<FrameContext*> &queue, Stage stage, FrameContext *ctx)
+{
+    Counters &counters = m_counters[stage];
+    if (!queue.try_push(ctx)) {
+        counters.stalls++;
+        if (m_policy != DropPolicy::Block) {
+            counters.dropped++;
+            release(ctx);
+            return false;
+        }
+        // 하류 단계는 상류가 끝날 때까지 큐를 비우므로 여기서 영원히 막히지 않음
+        Backoff backoff;
+        while (!queue.try_push(ctx)) {
+            backoff.wait();
+        }
+    }
+    counters.frames++;
+    return true;
+}
+
+/**
+ * @brief Waits for the next frame of a stage
+ *
+ * With DropPolicy::Latest, frames queued behind the newest one are released
+ * and counted as dropped by this stage.
+ *
+ * @return Frame, or nullptr once upstream is done and the queue is drained
+ */
+FrameContext *StagedPipeline::pop(SpscRing<FrameContext*> &queue, Stage stage,
+                                  const std::atomic<bool> &upstream_done)
+{
+    FrameContext *ctx = nullptr;
+    Backoff backoff;
+    while (!queue.try_pop(ctx)) {
+        if (upstream_done.load(std::memory_order_acquire)) {
+            // done 플래그를 본 뒤 한 번 더 확인 (마지막 push와의 경합)
+            if (!queue.try_pop(ctx)) {
+                return nullptr;
+            }
+            break;
+        }
+        backoff.wait();
+    }
+
+    if (m_policy == DropPolicy::Latest) {
+        FrameContext *newer = nullptr;
+        while (queue.try_pop(newer)) {
+            release(ctx);
+            m_counters[stage].dropped++;
+            ctx = newer;
+        }
+    }
+    return ctx;
+}
+
+void StagedPipeline::add_busy(Stage stage, Clock::time_point since)
+{
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - since).count();
+    m_counters[stage].busy_us += static_cast<uint64_t>(us);
+}
+
+// ==================== STAGES ====================
+
+/**
+ * @brief Pulls camera samples from appsink and maps them read-only
+ *
+ * A sample whose buffer cannot be mapped, or that finds the frame pool empty under
+ * a drop policy, is released right away and counted as an ingest drop.
+ */
+void StagedPipeline::ingest_loop()
+{
+    GstAppSink *appsink = GST_APP_SINK(m_appsink);
+    while (!m_stop_ingest) {
+        GstSample *sample = gst_app_sink_try_pull_sample(appsink, 100 * GST_MSECOND);
+        if (!sample) {
+            if (gst_app_sink_is_eos(appsink)) {
+                break;
+            }
+            continue;
+        }
+
+        auto t_start = Clock::now();
+        // 매핑할 수 없는 버퍼는 프레임 풀에서 꺼내기 전에 드롭
+        GstBuffer *buffer = gst_sample_get_buffer(sample);
+        GstMapInfo map;
+        if (!map_camera_buffer(&m_cb, buffer, map)) {
+            m_counters[INGEST].dropped++;
+            gst_sample_unref(sample);
+            continue;
+        }
+
+        FrameContext *ctx = acquire_frame();
+        if (!ctx) {
+            m_counters[INGEST].dropped++;
+            gst_buffer_unmap(buffer, &map);
+            gst_sample_unref(sample);
+            continue;
+        }
+
+        ctx->timing = FrameTiming{};
+        ctx->timing.t_start = t_start;
+        ctx->sample = sample;
+        ctx->buffer = buffer;
+        ctx->map = map;
+        stamp_capture(&m_cb, m_appsink, ctx->buffer, ctx->timing);
+        add_busy(INGEST, t_start);
+        timeline_span(TimelineSpan::Ingest, ctx->timing.frame_id, t_start, Clock::now());
+
+        push(m_capture_queue, INGEST, ctx);
+    }
+}
+
+/**
+ * @brief Resizes camera frames into NPU input slots and submits them
+ *
+ * acquire() blocks while every NPU slot is in flight; that wait is counted as a stall.
+ */
+void StagedPipeline::preprocess_loop()
+{
+    const Config *config = m_cb.config;
+    while (FrameContext *ctx = pop(m_capture_queue, PREPROCESS, m_ingest_done)) {
+        auto t_wait = Clock::now();
+        InferJob *job = m_engine.acquire();
+        if (!job) {
+            m_counters[PREPROCESS].dropped++;
+            release(ctx);
+            continue;
+        }
+
+        FrameTiming &timing = ctx->timing;
+        timing.t_preprocess_start = Clock::now();
+        if (timing.t_preprocess_start - t_wait > std::chrono::microseconds(100)) {
+            m_counters[PREPROCESS].stalls++;
+        }
+
+        const cv::Mat raw_img(config->video_inHeight, config->video_inWidth, CV_8UC3, ctx->map.data);
+        offer_models(&m_cb, timing, raw_img);
+        FrameResizer *resizer = select_model(&m_cb, *ctx, job);
+        cv::Mat input_img(model_size(&m_cb, *ctx), CV_8UC3, job->input);
+        resizer->resize(raw_img, input_img);
+        timing.t_preprocess_end = Clock::now();
+        add_busy(PREPROCESS, timing.t_preprocess_start);
+        timeline_span(TimelineSpan::Preprocess, timing.frame_id, timing.t_preprocess_start, timing.t_preprocess_end);
+
+        timing.t_infer_start = Clock::now();
+        mark_infer_start(&m_cb, timing);
+        job->user_data = ctx;
+        job->trace_id = timing.frame_id;
+        if (m_engine.submit(job) != HAILO_SUCCESS) {
+            m_counters[PREPROCESS].dropped++;
+            count_infer_failure(&m_cb);
+            release(ctx);
+            continue;
+        }
+        m_counters[PREPROCESS].frames++;
+    }
+}
+
+/**
+ * @brief Copies the int8 output out of the NPU slot so the slot can be reused right away
+ */
+void StagedPipeline::on_infer_complete(InferJob &job)
+{
+    FrameContext *ctx = static_cast<FrameContext*>(job.user_data);
+    FrameTiming &timing = ctx->timing;
+    timing.t_infer_end = Clock::now();
+    m_counters[INFER].busy_us += static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(timing.t_infer_end - timing.t_infer_start).count());
+
+    if (job.status != HAILO_SUCCESS) {
+        std::cerr << "[ERROR] Async inference failed with status: " << job.status << std::endl;
+        m_counters[INFER].dropped++;
+        count_infer_failure(&m_cb);
+        release(ctx);
+        return;
+    }
+
+    // 해상도 사다리: 전환 뒤 처음 쓰는 컨텍스트만 다시 할당된다
+    model_frame_done(&m_cb, *ctx);
+    ctx->depth.create(model_size(&m_cb, *ctx), CV_8SC1);
+    std::memcpy(ctx->depth.data, job.output, ctx->depth.total());
+    timing.bytes_copied += ctx->depth.total();
+    push(m_complete_queue, INFER, ctx);
+}
+
+void StagedPipeline::postprocess_loop()
+{
+    const Config *config = m_cb.config;
+    while (FrameContext *ctx = pop(m_complete_queue, POSTPROCESS, m_infer_done)) {
+        FrameTiming &timing = ctx->timing;
+        timing.t_postprocess_start = Clock::now();
+        write_depth(&m_cb, timing, ctx->depth);
+        cv::Mat raw_img(config->video_inHeight, config->video_inWidth, CV_8UC3, ctx->map.data);
+        GstFlowReturn ret = compose_output(&m_cb, raw_img, ctx->depth, &ctx->output);
+        timing.t_postprocess_end = Clock::now();
+        add_busy(POSTPROCESS, timing.t_postprocess_start);
+        timeline_span(TimelineSpan::Postprocess, timing.frame_id, timing.t_postprocess_start, timing.t_postprocess_end);
+        if (ret != GST_FLOW_OK) {
+            m_counters[POSTPROCESS].dropped++;
+            release(ctx);
+            continue;
+        }
+        if (ctx->output) {
+            timing.bytes_copied += raw_img.total() * raw_img.elemSize();  // 카메라 → 왼쪽 절반
+        }
+
+        push(m_output_queue, POSTPROCESS, ctx);
+    }
+}
+
+/**
+ * @brief Pushes composed pool buffers to appsrc, releases the camera sample, queues the frame timing
+ */
+void StagedPipeline::output_loop()
+{
+    while (FrameContext *ctx = pop(m_output_queue, OUTPUT, m_postprocess_done)) {
+        auto t_push = Clock::now();
+        GstFlowReturn ret = push_frame(&m_cb, ctx->timing, ctx->output);
+        ctx->output = nullptr;  // appsrc가 소유
+        if (ret != GST_FLOW_OK) {
+            std::cerr << "[ERROR] appsrc push failed: " << gst_flow_get_name(ret) << std::endl;
+        }
+        ctx->timing.t_end = Clock::now();
+        add_busy(OUTPUT, t_push);
+
+        FrameTiming timing = ctx->timing;
+        release(ctx);
+        m_counters[OUTPUT].frames++;
+
+        // 로그 스레드가 밀려도 출력은 기다리지 않음
+        if (!m_log_queue.try_push(timing)) {
+            m_log_dropped++;
+        }
+    }
+}
+
+/**
+ * @brief Passes frame timings to the TraceLog and prints the periodic per-stage report
+ */
+void StagedPipeline::log_loop()
+{
+    auto last_report = Clock::now();
+    Backoff backoff;
+    while (true) {
+        FrameTiming timing;
+        if (m_log_queue.try_pop(timing)) {
+            log_timing(&m_cb, timing);
+            backoff = Backoff();
+        } else if (m_output_done.load(std::memory_order_acquire)) {
+            if (!m_log_queue.try_pop(timing)) {
+                break;
+            }
+            log_timing(&m_cb, timing);
+        } else {
+            backoff.wait();
+        }
+
+        if (m_stats_interval_s > 0 &&
+            std::chrono::duration<double>(Clock::now() - last_report).count() >= m_stats_interval_s) {
+            print_stats();
+            last_report = Clock::now();
+        }
+    }
+}
+
+// ==================== STATS ====================
+
+std::vector<StageStats> StagedPipeline::stats() const
+{
+    // 각 단계 뒤의 큐 (preprocess 뒤는 NPU in-flight 슬롯)
+    const uint64_t submitted = m_counters[PREPROCESS].frames.load();
+    const uint64_t completed = m_counters[INFER].frames.load() + m_counters[INFER].dropped.load();
+    const size_t in_flight = submitted > completed ? static_cast<size_t>(submitted - completed) : 0;
+
+    const size_t depths[STAGE_COUNT] = {
+        m_capture_queue.size(), in_flight, m_complete_queue.size(), m_output_queue.size(), m_log_queue.size()};
+    const size_t capacities[STAGE_COUNT] = {
+        m_capture_queue.capacity(), m_engine.capacity(), m_complete_queue.capacity(),
+        m_output_queue.capacity(), m_log_queue.capacity()};
+
+    std::vector<StageStats> result;
+    for (int s = 0; s < STAGE_COUNT; s++) {
+        const Counters &c = m_counters[s];
+        result.push_back(StageStats{STAGE_NAMES[s], c.frames.load(), c.dropped.load(), c.stalls.load(),
+                                    c.busy_us.load(), depths[s], capacities[s]});
+    }
+    return result;
+}
+
+void StagedPipeline::print_stats()
+{
+    std::cout << "📊 stage        frames  dropped   stalls  busy(ms)  queue" << std::endl;
+    for (const StageStats &s : stats()) {
+        std::cout << "   " << std::left << std::setw(12) << s.name << std::right
+                  << std::setw(8) << s.frames
+                  << std::setw(9) << s.dropped
+                  << std::setw(9) << s.stalls
+                  << std::setw(10) << s.busy_us / 1000
+                  << "  " << s.queue_depth << "/" << s.queue_capacity << std::endl;
+    }
+    if (m_log_dropped) {
+        std::cout << "   timings dropped before the trace: " << m_log_dropped.load() << std::endl;
+    }
+}
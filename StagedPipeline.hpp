@@ -0,0 +1,140 @@
+#pragma once
+
+#include "gstreaming.hpp"
+#include "InferEngine.hpp"
+#include "SpscRing.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief What a stage does when the queue it feeds is full
+ *
+ * Latest on a full queue depends on the queue: a StagedPipeline stage queue (SPSC, the
+ * producer cannot take the oldest frame back) discards the frame being pushed like Drop,
+ * while a SourceScheduler source queue evicts its oldest frame to keep the incoming one.
+ */
+enum class DropPolicy {
+    Block,   ///< Wait for space (backpressure reaches the camera, nothing is lost)
+    Drop,    ///< Discard the frame being pushed
+    Latest,  ///< Consumers skip to the newest queued frame (lowest latency)
+};
+
+/**
+ * @brief Parses a pipeline.drop_policy value ("block", "drop" or "latest")
+ *
+ * @return false if the name is unknown (policy is left untouched)
+ */
+bool parse_drop_policy(const std::string &name, DropPolicy &policy);
+
+/**
+ * @brief Counters of one stage, readable from any thread while the pipeline runs
+ */
+struct StageStats {
+    const char *name;
+    uint64_t frames;         ///< Frames this stage handed downstream
+    uint64_t dropped;        ///< Frames discarded by the drop policy at this stage
+    uint64_t stalls;         ///< Times the stage had to wait for downstream space (queue full / no NPU slot)
+    uint64_t busy_us;        ///< Time spent working, excluding waits
+    size_t queue_depth;      ///< Frames currently queued in front of the next stage
+    size_t queue_capacity;
+};
+
+/**
+ * @brief Thread-per-stage executor for the depth pipeline
+ *
+ * ingest → preprocess → NPU (InferQueue writer/reader) → postprocess → output → log
+ *
+ * Each stage runs on its own thread and hands FrameContext pointers to the next
+ * through a bounded SpscRing, so a frame's stages overlap with its neighbours'
+ * and steady-state throughput is set by the slowest stage rather than by the sum.
+ * Frame contexts come from a fixed pool sized for every queue plus the NPU slots.
+ * The log thread hands each frame's timing to the TraceLog, whose flusher thread writes
+ * the binary trace and the once-per-second summary, and prints the per-stage report.
+ */
+class StagedPipeline {
+public:
+    /**
+     * @param[in] cb_data Shared callback data (session, resizer, colorizer, appsrc, log file)
+     * @param[in] engine Inference queue; its completion callback must call on_infer_complete()
+     * @param[in] appsink appsink to pull camera samples from (emit-signals off)
+     * @param[in] queue_depth Capacity of each inter-stage queue
+     * @param[in] policy Behaviour when a queue is full
+     * @param[in] stats_interval_s Period of the per-stage console report (0 = off)
+     */
+    StagedPipeline(CallbackData &cb_data, InferQueue &engine, GstElement *appsink,
+                   size_t queue_depth, DropPolicy policy, double stats_interval_s);
+    ~StagedPipeline();
+
+    StagedPipeline(const StagedPipeline &) = delete;
+    StagedPipeline &operator=(const StagedPipeline &) = delete;
+
+    void start();
+
+    /// Stops pulling camera frames, pushes every frame already in the pipeline to appsrc, joins all threads
+    void stop();
+
+    /// Completion hook for the InferQueue (runs on its completion thread)
+    void on_infer_complete(InferJob &job);
+
+    /// Snapshot of every stage's counters, in pipeline order
+    std::vector<StageStats> stats() const;
+
+private:
+    enum Stage { INGEST, PREPROCESS, INFER, POSTPROCESS, OUTPUT, STAGE_COUNT };
+
+    struct Counters {
+        std::atomic<uint64_t> frames{0};
+        std::atomic<uint64_t> dropped{0};
+        std::atomic<uint64_t> stalls{0};
+        std::atomic<uint64_t> busy_us{0};
+    };
+
+    void ingest_loop();
+    void preprocess_loop();
+    void postprocess_loop();
+    void output_loop();
+    void log_loop();
+
+    FrameContext *acquire_frame();
+    void release(FrameContext *ctx);
+    bool push(SpscRing<FrameContext*> &queue, Stage stage, FrameContext *ctx);
+    FrameContext *pop(SpscRing<FrameContext*> &queue, Stage stage, const std::atomic<bool> &upstream_done);
+    void add_busy(Stage stage, std::chrono::high_resolution_clock::time_point since);
+    void print_stats();
+
+    CallbackData &m_cb;
+    InferQueue &m_engine;
+    GstElement *m_appsink;
+    DropPolicy m_policy;
+    double m_stats_interval_s;
+
+    std::vector<FrameContext> m_frames;                 ///< Frame pool
+    std::unique_ptr<std::atomic<bool>[]> m_in_use;      ///< Set by ingest, cleared by whichever stage releases
+    size_t m_next_frame = 0;                            ///< Ingest's pool scan position
+
+    SpscRing<FrameContext*> m_capture_queue;            ///< ingest → preprocess
+    SpscRing<FrameContext*> m_complete_queue;           ///< NPU completion → postprocess
+    SpscRing<FrameContext*> m_output_queue;             ///< postprocess → output
+    SpscRing<FrameTiming> m_log_queue;                  ///< output → log (never blocks output)
+
+    Counters m_counters[STAGE_COUNT];
+    std::atomic<uint64_t> m_log_dropped{0};             ///< Frame timings lost before TraceLog::record() because the log thread fell behind
+
+    std::atomic<bool> m_stop_ingest{false};
+    std::atomic<bool> m_ingest_done{false};
+    std::atomic<bool> m_infer_done{false};
+    std::atomic<bool> m_postprocess_done{false};
+    std::atomic<bool> m_output_done{false};
+    bool m_running = false;
+
+    std::thread m_ingest;
+    std::thread m_preprocess;
+    std::thread m_postprocess;
+    std::thread m_output;
+    std::thread m_log;
+};
@@ -0,0 +1,226 @@
+#include "Timeline.hpp"
+
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <iostream>
+
+std::atomic<Timeline*> Timeline::s_active{nullptr};
+
+namespace {
+
+// 스레드별 링: 어느 Timeline 세션에 등록했는지 세대 번호로 구분
+std::atomic<uint64_t> g_generation{0};
+thread_local uint64_t t_generation = 0;
+thread_local void *t_producer = nullptr;
+
+int64_t to_ns(Timeline::Clock::time_point t)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+}
+
+}  // namespace
+
+const char *timeline_span_name(TimelineSpan span)
+{
+    switch (span) {
+    case TimelineSpan::Ingest: return "ingest";
+    case TimelineSpan::Preprocess: return "preprocess";
+    case TimelineSpan::Infer: return "infer";
+    case TimelineSpan::NpuWrite: return "npu_write";
+    case TimelineSpan::NpuRead: return "npu_read";
+    case TimelineSpan::BatchInfer: return "batch_infer";
+    case TimelineSpan::Postprocess: return "postprocess";
+    case TimelineSpan::Push: return "push";
+    case TimelineSpan::Queue1Out: return "queue1_out";
+    case TimelineSpan::AppsinkIn: return "appsink_in";
+    case TimelineSpan::AppsrcOut: return "appsrc_out";
+    default: return "?";
+    }
+}
+
+Timeline::~Timeline()
+{
+    stop();
+}
+
+bool Timeline::start(const std::string &path)
+{
+    m_file.open(path, std::ios::trunc);
+    if (!m_file.is_open()) {
+        std::cerr << "[ERROR] Failed to open timeline file: " << path << std::endl;
+        return false;
+    }
+    m_pid = static_cast<long>(getpid());
+    m_origin_ns = to_ns(Clock::now());
+    m_file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+           << "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":" << m_pid << ",\"args\":{\"name\":\"hailo-depth\"}}";
+
+    g_generation.fetch_add(1, std::memory_order_relaxed);
+    m_stop = false;
+    m_running = true;
+    m_flusher = std::thread(&Timeline::flush_loop, this);
+    s_active.store(this, std::memory_order_release);
+    std::cout << "타임라인 기록: " << path << " (ui.perfetto.dev에서 열기)" << std::endl;
+    return true;
+}
+
+void Timeline::stop()
+{
+    if (!m_running) {
+        return;
+    }
+    Timeline *self = this;
+    s_active.compare_exchange_strong(self, nullptr, std::memory_order_acq_rel);
+    m_stop = true;
+    m_flusher.join();
+    m_running = false;
+    m_file << "\n]}\n";
+    m_file.close();
+}
+
+void Timeline::span(TimelineSpan name, uint64_t frame_id, Clock::time_point begin, Clock::time_point end)
+{
+    push(Record{to_ns(begin), to_ns(end), frame_id, static_cast<uint8_t>(name)});
+}
+
+void Timeline::instant(TimelineSpan name, uint64_t frame_id)
+{
+    push(Record{to_ns(Clock::now()), -1, frame_id, static_cast<uint8_t>(name)});
+}
+
+/**
+ * @brief Queues a record on the calling thread's ring (no lock after the thread's first record)
+ */
+void Timeline::push(const Record &record)
+{
+    Producer *producer = static_cast<Producer*>(t_producer);
+    if (!producer || t_generation != g_generation.load(std::memory_order_relaxed)) {
+        producer = register_thread();
+    }
+    if (!producer->ring.try_push(record)) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+Timeline::Producer *Timeline::register_thread()
+{
+    std::unique_ptr<Producer> producer(new Producer(8192));
+    producer->tid = static_cast<long>(syscall(SYS_gettid));
+    char name[16] = {};
+    if (pthread_getname_np(pthread_self(), name, sizeof(name)) == 0) {
+        for (const char *c = name; *c; c++) {
+            producer->thread_name += (*c == '"' || *c == '\\' || *c < 0x20) ? '_' : *c;  // JSON 문자열에 그대로 쓴다
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_producers.push_back(std::move(producer));
+    t_producer = m_producers.back().get();
+    t_generation = g_generation.load(std::memory_order_relaxed);
+    return m_producers.back().get();
+}
+
+void Timeline::write_record(const Producer &producer, const Record &record)
+{
+    char line[320];
+    const double ts_us = (record.begin_ns - m_origin_ns) / 1000.0;
+    const char *name = record.name < static_cast<uint8_t>(TimelineSpan::Count)
+                           ? timeline_span_name(static_cast<TimelineSpan>(record.name)) : "?";
+    int n;
+    if (record.end_ns >= 0) {
+        n = std::snprintf(line, sizeof(line),
+                          ",\n{\"ph\":\"X\",\"cat\":\"stage\",\"name\":\"%s\",\"pid\":%ld,\"tid\":%ld,\"ts\":%.3f,\"dur\":%.3f",
+                          name, m_pid, producer.tid, ts_us, (record.end_ns - record.begin_ns) / 1000.0);
+    } else {
+        n = std::snprintf(line, sizeof(line),
+                          ",\n{\"ph\":\"i\",\"s\":\"t\",\"cat\":\"pad\",\"name\":\"%s\",\"pid\":%ld,\"tid\":%ld,\"ts\":%.3f",
+                          name, m_pid, producer.tid, ts_us);
+    }
+    m_file.write(line, n);
+    if (record.frame_id != TIMELINE_NO_FRAME) {
+        n = std::snprintf(line, sizeof(line), ",\"args\":{\"frame\":%llu}}",
+                          static_cast<unsigned long long>(record.frame_id));
+    } else {
+        n = std::snprintf(line, sizeof(line), "}");
+    }
+    m_file.write(line, n);
+}
+
+/**
+ * @brief Converts queued records of every thread to JSON
+ *
+ * @return Number of records written
+ */
+size_t Timeline::drain()
+{
+    std::vector<Producer*> producers;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto &producer : m_producers) {
+            producers.push_back(producer.get());
+        }
+    }
+
+    size_t total = 0;
+    for (Producer *producer : producers) {
+        if (!producer->named) {
+            // 스레드 이름 메타데이터 (GStreamer 스트리밍 스레드는 "queue1:src" 같은 이름)
+            m_file << ",\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":" << m_pid << ",\"tid\":" << producer->tid
+                   << ",\"args\":{\"name\":\"" << (producer->thread_name.empty() ? "thread" : producer->thread_name)
+                   << "\"}}";
+            producer->named = true;
+        }
+        Record record;
+        while (producer->ring.try_pop(record)) {
+            write_record(*producer, record);
+            total++;
+        }
+    }
+    return total;
+}
+
+void Timeline::flush_loop()
+{
+    while (!m_stop.load(std::memory_order_acquire)) {
+        if (drain() == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+    }
+    drain();
+    m_file.flush();
+    if (m_dropped.load(std::memory_order_relaxed)) {
+        std::cout << "타임라인: " << m_dropped.load(std::memory_order_relaxed) << " 이벤트 누락 (링 가득 참)" << std::endl;
+    }
+}
+
+// user_data: 하위 16비트 = TimelineSpan, TAGGED_PROBE = 버퍼 offset이 프레임 ID
+constexpr guint TAGGED_PROBE = 1u << 16;
+
+static GstPadProbeReturn timeline_probe(GstPad *, GstPadProbeInfo *info, gpointer user_data)
+{
+    if (Timeline *timeline = Timeline::active()) {
+        const guint flags = GPOINTER_TO_UINT(user_data);
+        GstBuffer *buffer = GST_PAD_PROBE_INFO_BUFFER(info);
+        uint64_t frame_id = TIMELINE_NO_FRAME;
+        if ((flags & TAGGED_PROBE) && buffer && GST_BUFFER_OFFSET(buffer) != GST_BUFFER_OFFSET_NONE) {
+            frame_id = GST_BUFFER_OFFSET(buffer);
+        }
+        timeline->instant(static_cast<TimelineSpan>(flags & 0xffff), frame_id);
+    }
+    return GST_PAD_PROBE_OK;
+}
+
+void add_timeline_probe(GstElement *element, const char *pad_name, TimelineSpan name, bool tagged)
+{
+    GstPad *pad = gst_element_get_static_pad(element, pad_name);
+    if (!pad) {
+        std::cerr << "[ERROR] No pad " << pad_name << " on " << GST_ELEMENT_NAME(element) << std::endl;
+        return;
+    }
+    const guint flags = static_cast<guint>(name) | (tagged ? TAGGED_PROBE : 0);
+    gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER, timeline_probe, GUINT_TO_POINTER(flags), nullptr);
+    gst_object_unref(pad);
+}
@@ -0,0 +1,154 @@
+#pragma once
+
+#include "SpscRing.hpp"
+
+#include <gst/gst.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Name of a timeline span / instant
+ */
+enum class TimelineSpan : uint8_t {
+    Ingest = 0,    ///< Sample pulled and mapped (staged ingest)
+    Preprocess,
+    Infer,         ///< Synchronous infer() call
+    NpuWrite,      ///< Async engine: input written to the device
+    NpuRead,       ///< Async engine: output read back (blocks while the NPU works)
+    BatchInfer,    ///< FrameBatcher: one infer() for a whole batch (frame = first frame)
+    Postprocess,
+    Push,          ///< appsrc push
+    Queue1Out,     ///< Instant: buffer left queue1
+    AppsinkIn,     ///< Instant: buffer reached the appsink
+    AppsrcOut,     ///< Instant: buffer left the appsrc
+    Count
+};
+
+const char *timeline_span_name(TimelineSpan span);
+
+constexpr uint64_t TIMELINE_NO_FRAME = UINT64_MAX;
+
+/**
+ * @brief Optional per-thread span recorder exported as Chrome trace-event JSON (Perfetto)
+ *
+ * Every thread that records gets its own SpscRing the first time it records, so
+ * stages running on the appsink, engine and staged threads show up on separate
+ * tracks. A flusher thread turns the events into JSON; the file can be opened in
+ * ui.perfetto.dev or chrome://tracing.
+ *
+ * While no Timeline is started, active() is nullptr and every recording site costs
+ * one atomic load and a branch. stop() must run after the pipelines have stopped.
+ */
+class Timeline {
+public:
+    using Clock = std::chrono::high_resolution_clock;  ///< Same clock as FrameTiming
+
+    Timeline() = default;
+    ~Timeline();
+
+    Timeline(const Timeline &) = delete;
+    Timeline &operator=(const Timeline &) = delete;
+
+    /// Opens the JSON file and makes this the active timeline
+    bool start(const std::string &path);
+    /// Deactivates, writes the remaining events and closes the JSON
+    void stop();
+
+    static Timeline *active() { return s_active.load(std::memory_order_acquire); }
+
+    void span(TimelineSpan name, uint64_t frame_id, Clock::time_point begin, Clock::time_point end);
+    void instant(TimelineSpan name, uint64_t frame_id);
+
+    uint64_t dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    struct Record {
+        int64_t begin_ns;
+        int64_t end_ns;     ///< -1 for an instant
+        uint64_t frame_id;
+        uint8_t name;       ///< TimelineSpan
+    };
+
+    struct Producer {
+        explicit Producer(size_t capacity) : ring(capacity) {}
+        SpscRing<Record> ring;
+        long tid = 0;
+        std::string thread_name;
+        bool named = false;  ///< thread_name metadata written (flusher only)
+    };
+
+    void push(const Record &record);
+    Producer *register_thread();
+    size_t drain();
+    void write_record(const Producer &producer, const Record &record);
+    void flush_loop();
+
+    static std::atomic<Timeline*> s_active;
+
+    std::mutex m_mutex;                               ///< Guards m_producers (registration only)
+    std::vector<std::unique_ptr<Producer>> m_producers;
+    std::atomic<uint64_t> m_dropped{0};
+
+    std::ofstream m_file;
+    int64_t m_origin_ns = 0;
+    long m_pid = 0;
+    std::atomic<bool> m_stop{false};
+    bool m_running = false;
+    std::thread m_flusher;
+};
+
+/**
+ * @brief Records a span on the active timeline (no-op when tracing is off)
+ */
+inline void timeline_span(TimelineSpan name, uint64_t frame_id, Timeline::Clock::time_point begin,
+                          Timeline::Clock::time_point end)
+{
+    if (Timeline *timeline = Timeline::active()) {
+        timeline->span(name, frame_id, begin, end);
+    }
+}
+
+/**
+ * @brief Records the enclosing scope as a span when tracing is on
+ */
+class TimelineScope {
+public:
+    TimelineScope(TimelineSpan name, uint64_t frame_id) :
+        m_timeline(Timeline::active()), m_name(name), m_frame_id(frame_id)
+    {
+        if (m_timeline) {
+            m_begin = Timeline::Clock::now();
+        }
+    }
+    ~TimelineScope()
+    {
+        if (m_timeline) {
+            m_timeline->span(m_name, m_frame_id, m_begin, Timeline::Clock::now());
+        }
+    }
+
+    TimelineScope(const TimelineScope &) = delete;
+    TimelineScope &operator=(const TimelineScope &) = delete;
+
+private:
+    Timeline *m_timeline;
+    TimelineSpan m_name;
+    uint64_t m_frame_id;
+    Timeline::Clock::time_point m_begin;
+};
+
+/**
+ * @brief Adds an instant event for every buffer passing element's pad
+ *
+ * @param[in] tagged true on pads downstream of push_frame(), whose buffers carry the
+ *                   frame ID in their offset; upstream instants have no frame ID yet
+ */
+void add_timeline_probe(GstElement *element, const char *pad_name, TimelineSpan name, bool tagged);
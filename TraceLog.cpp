@@ -0,0 +1,213 @@
+#include "TraceLog.hpp"
+#include "LatencyTracer.hpp"
+#include "gstreaming.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+const char *trace_stage_name(TraceStage stage)
+{
+    switch (stage) {
+    case TraceStage::Frame: return "frame";
+    case TraceStage::Preprocess: return "preprocess";
+    case TraceStage::Infer: return "infer";
+    case TraceStage::Postprocess: return "postprocess";
+    case TraceStage::Push: return "push";
+    case TraceStage::CaptureToInfer: return "capture_to_infer";
+    case TraceStage::CaptureToPush: return "capture_to_push";
+    default: return "?";
+    }
+}
+
+static int64_t to_ns(std::chrono::high_resolution_clock::time_point t)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+}
+
+TraceLog::TraceLog(size_t capacity_events) :
+    m_ring(capacity_events)
+{}
+
+TraceLog::~TraceLog()
+{
+    stop();
+}
+
+bool TraceLog::start(const std::string &path, LatencyTracer *latency)
+{
+    m_file.open(path, std::ios::binary | std::ios::app);
+    if (!m_file.is_open()) {
+        std::cerr << "[ERROR] Failed to open trace file: " << path << std::endl;
+        return false;
+    }
+
+    TraceFileHeader header = {};
+    std::memcpy(header.magic, "HDTR", 4);
+    header.version = TRACE_FILE_VERSION;
+    header.event_size = sizeof(TraceEvent);
+    header.wall_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    header.clock_ns = to_ns(std::chrono::high_resolution_clock::now());
+    m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    m_latency = latency;
+    m_stop = false;
+    m_running = true;
+    m_flusher = std::thread(&TraceLog::flush_loop, this);
+    return true;
+}
+
+void TraceLog::stop()
+{
+    if (!m_running) {
+        return;
+    }
+    m_stop = true;
+    m_flusher.join();
+    m_running = false;
+    m_file.close();
+}
+
+/**
+ * @brief Queues the frame's stage spans (no lock, no allocation, no I/O)
+ */
+void TraceLog::record(const FrameTiming &timing)
+{
+    constexpr size_t EVENTS_PER_FRAME = 7;
+    // 타임라인 / 출력 버퍼와 같은 프레임 ID: 드롭된 카메라 프레임은 번호가 비어 보인다
+    const uint64_t frame_id = timing.frame_id;
+    m_recorded++;
+    // 한 프레임의 이벤트는 전부 넣거나 전부 버린다
+    if (m_ring.capacity() - m_ring.size() < EVENTS_PER_FRAME) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    auto span = [&](TraceStage stage, int64_t begin_ns, int64_t end_ns, uint32_t value) {
+        TraceEvent event = {};
+        event.frame_id = frame_id;
+        event.begin_ns = begin_ns;
+        event.end_ns = end_ns;
+        event.value = value;
+        event.stage = static_cast<uint8_t>(stage);
+        m_ring.try_push(event);
+    };
+
+    const int64_t t_infer_start = to_ns(timing.t_infer_start);
+    const int64_t t_end = to_ns(timing.t_end);
+    span(TraceStage::Frame, to_ns(timing.t_start), t_end,
+         static_cast<uint32_t>(std::min<size_t>(timing.bytes_copied, UINT32_MAX)));
+    span(TraceStage::Preprocess, to_ns(timing.t_preprocess_start), to_ns(timing.t_preprocess_end), 0);
+    span(TraceStage::Infer, t_infer_start, to_ns(timing.t_infer_end), 0);
+    span(TraceStage::Postprocess, to_ns(timing.t_postprocess_start), to_ns(timing.t_postprocess_end), 0);
+    span(TraceStage::Push, to_ns(timing.t_postprocess_end), t_end, 0);
+    // 캡처 지연은 측정 시점에서 거꾸로 계산한 구간으로 저장
+    if (GST_CLOCK_TIME_IS_VALID(timing.capture_to_infer)) {
+        span(TraceStage::CaptureToInfer, t_infer_start - static_cast<int64_t>(timing.capture_to_infer), t_infer_start, 0);
+    }
+    if (GST_CLOCK_TIME_IS_VALID(timing.capture_to_push)) {
+        span(TraceStage::CaptureToPush, t_end - static_cast<int64_t>(timing.capture_to_push), t_end, 0);
+    }
+}
+
+/**
+ * @brief Writes queued events to the file and folds them into the console window
+ *
+ * @return Number of events drained
+ */
+size_t TraceLog::drain()
+{
+    TraceEvent batch[256];
+    size_t total = 0;
+    while (true) {
+        size_t n = 0;
+        while (n < 256 && m_ring.try_pop(batch[n])) {
+            n++;
+        }
+        if (n == 0) {
+            break;
+        }
+        m_file.write(reinterpret_cast<const char*>(batch), n * sizeof(TraceEvent));
+
+        for (size_t i = 0; i < n; i++) {
+            const TraceEvent &event = batch[i];
+            const int s = event.stage;
+            if (s >= static_cast<int>(TraceStage::Count)) {
+                continue;
+            }
+            const double ms = (event.end_ns - event.begin_ns) / 1e6;
+            m_window.sum_ms[s] += ms;
+            m_window.max_ms[s] = std::max(m_window.max_ms[s], ms);
+            m_window.count[s]++;
+            if (event.stage == static_cast<uint8_t>(TraceStage::Frame)) {
+                m_window.frames++;
+            }
+            if (m_latency) {
+                const GstClockTime ns = static_cast<GstClockTime>(std::max<int64_t>(event.end_ns - event.begin_ns, 0));
+                if (event.stage == static_cast<uint8_t>(TraceStage::CaptureToInfer)) {
+                    m_latency->record(LatencyTracer::INFER_START, ns);
+                } else if (event.stage == static_cast<uint8_t>(TraceStage::CaptureToPush)) {
+                    m_latency->record(LatencyTracer::PUSH, ns);
+                }
+            }
+        }
+        total += n;
+    }
+    return total;
+}
+
+void TraceLog::flush_loop()
+{
+    using Clock = std::chrono::steady_clock;
+    auto last_summary = Clock::now();
+    while (!m_stop.load(std::memory_order_acquire)) {
+        if (drain() == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+        const double elapsed = std::chrono::duration<double>(Clock::now() - last_summary).count();
+        if (elapsed >= 1.0) {
+            m_file.flush();
+            print_summary(elapsed);
+            last_summary = Clock::now();
+        }
+    }
+    // 종료: 남은 이벤트까지 기록
+    drain();
+    m_file.flush();
+    print_summary(std::chrono::duration<double>(Clock::now() - last_summary).count());
+}
+
+void TraceLog::print_summary(double seconds)
+{
+    const Window &w = m_window;
+    auto mean = [&w](TraceStage stage) {
+        const int s = static_cast<int>(stage);
+        return w.count[s] ? w.sum_ms[s] / w.count[s] : 0.0;
+    };
+
+    const uint64_t dropped = m_dropped.load(std::memory_order_relaxed);
+    if (w.frames > 0) {
+        std::ostringstream line;
+        line << std::fixed << std::setprecision(1)
+             << "⏱️  " << w.frames / std::max(seconds, 1e-3) << " fps | "
+             << "전처리: " << mean(TraceStage::Preprocess) << "ms | "
+             << "추론: " << mean(TraceStage::Infer) << "ms | "
+             << "후처리: " << mean(TraceStage::Postprocess) << "ms | "
+             << "전체: " << mean(TraceStage::Frame) << "ms (max "
+             << w.max_ms[static_cast<int>(TraceStage::Frame)] << ")";
+        if (w.count[static_cast<int>(TraceStage::CaptureToPush)]) {
+            line << " | 캡처→출력: " << mean(TraceStage::CaptureToPush) << "ms";
+        }
+        if (dropped != m_reported_dropped) {
+            line << " | trace dropped: " << dropped - m_reported_dropped;
+        }
+        line << '\n';
+        std::cout << line.str() << std::flush;
+    }
+    m_reported_dropped = dropped;
+    m_window = Window();
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "SpscRing.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <thread>
+
+struct FrameTiming;
+class LatencyTracer;
+
+/**
+ * @brief Stage a trace event measures
+ */
+enum class TraceStage : uint8_t {
+    Frame = 0,       ///< Frame entered the pipeline → pushed (value = host bytes copied)
+    Preprocess,
+    Infer,           ///< NPU submit → result available
+    Postprocess,
+    Push,            ///< Postprocess end → appsrc push returned
+    CaptureToInfer,  ///< Camera capture → NPU submit
+    CaptureToPush,   ///< Camera capture → appsrc push
+    Count
+};
+
+const char *trace_stage_name(TraceStage stage);
+
+/**
+ * @brief One stage span of one frame, as stored in the binary trace file (32 bytes)
+ *
+ * Timestamps are nanoseconds of std::chrono::high_resolution_clock; the file header
+ * maps them to wall-clock time.
+ */
+struct TraceEvent {
+    uint64_t frame_id;  ///< FrameTiming::frame_id, shared with the timeline and the output buffer
+    int64_t begin_ns;
+    int64_t end_ns;
+    uint32_t value;   ///< Stage specific (Frame: bytes copied)
+    uint8_t stage;    ///< TraceStage
+    uint8_t reserved[3];
+};
+static_assert(sizeof(TraceEvent) == 32, "TraceEvent is a file format");
+
+/**
+ * @brief Written once per session in front of its events (same size as an event)
+ */
+struct TraceFileHeader {
+    char magic[4];      ///< "HDTR"
+    uint32_t version;   ///< TRACE_FILE_VERSION
+    uint32_t event_size;
+    uint32_t reserved;
+    int64_t wall_ns;    ///< system_clock at open (ns since Unix epoch)
+    int64_t clock_ns;   ///< high_resolution_clock at the same instant
+};
+static_assert(sizeof(TraceFileHeader) == sizeof(TraceEvent), "header and events share the 32-byte record grid");
+
+constexpr uint32_t TRACE_FILE_VERSION = 1;
+
+/**
+ * @brief Per-frame timing trace: lock-free ring on the frame path, binary file off it
+ *
+ * record() turns a FrameTiming into stage events and pushes them into an SpscRing
+ * without locking, allocating or doing I/O; if the ring is full the frame is counted
+ * as dropped. A flusher thread drains the ring into the binary file (convert it with
+ * trace_convert), feeds the capture latencies to the LatencyTracer and prints a
+ * one-line summary once per second instead of a line per frame.
+ *
+ * record() must be called from a single thread at a time (the thread that finishes
+ * frames: appsink callback, inference completion thread or staged log thread).
+ */
+class TraceLog {
+public:
+    explicit TraceLog(size_t capacity_events = 16384);
+    ~TraceLog();
+
+    TraceLog(const TraceLog &) = delete;
+    TraceLog &operator=(const TraceLog &) = delete;
+
+    /**
+     * @brief Opens the trace file (appending a new session) and starts the flusher
+     *
+     * @param[in] path Binary trace file
+     * @param[in] latency Receives capture→infer / capture→push samples (may be nullptr)
+     * @return false if the file cannot be opened
+     */
+    bool start(const std::string &path, LatencyTracer *latency);
+
+    /// Drains every queued event, prints the last summary and closes the file
+    void stop();
+
+    void record(const FrameTiming &timing);
+
+    uint64_t frames() const { return m_recorded; }   ///< Frames passed to record()
+    uint64_t dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    /// Console summary accumulated by the flusher between two prints
+    struct Window {
+        uint64_t frames = 0;
+        double sum_ms[static_cast<int>(TraceStage::Count)] = {};
+        double max_ms[static_cast<int>(TraceStage::Count)] = {};
+        uint64_t count[static_cast<int>(TraceStage::Count)] = {};
+    };
+
+    void flush_loop();
+    size_t drain();
+    void print_summary(double seconds);
+
+    SpscRing<TraceEvent> m_ring;
+    uint64_t m_recorded = 0;                 ///< Producer side only
+    std::atomic<uint64_t> m_dropped{0};
+
+    std::ofstream m_file;
+    LatencyTracer *m_latency = nullptr;
+    Window m_window;
+    uint64_t m_reported_dropped = 0;
+
+    std::atomic<bool> m_stop{false};
+    bool m_running = false;
+    std::thread m_flusher;
+};
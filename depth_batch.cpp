@@ -0,0 +1,411 @@
+/**
+ * @brief Batch depth estimation over a directory of still images
+ *
+ * depth_batch <input_dir> <output_dir> [--config config.yaml] [--format png16|raw]
+ *             [--decoders N] [--writers N] [--batch N] [--full-size] [--limit N]
+ *
+ * A decoder pool reads JPEG/PNG files and resizes them straight into the batch buffer
+ * slots of the configured InferQueue (FrameBatcher when batch_size > 1, the async engine
+ * otherwise) on the configured backend, and a
+ * writer pool stores each depth map as <name>.png (16-bit) or <name>.raw (int8,
+ * model_width x model_height). Progress is printed once per second in images/s.
+ */
+#include "ConfigLoader.hpp"
+#include "InferBackend.hpp"
+#include "InferEngine.hpp"
+#include "ResizeKernels.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Bounded multi-producer / multi-consumer queue; push() blocks while full
+ */
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : m_capacity(std::max<size_t>(capacity, 1)) {}
+
+    void push(T item)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_not_full.wait(lock, [this] { return m_items.size() < m_capacity; });
+        m_items.push_back(std::move(item));
+        m_not_empty.notify_one();
+    }
+
+    /// @return false once the queue is closed and empty
+    bool pop(T &item)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_not_empty.wait(lock, [this] { return !m_items.empty() || m_closed; });
+        if (m_items.empty()) {
+            return false;
+        }
+        item = std::move(m_items.front());
+        m_items.pop_front();
+        m_not_full.notify_one();
+        return true;
+    }
+
+    void close()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closed = true;
+        m_not_empty.notify_all();
+    }
+
+private:
+    size_t m_capacity;
+    std::deque<T> m_items;
+    bool m_closed = false;
+    std::mutex m_mutex;
+    std::condition_variable m_not_full;
+    std::condition_variable m_not_empty;
+};
+
+/// Image whose model input sits in a job's batch slot
+struct DecodedImage {
+    size_t index;
+    cv::Size original;
+};
+
+/// Depth map waiting for a writer
+struct DepthImage {
+    size_t index;
+    cv::Mat depth;   ///< CV_8SC1, model size
+    cv::Size original;
+};
+
+struct Options {
+    std::string input_dir;
+    std::string output_dir;
+    std::string config_path = "config.yaml";
+    bool raw = false;
+    int decoders = 0;   ///< 0 = hardware threads / 2
+    int writers = 2;
+    int batch_size = 0; ///< 0 = inference.batch_size from the config
+    bool full_size = false;
+    size_t limit = 0;   ///< 0 = every image
+};
+
+void print_usage(const char *program)
+{
+    std::cerr << "usage: " << program << " <input_dir> <output_dir> [--config config.yaml] [--format png16|raw]\n"
+              << "       [--decoders N] [--writers N] [--batch N] [--full-size] [--limit N]" << std::endl;
+}
+
+bool parse_options(int argc, char *argv[], Options &options)
+{
+    if (argc < 3) {
+        return false;
+    }
+    options.input_dir = argv[1];
+    options.output_dir = argv[2];
+    for (int i = 3; i < argc; i++) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--config" && has_value) {
+            options.config_path = argv[++i];
+        } else if (arg == "--format" && has_value) {
+            const std::string format = argv[++i];
+            if (format != "png16" && format != "raw") {
+                std::cerr << "[ERROR] Unknown format: " << format << " (expected png16 or raw)" << std::endl;
+                return false;
+            }
+            options.raw = format == "raw";
+        } else if (arg == "--decoders" && has_value) {
+            options.decoders = std::atoi(argv[++i]);
+        } else if (arg == "--writers" && has_value) {
+            options.writers = std::atoi(argv[++i]);
+        } else if (arg == "--batch" && has_value) {
+            options.batch_size = std::atoi(argv[++i]);
+        } else if (arg == "--full-size") {
+            options.full_size = true;
+        } else if (arg == "--limit" && has_value) {
+            options.limit = static_cast<size_t>(std::atoll(argv[++i]));
+        } else {
+            std::cerr << "[ERROR] Unknown option: " << arg << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Sorted JPEG/PNG files of dir (not recursive)
+ */
+std::vector<std::filesystem::path> list_images(const std::string &dir)
+{
+    std::vector<std::filesystem::path> files;
+    std::error_code error;
+    for (const auto &entry : std::filesystem::directory_iterator(dir, error)) {
+        if (!entry.is_regular_file()) {
+            continue;
+        }
+        std::string ext = entry.path().extension().string();
+        std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+        if (ext == ".jpg" || ext == ".jpeg" || ext == ".png") {
+            files.push_back(entry.path());
+        }
+    }
+    if (error) {
+        std::cerr << "[ERROR] Failed to read directory " << dir << ": " << error.message() << std::endl;
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+/**
+ * @brief Decoder thread: imread → model-size RGB written into the job's input slot
+ *
+ * imread runs in parallel; acquire() / submit() take a single producer, so the resize
+ * into the slot happens under the producer mutex (it is a fraction of the decode).
+ * FrameResizer precomputes taps for one source size, so it is rebuilt only when
+ * the image size changes (datasets are usually a single resolution).
+ */
+void decode_loop(const std::vector<std::filesystem::path> &files, std::atomic<size_t> &next,
+                 InferQueue &engine, std::mutex &producer, std::vector<DecodedImage> &contexts,
+                 cv::Size model_size, ResizeMethod method, std::atomic<uint64_t> &failures,
+                 std::atomic<uint64_t> &infer_failures)
+{
+    std::unique_ptr<FrameResizer> resizer;
+    cv::Size resizer_size;
+    while (true) {
+        const size_t index = next.fetch_add(1, std::memory_order_relaxed);
+        if (index >= files.size()) {
+            return;
+        }
+        cv::Mat image = cv::imread(files[index].string(), cv::IMREAD_COLOR);
+        if (image.empty()) {
+            std::cerr << "[ERROR] Failed to decode " << files[index] << std::endl;
+            failures.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        if (!resizer || resizer_size != image.size()) {
+            resizer.reset(new FrameResizer(image.size(), model_size, method));
+            resizer_size = image.size();
+        }
+
+        std::lock_guard<std::mutex> lock(producer);
+        InferJob *job = engine.acquire();
+        if (!job) {
+            return;
+        }
+        // 잡의 배치 버퍼 슬롯에 바로 resize (임시 Mat, memcpy 없음)
+        cv::Mat input(model_size, CV_8UC3, job->input);
+        resizer->resize(image, input);
+        cv::cvtColor(input, input, cv::COLOR_BGR2RGB);  // 모델 입력은 카메라와 같은 RGB
+        contexts[job->index] = DecodedImage{index, image.size()};
+        if (engine.submit(job) != HAILO_SUCCESS) {
+            infer_failures.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+/**
+ * @brief Writer thread: int8 depth → 16-bit PNG or raw bytes
+ *
+ * The PNG keeps every int8 level: (v + 128) * 257 spans 0..65535 without per-image
+ * normalization, so images of one dataset stay comparable.
+ */
+void write_loop(const std::vector<std::filesystem::path> &files, const Options &options,
+                BoundedQueue<DepthImage> &depths, std::atomic<uint64_t> &written,
+                std::atomic<uint64_t> &failures)
+{
+    DepthImage item;
+    cv::Mat depth16;
+    cv::Mat resized;
+    while (depths.pop(item)) {
+        std::filesystem::path path = std::filesystem::path(options.output_dir) / files[item.index].stem();
+        bool ok;
+        if (options.raw) {
+            path += ".raw";
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            out.write(item.depth.ptr<const char>(), static_cast<std::streamsize>(item.depth.total()));
+            ok = out.good();
+        } else {
+            path += ".png";
+            item.depth.convertTo(depth16, CV_16UC1, 257.0, 128.0 * 257.0);
+            const cv::Mat *out = &depth16;
+            if (options.full_size && item.original != depth16.size()) {
+                cv::resize(depth16, resized, item.original, 0, 0, cv::INTER_LINEAR);
+                out = &resized;
+            }
+            ok = cv::imwrite(path.string(), *out);
+        }
+        if (ok) {
+            written.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            std::cerr << "[ERROR] Failed to write " << path << std::endl;
+            failures.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+}  // namespace
+
+int main(int argc, char *argv[])
+{
+    Options options;
+    if (!parse_options(argc, argv, options)) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    Config config = load_config(options.config_path);
+    if (options.batch_size > 0) {
+        config.batch_size = options.batch_size;
+    }
+    ResizeMethod resize_method;
+    if (!parse_resize_method(config.preprocess, resize_method)) {
+        std::cerr << "[ERROR] Unknown preprocess method: " << config.preprocess << std::endl;
+        return 1;
+    }
+
+    std::vector<std::filesystem::path> files = list_images(options.input_dir);
+    if (options.limit > 0 && files.size() > options.limit) {
+        files.resize(options.limit);
+    }
+    if (files.empty()) {
+        std::cerr << "[ERROR] No .jpg/.jpeg/.png files in " << options.input_dir << std::endl;
+        return 1;
+    }
+    std::error_code error;
+    std::filesystem::create_directories(options.output_dir, error);
+    if (error) {
+        std::cerr << "[ERROR] Failed to create " << options.output_dir << ": " << error.message() << std::endl;
+        return 1;
+    }
+
+    auto backend = create_backend(config);
+    if (!backend) {
+        std::cerr << "Failed to create inference backend (" << config.backend << "), status = " << backend.status() << std::endl;
+        return backend.status();
+    }
+    const size_t output_size = static_cast<size_t>(config.model_width) * config.model_height;
+    if (backend.value()->output_frame_size() != output_size) {
+        std::cerr << "[ERROR] Output frame size mismatch! Frame: " << backend.value()->output_frame_size()
+                  << ", Expected: " << output_size << std::endl;
+        return HAILO_INVALID_ARGUMENT;
+    }
+    const size_t input_size = output_size * 3;
+    if (backend.value()->input_frame_size() != input_size) {
+        std::cerr << "[ERROR] Input frame size mismatch! Frame: " << backend.value()->input_frame_size()
+                  << ", Expected: " << input_size << std::endl;
+        return HAILO_INVALID_ARGUMENT;
+    }
+
+    const unsigned hardware = std::max(std::thread::hardware_concurrency(), 2u);
+    const int decoder_count = options.decoders > 0 ? options.decoders : static_cast<int>(hardware / 2);
+    const int writer_count = std::max(options.writers, 1);
+    const size_t batch = static_cast<size_t>(std::max(config.batch_size, 1));
+
+    // 큐 용량: 배치 두 개 분량이면 NPU가 다음 배치를 기다리지 않는다
+    BoundedQueue<DepthImage> depths(batch * 2 + static_cast<size_t>(writer_count));
+    std::atomic<uint64_t> decode_failures{0};
+    std::atomic<uint64_t> infer_failures{0};
+    std::atomic<uint64_t> write_failures{0};
+    std::atomic<uint64_t> written{0};
+
+    // 완료 콜백 (엔진/배처 스레드): 잡 출력은 슬롯 재사용 전에 복사해 writer로 넘긴다
+    std::vector<DecodedImage> contexts;
+    auto on_complete = [&](InferJob &job) {
+        const DecodedImage &context = contexts[job.index];
+        if (job.status != HAILO_SUCCESS) {
+            infer_failures.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        cv::Mat depth(config.model_height, config.model_width, CV_8SC1, job.output);
+        depths.push(DepthImage{context.index, depth.clone(), context.original});
+    };
+    auto queue = create_infer_queue(*backend.value(), config, on_complete);
+    if (!queue) {
+        std::cerr << "Failed to start inference queue " << queue.status() << std::endl;
+        return queue.status();
+    }
+    std::unique_ptr<InferQueue> engine = std::move(queue.value());
+    contexts.resize(engine->capacity());
+
+    std::cout << "이미지 " << files.size() << "장 | 백엔드 " << config.backend << " | 배치 " << batch
+              << " | 디코더 " << decoder_count << " | writer " << writer_count
+              << " | 출력 " << (options.raw ? "raw int8" : "16-bit PNG") << " → " << options.output_dir << std::endl;
+
+    const auto t_start = Clock::now();
+    std::atomic<size_t> next_file{0};
+    std::mutex producer;  // acquire()/submit()는 단일 producer: 디코더가 번갈아 잡는다
+    std::vector<std::thread> decoders;
+    for (int i = 0; i < decoder_count; i++) {
+        decoders.emplace_back(decode_loop, std::cref(files), std::ref(next_file), std::ref(*engine),
+                              std::ref(producer), std::ref(contexts),
+                              cv::Size(config.model_width, config.model_height), resize_method,
+                              std::ref(decode_failures), std::ref(infer_failures));
+    }
+    std::vector<std::thread> writers;
+    for (int i = 0; i < writer_count; i++) {
+        writers.emplace_back(write_loop, std::cref(files), std::cref(options), std::ref(depths),
+                             std::ref(written), std::ref(write_failures));
+    }
+    // 디코더가 모두 끝나면 알린다
+    std::mutex decode_mutex;
+    std::condition_variable decode_cv;
+    bool decoding = true;
+    std::thread decode_closer([&]() {
+        for (std::thread &decoder : decoders) {
+            decoder.join();
+        }
+        std::lock_guard<std::mutex> lock(decode_mutex);
+        decoding = false;
+        decode_cv.notify_all();
+    });
+
+    // ==================== PROGRESS ====================
+    auto t_report = t_start;
+    uint64_t reported = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(decode_mutex);
+            if (decode_cv.wait_until(lock, t_report + std::chrono::seconds(1), [&] { return !decoding; })) {
+                break;
+            }
+        }
+        const auto now = Clock::now();
+        const uint64_t done = written.load(std::memory_order_relaxed);
+        const double interval_s = std::chrono::duration<double>(now - t_report).count();
+        std::cout << "   " << done << "/" << files.size() << " | " << (done - reported) / interval_s
+                  << " images/s" << std::endl;
+        t_report = now;
+        reported = done;
+    }
+    decode_closer.join();
+    engine->flush();  // 부분 배치까지 추론
+    engine->stop();
+    depths.close();
+    for (std::thread &writer : writers) {
+        writer.join();
+    }
+    const double wall_s = std::chrono::duration<double>(Clock::now() - t_start).count();
+
+    const uint64_t done = written.load();
+    std::cout << "========== 배치 결과 ==========" << std::endl;
+    std::cout << "   저장 " << done << "/" << files.size() << " | 디코딩 실패 " << decode_failures.load()
+              << " | 추론 실패 " << infer_failures.load() << " | 저장 실패 " << write_failures.load() << std::endl;
+    std::cout << "   " << wall_s << " s | " << (wall_s > 0 ? done / wall_s : 0.0) << " images/s" << std::endl;
+    return done == files.size() ? 0 : 1;
+}
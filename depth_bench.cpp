@@ -0,0 +1,434 @@
+/**
+ * @file depth_bench.cpp
+ * Host-side kernel benchmark suite for the depth pipeline. Runs every pre/postprocessing
+ * stage of new_sample_callback, the original OpenCV chain and the fused kernels that
+ * replaced it, on synthetic frames at the deployed camera resolutions and model sizes,
+ * so no camera and no Hailo device are needed (x86 and ARM).
+ *
+ * Usage: depth_bench [-r repeats] [-t ms_per_repeat] [-n iterations] [-j threads] [--filter text] [--csv] [--check]
+ *
+ * Each case is warmed up, then timed repeats times; a repeat runs the kernel for about
+ * ms_per_repeat (or exactly iterations calls with -n). Reported per frame: median ns,
+ * min and max of the repeats, relative spread (MAD / median), bytes touched, GB/s and fps.
+ *
+ * The fused colorize output is compared with the OpenCV chain at every model size; the
+ * exit code is 1 if any channel differs by more than one level. --check runs only that
+ * comparison, without timing (registered with ctest).
+ **/
+
+#include "DepthKernels.hpp"
+#include "ResizeKernels.hpp"
+
+#include <opencv2/opencv.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+    int repeats = 9;
+    double ms_per_repeat = 25.0;
+    int iterations = 0;    ///< Fixed calls per repeat (0 = derived from ms_per_repeat)
+    int threads = 1;       ///< cv::setNumThreads (1 = like a single pipeline stage thread)
+    std::string filter;    ///< Only cases whose "group name shape" contains this
+    bool csv = false;
+    bool check = false;    ///< Only compare fused kernels with the OpenCV chain, no timing
+};
+
+struct Stats {
+    double median_ns;
+    double min_ns;
+    double max_ns;
+    double spread;         ///< Median absolute deviation / median
+    int iterations;        ///< Calls per repeat
+};
+
+Options g_options;
+
+/// 반올림 경계에서 한 단계까지는 허용
+constexpr int MAX_COLOR_DIFF = 1;
+bool g_check_failed = false;
+
+double median(std::vector<double> values)
+{
+    std::sort(values.begin(), values.end());
+    const size_t n = values.size();
+    return n % 2 ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2.0;
+}
+
+/**
+ * @brief Times fn: warm-up, calibration, then g_options.repeats timed repeats (ns per call)
+ */
+Stats measure(const std::function<void()> &fn)
+{
+    using Clock = std::chrono::steady_clock;
+    auto t0 = Clock::now();
+    int warmup = 0;
+    // 캐시/LUT/분기 예측이 안정될 때까지 최소 3회, 10ms
+    while (warmup < 3 || Clock::now() - t0 < std::chrono::milliseconds(10)) {
+        fn();
+        warmup++;
+    }
+    const double estimate_ns = std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / warmup;
+
+    Stats stats = {};
+    stats.iterations = g_options.iterations > 0
+                           ? g_options.iterations
+                           : std::max(1, static_cast<int>(g_options.ms_per_repeat * 1e6 / estimate_ns));
+    std::vector<double> samples;
+    for (int r = 0; r < g_options.repeats; r++) {
+        auto begin = Clock::now();
+        for (int i = 0; i < stats.iterations; i++) {
+            fn();
+        }
+        samples.push_back(std::chrono::duration<double, std::nano>(Clock::now() - begin).count() / stats.iterations);
+    }
+    stats.median_ns = median(samples);
+    stats.min_ns = *std::min_element(samples.begin(), samples.end());
+    stats.max_ns = *std::max_element(samples.begin(), samples.end());
+    std::vector<double> deviations;
+    for (double s : samples) {
+        deviations.push_back(std::abs(s - stats.median_ns));
+    }
+    stats.spread = median(deviations) / stats.median_ns;
+    return stats;
+}
+
+std::string shape(cv::Size a, cv::Size b = cv::Size())
+{
+    char text[48];
+    if (b.area() > 0) {
+        std::snprintf(text, sizeof(text), "%dx%d->%dx%d", a.width, a.height, b.width, b.height);
+    } else {
+        std::snprintf(text, sizeof(text), "%dx%d", a.width, a.height);
+    }
+    return text;
+}
+
+bool selected(const std::string &group, const std::string &name, const std::string &shape_text)
+{
+    return g_options.filter.empty() ||
+           (group + " " + name + " " + shape_text).find(g_options.filter) != std::string::npos;
+}
+
+/**
+ * @brief Measures and prints one case
+ *
+ * @param[in] bytes Bytes read + written per frame (nominal, without scratch buffers)
+ * @return Median ns per frame (0 if filtered out)
+ */
+double run_case(const std::string &group, const std::string &name, const std::string &shape_text,
+                double bytes, const std::function<void()> &fn)
+{
+    if (g_options.check || !selected(group, name, shape_text)) {
+        return 0.0;
+    }
+    const Stats s = measure(fn);
+    if (g_options.csv) {
+        std::printf("%s,%s,%s,%.0f,%.0f,%.0f,%.4f,%.0f,%.3f,%.1f,%d\n", group.c_str(), name.c_str(),
+                    shape_text.c_str(), s.median_ns, s.min_ns, s.max_ns, s.spread, bytes, bytes / s.median_ns,
+                    1e9 / s.median_ns, s.iterations);
+    } else {
+        std::printf("%-11s %-22s %-20s %11.0f %11.0f %11.0f %6.1f%% %10.0f %7.2f %9.1f\n", group.c_str(),
+                    name.c_str(), shape_text.c_str(), s.median_ns, s.min_ns, s.max_ns, s.spread * 100.0, bytes,
+                    bytes / s.median_ns, 1e9 / s.median_ns);
+    }
+    std::fflush(stdout);
+    return s.median_ns;
+}
+
+/**
+ * @brief Synthetic int8 depth map: vertical ramp plus noise, like the NPU output
+ */
+cv::Mat make_depth(cv::Size size)
+{
+    cv::Mat depth(size, CV_8SC1);
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> noise(-12, 12);
+    for (int y = 0; y < size.height; y++) {
+        int8_t *row = depth.ptr<int8_t>(y);
+        for (int x = 0; x < size.width; x++) {
+            int v = (y * 200) / size.height - 100 + noise(rng);
+            row[x] = static_cast<int8_t>(std::max(-128, std::min(127, v)));
+        }
+    }
+    return depth;
+}
+
+/**
+ * @brief Synthetic camera frame: gradients plus noise so the filters have detail to remove
+ */
+cv::Mat make_camera_frame(cv::Size size)
+{
+    cv::Mat frame(size, CV_8UC3);
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int> noise(0, 31);
+    for (int y = 0; y < size.height; y++) {
+        uint8_t *row = frame.ptr<uint8_t>(y);
+        for (int x = 0; x < size.width; x++) {
+            row[3 * x] = static_cast<uint8_t>((x * 255) / size.width);
+            row[3 * x + 1] = static_cast<uint8_t>((y * 255) / size.height);
+            row[3 * x + 2] = static_cast<uint8_t>(((x ^ y) & 0xE0) + noise(rng));
+        }
+    }
+    return frame;
+}
+
+/**
+ * @brief Reference chain from new_sample_callback before the fused kernel
+ */
+void colormap_opencv(const cv::Mat &raw_depth, cv::Mat &dst)
+{
+    cv::Mat depth_u8;
+    raw_depth.convertTo(depth_u8, CV_8U, 1.0, 128);
+    cv::Mat depth_normalized;
+    cv::normalize(depth_u8, depth_normalized, 0, 255, cv::NORM_MINMAX);
+    cv::applyColorMap(depth_normalized, dst, cv::COLORMAP_MAGMA);
+    cv::cvtColor(dst, dst, cv::COLOR_RGB2BGR);
+    dst.convertTo(dst, CV_8UC3);
+}
+
+int max_channel_diff(const cv::Mat &a, const cv::Mat &b)
+{
+    int max_diff = 0;
+    for (int y = 0; y < a.rows; y++) {
+        const uint8_t *pa = a.ptr<uint8_t>(y);
+        const uint8_t *pb = b.ptr<uint8_t>(y);
+        for (int x = 0; x < a.cols * a.channels(); x++) {
+            max_diff = std::max(max_diff, std::abs(pa[x] - pb[x]));
+        }
+    }
+    return max_diff;
+}
+
+// ==================== PREPROCESS ====================
+
+/**
+ * @brief Stages that only depend on the camera resolution
+ */
+void bench_camera(cv::Size camera)
+{
+    const cv::Mat frame = make_camera_frame(camera);
+    const double frame_bytes = camera.area() * 3.0;
+
+    cv::Mat blurred;
+    run_case("preprocess", "cv_blur3x3", shape(camera), 2 * frame_bytes,
+             [&] { cv::GaussianBlur(frame, blurred, cv::Size(3, 3), 0); });
+
+    cv::Mat output(camera.height, camera.width * 2, CV_8UC3);
+    cv::Mat left = output(cv::Rect(0, 0, camera.width, camera.height));
+    run_case("compose", "copy_left_half", shape(camera), 2 * frame_bytes, [&] { frame.copyTo(left); });
+}
+
+void bench_preprocess(cv::Size camera, cv::Size model)
+{
+    const cv::Mat frame = make_camera_frame(camera);
+    const std::string s = shape(camera, model);
+    const double in_bytes = camera.area() * 3.0;
+    const double out_bytes = model.area() * 3.0;
+    cv::Mat out(model, CV_8UC3);
+
+    // 기존 코드의 단계: 전체 프레임 blur (사본에) → INTER_LINEAR
+    cv::Mat blurred;
+    run_case("preprocess", "cv_resize_linear", s, in_bytes + out_bytes,
+             [&] { cv::resize(frame, out, model, 0, 0, cv::INTER_LINEAR); });
+    run_case("preprocess", "cv_blur+resize", s, 2 * in_bytes + in_bytes + out_bytes, [&] {
+        cv::GaussianBlur(frame, blurred, cv::Size(3, 3), 0);
+        cv::resize(blurred, out, model, 0, 0, cv::INTER_LINEAR);
+    });
+    run_case("preprocess", "cv_resize_area", s, in_bytes + out_bytes,
+             [&] { cv::resize(frame, out, model, 0, 0, cv::INTER_AREA); });
+
+    for (ResizeMethod method : {ResizeMethod::BlurResize, ResizeMethod::Antialias, ResizeMethod::Area}) {
+        FrameResizer resizer(camera, model, method);
+        run_case("preprocess", std::string("fused_") + resize_method_name(method), s, in_bytes + out_bytes,
+                 [&] { resizer.resize(frame, out); });
+    }
+}
+
+// ==================== POSTPROCESS ====================
+
+void bench_postprocess(cv::Size model)
+{
+    const cv::Mat raw_depth = make_depth(model);
+    const std::string s = shape(model);
+    const double depth_bytes = model.area();
+    const double rgb_bytes = model.area() * 3.0;
+
+    cv::Mat depth_u8;
+    cv::Mat normalized;
+    cv::Mat colored;
+    cv::Mat swapped;
+    raw_depth.convertTo(depth_u8, CV_8U, 1.0, 128);
+    cv::normalize(depth_u8, normalized, 0, 255, cv::NORM_MINMAX);
+    cv::applyColorMap(normalized, colored, cv::COLORMAP_MAGMA);
+
+    run_case("postprocess", "cv_convert_s8_u8", s, 2 * depth_bytes,
+             [&] { raw_depth.convertTo(depth_u8, CV_8U, 1.0, 128); });
+    run_case("postprocess", "cv_normalize_minmax", s, 3 * depth_bytes,
+             [&] { cv::normalize(depth_u8, normalized, 0, 255, cv::NORM_MINMAX); });
+    run_case("postprocess", "cv_applyColorMap", s, depth_bytes + rgb_bytes,
+             [&] { cv::applyColorMap(normalized, colored, cv::COLORMAP_MAGMA); });
+    run_case("postprocess", "cv_cvtColor_rgb2bgr", s, 2 * rgb_bytes,
+             [&] { cv::cvtColor(colored, swapped, cv::COLOR_RGB2BGR); });
+
+    cv::Mat reference;
+    colormap_opencv(raw_depth, reference);
+    run_case("postprocess", "cv_colormap_chain", s, 3 * depth_bytes + 3 * rgb_bytes,
+             [&] { colormap_opencv(raw_depth, reference); });
+
+    int8_t lo = 0;
+    int8_t hi = 0;
+    run_case("postprocess", std::string("fused_minmax_") + depth_kernel_path(), s, depth_bytes,
+             [&] { depth_minmax(raw_depth.ptr<int8_t>(), raw_depth.total(), &lo, &hi); });
+
+    DepthColorizer colorizer(cv::COLORMAP_MAGMA, true);
+    cv::Mat fused;
+    colorizer.colorize(raw_depth, fused);
+    run_case("postprocess", std::string("fused_colorize_") + depth_kernel_path(), s, depth_bytes + rgb_bytes,
+             [&] { colorizer.colorize(raw_depth, fused); });
+
+    // 결과 비교: 필터와 상관없이 항상 (한 단계 넘게 다르면 실패)
+    const bool same_shape = fused.size() == reference.size() && fused.type() == reference.type();
+    const int diff = same_shape ? max_channel_diff(reference, fused) : 255;
+    const bool ok = same_shape && diff <= MAX_COLOR_DIFF;
+    if (!ok) {
+        g_check_failed = true;
+    }
+    if (!g_options.csv) {
+        std::printf("%-11s %-22s %-20s max channel diff vs cv_colormap_chain: %d %s\n", "check", "fused_colorize",
+                    s.c_str(), diff, ok ? "ok" : "FAILED");
+    } else if (!ok) {
+        std::fprintf(stderr, "fused_colorize %s: max channel diff %d vs cv_colormap_chain\n", s.c_str(), diff);
+    }
+}
+
+// ==================== COMPOSE ====================
+
+void bench_compose(cv::Size camera, cv::Size model)
+{
+    const cv::Mat frame = make_camera_frame(camera);
+    const cv::Mat raw_depth = make_depth(model);
+    const std::string s = shape(model, camera);
+    const double out_bytes = camera.area() * 6.0;  // 카메라 | depth 나란히
+    const double bytes = camera.area() * 3.0 + model.area() + out_bytes;
+
+    // 출력 버퍼 (GstBufferPool 버퍼 대신 미리 할당한 Mat)
+    cv::Mat output(camera.height, camera.width * 2, CV_8UC3);
+
+    // 기존 코드: 컬러맵 체인 → resize → hconcat → memcpy
+    cv::Mat colored;
+    cv::Mat resized;
+    cv::Mat result;
+    run_case("compose", "cv_resize+hconcat+copy", s, bytes + 2 * out_bytes, [&] {
+        colormap_opencv(raw_depth, colored);
+        cv::resize(colored, resized, camera, 0, 0, cv::INTER_LINEAR);
+        cv::hconcat(frame, resized, result);
+        std::memcpy(output.data, result.data, result.total() * result.elemSize());
+    });
+
+    // 현재 postprocess(): 왼쪽 절반 복사 + fused 컬러맵 + 오른쪽 절반에 바로 resize
+    DepthColorizer colorizer(cv::COLORMAP_MAGMA, true);
+    cv::Mat left = output(cv::Rect(0, 0, camera.width, camera.height));
+    cv::Mat right = output(cv::Rect(camera.width, 0, camera.width, camera.height));
+    cv::Mat depth_colormap;
+    run_case("compose", "fused_in_place", s, bytes, [&] {
+        frame.copyTo(left);
+        colorizer.colorize(raw_depth, depth_colormap);
+        cv::resize(depth_colormap, right, right.size(), 0, 0, cv::INTER_LINEAR);
+    });
+}
+
+bool parse_args(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if ((arg == "-r" || arg == "--repeats") && has_value) {
+            g_options.repeats = std::max(1, std::atoi(argv[++i]));
+        } else if ((arg == "-t" || arg == "--ms") && has_value) {
+            g_options.ms_per_repeat = std::max(0.1, std::atof(argv[++i]));
+        } else if ((arg == "-n" || arg == "--iterations") && has_value) {
+            g_options.iterations = std::max(1, std::atoi(argv[++i]));
+        } else if ((arg == "-j" || arg == "--threads") && has_value) {
+            g_options.threads = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--filter" && has_value) {
+            g_options.filter = argv[++i];
+        } else if (arg == "--csv") {
+            g_options.csv = true;
+        } else if (arg == "--check") {
+            g_options.check = true;
+        } else if (!arg.empty() && std::isdigit(static_cast<unsigned char>(arg[0]))) {
+            g_options.iterations = std::max(1, std::atoi(arg.c_str()));  // 예전 사용법: depth_bench [iterations]
+        } else {
+            std::fprintf(stderr, "usage: %s [-r repeats] [-t ms_per_repeat] [-n iterations] [-j threads] "
+                                 "[--filter text] [--csv] [--check]\n", argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char *argv[])
+{
+    if (!parse_args(argc, argv)) {
+        return 1;
+    }
+    // 기본 1: 파이프라인은 단계마다 한 스레드에서 커널을 돌리고, 반복 간 편차도 작다
+    cv::setNumThreads(g_options.threads);
+
+    const std::vector<cv::Size> cameras = {{640, 480}, {1280, 720}, {1920, 1080}};
+    const std::vector<cv::Size> models = {{224, 224}, {256, 256}, {320, 256}};
+
+    if (g_options.check) {
+        std::printf("depth_bench --check: colormap path %s\n", depth_kernel_path());
+    } else if (g_options.csv) {
+        std::printf("group,case,shape,median_ns,min_ns,max_ns,spread,bytes_per_frame,gb_per_s,frames_per_s,iterations\n");
+    } else {
+        char per_repeat[32];
+        if (g_options.iterations > 0) {
+            std::snprintf(per_repeat, sizeof(per_repeat), "%d calls", g_options.iterations);
+        } else {
+            std::snprintf(per_repeat, sizeof(per_repeat), "~%.0f ms", g_options.ms_per_repeat);
+        }
+        std::printf("depth_bench: %d repeats x %s, colormap path %s, resize path %s, OpenCV threads %d\n",
+                    g_options.repeats, per_repeat, depth_kernel_path(), resize_kernel_path(), g_options.threads);
+        std::printf("%-11s %-22s %-20s %11s %11s %11s %7s %10s %7s %9s\n", "group", "case", "shape", "ns/frame",
+                    "min", "max", "spread", "bytes", "GB/s", "fps");
+    }
+
+    if (g_options.check) {
+        for (cv::Size model : models) {
+            bench_postprocess(model);
+        }
+        return g_check_failed ? 1 : 0;
+    }
+
+    for (cv::Size camera : cameras) {
+        bench_camera(camera);
+        for (cv::Size model : models) {
+            bench_preprocess(camera, model);
+        }
+    }
+    for (cv::Size model : models) {
+        bench_postprocess(model);
+    }
+    for (cv::Size camera : cameras) {
+        for (cv::Size model : models) {
+            bench_compose(camera, model);
+        }
+    }
+    return g_check_failed ? 1 : 0;
+}
@@ -0,0 +1,102 @@
+/**
+ * @brief Example consumer of the shared-memory depth ring
+ *
+ * depth_ring_dump [/hailodepth] [--seconds N]
+ *
+ * Attaches to the ring (waiting for the pipeline to create it), takes the newest
+ * depth map whenever one is published and prints once per second: frames received,
+ * frames skipped (published while this reader was busy), capture → read age and the
+ * dequantized centre value. Reattaches when the writer restarts.
+ */
+#include "DepthRing.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+uint64_t monotonic_ns()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+}  // namespace
+
+int main(int argc, char *argv[])
+{
+    std::string name = "/hailodepth";
+    double seconds = 0.0;  // 0 = Ctrl+C까지
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg == "--seconds" && i + 1 < argc) {
+            seconds = std::atof(argv[++i]);
+        } else if (!arg.empty() && arg[0] == '/') {
+            name = arg;
+        } else {
+            std::cerr << "usage: " << argv[0] << " [/hailodepth] [--seconds N]" << std::endl;
+            return 1;
+        }
+    }
+
+    DepthRingReader reader;
+    const auto t_start = std::chrono::steady_clock::now();
+    auto t_report = t_start;
+    uint64_t received = 0;
+    uint64_t skipped = 0;
+    uint64_t last_index = 0;
+    bool have_last = false;
+    std::vector<double> ages_ms;
+    float centre = 0.0f;
+
+    while (seconds <= 0.0 ||
+           std::chrono::duration<double>(std::chrono::steady_clock::now() - t_start).count() < seconds) {
+        if (!reader.is_open() || reader.closed()) {
+            if (!reader.open(name)) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(200));
+                continue;
+            }
+            std::cout << "attached " << name << " (" << reader.width() << "x" << reader.height() << ")" << std::endl;
+            have_last = false;
+        }
+
+        DepthFrame frame;
+        if (!reader.latest(frame)) {
+            std::this_thread::sleep_for(std::chrono::microseconds(500));
+        } else {
+            // 복사 없이 슬롯을 직접 읽고, 다 쓴 뒤 덮어쓰이지 않았는지 확인
+            const size_t middle = static_cast<size_t>(frame.height / 2) * frame.width + frame.width / 2;
+            const int value = frame.is_signed ? static_cast<int8_t>(frame.data[middle]) : frame.data[middle];
+            if (reader.valid(frame)) {
+                received++;
+                skipped += have_last && frame.index > last_index + 1 ? frame.index - last_index - 1 : 0;
+                last_index = frame.index;
+                have_last = true;
+                centre = frame.scale * (value - frame.zero_point);
+                if (frame.capture_ns) {
+                    ages_ms.push_back((monotonic_ns() - frame.capture_ns) / 1e6);
+                }
+            }
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        if (now - t_report >= std::chrono::seconds(1)) {
+            std::sort(ages_ms.begin(), ages_ms.end());
+            std::cout << "frames " << received << " | skipped " << skipped << " | centre " << centre;
+            if (!ages_ms.empty()) {
+                std::cout << " | capture→read p50 " << ages_ms[ages_ms.size() / 2] << " ms, max " << ages_ms.back() << " ms";
+            }
+            std::cout << std::endl;
+            ages_ms.clear();
+            t_report = now;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,414 @@
+/**
+ * @brief Resident depth inference service shared by several client processes
+ *
+ * depth_service [--config config.yaml] [--backend hailo|cpu] [--clients N] [--slots N] [--name /shm_name]
+ *
+ * Creates the backend once (VDevice, HEF, network group, vstreams) and keeps it
+ * configured while camera clients come and go. Clients attach through the
+ * shared-memory region service.name (DepthServiceClient, or inference.backend: service
+ * in the pipeline config), write frames into their slots and sleep on a futex until
+ * the depth map is in the slot's output buffer. Queued slots of every client are fed
+ * round-robin into the configured InferQueue, so FrameBatcher (batch_size > 1) fills
+ * its batches across clients. Clients that exit without detaching are reclaimed.
+ */
+#include "ConfigLoader.hpp"
+#include "DepthService.hpp"
+#include "InferBackend.hpp"
+#include "InferEngine.hpp"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace {
+
+volatile sig_atomic_t g_stop = 0;
+
+void signal_handler(int)
+{
+    g_stop = 1;
+}
+
+bool process_alive(int32_t pid)
+{
+    return pid <= 0 || kill(pid, 0) == 0 || errno != ESRCH;
+}
+
+/**
+ * @brief The mapped service region (owner side)
+ */
+class ServiceRegion {
+public:
+    ~ServiceRegion() { close(); }
+
+    /**
+     * @brief Creates the region; refuses if another live service owns the name
+     *
+     * A region left behind by a crashed service is marked stopped (so attached
+     * clients see ServiceGone) and replaced.
+     */
+    bool create(const std::string &name, const Config &config, size_t input_size, size_t output_size,
+                uint32_t max_clients, uint32_t slots)
+    {
+        if (name.empty() || name[0] != '/' || max_clients < 1 || slots < 1) {
+            std::cerr << "[ERROR] Service needs a name like /hailodepth_service, at least 1 client and 1 slot" << std::endl;
+            return false;
+        }
+        const int old_fd = shm_open(name.c_str(), O_RDWR, 0);
+        if (old_fd >= 0) {
+            struct stat st;
+            if (fstat(old_fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(ServiceHeader)) {
+                void *old = mmap(nullptr, sizeof(ServiceHeader), PROT_READ | PROT_WRITE, MAP_SHARED, old_fd, 0);
+                if (old != MAP_FAILED) {
+                    ServiceHeader *header = static_cast<ServiceHeader*>(old);
+                    const bool running = header->running.load(std::memory_order_acquire) != 0;
+                    const int32_t pid = header->service_pid.load(std::memory_order_acquire);
+                    if (running && pid != getpid() && pid > 0 && process_alive(pid)) {
+                        std::cerr << "[ERROR] Service " << name << " is already running (pid " << pid << ")" << std::endl;
+                        munmap(old, sizeof(ServiceHeader));
+                        ::close(old_fd);
+                        return false;
+                    }
+                    header->running.store(0, std::memory_order_release);
+                    munmap(old, sizeof(ServiceHeader));
+                }
+            }
+            ::close(old_fd);
+        }
+        shm_unlink(name.c_str());
+
+        const size_t stride = service_channel_stride(slots, input_size, output_size);
+        m_size = (sizeof(ServiceHeader) + 63) / 64 * 64 + stride * max_clients;
+        const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0666);
+        if (fd < 0) {
+            std::cerr << "[ERROR] shm_open(" << name << "): " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        fchmod(fd, 0666);  // umask와 관계없이 다른 사용자의 카메라 클라이언트도 붙을 수 있게
+        if (ftruncate(fd, static_cast<off_t>(m_size)) < 0) {
+            std::cerr << "[ERROR] ftruncate(" << name << "): " << std::strerror(errno) << std::endl;
+            ::close(fd);
+            shm_unlink(name.c_str());
+            return false;
+        }
+        void *base = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (base == MAP_FAILED) {
+            std::cerr << "[ERROR] mmap(" << name << "): " << std::strerror(errno) << std::endl;
+            shm_unlink(name.c_str());
+            return false;
+        }
+
+        // ftruncate로 0으로 채워진 상태: 채널 FREE, 슬롯 FREE
+        m_base = static_cast<uint8_t*>(base);
+        m_header = new (m_base) ServiceHeader();
+        m_header->version = DEPTH_SERVICE_VERSION;
+        m_header->width = static_cast<uint32_t>(config.model_width);
+        m_header->height = static_cast<uint32_t>(config.model_height);
+        m_header->input_size = input_size;
+        m_header->output_size = output_size;
+        m_header->max_clients = max_clients;
+        m_header->slots = slots;
+        m_header->channel_stride = stride;
+        m_header->service_pid.store(static_cast<int32_t>(getpid()), std::memory_order_relaxed);
+        m_header->doorbell.store(0, std::memory_order_relaxed);
+        for (uint32_t c = 0; c < max_clients; c++) {
+            ServiceChannel *channel = new (service_channel(m_header, c)) ServiceChannel();
+            for (uint32_t s = 0; s < slots; s++) {
+                new (service_slot(m_header, channel, s)) ServiceSlot();
+            }
+        }
+        m_name = name;
+        return true;
+    }
+
+    /// Opens the region to clients (magic last: they only attach to a complete layout)
+    void start(float scale, float zero_point)
+    {
+        m_header->scale = scale;
+        m_header->zero_point = zero_point;
+        m_header->running.store(1, std::memory_order_relaxed);
+        m_header->magic.store(DEPTH_SERVICE_MAGIC, std::memory_order_release);
+    }
+
+    /// Tells clients the service is gone, wakes them and removes the name
+    void close()
+    {
+        if (!m_base) {
+            return;
+        }
+        m_header->running.store(0, std::memory_order_release);
+        for (uint32_t c = 0; c < m_header->max_clients; c++) {
+            ServiceChannel *channel = service_channel(m_header, c);
+            channel->completed.fetch_add(1, std::memory_order_release);
+            futex_wake(&channel->completed);
+        }
+        munmap(m_base, m_size);
+        shm_unlink(m_name.c_str());
+        m_base = nullptr;
+        m_header = nullptr;
+    }
+
+    ServiceHeader *header() const { return m_header; }
+
+private:
+    std::string m_name;
+    uint8_t *m_base = nullptr;
+    size_t m_size = 0;
+    ServiceHeader *m_header = nullptr;
+};
+
+/// Where a job's result goes
+struct SlotRef {
+    uint32_t client = 0;
+    ServiceChannel *channel = nullptr;
+    ServiceSlot *slot = nullptr;
+    uint32_t slot_index = 0;
+};
+
+void print_usage(const char *program)
+{
+    std::cerr << "usage: " << program << " [--config config.yaml] [--backend hailo|cpu] [--clients N] [--slots N] [--name /shm_name]" << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char *argv[])
+{
+    std::string config_path = "config.yaml";
+    std::string backend_override;
+    std::string name_override;
+    int clients_override = 0;
+    int slots_override = 0;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--config" && has_value) {
+            config_path = argv[++i];
+        } else if (arg == "--backend" && has_value) {
+            backend_override = argv[++i];
+        } else if (arg == "--clients" && has_value) {
+            clients_override = std::atoi(argv[++i]);
+        } else if (arg == "--slots" && has_value) {
+            slots_override = std::atoi(argv[++i]);
+        } else if (arg == "--name" && has_value) {
+            name_override = argv[++i];
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    Config config = load_config(config_path);
+    // 클라이언트와 같은 config.yaml을 쓰므로 inference.backend(= service) 대신 service.backend로 돈다
+    config.backend = backend_override.empty() ? config.service_backend : backend_override;
+    if (config.backend == "service") {
+        std::cerr << "[ERROR] depth_service cannot use the service backend itself (set service.backend)" << std::endl;
+        return 1;
+    }
+    if (!name_override.empty()) {
+        config.service_name = name_override;
+    }
+    const uint32_t max_clients = static_cast<uint32_t>(clients_override > 0 ? clients_override : config.service_clients);
+    const uint32_t slots = static_cast<uint32_t>(slots_override > 0 ? slots_override : config.service_slots);
+
+    const auto t_load = std::chrono::steady_clock::now();
+    auto backend = create_backend(config);
+    if (!backend) {
+        std::cerr << "Failed to create inference backend (" << config.backend << "), status = " << backend.status() << std::endl;
+        return backend.status();
+    }
+    const size_t input_size = backend.value()->input_frame_size();
+    const size_t output_size = static_cast<size_t>(config.model_width) * config.model_height;
+    if (backend.value()->output_frame_size() != output_size) {
+        std::cerr << "[ERROR] Output frame size mismatch! Frame: " << backend.value()->output_frame_size()
+                  << ", Expected: " << output_size << std::endl;
+        return HAILO_INVALID_ARGUMENT;
+    }
+
+    ServiceRegion region;
+    if (!region.create(config.service_name, config, input_size, output_size, max_clients, slots)) {
+        return 1;
+    }
+    ServiceHeader *header = region.header();
+
+    // 완료 콜백 (엔진/배처 스레드): 결과를 클라이언트 슬롯에 쓰고 그 클라이언트만 깨운다
+    std::vector<SlotRef> contexts;
+    std::unique_ptr<std::atomic<int>[]> in_flight(new std::atomic<int>[max_clients]);
+    for (uint32_t c = 0; c < max_clients; c++) {
+        in_flight[c].store(0);
+    }
+    std::atomic<uint64_t> completed{0};
+    std::atomic<uint64_t> failures{0};
+    auto on_complete = [&](InferJob &job) {
+        const SlotRef &ref = contexts[job.index];
+        const bool ok = job.status == HAILO_SUCCESS;
+        if (ok) {
+            std::memcpy(service_output(header, ref.channel, ref.slot_index), job.output, output_size);
+        } else {
+            failures.fetch_add(1, std::memory_order_relaxed);
+        }
+        ref.slot->done_ns = service_clock_ns();
+        ref.slot->state.store(ok ? SLOT_DONE : SLOT_FAILED, std::memory_order_release);
+        ref.channel->frames.fetch_add(1, std::memory_order_relaxed);
+        ref.channel->completed.fetch_add(1, std::memory_order_release);
+        futex_wake(&ref.channel->completed);
+        in_flight[ref.client].fetch_sub(1, std::memory_order_release);
+        completed.fetch_add(1, std::memory_order_relaxed);
+    };
+    auto queue = create_infer_queue(*backend.value(), config, on_complete);
+    if (!queue) {
+        std::cerr << "Failed to start inference queue " << queue.status() << std::endl;
+        return queue.status();
+    }
+    std::unique_ptr<InferQueue> engine = std::move(queue.value());
+    contexts.resize(engine->capacity());
+
+    float scale = 1.0f;
+    float zero_point = 0.0f;
+    backend.value()->output_quantization(scale, zero_point);
+    region.start(scale, zero_point);
+    const double load_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t_load).count();
+    std::cout << "추론 서비스: /dev/shm" << config.service_name << " | 백엔드 " << config.backend
+              << " | 클라이언트 " << max_clients << " x 슬롯 " << slots << " | 배치 " << std::max(config.batch_size, 1)
+              << " | 모델 준비 " << load_ms << " ms" << std::endl;
+
+    signal(SIGINT, signal_handler);
+    signal(SIGTERM, signal_handler);
+
+    std::vector<uint32_t> cursor(max_clients, 0);  // 클라이언트별 다음 슬롯 (제출 순서 = 슬롯 순서)
+    std::vector<int32_t> known_pid(max_clients, 0);
+    uint32_t next_client = 0;
+    const double report_s = config.stats_interval_s > 0 ? config.stats_interval_s : 5.0;
+    auto t_housekeeping = std::chrono::steady_clock::now();
+    auto t_report = t_housekeeping;
+    uint64_t reported = 0;
+
+    while (!g_stop) {
+        // doorbell을 스캔 전에 읽어야 스캔과 잠들기 사이의 제출을 놓치지 않는다
+        const uint32_t bell = header->doorbell.load(std::memory_order_acquire);
+
+        // 라운드 로빈: 한 바퀴에 클라이언트당 한 프레임씩 넣어 한 클라이언트가 배치를 독차지하지 못하게
+        size_t taken = 0;
+        bool progress = true;
+        while (progress && !g_stop) {
+            progress = false;
+            for (uint32_t k = 0; k < max_clients; k++) {
+                const uint32_t c = (next_client + k) % max_clients;
+                ServiceChannel *channel = service_channel(header, c);
+                if (channel->state.load(std::memory_order_acquire) != CHANNEL_ACTIVE) {
+                    continue;
+                }
+                // 클라이언트가 슬롯을 순서대로 쓰면 cursor 위치에서 바로 찾는다
+                ServiceSlot *slot = nullptr;
+                uint32_t s = 0;
+                for (uint32_t j = 0; j < slots && !slot; j++) {
+                    s = (cursor[c] + j) % slots;
+                    ServiceSlot *candidate = service_slot(header, channel, s);
+                    uint32_t expected = SLOT_QUEUED;
+                    if (candidate->state.compare_exchange_strong(expected, SLOT_BUSY, std::memory_order_acq_rel)) {
+                        slot = candidate;
+                    }
+                }
+                if (!slot) {
+                    continue;
+                }
+                InferJob *job = engine->acquire();  // 큐가 차 있으면 완료될 때까지 대기 (backpressure)
+                if (!job) {
+                    slot->state.store(SLOT_FAILED, std::memory_order_release);
+                    channel->completed.fetch_add(1, std::memory_order_release);
+                    futex_wake(&channel->completed);
+                    continue;
+                }
+                std::memcpy(job->input, service_input(header, channel, s), std::min(job->input_size, input_size));
+                contexts[job->index] = SlotRef{c, channel, slot, s};
+                job->trace_id = slot->frame_id;
+                in_flight[c].fetch_add(1, std::memory_order_acq_rel);
+                if (engine->submit(job) != HAILO_SUCCESS) {
+                    // 완료 콜백이 오지 않으니 acquire() 실패와 같이 슬롯을 바로 실패로 돌려준다
+                    contexts[job->index] = SlotRef{};
+                    in_flight[c].fetch_sub(1, std::memory_order_release);
+                    failures.fetch_add(1, std::memory_order_relaxed);
+                    slot->state.store(SLOT_FAILED, std::memory_order_release);
+                    channel->completed.fetch_add(1, std::memory_order_release);
+                    futex_wake(&channel->completed);
+                    continue;
+                }
+                cursor[c] = (s + 1) % slots;
+                progress = true;
+                taken++;
+            }
+            next_client = (next_client + 1) % max_clients;
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        if (now - t_housekeeping >= std::chrono::milliseconds(100)) {
+            t_housekeeping = now;
+            for (uint32_t c = 0; c < max_clients; c++) {
+                ServiceChannel *channel = service_channel(header, c);
+                const uint32_t state = channel->state.load(std::memory_order_acquire);
+                const int32_t pid = channel->pid.load(std::memory_order_relaxed);
+                if (state == CHANNEL_ACTIVE && known_pid[c] != pid) {
+                    known_pid[c] = pid;
+                    std::cout << "클라이언트 연결: 채널 " << c << " (pid " << pid << ")" << std::endl;
+                }
+                if (state == CHANNEL_ACTIVE && !process_alive(pid)) {
+                    std::cout << "클라이언트 종료 감지: 채널 " << c << " (pid " << pid << ", 해제 없이 종료)" << std::endl;
+                    channel->state.store(CHANNEL_CLOSING, std::memory_order_release);
+                    continue;  // 다음 정리 때 in_flight가 0이면 회수
+                }
+                // 진행 중인 슬롯이 다 끝난 뒤에만 회수: 완료 콜백이 아직 이 채널 버퍼에 쓸 수 있다
+                if (state == CHANNEL_CLOSING && in_flight[c].load(std::memory_order_acquire) == 0) {
+                    for (uint32_t s = 0; s < slots; s++) {
+                        service_slot(header, channel, s)->state.store(SLOT_FREE, std::memory_order_relaxed);
+                    }
+                    std::cout << "클라이언트 해제: 채널 " << c << " (pid " << pid << ", "
+                              << channel->frames.load(std::memory_order_relaxed) << " 프레임)" << std::endl;
+                    channel->frames.store(0, std::memory_order_relaxed);
+                    channel->pid.store(0, std::memory_order_relaxed);
+                    known_pid[c] = 0;
+                    cursor[c] = 0;
+                    channel->state.store(CHANNEL_FREE, std::memory_order_release);
+                }
+            }
+        }
+        if (now - t_report >= std::chrono::duration<double>(report_s)) {
+            const uint64_t done = completed.load(std::memory_order_relaxed);
+            const double interval_s = std::chrono::duration<double>(now - t_report).count();
+            uint32_t active = 0;
+            for (uint32_t c = 0; c < max_clients; c++) {
+                active += service_channel(header, c)->state.load(std::memory_order_relaxed) == CHANNEL_ACTIVE ? 1 : 0;
+            }
+            std::cout << "   클라이언트 " << active << " | " << (done - reported) / interval_s << " fps | 누적 " << done
+                      << " | 실패 " << failures.load(std::memory_order_relaxed) << std::endl;
+            t_report = now;
+            reported = done;
+        }
+
+        if (taken == 0) {
+            futex_wait(&header->doorbell, bell, 100);
+        }
+    }
+
+    std::cout << "추론 서비스 종료 중..." << std::endl;
+    engine->flush();  // 부분 배치까지 끝내 대기 중인 클라이언트에게 결과를 돌려준다
+    engine->stop();
+    region.close();
+    std::cout << "========== 서비스 결과 ==========" << std::endl;
+    std::cout << "   처리 " << completed.load() << " 프레임 | 실패 " << failures.load() << std::endl;
+    return 0;
+}
@@ -0,0 +1,735 @@
+#include "gsthailodepth.hpp"
+
+#include "Hailoinfer.hpp"
+#include "InferBackend.hpp"
+#include "InferEngine.hpp"
+#include "DepthKernels.hpp"
+#include "ResizeKernels.hpp"
+#include "gstreaming.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+GST_DEBUG_CATEGORY_STATIC(gst_hailo_depth_debug);
+#define GST_CAT_DEFAULT gst_hailo_depth_debug
+
+#define DEFAULT_HEF_PATH "./hefs/Midas_v2_small_model.hef"
+#define DEFAULT_BACKEND "hailo"
+#define DEFAULT_COLORMAP "magma"
+#define DEFAULT_PREPROCESS "antialias"
+#define DEFAULT_BATCH_SIZE 1
+#define DEFAULT_FRAMES_IN_FLIGHT 2
+#define DEFAULT_MODEL_SIZE 256
+#define DEFAULT_LATENCY_HINT_MS 39.0
+
+enum {
+    PROP_0,
+    PROP_HEF_PATH,
+    PROP_BACKEND,
+    PROP_COLORMAP,
+    PROP_PREPROCESS,
+    PROP_BATCH_SIZE,
+    PROP_FRAMES_IN_FLIGHT,
+    PROP_MODEL_WIDTH,
+    PROP_MODEL_HEIGHT,
+    PROP_LATENCY_HINT_MS,
+};
+
+static GstStaticPadTemplate sink_template = GST_STATIC_PAD_TEMPLATE("sink",
+    GST_PAD_SINK, GST_PAD_ALWAYS, GST_STATIC_CAPS(GST_VIDEO_CAPS_MAKE("RGB")));
+
+static GstStaticPadTemplate src_template = GST_STATIC_PAD_TEMPLATE("src",
+    GST_PAD_SRC, GST_PAD_ALWAYS, GST_STATIC_CAPS(GST_VIDEO_CAPS_MAKE("RGB")));
+
+/**
+ * @brief Everything the element owns while it is between start() and stop()
+ *
+ * The streaming thread resizes into InferJob input buffers and submits them; the
+ * InferQueue worker composes finished frames and appends them to ready, which
+ * generate_output() drains on the streaming thread.
+ */
+struct HailoDepthState {
+    struct Slot {
+        GstBuffer *input;                                   ///< Camera buffer kept alive until its depth arrives
+        std::chrono::steady_clock::time_point t_submit;
+    };
+
+    explicit HailoDepthState(int colormap) : colorizer(colormap, true) {}
+
+    Config config{};
+    ResizeMethod resize_method = ResizeMethod::Antialias;
+    std::unique_ptr<InferenceBackend> backend;
+    std::unique_ptr<InferQueue> queue;      ///< Declared after backend so it is destroyed first
+    std::unique_ptr<FrameResizer> resizer;  ///< Created in set_caps() for the negotiated input size
+    DepthColorizer colorizer;
+    std::vector<Slot> slots;                ///< Indexed by InferJob::index
+
+    std::mutex mutex;                       ///< Guards ready, error and the latency fields
+    std::deque<GstBuffer*> ready;           ///< Composed output buffers in submit order
+    GstFlowReturn error = GST_FLOW_OK;      ///< First failure seen by the completion thread
+    double infer_latency_ns = 0.0;          ///< EMA of submit → composed output
+    GstClockTime reported_latency = 0;      ///< Last latency answered to a query
+};
+
+#define gst_hailo_depth_parent_class parent_class
+G_DEFINE_TYPE(GstHailoDepth, gst_hailo_depth, GST_TYPE_BASE_TRANSFORM);
+
+// ==================== 지연 시간 ====================
+
+/**
+ * @brief Latency the element adds: whole frame periods held while the NPU works
+ *
+ * Without a known framerate the measured inference latency is reported as is.
+ */
+static GstClockTime gst_hailo_depth_latency(GstHailoDepth *self, double infer_latency_ns)
+{
+    const gint fps_n = GST_VIDEO_INFO_FPS_N(&self->in_info);
+    const gint fps_d = GST_VIDEO_INFO_FPS_D(&self->in_info);
+    if (fps_n <= 0 || fps_d <= 0) {
+        return static_cast<GstClockTime>(infer_latency_ns);
+    }
+    const GstClockTime frame_duration = gst_util_uint64_scale(GST_SECOND, fps_d, fps_n);
+    // 배치 모드는 배치가 찰 때까지 (batch_size - 1) 프레임을 더 붙잡는다
+    const guint64 frames = static_cast<guint64>(std::ceil(infer_latency_ns / frame_duration)) +
+                           (self->batch_size > 1 ? self->batch_size - 1 : 0);
+    return frames * frame_duration;
+}
+
+// ==================== 추론 완료 (InferQueue 스레드) ====================
+
+/**
+ * @brief Composes camera | colourized depth into a buffer from the negotiated pool
+ *
+ * The pool holds at least queue->capacity() buffers on top of the downstream minimum
+ * (see decide_allocation), so this acquire does not block on a bounded pool.
+ */
+static GstFlowReturn gst_hailo_depth_compose(GstHailoDepth *self, GstBuffer *input, const InferJob &job,
+                                             GstBuffer **out_buffer)
+{
+    HailoDepthState *state = self->state;
+    GstBufferPool *pool = gst_base_transform_get_buffer_pool(GST_BASE_TRANSFORM(self));
+    if (!pool) {
+        return GST_FLOW_NOT_NEGOTIATED;
+    }
+    if (!gst_buffer_pool_is_active(pool) && !gst_buffer_pool_set_active(pool, TRUE)) {
+        gst_object_unref(pool);
+        return GST_FLOW_ERROR;
+    }
+    GstBuffer *output = NULL;
+    GstFlowReturn ret = gst_buffer_pool_acquire_buffer(pool, &output, NULL);
+    gst_object_unref(pool);
+    if (ret != GST_FLOW_OK) {
+        return ret;
+    }
+
+    GstVideoFrame in_frame;
+    GstVideoFrame out_frame;
+    if (!gst_video_frame_map(&in_frame, &self->in_info, input, GST_MAP_READ)) {
+        gst_buffer_unref(output);
+        return GST_FLOW_ERROR;
+    }
+    if (!gst_video_frame_map(&out_frame, &self->out_info, output, GST_MAP_WRITE)) {
+        gst_video_frame_unmap(&in_frame);
+        gst_buffer_unref(output);
+        return GST_FLOW_ERROR;
+    }
+
+    const cv::Mat raw_img(GST_VIDEO_FRAME_HEIGHT(&in_frame), GST_VIDEO_FRAME_WIDTH(&in_frame), CV_8UC3,
+                          GST_VIDEO_FRAME_PLANE_DATA(&in_frame, 0), GST_VIDEO_FRAME_PLANE_STRIDE(&in_frame, 0));
+    const cv::Mat raw_depth(state->config.model_height, state->config.model_width, CV_8SC1, job.output);
+    cv::Mat composite(GST_VIDEO_FRAME_HEIGHT(&out_frame), GST_VIDEO_FRAME_WIDTH(&out_frame), CV_8UC3,
+                      GST_VIDEO_FRAME_PLANE_DATA(&out_frame, 0), GST_VIDEO_FRAME_PLANE_STRIDE(&out_frame, 0));
+    postprocess(raw_img, raw_depth, &state->config, &state->colorizer, composite);
+
+    gst_video_frame_unmap(&out_frame);
+    gst_video_frame_unmap(&in_frame);
+
+    // PTS/DTS/duration/offset와 플래그를 입력에서 그대로 가져온다
+    gst_buffer_copy_into(output, input, (GstBufferCopyFlags)(GST_BUFFER_COPY_FLAGS | GST_BUFFER_COPY_TIMESTAMPS), 0, -1);
+    *out_buffer = output;
+    return GST_FLOW_OK;
+}
+
+static void gst_hailo_depth_complete(GstHailoDepth *self, InferJob &job)
+{
+    HailoDepthState *state = self->state;
+    HailoDepthState::Slot *slot = static_cast<HailoDepthState::Slot*>(job.user_data);
+    if (!slot || !slot->input) {
+        return;  // 입력 매핑에 실패한 프레임
+    }
+    GstBuffer *input = slot->input;
+    slot->input = NULL;
+
+    GstBuffer *output = NULL;
+    GstFlowReturn ret = GST_FLOW_ERROR;
+    if (job.status == HAILO_SUCCESS) {
+        ret = gst_hailo_depth_compose(self, input, job, &output);
+    } else {
+        GST_ELEMENT_ERROR(self, STREAM, FAILED, ("Inference failed"), ("hailo_status %d", job.status));
+    }
+    gst_buffer_unref(input);
+
+    const double elapsed_ns = std::chrono::duration<double, std::nano>(
+        std::chrono::steady_clock::now() - slot->t_submit).count();
+    bool latency_changed = false;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (ret == GST_FLOW_OK) {
+            state->ready.push_back(output);
+        } else if (state->error == GST_FLOW_OK) {
+            state->error = ret;
+        }
+        state->infer_latency_ns = 0.9 * state->infer_latency_ns + 0.1 * elapsed_ns;
+        // 보고한 값보다 10% 넘게 늘면 파이프라인에 latency 재계산을 요청
+        const GstClockTime latency = gst_hailo_depth_latency(self, state->infer_latency_ns);
+        if (state->reported_latency != 0 && latency > state->reported_latency + state->reported_latency / 10) {
+            state->reported_latency = latency;
+            latency_changed = true;
+        }
+    }
+    if (latency_changed) {
+        gst_element_post_message(GST_ELEMENT(self), gst_message_new_latency(GST_OBJECT(self)));
+    }
+}
+
+// ==================== GstBaseTransform ====================
+
+static gboolean gst_hailo_depth_start(GstBaseTransform *trans)
+{
+    GstHailoDepth *self = GST_HAILO_DEPTH(trans);
+
+    int colormap;
+    if (!parse_colormap(self->colormap, colormap)) {
+        GST_ELEMENT_ERROR(self, RESOURCE, SETTINGS, ("Unknown colormap '%s'", self->colormap),
+                          ("expected magma, inferno, plasma, viridis, turbo or jet"));
+        return FALSE;
+    }
+    std::unique_ptr<HailoDepthState> state(new HailoDepthState(colormap));
+    if (!parse_resize_method(self->preprocess, state->resize_method)) {
+        GST_ELEMENT_ERROR(self, RESOURCE, SETTINGS, ("Unknown preprocess method '%s'", self->preprocess),
+                          ("expected antialias, area or blur_resize"));
+        return FALSE;
+    }
+
+    Config &config = state->config;
+    config.hef_path = self->hef_path;
+    config.backend = self->backend;
+    config.preprocess = self->preprocess;
+    config.model_width = static_cast<int>(self->model_width);
+    config.model_height = static_cast<int>(self->model_height);
+    config.batch_size = static_cast<int>(self->batch_size);
+    config.frames_in_flight = static_cast<int>(self->frames_in_flight);
+    config.batch_timeout_ms = 50.0;
+    config.cpu_latency_ms = self->latency_hint_ms;
+    config.cpu_jitter_ms = 1.5;
+
+    auto backend = create_backend(config);
+    if (!backend) {
+        GST_ELEMENT_ERROR(self, RESOURCE, OPEN_READ, ("Failed to create %s backend", self->backend),
+                          ("hef %s, status %d", self->hef_path, backend.status()));
+        return FALSE;
+    }
+    state->backend = std::move(backend.value());
+    const size_t depth_size = static_cast<size_t>(config.model_width) * config.model_height;
+    if (state->backend->input_frame_size() != depth_size * 3 || state->backend->output_frame_size() != depth_size) {
+        GST_ELEMENT_ERROR(self, RESOURCE, SETTINGS, ("Model does not match %ux%u", self->model_width, self->model_height),
+                          ("input %zu bytes, output %zu bytes", state->backend->input_frame_size(),
+                           state->backend->output_frame_size()));
+        return FALSE;
+    }
+
+    auto queue = create_infer_queue(*state->backend, config, [self](InferJob &job) { gst_hailo_depth_complete(self, job); });
+    if (!queue) {
+        GST_ELEMENT_ERROR(self, RESOURCE, FAILED, ("Failed to start inference queue"), ("status %d", queue.status()));
+        return FALSE;
+    }
+    state->queue = std::move(queue.value());
+    state->slots.assign(state->queue->capacity(), HailoDepthState::Slot{NULL, {}});
+    state->infer_latency_ns = self->latency_hint_ms * 1e6;
+
+    GST_INFO_OBJECT(self, "%s backend, batch %u, in-flight %u, %s preprocessing (%s)", self->backend,
+                    self->batch_size, self->frames_in_flight, resize_method_name(state->resize_method),
+                    resize_kernel_path());
+    self->state = state.release();
+    return TRUE;
+}
+
+static void gst_hailo_depth_drop_ready(HailoDepthState *state)
+{
+    std::lock_guard<std::mutex> lock(state->mutex);
+    for (GstBuffer *buffer : state->ready) {
+        gst_buffer_unref(buffer);
+    }
+    state->ready.clear();
+}
+
+static gboolean gst_hailo_depth_stop(GstBaseTransform *trans)
+{
+    GstHailoDepth *self = GST_HAILO_DEPTH(trans);
+    HailoDepthState *state = self->state;
+    if (!state) {
+        return TRUE;
+    }
+    state->queue->stop();  // in-flight 프레임은 ready로 들어온 뒤 함께 해제
+    gst_hailo_depth_drop_ready(state);
+    delete state;
+    self->state = NULL;
+    return TRUE;
+}
+
+/**
+ * @brief Output is the input frame and its depth side by side: twice the width, same height
+ */
+static GstCaps *gst_hailo_depth_transform_caps(GstBaseTransform *trans, GstPadDirection direction,
+                                               GstCaps *caps, GstCaps *filter)
+{
+    GstCaps *result = gst_caps_copy(caps);
+    for (guint i = 0; i < gst_caps_get_size(result); i++) {
+        GstStructure *structure = gst_caps_get_structure(result, i);
+        const GValue *width = gst_structure_get_value(structure, "width");
+        if (width && G_VALUE_HOLDS_INT(width)) {
+            const gint value = g_value_get_int(width);
+            if (direction == GST_PAD_SINK) {
+                gst_structure_set(structure, "width", G_TYPE_INT, value * 2, NULL);
+            } else {
+                gst_structure_set(structure, "width", G_TYPE_INT, value / 2, NULL);
+            }
+        } else if (width && GST_VALUE_HOLDS_INT_RANGE(width)) {
+            const gint min = gst_value_get_int_range_min(width);
+            const gint max = gst_value_get_int_range_max(width);
+            if (direction == GST_PAD_SINK) {
+                gst_structure_set(structure, "width", GST_TYPE_INT_RANGE, MIN(min, G_MAXINT / 2) * 2,
+                                  MIN(max, G_MAXINT / 2) * 2, NULL);
+            } else {
+                gst_structure_set(structure, "width", GST_TYPE_INT_RANGE, MAX(min / 2, 1), MAX(max / 2, 1), NULL);
+            }
+        } else {
+            gst_structure_set(structure, "width", GST_TYPE_INT_RANGE, 1, G_MAXINT, NULL);
+        }
+    }
+
+    if (filter) {
+        GstCaps *intersection = gst_caps_intersect_full(filter, result, GST_CAPS_INTERSECT_FIRST);
+        gst_caps_unref(result);
+        result = intersection;
+    }
+    GST_DEBUG_OBJECT(trans, "transformed %" GST_PTR_FORMAT " into %" GST_PTR_FORMAT, caps, result);
+    return result;
+}
+
+static gboolean gst_hailo_depth_set_caps(GstBaseTransform *trans, GstCaps *incaps, GstCaps *outcaps)
+{
+    GstHailoDepth *self = GST_HAILO_DEPTH(trans);
+    HailoDepthState *state = self->state;
+    if (!state) {
+        return FALSE;
+    }
+
+    GstVideoInfo in_info;
+    GstVideoInfo out_info;
+    if (!gst_video_info_from_caps(&in_info, incaps) || !gst_video_info_from_caps(&out_info, outcaps)) {
+        GST_ERROR_OBJECT(self, "invalid caps");
+        return FALSE;
+    }
+    if (GST_VIDEO_INFO_WIDTH(&out_info) != 2 * GST_VIDEO_INFO_WIDTH(&in_info) ||
+        GST_VIDEO_INFO_HEIGHT(&out_info) != GST_VIDEO_INFO_HEIGHT(&in_info)) {
+        GST_ERROR_OBJECT(self, "output must be twice the input width and the same height");
+        return FALSE;
+    }
+
+    // 재협상 전에 이전 해상도로 제출한 프레임을 모두 내보낸다
+    if (state->resizer) {
+        state->queue->flush();
+    }
+    self->in_info = in_info;
+    self->out_info = out_info;
+    state->config.video_inWidth = GST_VIDEO_INFO_WIDTH(&in_info);
+    state->config.video_inHeight = GST_VIDEO_INFO_HEIGHT(&in_info);
+    state->config.video_outWidth = GST_VIDEO_INFO_WIDTH(&out_info);
+    state->config.video_outHeight = GST_VIDEO_INFO_HEIGHT(&out_info);
+    state->resizer.reset(new FrameResizer(cv::Size(state->config.video_inWidth, state->config.video_inHeight),
+                                          cv::Size(state->config.model_width, state->config.model_height),
+                                          state->resize_method));
+    return TRUE;
+}
+
+/**
+ * @brief Outputs come from a video pool of at least 4 buffers (frames in flight + downstream queue)
+ */
+static gboolean gst_hailo_depth_decide_allocation(GstBaseTransform *trans, GstQuery *query)
+{
+    GstHailoDepth *self = GST_HAILO_DEPTH(trans);
+    GstCaps *caps = NULL;
+    gst_query_parse_allocation(query, &caps, NULL);
+    if (!caps) {
+        return FALSE;
+    }
+
+    GstBufferPool *pool = NULL;
+    guint size = 0;
+    guint min = 0;
+    guint max = 0;
+    const gboolean update = gst_query_get_n_allocation_pools(query) > 0;
+    if (update) {
+        gst_query_parse_nth_allocation_pool(query, 0, &pool, &size, &min, &max);
+    }
+    if (!pool) {
+        pool = gst_video_buffer_pool_new();
+    }
+    size = MAX(size, (guint)GST_VIDEO_INFO_SIZE(&self->out_info));
+    // 완료 스레드는 InferQueue 용량만큼 (배치 모드는 2 x batch_size) 연달아 출력 버퍼를 잡는다.
+    // 다운스트림이 붙잡는 min개에 그만큼을 더해야 acquire에서 막히지 않는다 (막히면 스트리밍
+    // 스레드의 queue->acquire()와 서로 기다리며 멈춘다)
+    const guint in_flight = self->state ? static_cast<guint>(self->state->queue->capacity()) : 0u;
+    min = MAX(min + in_flight, 4u);
+    if (max != 0) {
+        max = MAX(max, min);
+    }
+
+    GstStructure *config = gst_buffer_pool_get_config(pool);
+    gst_buffer_pool_config_set_params(config, caps, size, min, max);
+    if (gst_query_find_allocation_meta(query, GST_VIDEO_META_API_TYPE, NULL)) {
+        gst_buffer_pool_config_add_option(config, GST_BUFFER_POOL_OPTION_VIDEO_META);
+    }
+    if (!gst_buffer_pool_set_config(pool, config)) {
+        // 풀이 설정을 조정했으면 조정된 값으로 다시 시도
+        config = gst_buffer_pool_get_config(pool);
+        if (!gst_buffer_pool_config_validate_params(config, caps, size, min, max) ||
+            !gst_buffer_pool_set_config(pool, config)) {
+            GST_ERROR_OBJECT(self, "failed to configure the output pool");
+            gst_object_unref(pool);
+            return FALSE;
+        }
+    }
+
+    if (update) {
+        gst_query_set_nth_allocation_pool(query, 0, pool, size, min, max);
+    } else {
+        gst_query_add_allocation_pool(query, pool, size, min, max);
+    }
+    gst_object_unref(pool);
+
+    return GST_BASE_TRANSFORM_CLASS(parent_class)->decide_allocation(trans, query);
+}
+
+/**
+ * @brief Preprocesses the camera frame into an NPU job; the output is produced later by the completion thread
+ */
+static GstFlowReturn gst_hailo_depth_submit_input_buffer(GstBaseTransform *trans, gboolean is_discont,
+                                                         GstBuffer *input)
+{
+    GstHailoDepth *self = GST_HAILO_DEPTH(trans);
+    HailoDepthState *state = self->state;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (state->error != GST_FLOW_OK) {
+            gst_buffer_unref(input);
+            return state->error;
+        }
+    }
+
+    // NPU 슬롯이 빌 때까지 대기 (업스트림으로 backpressure)
+    InferJob *job = state->queue->acquire();
+    if (!job) {
+        gst_buffer_unref(input);
+        return GST_FLOW_FLUSHING;
+    }
+    HailoDepthState::Slot &slot = state->slots[job->index];
+    slot.input = NULL;
+    job->user_data = &slot;
+
+    GstVideoFrame frame;
+    if (!gst_video_frame_map(&frame, &self->in_info, input, GST_MAP_READ)) {
+        gst_buffer_unref(input);
+        state->queue->submit(job);  // 빈 슬롯도 제출해야 큐 순서가 유지된다
+        GST_ELEMENT_ERROR(self, STREAM, FAILED, ("Failed to map input frame"), (NULL));
+        return GST_FLOW_ERROR;
+    }
+    const cv::Mat raw_img(GST_VIDEO_FRAME_HEIGHT(&frame), GST_VIDEO_FRAME_WIDTH(&frame), CV_8UC3,
+                          GST_VIDEO_FRAME_PLANE_DATA(&frame, 0), GST_VIDEO_FRAME_PLANE_STRIDE(&frame, 0));
+    cv::Mat model_input(state->config.model_height, state->config.model_width, CV_8UC3, job->input);
+    state->resizer->resize(raw_img, model_input);
+    gst_video_frame_unmap(&frame);
+
+    slot.input = input;  // 출력 합성과 타임스탬프 복사를 위해 완료까지 보관
+    slot.t_submit = std::chrono::steady_clock::now();
+    hailo_status status = state->queue->submit(job);
+    if (status != HAILO_SUCCESS) {
+        // 제출되지 않은 잡은 완료 콜백이 오지 않으므로 입력 버퍼를 여기서 놓는다
+        slot.input = NULL;
+        gst_buffer_unref(input);
+        GST_ELEMENT_ERROR(self, STREAM, FAILED, ("Failed to submit frame"), ("hailo_status %d", status));
+        return GST_FLOW_ERROR;
+    }
+    return GST_FLOW_OK;
+}
+
+static GstFlowReturn gst_hailo_depth_generate_output(GstBaseTransform *trans, GstBuffer **outbuf)
+{
+    GstHailoDepth *self = GST_HAILO_DEPTH(trans);
+    HailoDepthState *state = self->state;
+    std::lock_guard<std::mutex> lock(state->mutex);
+    if (!state->ready.empty()) {
+        *outbuf = state->ready.front();
+        state->ready.pop_front();
+        return GST_FLOW_OK;
+    }
+    *outbuf = NULL;
+    return state->error;
+}
+
+static gboolean gst_hailo_depth_sink_event(GstBaseTransform *trans, GstEvent *event)
+{
+    GstHailoDepth *self = GST_HAILO_DEPTH(trans);
+    HailoDepthState *state = self->state;
+    if (!state) {
+        return GST_BASE_TRANSFORM_CLASS(parent_class)->sink_event(trans, event);
+    }
+
+    switch (GST_EVENT_TYPE(event)) {
+    case GST_EVENT_EOS: {
+        // 부분 배치와 in-flight 프레임까지 내보낸 뒤 EOS 전달
+        state->queue->flush();
+        while (true) {
+            GstBuffer *buffer = NULL;
+            if (gst_hailo_depth_generate_output(trans, &buffer) != GST_FLOW_OK || !buffer) {
+                break;
+            }
+            GstFlowReturn ret = gst_pad_push(GST_BASE_TRANSFORM_SRC_PAD(trans), buffer);
+            if (ret != GST_FLOW_OK) {
+                GST_DEBUG_OBJECT(self, "drain push returned %s", gst_flow_get_name(ret));
+                gst_hailo_depth_drop_ready(state);
+                break;
+            }
+        }
+        break;
+    }
+    case GST_EVENT_FLUSH_STOP:
+        state->queue->flush();
+        gst_hailo_depth_drop_ready(state);
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->error = GST_FLOW_OK;
+        }
+        break;
+    default:
+        break;
+    }
+    return GST_BASE_TRANSFORM_CLASS(parent_class)->sink_event(trans, event);
+}
+
+static gboolean gst_hailo_depth_query(GstBaseTransform *trans, GstPadDirection direction, GstQuery *query)
+{
+    GstHailoDepth *self = GST_HAILO_DEPTH(trans);
+
+    if (direction == GST_PAD_SRC && GST_QUERY_TYPE(query) == GST_QUERY_LATENCY && self->state) {
+        if (!gst_pad_peer_query(GST_BASE_TRANSFORM_SINK_PAD(trans), query)) {
+            return FALSE;
+        }
+        gboolean live;
+        GstClockTime min_latency;
+        GstClockTime max_latency;
+        gst_query_parse_latency(query, &live, &min_latency, &max_latency);
+
+        GstClockTime latency;
+        {
+            std::lock_guard<std::mutex> lock(self->state->mutex);
+            latency = gst_hailo_depth_latency(self, self->state->infer_latency_ns);
+            self->state->reported_latency = latency;
+        }
+        GST_DEBUG_OBJECT(self, "adding latency %" GST_TIME_FORMAT, GST_TIME_ARGS(latency));
+        min_latency += latency;
+        if (GST_CLOCK_TIME_IS_VALID(max_latency)) {
+            max_latency += latency;
+        }
+        gst_query_set_latency(query, live, min_latency, max_latency);
+        return TRUE;
+    }
+    return GST_BASE_TRANSFORM_CLASS(parent_class)->query(trans, direction, query);
+}
+
+// ==================== GObject ====================
+
+static void gst_hailo_depth_set_property(GObject *object, guint prop_id, const GValue *value, GParamSpec *pspec)
+{
+    GstHailoDepth *self = GST_HAILO_DEPTH(object);
+    switch (prop_id) {
+    case PROP_HEF_PATH:
+        g_free(self->hef_path);
+        self->hef_path = g_value_dup_string(value);
+        break;
+    case PROP_BACKEND:
+        g_free(self->backend);
+        self->backend = g_value_dup_string(value);
+        break;
+    case PROP_COLORMAP:
+        g_free(self->colormap);
+        self->colormap = g_value_dup_string(value);
+        break;
+    case PROP_PREPROCESS:
+        g_free(self->preprocess);
+        self->preprocess = g_value_dup_string(value);
+        break;
+    case PROP_BATCH_SIZE:
+        self->batch_size = g_value_get_uint(value);
+        break;
+    case PROP_FRAMES_IN_FLIGHT:
+        self->frames_in_flight = g_value_get_uint(value);
+        break;
+    case PROP_MODEL_WIDTH:
+        self->model_width = g_value_get_uint(value);
+        break;
+    case PROP_MODEL_HEIGHT:
+        self->model_height = g_value_get_uint(value);
+        break;
+    case PROP_LATENCY_HINT_MS:
+        self->latency_hint_ms = g_value_get_double(value);
+        break;
+    default:
+        G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
+        break;
+    }
+}
+
+static void gst_hailo_depth_get_property(GObject *object, guint prop_id, GValue *value, GParamSpec *pspec)
+{
+    GstHailoDepth *self = GST_HAILO_DEPTH(object);
+    switch (prop_id) {
+    case PROP_HEF_PATH:
+        g_value_set_string(value, self->hef_path);
+        break;
+    case PROP_BACKEND:
+        g_value_set_string(value, self->backend);
+        break;
+    case PROP_COLORMAP:
+        g_value_set_string(value, self->colormap);
+        break;
+    case PROP_PREPROCESS:
+        g_value_set_string(value, self->preprocess);
+        break;
+    case PROP_BATCH_SIZE:
+        g_value_set_uint(value, self->batch_size);
+        break;
+    case PROP_FRAMES_IN_FLIGHT:
+        g_value_set_uint(value, self->frames_in_flight);
+        break;
+    case PROP_MODEL_WIDTH:
+        g_value_set_uint(value, self->model_width);
+        break;
+    case PROP_MODEL_HEIGHT:
+        g_value_set_uint(value, self->model_height);
+        break;
+    case PROP_LATENCY_HINT_MS:
+        g_value_set_double(value, self->latency_hint_ms);
+        break;
+    default:
+        G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
+        break;
+    }
+}
+
+static void gst_hailo_depth_finalize(GObject *object)
+{
+    GstHailoDepth *self = GST_HAILO_DEPTH(object);
+    g_free(self->hef_path);
+    g_free(self->backend);
+    g_free(self->colormap);
+    g_free(self->preprocess);
+    G_OBJECT_CLASS(parent_class)->finalize(object);
+}
+
+static void gst_hailo_depth_class_init(GstHailoDepthClass *klass)
+{
+    GObjectClass *gobject_class = G_OBJECT_CLASS(klass);
+    GstElementClass *element_class = GST_ELEMENT_CLASS(klass);
+    GstBaseTransformClass *trans_class = GST_BASE_TRANSFORM_CLASS(klass);
+
+    gobject_class->set_property = gst_hailo_depth_set_property;
+    gobject_class->get_property = gst_hailo_depth_get_property;
+    gobject_class->finalize = gst_hailo_depth_finalize;
+
+    const GParamFlags flags = (GParamFlags)(G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS | GST_PARAM_MUTABLE_READY);
+    g_object_class_install_property(gobject_class, PROP_HEF_PATH,
+        g_param_spec_string("hef-path", "HEF path", "Compiled depth model", DEFAULT_HEF_PATH, flags));
+    g_object_class_install_property(gobject_class, PROP_BACKEND,
+        g_param_spec_string("backend", "Backend", "hailo (NPU) or cpu (simulated, no device needed)",
+                            DEFAULT_BACKEND, flags));
+    g_object_class_install_property(gobject_class, PROP_COLORMAP,
+        g_param_spec_string("colormap", "Colormap", "magma, inferno, plasma, viridis, turbo or jet",
+                            DEFAULT_COLORMAP, flags));
+    g_object_class_install_property(gobject_class, PROP_PREPROCESS,
+        g_param_spec_string("preprocess", "Preprocess", "Camera to model resize: antialias, area or blur_resize",
+                            DEFAULT_PREPROCESS, flags));
+    g_object_class_install_property(gobject_class, PROP_BATCH_SIZE,
+        g_param_spec_uint("batch-size", "Batch size", "Frames per NPU infer call (1 = no temporal batching)",
+                          1, 64, DEFAULT_BATCH_SIZE, flags));
+    g_object_class_install_property(gobject_class, PROP_FRAMES_IN_FLIGHT,
+        g_param_spec_uint("frames-in-flight", "Frames in flight", "Frames queued on the NPU at once (batch-size 1)",
+                          1, 16, DEFAULT_FRAMES_IN_FLIGHT, flags));
+    g_object_class_install_property(gobject_class, PROP_MODEL_WIDTH,
+        g_param_spec_uint("model-width", "Model width", "Model input width", 1, 4096, DEFAULT_MODEL_SIZE, flags));
+    g_object_class_install_property(gobject_class, PROP_MODEL_HEIGHT,
+        g_param_spec_uint("model-height", "Model height", "Model input height", 1, 4096, DEFAULT_MODEL_SIZE, flags));
+    g_object_class_install_property(gobject_class, PROP_LATENCY_HINT_MS,
+        g_param_spec_double("latency-hint-ms", "Latency hint",
+                            "Initial inference latency estimate (also the cpu backend's simulated latency)",
+                            0.0, 10000.0, DEFAULT_LATENCY_HINT_MS, flags));
+
+    gst_element_class_set_static_metadata(element_class, "Hailo depth estimation", "Filter/Effect/Video",
+        "Runs a depth model and outputs the camera frame and colourized depth side by side", "BicMak");
+    gst_element_class_add_static_pad_template(element_class, &sink_template);
+    gst_element_class_add_static_pad_template(element_class, &src_template);
+
+    trans_class->passthrough_on_same_caps = FALSE;
+    trans_class->start = GST_DEBUG_FUNCPTR(gst_hailo_depth_start);
+    trans_class->stop = GST_DEBUG_FUNCPTR(gst_hailo_depth_stop);
+    trans_class->transform_caps = GST_DEBUG_FUNCPTR(gst_hailo_depth_transform_caps);
+    trans_class->set_caps = GST_DEBUG_FUNCPTR(gst_hailo_depth_set_caps);
+    trans_class->decide_allocation = GST_DEBUG_FUNCPTR(gst_hailo_depth_decide_allocation);
+    trans_class->submit_input_buffer = GST_DEBUG_FUNCPTR(gst_hailo_depth_submit_input_buffer);
+    trans_class->generate_output = GST_DEBUG_FUNCPTR(gst_hailo_depth_generate_output);
+    trans_class->sink_event = GST_DEBUG_FUNCPTR(gst_hailo_depth_sink_event);
+    trans_class->query = GST_DEBUG_FUNCPTR(gst_hailo_depth_query);
+}
+
+static void gst_hailo_depth_init(GstHailoDepth *self)
+{
+    self->hef_path = g_strdup(DEFAULT_HEF_PATH);
+    self->backend = g_strdup(DEFAULT_BACKEND);
+    self->colormap = g_strdup(DEFAULT_COLORMAP);
+    self->preprocess = g_strdup(DEFAULT_PREPROCESS);
+    self->batch_size = DEFAULT_BATCH_SIZE;
+    self->frames_in_flight = DEFAULT_FRAMES_IN_FLIGHT;
+    self->model_width = DEFAULT_MODEL_SIZE;
+    self->model_height = DEFAULT_MODEL_SIZE;
+    self->latency_hint_ms = DEFAULT_LATENCY_HINT_MS;
+    gst_video_info_init(&self->in_info);
+    gst_video_info_init(&self->out_info);
+    self->state = NULL;
+}
+
+// ==================== 등록 ====================
+
+static gboolean plugin_init(GstPlugin *plugin)
+{
+    GST_DEBUG_CATEGORY_INIT(gst_hailo_depth_debug, "hailodepth", 0, "Hailo depth estimation");
+    return gst_element_register(plugin, "hailodepth", GST_RANK_NONE, GST_TYPE_HAILO_DEPTH);
+}
+
+gboolean gst_hailo_depth_register_static(void)
+{
+    return gst_plugin_register_static(GST_VERSION_MAJOR, GST_VERSION_MINOR, "hailodepth",
+                                      "Hailo depth estimation", plugin_init, "1.0", "unknown",
+                                      "hailodepth", "hailo-depth-Estimation",
+                                      "https://github.com/BicMak/hailo-depth-Estimation");
+}
+
+#ifdef HAILODEPTH_BUILD_PLUGIN
+// gst-launch-1.0에서 GST_PLUGIN_PATH로 로드하는 플러그인 진입점
+GST_PLUGIN_DEFINE(GST_VERSION_MAJOR, GST_VERSION_MINOR, hailodepth, "Hailo depth estimation",
+                  plugin_init, "1.0", "unknown", "hailodepth", "https://github.com/BicMak/hailo-depth-Estimation")
+#endif
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <gst/gst.h>
+#include <gst/base/gstbasetransform.h>
+#include <gst/video/video.h>
+
+G_BEGIN_DECLS
+
+#define GST_TYPE_HAILO_DEPTH (gst_hailo_depth_get_type())
+#define GST_HAILO_DEPTH(obj) (G_TYPE_CHECK_INSTANCE_CAST((obj), GST_TYPE_HAILO_DEPTH, GstHailoDepth))
+
+struct HailoDepthState;
+
+/**
+ * @brief hailodepth element: RGB camera frames in, camera | colourized depth side by side out
+ *
+ * A GstBaseTransform that runs the whole host pipeline inside GStreamer:
+ * FrameResizer preprocessing, inference through an InferQueue (several frames in
+ * flight, or temporal batches), DepthColorizer postprocessing, and composition
+ * into buffers from the negotiated downstream pool. Input PTS/DTS/duration are
+ * copied to the matching output and the added latency is reported to latency
+ * queries. backend=cpu runs the simulated backend, so the element can be used
+ * without a Hailo device.
+ *
+ * gst-launch-1.0 v4l2src ! videoconvert ! videoscale ! video/x-raw,format=RGB,width=640,height=480 !
+ *     hailodepth hef-path=model.hef ! videoconvert ! autovideosink
+ */
+typedef struct _GstHailoDepth {
+    GstBaseTransform parent;
+
+    // 속성 (start() 시점에 적용)
+    gchar *hef_path;
+    gchar *backend;
+    gchar *colormap;
+    gchar *preprocess;
+    guint batch_size;
+    guint frames_in_flight;
+    guint model_width;
+    guint model_height;
+    gdouble latency_hint_ms;
+
+    GstVideoInfo in_info;
+    GstVideoInfo out_info;
+
+    HailoDepthState *state;  ///< Backend, queue, kernels; created in start(), freed in stop()
+} GstHailoDepth;
+
+typedef struct _GstHailoDepthClass {
+    GstBaseTransformClass parent_class;
+} GstHailoDepthClass;
+
+GType gst_hailo_depth_get_type(void);
+
+/**
+ * @brief Registers hailodepth with the running process (no plugin scan needed)
+ */
+gboolean gst_hailo_depth_register_static(void);
+
+G_END_DECLS
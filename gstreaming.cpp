@@ -3,6 +3,7 @@
 #include <gst/app/gstappsink.h>  // 추가
 #include <gst/app/gstappsrc.h>   // 추가
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <opencv2/opencv.hpp>
@@ -13,6 +14,9 @@
 #include "hailo/hailort.hpp"
 #include "hailo/hailort_common.hpp" 
 #include "gstreaming.hpp" 
+#include "StagedPipeline.hpp"
+#include "ModelGroup.hpp"
+#include "ModelLadder.hpp"
 
 #include <fstream>
 static const bool MONITORING = FALSE;
@@ -89,19 +93,137 @@ gboolean on_message(GstBus *bus, GstMessage *message, gpointer data) {
     return TRUE;
 }
 
+/**
+ * @brief gst-launch description of the replay source: recorded file → RGB at the camera size
+ *
+ * Video files go through decodebin; *.rgb / *.raw files are raw RGB frame dumps at
+ * video.input size. With replay_rate > 0 frames are paced to that rate on the
+ * pipeline clock (identity sync=true), like a camera; with 0 they flow as fast as the
+ * appsink consumes them.
+ */
+std::string replay_source_description(const Config& config) {
+    const std::string &file = config.replay_file;
+    const bool raw = file.size() > 4 &&
+        (file.compare(file.size() - 4, 4, ".rgb") == 0 || file.compare(file.size() - 4, 4, ".raw") == 0);
+    const std::string size = "width=" + std::to_string(config.video_inWidth) +
+                             ",height=" + std::to_string(config.video_inHeight);
+    const int rate_milli = static_cast<int>(config.replay_rate * 1000.0 + 0.5);
+    const std::string framerate = rate_milli > 0 ? std::to_string(rate_milli) + "/1000"
+                                                 : std::to_string(config.frame_rate) + "/1";
+
+    std::string desc;
+    if (raw) {
+        const size_t frame_bytes = static_cast<size_t>(config.video_inWidth) * config.video_inHeight * 3;
+        std::string raw_size = size;
+        std::replace(raw_size.begin(), raw_size.end(), ',', ' ');
+        desc = "filesrc location=\"" + file + "\" blocksize=" + std::to_string(frame_bytes) +
+               " ! rawvideoparse format=rgb " + raw_size + " framerate=" + framerate;
+    } else {
+        desc = "filesrc location=\"" + file + "\" ! decodebin ! videoconvert ! videoscale";
+        if (rate_milli > 0) {
+            desc += " ! videorate";
+        }
+        desc += " ! video/x-raw,format=RGB," + size + (rate_milli > 0 ? ",framerate=" + framerate : "");
+    }
+    if (rate_milli > 0) {
+        desc += " ! identity sync=true";  // 파일을 카메라처럼 실시간 속도로
+    }
+    return desc;
+}
+
+/**
+ * @brief Builds the replay source (replay_source_description()) → queue1
+ *
+ * @return false if the source description cannot be built
+ */
+static bool makeReplaySource(GstElement* pipeline, const Config& config) {
+    const std::string desc = replay_source_description(config);
+    GError *error = nullptr;
+    GstElement *source = gst_parse_bin_from_description(desc.c_str(), TRUE, &error);
+    if (!source) {
+        std::cerr << "[ERROR] Replay source: " << (error ? error->message : desc) << std::endl;
+        if (error) {
+            g_error_free(error);
+        }
+        return false;
+    }
+    GstElement *queue1 = gst_element_factory_make("queue", "queue1");
+    gst_bin_add_many(GST_BIN(pipeline), source, queue1, NULL);
+    if (!gst_element_link(source, queue1)) {
+        std::cerr << "replay source → queue1 링크 실패" << std::endl;
+        return false;
+    }
+    const bool paced = config.replay_rate > 0;
+    std::cout << "재생: " << config.replay_file << " ("
+              << (paced ? std::to_string(config.replay_rate) + " fps" : std::string("제한 없음")) << ")" << std::endl;
+    return true;
+}
+
+/**
+ * @brief Builds the capture pipeline of one source in a multi-source rig
+ *
+ * source → RGB at the source's capture size → queue → appsink named "app_sink".
+ * v4l2 opens a camera, test is a live videotestsrc (location = pattern) paced at the
+ * source frame rate, file replays a recording (replay_source_description()).
+ *
+ * @param[in] source Source entry from the sources list
+ * @param[in] config Per-source configuration (capture size, frame rate, replay settings)
+ * @return Pipeline in NULL state, or nullptr for an unknown type or a parse error
+ */
+GstElement* makeSourcePipeline(const VideoSource& source, const Config& config) {
+    const std::string caps = "video/x-raw,format=RGB,width=" + std::to_string(config.video_inWidth) +
+                             ",height=" + std::to_string(config.video_inHeight);
+    std::string desc;
+    if (source.type == "v4l2") {
+        desc = "v4l2src device=" + source.location + " ! videoconvert ! videoscale ! " + caps;
+    } else if (source.type == "test") {
+        desc = "videotestsrc is-live=true pattern=" + (source.location.empty() ? std::string("smpte") : source.location) +
+               " ! " + caps + ",framerate=" + std::to_string(config.frame_rate) + "/1";
+    } else if (source.type == "file") {
+        desc = replay_source_description(config);
+    } else {
+        std::cerr << "[ERROR] Unknown source type: " << source.type << " (expected v4l2, test or file)" << std::endl;
+        return nullptr;
+    }
+    desc += " ! queue max-size-buffers=2 ! appsink name=app_sink";
+
+    std::cout << "소스 " << source.name << ": " << desc << std::endl;
+    GError *error = nullptr;
+    GstElement *pipeline = gst_parse_launch(desc.c_str(), &error);
+    if (error) {
+        std::cerr << "[ERROR] Source " << source.name << ": " << error->message << std::endl;
+        g_error_free(error);
+        if (pipeline) {
+            gst_object_unref(pipeline);
+        }
+        return nullptr;
+    }
+    return pipeline;
+}
+
 /**
  * @brief create videoInput to appSink stream Gstreamer pipeline 
  * 
  * @param[out] pipeline Gsteamer inputpipe line 
  * @param[in] config Configuration containing videoInput stream
+ * @return false if the source elements cannot be created
  */
-void makeSinkpipeline(GstElement* pipeline, const Config& config){
+bool makeSinkpipeline(GstElement* pipeline, const Config& config){
    
     if (!gst_is_initialized()) {
         std::cerr << "GStreamer 초기화 실패" << std::endl;
     }
     
     std::cout << "GStreamer 초기화 성공" << std::endl;
+
+    // 녹화 파일 재생: 카메라 대신 파일 → queue1 (appsink 이후는 동일)
+    if (!config.replay_file.empty()) {
+        if (!makeReplaySource(pipeline, config)) {
+            std::cerr << "[ERROR] Failed to build the replay source for " << config.replay_file << std::endl;
+            return false;
+        }
+        return true;
+    }
     
     // 엘리먼트 생성
     GstElement *source = gst_element_factory_make("v4l2src", "source");
@@ -116,7 +238,7 @@ void makeSinkpipeline(GstElement* pipeline, const Config& config){
         if (!videoconvert1) std::cerr << "  - videoconvert1 실패" << std::endl;
         if (!scaler) std::cerr << "  - scaler 실패" << std::endl;
         if (!queue1) std::cerr << "  - queue1 실패" << std::endl;
-        gst_object_unref(pipeline); 
+        return false;
     }
 
     // 파이프라인에 추가
@@ -142,106 +264,630 @@ void makeSinkpipeline(GstElement* pipeline, const Config& config){
         std::cerr << "scaler → queue1 링크 실패" << std::endl;
     }
     gst_caps_unref(caps1);
+    return true;
 }
 
 /**
- * @brief create appSrc to VideoOut stream Gstreamer pipeline 
- * 
- * @param[out] pipeline Gsteamer output pipeline 
- * @param[in] config Configuration containing videoOut stream
+ * @brief Sets the output caps, time format and latency on the appsrc
  */
-GstElement* makeSrcPipeline(GstElement* pipeline, const Config& config) {
-    // 엘리먼트 생성
-    GstElement *appsrc = gst_element_factory_make("appsrc", "app_src");
-    GstElement *videoconvert = gst_element_factory_make("videoconvert", "convert_src");
-    GstElement *tee = gst_element_factory_make("tee", "tee");
-    
-    // 화면 출력 브랜치
-    GstElement *queue1 = gst_element_factory_make("queue", "queue_display");
-    GstElement *sink = gst_element_factory_make("autovideosink", "video_sink");
-    
-    // 파일 저장 브랜치
-    GstElement *queue2 = gst_element_factory_make("queue", "queue_file");
-    GstElement *convert2 = gst_element_factory_make("videoconvert", "convert_encoder");  // ← 추가!
-    GstElement *encoder = gst_element_factory_make("x264enc", "encoder");
-    GstElement *muxer = gst_element_factory_make("mp4mux", "muxer");
-    GstElement *filesink = gst_element_factory_make("filesink", "file_sink");
-    
-    // NULL 체크
-    if (!appsrc || !videoconvert || !tee || !queue1 || !sink || 
-        !queue2 || !convert2 || !encoder || !muxer || !filesink) { 
-            std::cerr << "Src 파이프라인 엘리먼트 생성 실패!" << std::endl;
-            return nullptr;
-        }
-    
-    // 파이프라인에 추가
-    gst_bin_add_many(GST_BIN(pipeline), 
-                     appsrc, videoconvert, tee,
-                     queue1, sink,
-                     queue2, convert2, encoder, muxer, filesink,
-                     NULL);
-    
-    // appsrc 설정
+static void configureAppsrc(GstElement *appsrc, const Config &config) {
     std::string caps_str = "video/x-raw,format=RGB,width=" + 
                           std::to_string(config.video_outWidth) + 
                           ",height=" + std::to_string(config.video_outHeight) +
                           ",framerate=" + std::to_string(config.frame_rate) + "/1";
     
     GstCaps *caps = gst_caps_from_string(caps_str.c_str());
+    // 버퍼 PTS는 카메라 캡처 시각이므로, 싱크가 제때 렌더링하도록 처리 지연을 latency로 알린다
     g_object_set(appsrc,
                  "caps", caps,
                  "format", GST_FORMAT_TIME,
                  "is-live", TRUE,
+                 "min-latency", static_cast<gint64>(config.output_latency_ms * GST_MSECOND),
                  NULL);
     gst_caps_unref(caps);
-    
-    // filesink 설정
-    g_object_set(filesink, 
-                 "location", config.output_name.c_str(),
-                 NULL);
-    
-    // encoder 설정 - tune을 int flags 값으로 설정
-    g_object_set(encoder,
-                 "speed-preset", config.encode_speed,
-                 "tune", config.tune,  // int flags 값
-                 NULL);
-    
-    // 메인 라인 링크
-    if (!gst_element_link_many(appsrc, videoconvert, tee, NULL)) {
+    // 오프라인: 인코더가 밀리면 push가 기다린다 (큐가 무한히 쌓이거나 버려지지 않음)
+    if (is_unthrottled_replay(config)) {
+        g_object_set(appsrc, "block", TRUE, "max-buffers", static_cast<guint64>(4), NULL);
+    }
+}
+
+/**
+ * @brief Output branches that are actually built
+ *
+ * Display branches are left out while replaying headless (replay.display: false) and
+ * file branches when video writing is off (--no-video / offline.write_video: false).
+ */
+std::vector<OutputSink> active_outputs(const Config& config) {
+    const bool headless = !config.replay_file.empty() && !config.replay_display;
+    std::vector<OutputSink> outputs;
+    for (const OutputSink &sink : config.outputs) {
+        if ((sink.type == "display" && headless) || (sink.type == "file" && !config.write_video)) {
+            continue;
+        }
+        outputs.push_back(sink);
+    }
+    return outputs;
+}
+
+/**
+ * @brief gst-launch description of one output branch (queue → optional rate/scale → sink)
+ *
+ * Frames are dropped before they are scaled, and only the file branch converts and
+ * encodes. The first file branch's x264enc is named "encoder" (encoder-out latency probe).
+ *
+ * @param[in] sink Branch settings
+ * @param[in] index Position in the outputs list (keeps element names unique)
+ * @param[in] config Configuration (output size, encoder settings, default file name)
+ * @return Description, or an empty string for an unknown sink type
+ */
+std::string output_branch_description(const OutputSink& sink, size_t index, const Config& config) {
+    std::string convert;
+    if (sink.fps > 0 || sink.width > 0 || sink.height > 0) {
+        std::string caps = "video/x-raw";
+        if (sink.width > 0 && sink.height > 0) {
+            caps += ",width=" + std::to_string(sink.width) + ",height=" + std::to_string(sink.height);
+        }
+        if (sink.fps > 0) {
+            convert += "videorate drop-only=true ! ";
+            caps += ",framerate=" + std::to_string(sink.fps) + "/1";
+        }
+        if (sink.width > 0 && sink.height > 0) {
+            convert += "videoscale ! ";
+        }
+        convert += caps + " ! ";
+    }
+
+    if (sink.type == "display") {
+        return "queue ! " + convert + "videoconvert ! autovideosink";
+    }
+    if (sink.type == "file") {
+        const std::string &location = sink.location.empty() ? config.output_name : sink.location;
+        const std::string name = index == 0 ? "encoder" : "encoder_" + std::to_string(index);
+        return "queue ! " + convert + "videoconvert ! x264enc name=" + name +
+               " speed-preset=" + std::to_string(config.encode_speed) + " tune=" + std::to_string(config.tune) +
+               " ! mp4mux ! filesink location=\"" + location + "\"";
+    }
+    if (sink.type == "shm") {
+        // 느린 구독자가 파이프라인을 막지 않도록 오래된 프레임부터 버린다
+        return "queue leaky=downstream max-size-buffers=2 ! " + convert +
+               "shmsink socket-path=\"" + sink.location + "\" wait-for-connection=false sync=false";
+    }
+    if (sink.type == "fake") {
+        return "queue ! " + convert + "fakesink sync=false";
+    }
+    std::cerr << "[ERROR] Unknown output type: " << sink.type << " (expected display, file, shm or fake)" << std::endl;
+    return std::string();
+}
+
+/**
+ * @brief create appSrc to VideoOut stream Gstreamer pipeline 
+ *
+ * appsrc → tee → one branch per active output (see output_branch_description()).
+ * Branches that are not configured are not built at all.
+ * 
+ * @param[out] pipeline Gsteamer output pipeline 
+ * @param[in] config Configuration containing videoOut stream and the outputs list
+ * @return appsrc, or nullptr if an element cannot be created or linked
+ */
+GstElement* makeSrcPipeline(GstElement* pipeline, const Config& config) {
+    GstElement *appsrc = gst_element_factory_make("appsrc", "app_src");
+    GstElement *tee = gst_element_factory_make("tee", "tee");
+    if (!appsrc || !tee) {
+        std::cerr << "Src 파이프라인 엘리먼트 생성 실패!" << std::endl;
+        return nullptr;
+    }
+    gst_bin_add_many(GST_BIN(pipeline), appsrc, tee, NULL);
+    configureAppsrc(appsrc, config);
+    if (!gst_element_link(appsrc, tee)) {
         std::cerr << "메인 파이프라인 링크 실패" << std::endl;
         return nullptr;
     }
-    
-    // 화면 출력 브랜치 링크
-    if (!gst_element_link_many(queue1, sink, NULL)) {
-        std::cerr << "화면 출력 브랜치 링크 실패" << std::endl;
+
+    const std::vector<OutputSink> outputs = active_outputs(config);
+    for (size_t i = 0; i < outputs.size(); i++) {
+        const std::string desc = output_branch_description(outputs[i], i, config);
+        if (desc.empty()) {
+            return nullptr;
+        }
+        GError *error = nullptr;
+        GstElement *branch = gst_parse_bin_from_description(desc.c_str(), TRUE, &error);
+        if (!branch) {
+            std::cerr << "[ERROR] Output branch " << outputs[i].type << ": " << (error ? error->message : desc) << std::endl;
+            if (error) {
+                g_error_free(error);
+            }
+            return nullptr;
+        }
+        gst_bin_add(GST_BIN(pipeline), branch);
+
+        // tee 패드 연결
+        GstPad *tee_src = gst_element_request_pad_simple(tee, "src_%u");
+        GstPad *branch_sink = gst_element_get_static_pad(branch, "sink");
+        const bool linked = gst_pad_link(tee_src, branch_sink) == GST_PAD_LINK_OK;
+        gst_object_unref(tee_src);
+        gst_object_unref(branch_sink);
+        if (!linked) {
+            std::cerr << outputs[i].type << " 브랜치 링크 실패" << std::endl;
+            return nullptr;
+        }
+        std::cout << "출력: " << desc << std::endl;
+    }
+    return appsrc;
+}
+
+
+/**
+ * @brief Builds the single-pipeline variant: camera → hailodepth → configured outputs
+ *
+ * Replaces the appsink/appsrc pipeline pair. Preprocessing, inference and
+ * composition run inside the hailodepth element, so buffers, timestamps and
+ * latency flow through GStreamer end to end.
+ *
+ * @param[in] config Configuration (camera, model, inference and encoder settings)
+ * @return Pipeline in NULL state, or nullptr if parsing failed (hailodepth must be registered)
+ */
+GstElement* makeElementPipeline(const Config& config) {
+    std::string description =
+        "v4l2src device=" + config.device + " ! videoconvert ! videoscale ! "
+        "video/x-raw,format=RGB,width=" + std::to_string(config.video_inWidth) +
+        ",height=" + std::to_string(config.video_inHeight) + " ! queue max-size-buffers=2 ! "
+        "hailodepth name=depth hef-path=" + config.hef_path +
+        " backend=" + config.backend +
+        " preprocess=" + config.preprocess +
+        " batch-size=" + std::to_string(std::max(config.batch_size, 1)) +
+        " frames-in-flight=" + std::to_string(std::max(config.frames_in_flight, 1)) +
+        " model-width=" + std::to_string(config.model_width) +
+        " model-height=" + std::to_string(config.model_height) +
+        " latency-hint-ms=" + std::to_string(config.cpu_latency_ms) + " ! ";
+    const std::vector<OutputSink> outputs = active_outputs(config);
+    if (outputs.empty()) {
+        description += "fakesink sync=false";  // 출력 없음: 깊이 계산만 (metrics)
+    } else {
+        description += "tee name=t";
+        for (size_t i = 0; i < outputs.size(); i++) {
+            const std::string branch = output_branch_description(outputs[i], i, config);
+            if (branch.empty()) {
+                return nullptr;
+            }
+            description += " t. ! " + branch;
+        }
+    }
+
+    std::cout << "파이프라인: " << description << std::endl;
+    GError *error = NULL;
+    GstElement *pipeline = gst_parse_launch(description.c_str(), &error);
+    if (error) {
+        std::cerr << "[ERROR] Failed to build element pipeline: " << error->message << std::endl;
+        g_error_free(error);
+        if (pipeline) {
+            gst_object_unref(pipeline);
+        }
         return nullptr;
     }
-    
-    // 파일 저장 브랜치 링크
-    if (!gst_element_link_many(queue2, convert2, encoder, muxer, filesink, NULL)) {  // ← convert2 추가
-        std::cerr << "파일 저장 브랜치 링크 실패" << std::endl;
+    return pipeline;
+}
+
+
+/**
+ * @brief Creates the pool that appsrc output buffers are taken from
+ *
+ * Buffers have the appsrc caps size (video_outWidth x video_outHeight RGB). Once the
+ * pipeline reaches steady state, buffers released by the sinks are recycled, so
+ * composing a frame allocates nothing.
+ *
+ * @param[in] config Configuration containing output video dimensions
+ * @return Active pool, or nullptr if the output size does not fit the side-by-side layout
+ */
+GstBufferPool* makeOutputPool(const Config& config) {
+    if (config.video_outWidth != 2 * config.video_inWidth || config.video_outHeight != config.video_inHeight) {
+        std::cerr << "[ERROR] video.output must be " << 2 * config.video_inWidth << "x" << config.video_inHeight
+                  << " (camera and depth side by side)" << std::endl;
         return nullptr;
     }
-        
-    // tee 패드 연결
-    GstPad *tee_src1 = gst_element_request_pad_simple(tee, "src_%u");
-    GstPad *queue1_sink = gst_element_get_static_pad(queue1, "sink");
-    gst_pad_link(tee_src1, queue1_sink);
-    
-    GstPad *tee_src2 = gst_element_request_pad_simple(tee, "src_%u");
-    GstPad *queue2_sink = gst_element_get_static_pad(queue2, "sink");
-    gst_pad_link(tee_src2, queue2_sink);
-    
-    // 패드 언레프
-    gst_object_unref(tee_src1);
-    gst_object_unref(queue1_sink);
-    gst_object_unref(tee_src2);
-    gst_object_unref(queue2_sink);
-    
-    return appsrc;
+
+    std::string caps_str = "video/x-raw,format=RGB,width=" + 
+                          std::to_string(config.video_outWidth) + 
+                          ",height=" + std::to_string(config.video_outHeight) +
+                          ",framerate=" + std::to_string(config.frame_rate) + "/1";
+    GstCaps *caps = gst_caps_from_string(caps_str.c_str());
+    guint size = static_cast<guint>(config.video_outWidth * config.video_outHeight * 3);
+
+    // min 4: 화면/인코더 브랜치가 잡고 있는 버퍼 + 작성 중인 버퍼, max 0: 부족하면 늘어난 뒤 재사용
+    GstBufferPool *pool = gst_buffer_pool_new();
+    GstStructure *pool_config = gst_buffer_pool_get_config(pool);
+    gst_buffer_pool_config_set_params(pool_config, caps, size, 4, 0);
+    gst_caps_unref(caps);
+
+    if (!gst_buffer_pool_set_config(pool, pool_config) || !gst_buffer_pool_set_active(pool, TRUE)) {
+        std::cerr << "[ERROR] Failed to activate output buffer pool" << std::endl;
+        gst_object_unref(pool);
+        return nullptr;
+    }
+    return pool;
+}
+
+/**
+ * @brief Writes the side-by-side output frame in place
+ *
+ * Steps: camera rows → left half, fused int8 → normalize → colormap (RGB order) →
+ * resize straight into the right half. composite is a Mat header over the mapped
+ * output buffer, so there is no intermediate composite and no hconcat.
+ *
+ * @param[in] raw_img Camera frame (video_inWidth x video_inHeight, CV_8UC3)
+ * @param[in] raw_depth int8 depth map returned by inference (CV_8SC1)
+ * @param[in] config Configuration containing video dimensions
+ * @param[in] colorizer Fused normalize + colormap kernel
+ * @param[out] composite Output frame (video_inHeight x 2*video_inWidth, CV_8UC3)
+ */
+void postprocess(const cv::Mat &raw_img, const cv::Mat &raw_depth, const Config *config,
+                 const DepthColorizer *colorizer, cv::Mat &composite) {
+    const int width = config->video_inWidth;
+    const int height = config->video_inHeight;
+    cv::Mat left = composite(cv::Rect(0, 0, width, height));
+    cv::Mat right = composite(cv::Rect(width, 0, width, height));
+
+    if (MONITORING) std::cout << ">>> [POST-1] Copying camera frame into left half..." << std::endl;
+    raw_img.copyTo(left);
+    if (MONITORING) std::cout << "    ✓ copy done: " << left.size() << std::endl;
+
+    // 모델 해상도 컬러맵은 스레드마다 한 번만 할당해 재사용
+    if (MONITORING) std::cout << ">>> [POST-2] Starting colorize (" << depth_kernel_path() << ")..." << std::endl;
+    static thread_local cv::Mat depth_colormap;
+    colorizer->colorize(raw_depth, depth_colormap);
+    if (MONITORING) std::cout << "    ✓ colorize done: " << depth_colormap.size() << std::endl;
+
+    if (MONITORING) {
+        std::cout << ">>> [POST-3] Starting resize into right half " 
+                  << width << "x" << height << "..." << std::endl;
+    }
+    cv::resize(depth_colormap, right, right.size(), 0, 0, cv::INTER_LINEAR);
+    if (MONITORING) std::cout << "    ✓ resize done: " << right.size() << std::endl;
+}
+
+/**
+ * @brief Takes a buffer from the output pool and composes the frame into it
+ *
+ * @param[in] cb_data Callback data (output pool, config, colorizer)
+ * @param[in] raw_img Camera frame
+ * @param[in] raw_depth int8 depth map (CV_8SC1)
+ * @param[out] out_buffer Composed buffer; the caller pushes it or unrefs it (nullptr without outputs)
+ * @return GST_FLOW_OK, the pool's acquire result, or GST_FLOW_ERROR if the buffer cannot be mapped
+ */
+GstFlowReturn compose_output(CallbackData *cb_data, const cv::Mat &raw_img, const cv::Mat &raw_depth,
+                             GstBuffer **out_buffer) {
+    const Config* config = cb_data->config;
+
+    // 출력 브랜치가 없으면 합성도 하지 않는다 (깊이 계산만)
+    if (!cb_data->appsrc) {
+        *out_buffer = nullptr;
+        return GST_FLOW_OK;
+    }
+
+    if (MONITORING) std::cout << ">>> [GST-1] Acquiring buffer from output pool..." << std::endl;
+    GstBuffer *buffer = nullptr;
+    GstFlowReturn ret = gst_buffer_pool_acquire_buffer(cb_data->output_pool, &buffer, NULL);
+    if (ret != GST_FLOW_OK) {
+        std::cerr << "    ✗ gst_buffer_pool_acquire_buffer FAILED: " << gst_flow_get_name(ret) << std::endl;
+        return ret;
+    }
+
+    if (MONITORING) std::cout << ">>> [GST-2] Mapping GstBuffer..." << std::endl;
+    GstMapInfo out_map;
+    if (!gst_buffer_map(buffer, &out_map, GST_MAP_WRITE)) {
+        std::cerr << "    ✗ gst_buffer_map FAILED!" << std::endl;
+        gst_buffer_unref(buffer);
+        return GST_FLOW_ERROR;
+    }
+    if (MONITORING) std::cout << "    ✓ GstBuffer mapped, out_map.data: " << (void*)out_map.data << std::endl;
+
+    cv::Mat composite(config->video_outHeight, config->video_outWidth, CV_8UC3, out_map.data);
+    postprocess(raw_img, raw_depth, config, cb_data->colorizer, composite);
+
+    gst_buffer_unmap(buffer, &out_map);
+    *out_buffer = buffer;
+    return GST_FLOW_OK;
+}
+
+/**
+ * @brief Time elapsed on the pipeline clock since a capture time (GST_CLOCK_TIME_NONE if unknown)
+ */
+static GstClockTime since_capture(CallbackData *cb_data, GstClockTime capture_time) {
+    if (!cb_data->clock || !GST_CLOCK_TIME_IS_VALID(capture_time)) {
+        return GST_CLOCK_TIME_NONE;
+    }
+    const GstClockTime now = gst_clock_get_time(cb_data->clock);
+    return now >= capture_time ? now - capture_time : 0;
+}
+
+/**
+ * @brief Maps a camera buffer for reading
+ *
+ * A buffer that cannot be mapped is dropped: the caller releases its sample and
+ * carries on with the next one. It is counted in map_failures and, because it
+ * never reaches stamp_capture(), in the appsink drop count as well.
+ *
+ * @param[in] cb_data Callback data (metrics)
+ * @param[in] buffer Camera buffer (may be nullptr)
+ * @param[out] map Mapping to release with gst_buffer_unmap()
+ * @return false if the frame has to be dropped
+ */
+bool map_camera_buffer(CallbackData *cb_data, GstBuffer *buffer, GstMapInfo &map) {
+    if (buffer && gst_buffer_map(buffer, &map, GST_MAP_READ)) {
+        return true;
+    }
+    std::cerr << "[ERROR] Failed to map camera buffer, frame dropped" << std::endl;
+    if (cb_data->metrics) {
+        cb_data->metrics->map_failures.fetch_add(1, std::memory_order_relaxed);
+    }
+    return false;
+}
+
+/**
+ * @brief Records when the camera captured the frame (appsink buffer base_time + PTS)
+ *
+ * v4l2src stamps buffers with the capture time, so the wait in queue1 and in the
+ * appsink is included in every capture→X latency. Without a PTS (or when replaying
+ * a file unthrottled) the pull time is used.
+ *
+ * The frame ID comes from the pipeline's own counter (cb_data->next_frame_id), so it
+ * is unique and increasing whatever the source writes into GST_BUFFER_OFFSET.
+ *
+ * @param[in,out] cb_data Callback data (clock, config, frame counter)
+ * @param[in] appsink appsink the buffer was pulled from (its base_time maps PTS to clock time)
+ * @param[in] buffer Camera buffer
+ * @param[out] timing Frame timing to fill
+ */
+void stamp_capture(CallbackData *cb_data, GstElement *appsink, GstBuffer *buffer, FrameTiming &timing) {
+    const GstClockTime pts = GST_BUFFER_PTS(buffer);
+    // 제한 없는 재생은 PTS가 실제 시간보다 앞서 가므로 꺼낸 시각을 캡처 시각으로 쓴다
+    timing.pts = pts;
+    if (GST_CLOCK_TIME_IS_VALID(pts) && !is_unthrottled_replay(*cb_data->config)) {
+        timing.capture_time = gst_element_get_base_time(appsink) + pts;
+    } else {
+        timing.capture_time = cb_data->clock ? gst_clock_get_time(cb_data->clock) : GST_CLOCK_TIME_NONE;
+    }
+    timing.duration = GST_BUFFER_DURATION(buffer);
+    if (!GST_CLOCK_TIME_IS_VALID(timing.duration) && cb_data->config->frame_rate > 0) {
+        timing.duration = gst_util_uint64_scale_int(GST_SECOND, 1, cb_data->config->frame_rate);
+    }
+    timing.capture_to_infer = GST_CLOCK_TIME_NONE;
+    timing.capture_to_push = GST_CLOCK_TIME_NONE;
+
+    // GST_BUFFER_OFFSET은 순번이 아닐 수 있다 (바이트 offset, NONE, seek 후 반복): 파이프라인 자체 순번
+    timing.frame_id = cb_data->next_frame_id++;
+    if (cb_data->metrics) {
+        cb_data->metrics->frames_in.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Records capture → NPU submit for the frame
+ */
+void mark_infer_start(CallbackData *cb_data, FrameTiming &timing) {
+    timing.capture_to_infer = since_capture(cb_data, timing.capture_time);
+}
+
+/**
+ * @brief Stamps the capture time on a composed output buffer and pushes it to appsrc (appsrc takes ownership)
+ *
+ * Both pipelines run on the same clock, so the capture clock time minus the output
+ * pipeline's base_time is the frame's running time there. Sinks then render each
+ * frame at capture + output latency, and x264enc/mp4mux get real timestamps.
+ *
+ * @param[in] cb_data Callback data (appsrc, clock)
+ * @param[in,out] timing Frame timing (capture_time read, capture_to_push written)
+ * @param[in] buffer Buffer returned by compose_output() (nullptr without outputs: only counted)
+ * @return GstFlowReturn of the push
+ */
+GstFlowReturn push_frame(CallbackData *cb_data, FrameTiming &timing, GstBuffer *buffer) {
+    if (!buffer) {
+        timing.capture_to_push = since_capture(cb_data, timing.capture_time);
+        if (cb_data->metrics) {
+            cb_data->metrics->frames_out.fetch_add(1, std::memory_order_relaxed);
+        }
+        return GST_FLOW_OK;
+    }
+    if (is_unthrottled_replay(*cb_data->config) && GST_CLOCK_TIME_IS_VALID(timing.pts)) {
+        GST_BUFFER_PTS(buffer) = timing.pts;  // 오프라인: 출력 영상이 원본 파일의 타이밍을 따른다
+    } else if (GST_CLOCK_TIME_IS_VALID(timing.capture_time)) {
+        const GstClockTime base_time = gst_element_get_base_time(cb_data->appsrc);
+        GST_BUFFER_PTS(buffer) = timing.capture_time > base_time ? timing.capture_time - base_time : 0;
+    }
+    GST_BUFFER_DTS(buffer) = GST_CLOCK_TIME_NONE;
+    GST_BUFFER_DURATION(buffer) = timing.duration;
+    GST_BUFFER_OFFSET(buffer) = timing.frame_id;  // 출력 쪽 pad probe도 같은 프레임 ID를 본다
+    timing.capture_to_push = since_capture(cb_data, timing.capture_time);
+
+    if (MONITORING) std::cout << ">>> [GST-3] Pushing to appsrc..." << std::endl;
+    GstFlowReturn ret;
+    {
+        TimelineScope span(TimelineSpan::Push, timing.frame_id);
+        ret = gst_app_src_push_buffer(GST_APP_SRC(cb_data->appsrc), buffer);
+    }
+    if (MONITORING) std::cout << "    ✓ Push complete, return: " << ret << std::endl;
+    if (cb_data->metrics) {
+        (ret == GST_FLOW_OK ? cb_data->metrics->frames_out : cb_data->metrics->push_failures)
+            .fetch_add(1, std::memory_order_relaxed);
+    }
+    return ret;
+}
+
+/**
+ * @brief True when a recorded file is replayed as fast as possible (no pacing, no drops)
+ */
+bool is_unthrottled_replay(const Config &config) {
+    return !config.replay_file.empty() && config.replay_rate <= 0;
+}
+
+/**
+ * @brief Hands the frame's int8 depth map (model_width x model_height) to the raw file and the shm ring
+ *
+ * Called in frame order from the single thread that postprocesses frames.
+ */
+void write_depth(CallbackData *cb_data, const FrameTiming &timing, const cv::Mat &raw_depth) {
+    if (cb_data->depth_ring && raw_depth.isContinuous()) {
+        // 캡처 시각은 시스템 clock(CLOCK_MONOTONIC) 기준이라 다른 프로세스에서도 비교 가능
+        cb_data->depth_ring->publish(raw_depth.data, timing.frame_id,
+                                     GST_CLOCK_TIME_IS_VALID(timing.capture_time) ? timing.capture_time : 0);
+    }
+    if (cb_data->depth_out) {
+        for (int y = 0; y < raw_depth.rows; y++) {
+            cb_data->depth_out->write(raw_depth.ptr<const char>(y), raw_depth.cols);
+        }
+    }
+}
+
+/**
+ * @brief Hands the camera frame to the extra models (each keeps only its target rate)
+ */
+void offer_models(CallbackData *cb_data, const FrameTiming &timing, const cv::Mat &raw_img) {
+    if (cb_data->models) {
+        cb_data->models->offer(raw_img, timing.frame_id,
+                               GST_CLOCK_TIME_IS_VALID(timing.capture_time) ? timing.capture_time : 0);
+    }
+}
+
+/**
+ * @brief Picks the model resolution of a frame about to be submitted and returns its resizer
+ *
+ * With a model ladder the QoS controller's current rung is recorded for the job (the
+ * backend routes it by its buffers) and in the frame context; otherwise the frame
+ * uses model.input_size. Called by the single producer, once per job, before submit.
+ */
+FrameResizer* select_model(CallbackData *cb_data, FrameContext &ctx, const InferJob *job) {
+    if (!cb_data->qos || !job) {
+        ctx.rung = -1;
+        return cb_data->resizer;
+    }
+    ctx.rung = static_cast<int>(cb_data->qos->begin_frame(*job));
+    return &cb_data->qos->resizer(ctx.rung);
 }
 
+/**
+ * @brief Model input (= depth output) size of the frame
+ */
+cv::Size model_size(const CallbackData *cb_data, const FrameContext &ctx) {
+    if (ctx.rung < 0 || !cb_data->qos) {
+        return cv::Size(cb_data->config->model_width, cb_data->config->model_height);
+    }
+    const ModelRung &rung = cb_data->qos->ladder().rung(ctx.rung);
+    return cv::Size(rung.width, rung.height);
+}
+
+/**
+ * @brief Tells the QoS controller a frame came back at its rung (switch latency)
+ */
+void model_frame_done(CallbackData *cb_data, const FrameContext &ctx) {
+    if (cb_data->qos && ctx.rung >= 0) {
+        cb_data->qos->frame_done(ctx.rung);
+    }
+}
+
+/**
+ * @brief Counts a failed or unsubmittable inference job on /metrics
+ */
+void count_infer_failure(CallbackData *cb_data) {
+    if (cb_data->metrics) {
+        cb_data->metrics->infer_failures.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Adds the frame to the stage histograms and queues its timings into the trace ring
+ *
+ * No file or console I/O happens here: the TraceLog flusher thread writes the
+ * binary trace and prints the once-per-second summary.
+ */
+void log_timing(CallbackData *cb_data, const FrameTiming &timing) {
+    if (cb_data->histograms) {
+        cb_data->histograms->record(timing);
+    }
+    if (cb_data->trace) {
+        cb_data->trace->record(timing);
+    }
+}
+
+/**
+ * @brief Releases the camera sample held by a frame context
+ */
+void release_frame(FrameContext &ctx) {
+    if (ctx.sample) {
+        gst_buffer_unmap(ctx.buffer, &ctx.map);
+        gst_sample_unref(ctx.sample);
+        ctx.sample = nullptr;
+        ctx.buffer = nullptr;
+    }
+}
+
+/**
+ * @brief Postprocesses a finished frame, pushes it to appsrc and logs its timings
+ *
+ * Shared tail of the synchronous and asynchronous inference paths.
+ *
+ * @param[in] cb_data Callback data (appsrc, config, log file)
+ * @param[in] ctx Frame context holding the mapped camera frame and start timestamps
+ * @param[in] output_img Raw int8 depth map (CV_8SC1)
+ * @return GstFlowReturn of the appsrc push
+ */
+static GstFlowReturn finish_frame(CallbackData *cb_data, FrameContext &ctx, const cv::Mat &output_img) {
+    const Config* config = cb_data->config;
+    FrameTiming &timing = ctx.timing;
+    timing.t_infer_end = std::chrono::high_resolution_clock::now();
+    write_depth(cb_data, timing, output_img);
+
+    // ========== 후처리 시작 (출력 풀 버퍼에 바로 합성) ==========
+    timing.t_postprocess_start = std::chrono::high_resolution_clock::now();
+    cv::Mat raw_img(config->video_inHeight, config->video_inWidth, CV_8UC3, ctx.map.data);
+    GstBuffer *out_buffer = nullptr;
+    GstFlowReturn ret = compose_output(cb_data, raw_img, output_img, &out_buffer);
+    timing.t_postprocess_end = std::chrono::high_resolution_clock::now();
+    timeline_span(TimelineSpan::Postprocess, timing.frame_id, timing.t_postprocess_start, timing.t_postprocess_end);
+    if (ret != GST_FLOW_OK) {
+        return ret;
+    }
+    if (out_buffer) {
+        timing.bytes_copied += raw_img.total() * raw_img.elemSize();  // 카메라 → 왼쪽 절반
+    }
+
+    // ===== appsrc로 push (캡처 PTS 전달) =====
+    ret = push_frame(cb_data, timing, out_buffer);
+    timing.t_end = std::chrono::high_resolution_clock::now();
+
+    log_timing(cb_data, timing);
+    return ret;
+}
+
+/**
+ * @brief Completion callback of AsyncInferEngine / FrameBatcher (runs on their worker thread)
+ *
+ * Postprocesses and pushes the raw int8 output the same way the synchronous path does,
+ * then releases the camera sample. With the staged pipeline the frame is only
+ * handed to its postprocess queue.
+ *
+ * @param[in] job Finished inference job; job.user_data points at its FrameContext
+ * @param[in] cb_data Callback data shared with new_sample_callback
+ */
+void on_infer_complete(InferJob &job, CallbackData *cb_data) {
+    if (cb_data->staged) {
+        cb_data->staged->on_infer_complete(job);
+        return;
+    }
+
+    const Config* config = cb_data->config;
+    FrameContext &ctx = *static_cast<FrameContext*>(job.user_data);
+
+    if (job.status != HAILO_SUCCESS) {
+        std::cerr << "[ERROR] Async inference failed with status: " << job.status << std::endl;
+        count_infer_failure(cb_data);
+        release_frame(ctx);
+        return;
+    }
+
+    model_frame_done(cb_data, ctx);
+    cv::Mat depth_map(model_size(cb_data, ctx), CV_8SC1, job.output);
+    finish_frame(cb_data, ctx, depth_map);
+    release_frame(ctx);
+}
 
 /**
  * @brief GStreamer callback function for processing video frames through NPU inference pipeline
@@ -252,19 +898,31 @@ GstElement* makeSrcPipeline(GstElement* pipeline, const Config& config) {
  * 
  * Processing steps:
  * 1. Pull frame from appsink
- * 2. Preprocessing: Gaussian blur and resize to model input dimensions
+ * 2. Preprocessing: anti-aliased resize to model input dimensions (FrameResizer, read-only source)
  * 3. NPU inference: Depth estimation using Hailo-8
- * 4. Postprocessing: Normalize, apply colormap, resize back, concatenate with original frame
- * 5. Push processed frame to appsrc
- * 6. Log timing metrics (preprocessing, inference, postprocessing, total)
+ * 4. Postprocessing: camera frame and colourized depth composed side by side in an output pool buffer
+ * 5. Push the pool buffer to appsrc
+ * 6. Queue timing metrics (preprocessing, inference, postprocessing, total) into the trace ring
+ * 
+ * When an InferQueue is configured (AsyncInferEngine for frames_in_flight > 1, or
+ * FrameBatcher for batch_size > 1), steps 3-6 are deferred to on_infer_complete() on
+ * the queue's worker thread and this callback returns as soon as the frame is queued,
+ * so the next frame can be preprocessed while the NPU works.
  * 
  * @param[in] sink GStreamer appsink element providing input frames
  * @param[in] user_data Pointer to CallbackData struct containing:
- *                      - infer_pipeline: NPU inference VStreams
+ *                      - infer_session: NPU inference session (synchronous path)
+ *                      - infer_engine: async engine or batcher (nullptr for synchronous path)
+ *                      - frame_contexts: one FrameContext per in-flight slot
  *                      - appsrc: GStreamer appsrc element for output
+ *                      - output_pool: buffer pool the output frame is composed into
  *                      - config: Pipeline configuration (dimensions, paths, etc.)
- *                      - log_file: Output stream for performance logging
- *                      - header_written: Flag for CSV header initialization
+ *                      - resizer: camera → model input preprocessing kernel
+ *                      - colorizer: fused depth colormap kernel
+ *                      - trace: per-frame timing trace
+ *                      - histograms: per-stage µs histograms
+ *                      - models: extra models offered the camera frame
+ *                      - qos: model ladder rung picked for the frame
  * 
  * @return GstFlowReturn status code
  *         - GST_FLOW_OK: Frame processed and pushed successfully
@@ -275,191 +933,101 @@ GstFlowReturn new_sample_callback(GstElement *sink, gpointer user_data) {
     
     // user_data에서 필요한 데이터 꺼내기
     CallbackData* cb_data = static_cast<CallbackData*>(user_data);
-    InferVStreams* infer_pipeline = cb_data->infer_pipeline;
-    GstElement* appsrc = cb_data->appsrc;
+    InferSession* infer_session = cb_data->infer_session;
+    InferQueue* infer_engine = cb_data->infer_engine;
     const Config* config = cb_data->config;
-    std::ofstream* log_file = cb_data->log_file;
-    bool* header_written = cb_data->header_written;
     
     // 1. appsink에서 sample 가져오기
     GstSample *sample = gst_app_sink_pull_sample(GST_APP_SINK(sink));
     if (!sample) {
         return GST_FLOW_ERROR;
     }
-    
+
+    // 매핑할 수 없는 버퍼는 슬롯을 잡기 전에 버린다 (드롭으로 집계, 파이프라인은 계속)
     GstBuffer *buffer = gst_sample_get_buffer(sample);
     GstMapInfo map;
-    gst_buffer_map(buffer, &map, GST_MAP_READ);
+    if (!map_camera_buffer(cb_data, buffer, map)) {
+        gst_sample_unref(sample);
+        return GST_FLOW_OK;
+    }
+
+    // 비동기 모드: 빈 슬롯이 날 때까지 대기 (in-flight 프레임 수 제한)
+    InferJob* job = nullptr;
+    FrameContext local_ctx = {};
+    FrameContext* ctx = &local_ctx;
+    if (infer_engine) {
+        job = infer_engine->acquire();
+        if (!job) {
+            gst_buffer_unmap(buffer, &map);
+            gst_sample_unref(sample);
+            return GST_FLOW_FLUSHING;
+        }
+        ctx = &cb_data->frame_contexts[job->index];
+    }
+
+    ctx->timing.t_start = t_start;
+    ctx->timing.bytes_copied = 0;
+    ctx->sample = sample;
+    ctx->buffer = buffer;
+    ctx->map = map;
+    stamp_capture(cb_data, sink, ctx->buffer, ctx->timing);
     
     // ========== 전처리 시작 ==========
-    auto t_preprocess_start = std::chrono::high_resolution_clock::now();
+    ctx->timing.t_preprocess_start = std::chrono::high_resolution_clock::now();
     
-    cv::Mat raw_img(config->video_inHeight, config->video_inWidth, CV_8UC3, map.data);
-    cv::GaussianBlur(raw_img, raw_img, cv::Size(3, 3), 0);
+    // map은 GST_MAP_READ이므로 원본에는 쓰지 않음 (blur는 resize 필터에 포함)
+    const cv::Mat raw_img(config->video_inHeight, config->video_inWidth, CV_8UC3, ctx->map.data);
+    offer_models(cb_data, ctx->timing, raw_img);
+    // 추론 계층이 소유한 페이지 정렬 입력 버퍼에 바로 resize (중간 Mat / memcpy 없음)
+    // (해상도 사다리가 있으면 QoS가 고른 해상도로)
+    FrameResizer *resizer = select_model(cb_data, *ctx, job);
     cv::Mat input_img;
-    cv::resize(raw_img, input_img, 
-               cv::Size(config->model_width, config->model_height), 
-               0, 0, cv::INTER_LINEAR);
+    if (job) {
+        input_img = cv::Mat(model_size(cb_data, *ctx), CV_8UC3, job->input);
+    } else {
+        input_img = infer_session->input_mat();
+    }
+    resizer->resize(raw_img, input_img);
     
-    auto t_preprocess_end = std::chrono::high_resolution_clock::now();
+    ctx->timing.t_preprocess_end = std::chrono::high_resolution_clock::now();
+    timeline_span(TimelineSpan::Preprocess, ctx->timing.frame_id, ctx->timing.t_preprocess_start,
+                  ctx->timing.t_preprocess_end);
     
     // ========== 추론 시작 ==========
-    auto t_infer_start = std::chrono::high_resolution_clock::now();    
+    ctx->timing.t_infer_start = std::chrono::high_resolution_clock::now();    
+    mark_infer_start(cb_data, ctx->timing);
+
+    if (job) {
+        job->user_data = ctx;
+        job->trace_id = ctx->timing.frame_id;
+        if (infer_engine->submit(job) != HAILO_SUCCESS) {
+            count_infer_failure(cb_data);
+            release_frame(*ctx);
+            return GST_FLOW_ERROR;
+        }
+        return GST_FLOW_OK;
+    }
 
     if (MONITORING) std::cout << ">>> BEFORE infer() call" << std::endl;
     cv::Mat output_img;
-    output_img = infer(*infer_pipeline, input_img, *config);
+    {
+        TimelineScope span(TimelineSpan::Infer, ctx->timing.frame_id);
+        output_img = infer_session->infer(input_img);
+    }
+    ctx->timing.bytes_copied += infer_session->bytes_copied();
     if (MONITORING) std::cout << ">>> AFTER infer() call" << std::endl;
 
     // 반환값 검증
     if (output_img.empty()) {
         std::cerr << "❌ infer() returned empty Mat!" << std::endl;
-        gst_buffer_unmap(buffer, &map);
-        gst_sample_unref(sample);
+        count_infer_failure(cb_data);
+        release_frame(*ctx);
         return GST_FLOW_ERROR;
     }
     if (MONITORING) std::cout << "✅ infer() returned valid Mat: " << output_img.size() << std::endl;
 
-    auto t_infer_end = std::chrono::high_resolution_clock::now();
+    GstFlowReturn ret = finish_frame(cb_data, *ctx, output_img);
+    release_frame(*ctx);
     
-    // ========== 후처리 시작 ==========
-    auto t_postprocess_start = std::chrono::high_resolution_clock::now();
-
-    if (MONITORING) std::cout << ">>> [POST-1] Starting normalize..." << std::endl;
-    cv::Mat depth_normalized;
-    cv::normalize(output_img, depth_normalized, 0, 255, cv::NORM_MINMAX);
-    if (MONITORING) std::cout << "    ✓ normalize done: " << depth_normalized.size() << std::endl;
-
-    if (MONITORING) std::cout << ">>> [POST-2] Starting applyColorMap..." << std::endl;
-    cv::Mat depth_colormap;
-    cv::applyColorMap(depth_normalized, depth_colormap, cv::COLORMAP_MAGMA);
-    if (MONITORING) std::cout << "    ✓ colormap done: " << depth_colormap.size() << std::endl;
-
-    if (MONITORING) std::cout << ">>> [POST-3] Starting cvtColor..." << std::endl;
-    cv::cvtColor(depth_colormap, depth_colormap, cv::COLOR_RGB2BGR);
-    if (MONITORING) std::cout << "    ✓ cvtColor done" << std::endl;
-
-    if (MONITORING) {
-        std::cout << ">>> [POST-4] Starting resize to " 
-                  << config->video_inWidth << "x" << config->video_inHeight << "..." << std::endl;
-    }
-    cv::Mat depth_resized;
-    cv::resize(depth_colormap, depth_resized, 
-               cv::Size(config->video_inWidth, config->video_inHeight), 
-               0, 0, cv::INTER_LINEAR);
-    if (MONITORING) std::cout << "    ✓ resize done: " << depth_resized.size() << std::endl;
-
-    if (MONITORING) std::cout << ">>> [POST-5] Starting convertTo..." << std::endl;
-    depth_resized.convertTo(depth_resized, CV_8UC3);
-    if (MONITORING) std::cout << "    ✓ convertTo done" << std::endl;
-
-    if (MONITORING) {
-        // hconcat 전에 이것들 확인:
-        std::cout << ">>> Checking raw_img..." << std::endl;
-        std::cout << "    - empty: " << raw_img.empty() << std::endl;
-        std::cout << "    - isContinuous: " << raw_img.isContinuous() << std::endl;
-        std::cout << "    - data ptr: " << (void*)raw_img.data << std::endl;
-        std::cout << "    - type: " << raw_img.type() << " (CV_8UC3=" << CV_8UC3 << ")" << std::endl;
-
-        std::cout << ">>> Checking depth_resized..." << std::endl;
-        std::cout << "    - empty: " << depth_resized.empty() << std::endl;
-        std::cout << "    - isContinuous: " << depth_resized.isContinuous() << std::endl;
-        std::cout << "    - data ptr: " << (void*)depth_resized.data << std::endl;
-        std::cout << "    - type: " << depth_resized.type() << " (CV_8UC3=" << CV_8UC3 << ")" << std::endl;
-
-        // 메모리 접근 테스트
-        try {
-            uchar test1 = raw_img.at<cv::Vec3b>(0, 0)[0];
-            uchar test2 = depth_resized.at<cv::Vec3b>(0, 0)[0];
-            std::cout << "    ✓ Memory access OK" << std::endl;
-        } catch (...) {
-            std::cerr << "    ✗ Memory access FAILED!" << std::endl;
-        }
-    }
-
-    if (MONITORING) {
-        std::cout << ">>> [POST-6] Starting hconcat (raw_img: " 
-                  << raw_img.size() << ", depth_resized: " << depth_resized.size() << ")..." << std::endl;
-    }
-    cv::Mat result;
-    cv::hconcat(raw_img, depth_resized, result);
-    if (MONITORING) std::cout << "    ✓ hconcat done: " << result.size() << std::endl;
-    auto t_postprocess_end = std::chrono::high_resolution_clock::now();
-
-    // ===== appsrc로 push =====
-    if (MONITORING) {
-        std::cout << ">>> [GST-1] Calculating buffer size..." << std::endl;
-    }
-    gsize size = result.total() * result.elemSize();
-    if (MONITORING) {
-        std::cout << "    - Size: " << size << " bytes (" << size/1024/1024.0 << " MB)" << std::endl;
-        std::cout << "    - result.data: " << (void*)result.data << std::endl;
-        std::cout << "    - result.isContinuous: " << result.isContinuous() << std::endl;
-    }
-
-    if (MONITORING) std::cout << ">>> [GST-2] Allocating GstBuffer..." << std::endl;
-    GstBuffer *out_buffer = gst_buffer_new_allocate(NULL, size, NULL);
-    if (!out_buffer) {
-        std::cerr << "    ✗ gst_buffer_new_allocate FAILED!" << std::endl;
-        gst_buffer_unmap(buffer, &map);
-        gst_sample_unref(sample);
-        return GST_FLOW_ERROR;
-    }
-    if (MONITORING) std::cout << "    ✓ GstBuffer allocated" << std::endl;
-
-    if (MONITORING) std::cout << ">>> [GST-3] Mapping GstBuffer..." << std::endl;
-    GstMapInfo out_map;
-    if (!gst_buffer_map(out_buffer, &out_map, GST_MAP_WRITE)) {
-        std::cerr << "    ✗ gst_buffer_map FAILED!" << std::endl;
-        gst_buffer_unref(out_buffer);
-        gst_buffer_unmap(buffer, &map);
-        gst_sample_unref(sample);
-        return GST_FLOW_ERROR;
-    }
-    if (MONITORING) std::cout << "    ✓ GstBuffer mapped, out_map.data: " << (void*)out_map.data << std::endl;
-
-    if (MONITORING) std::cout << ">>> [GST-4] Copying data (memcpy " << size << " bytes)..." << std::endl;
-    memcpy(out_map.data, result.data, size);
-    if (MONITORING) std::cout << "    ✓ memcpy done" << std::endl;
-
-    if (MONITORING) std::cout << ">>> [GST-5] Unmapping buffer..." << std::endl;
-    gst_buffer_unmap(out_buffer, &out_map);
-    if (MONITORING) std::cout << "    ✓ Unmapped" << std::endl;
-
-    if (MONITORING) std::cout << ">>> [GST-6] Pushing to appsrc..." << std::endl;
-    GstFlowReturn ret = gst_app_src_push_buffer(GST_APP_SRC(appsrc), out_buffer);
-    if (MONITORING) std::cout << "    ✓ Push complete, return: " << ret << std::endl;
-    auto t_end = std::chrono::high_resolution_clock::now();
-
-    // ========== 시간 계산 및 출력 ==========
-    auto preprocess_time = std::chrono::duration_cast<std::chrono::milliseconds>(t_preprocess_end - t_preprocess_start).count();
-    auto infer_time = std::chrono::duration_cast<std::chrono::milliseconds>(t_infer_end - t_infer_start).count();
-    auto postprocess_time = std::chrono::duration_cast<std::chrono::milliseconds>(t_postprocess_end - t_postprocess_start).count();
-    auto total_time = std::chrono::duration_cast<std::chrono::milliseconds>(t_end - t_start).count();
-    
-    if (!(*header_written)) {
-        (*log_file) << "Timestamp(ms),Preprocess(ms),Infer(ms),Postprocess(ms),Total(ms)\n";
-        *header_written = true;
-    }
-    
-    auto now = std::chrono::system_clock::now();
-    auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
-        now.time_since_epoch()).count();
-    
-    (*log_file) << timestamp << ","
-                << preprocess_time << ","
-                << infer_time << ","
-                << postprocess_time << ","
-                << total_time << "\n";
-    
-    // 성능 측정 결과는 항상 출력
-    std::cout << "⏱️  전처리: " << preprocess_time << "ms | "
-              << "추론: " << infer_time << "ms | "
-              << "후처리: " << postprocess_time << "ms | "
-              << "전체: " << total_time << "ms" << std::endl;
-    
-    gst_buffer_unmap(buffer, &map);
-    gst_sample_unref(sample);
-    
-    return GST_FLOW_OK;
+    return ret == GST_FLOW_ERROR ? GST_FLOW_ERROR : GST_FLOW_OK;
 }
\ No newline at end of file
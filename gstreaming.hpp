@@ -11,29 +11,120 @@
 #include <yaml-cpp/yaml.h>
 
 #include "Hailoinfer.hpp"
+#include "InferEngine.hpp"
+#include "DepthKernels.hpp"
+#include "ResizeKernels.hpp"
+#include "LatencyTracer.hpp"
+#include "TraceLog.hpp"
+#include "Histogram.hpp"
+#include "Metrics.hpp"
+#include "Timeline.hpp"
+#include "DepthRing.hpp"
 #include "hailo/hailort.hpp"
 #include "hailo/hailort_common.hpp" 
 
+#include <chrono>
 #include <fstream>
 
 constexpr hailo_format_type_t FORMAT_TYPE = HAILO_FORMAT_TYPE_AUTO;
 using namespace hailort;
 
+/**
+ * @brief Stage timestamps of one frame, written to the timing log as one CSV row
+ */
+struct FrameTiming {
+    std::chrono::high_resolution_clock::time_point t_start;
+    std::chrono::high_resolution_clock::time_point t_preprocess_start;
+    std::chrono::high_resolution_clock::time_point t_preprocess_end;
+    std::chrono::high_resolution_clock::time_point t_infer_start;
+    std::chrono::high_resolution_clock::time_point t_infer_end;
+    std::chrono::high_resolution_clock::time_point t_postprocess_start;
+    std::chrono::high_resolution_clock::time_point t_postprocess_end;
+    std::chrono::high_resolution_clock::time_point t_end;
+    size_t bytes_copied; //host memcpy/concat bytes spent on this frame (logged as Copied(bytes))
+    uint64_t frame_id; //per-pipeline frame number (CallbackData::next_frame_id), carried to the output buffer, trace and timeline spans
+    GstClockTime capture_time; //pipeline clock time the camera captured the frame (base_time + PTS)
+    GstClockTime pts; //camera / file buffer PTS (output PTS in unthrottled replay)
+    GstClockTime duration; //camera buffer duration, carried to the output buffer
+    GstClockTime capture_to_infer; //capture → handed to the NPU (GST_CLOCK_TIME_NONE if unknown)
+    GstClockTime capture_to_push; //capture → pushed to appsrc
+};
+
+/**
+ * @brief Per-frame state kept from appsink pull until the result is pushed
+ * 
+ * Holds the mapped camera sample (needed for the side-by-side output) and the
+ * stage timestamps. The staged pipeline also keeps the frame's depth copy and
+ * composed output buffer here while the frame moves between its threads.
+ */
+struct FrameContext {
+    GstSample* sample; //camera sample, unref'd once the frame is pushed
+    GstBuffer* buffer; //buffer of sample (mapped read-only)
+    GstMapInfo map;
+    FrameTiming timing;
+    cv::Mat depth;  //staged pipeline: int8 depth copied out of the engine slot
+    GstBuffer* output; //staged pipeline: composed output pool buffer waiting for appsrc
+    int rung; //model ladder rung the frame was resized for (-1 = model.input_size)
+};
+
+class StagedPipeline;
+class ModelGroup;
+class QosController;
+
 /**
  * @brief parameter sturct to send callback function
  * 
- * Contains infer_pipeline, appsrc, config, log_file and header_written
+ * Contains infer_session, infer_engine, frame_contexts, appsrc, output_pool, config, resizer, staged, colorizer, clock, trace, histograms, metrics, models and qos
  */
 struct CallbackData {
-    InferVStreams* infer_pipeline; //NPU inference VStreams
+    InferSession* infer_session; //NPU inference session (owns reusable I/O buffers)
+    InferQueue* infer_engine; //async engine or batcher, nullptr to run inference synchronously
+    FrameContext* frame_contexts; //one context per job slot (infer_engine->capacity())
     GstElement* appsrc; //appsrc element for output
+    GstBufferPool* output_pool; //preallocated appsrc buffers the composite is written into
     const Config* config; //configuration (dimensions, paths, etc.)
-    std::ofstream* log_file; // stream for performance logging
-    bool* header_written; // Flag for CSV header initialization
+    FrameResizer* resizer; //camera frame → model input (only used on the appsink thread)
+    StagedPipeline* staged; //staged executor, nullptr when frames are processed on the appsink thread
+    const DepthColorizer* colorizer; //fused int8 depth → colour kernel
+    GstClock* clock; //clock shared by the camera and output pipelines
+    TraceLog* trace; //per-frame timing trace (lock-free ring, flushed to a binary file off the frame path)
+    StageHistograms* histograms; //per-stage µs histograms (lock-free)
+    PipelineMetrics* metrics; //frame / failure counters served on /metrics, nullptr when disabled
+    std::ofstream* depth_out; //raw int8 depth frames (offline mode), nullptr when disabled
+    DepthRingWriter* depth_ring; //shared-memory depth ring for other processes, nullptr when disabled
+    ModelGroup* models; //extra models sharing the device, fed camera frames; nullptr without a models list
+    QosController* qos; //picks the ladder rung per frame, nullptr without model.ladder
+    uint64_t next_frame_id = 0; //frame ID stamp_capture() hands out next (only touched by the thread pulling the appsink)
 };
 
 // 버스 메시지 콜백
 gboolean on_message(GstBus *bus, GstMessage *message, gpointer data);
-void makeSinkpipeline(GstElement* pipeline, const Config& config);
+bool makeSinkpipeline(GstElement* pipeline, const Config& config);
+std::string replay_source_description(const Config& config);
+GstElement* makeSourcePipeline(const VideoSource& source, const Config& config);
 GstElement* makeSrcPipeline(GstElement* pipeline, const Config& config);
-GstFlowReturn new_sample_callback(GstElement *sink, gpointer user_data);
\ No newline at end of file
+std::vector<OutputSink> active_outputs(const Config& config);
+std::string output_branch_description(const OutputSink& sink, size_t index, const Config& config);
+GstElement* makeElementPipeline(const Config& config);
+GstFlowReturn new_sample_callback(GstElement *sink, gpointer user_data);
+void on_infer_complete(InferJob &job, CallbackData *cb_data);
+
+// 프레임 단계 (동기 경로와 StagedPipeline이 공유)
+GstBufferPool* makeOutputPool(const Config& config);
+void postprocess(const cv::Mat &raw_img, const cv::Mat &raw_depth, const Config *config,
+                 const DepthColorizer *colorizer, cv::Mat &composite);
+GstFlowReturn compose_output(CallbackData *cb_data, const cv::Mat &raw_img, const cv::Mat &raw_depth,
+                             GstBuffer **out_buffer);
+bool map_camera_buffer(CallbackData *cb_data, GstBuffer *buffer, GstMapInfo &map);
+void stamp_capture(CallbackData *cb_data, GstElement *appsink, GstBuffer *buffer, FrameTiming &timing);
+void mark_infer_start(CallbackData *cb_data, FrameTiming &timing);
+GstFlowReturn push_frame(CallbackData *cb_data, FrameTiming &timing, GstBuffer *buffer);
+void log_timing(CallbackData *cb_data, const FrameTiming &timing);
+void count_infer_failure(CallbackData *cb_data);
+void write_depth(CallbackData *cb_data, const FrameTiming &timing, const cv::Mat &raw_depth);
+void offer_models(CallbackData *cb_data, const FrameTiming &timing, const cv::Mat &raw_img);
+FrameResizer* select_model(CallbackData *cb_data, FrameContext &ctx, const InferJob *job);
+cv::Size model_size(const CallbackData *cb_data, const FrameContext &ctx);
+void model_frame_done(CallbackData *cb_data, const FrameContext &ctx);
+bool is_unthrottled_replay(const Config &config);
+void release_frame(FrameContext &ctx);
\ No newline at end of file
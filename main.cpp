@@ -11,12 +11,28 @@
 #include <signal.h>  // ← 이거 추가!
 
 #include "Hailoinfer.hpp"
+#include "ConfigLoader.hpp"
 #include "gstreaming.hpp"
+#include "InferBackend.hpp"
+#include "InferEngine.hpp"
+#include "ResizeKernels.hpp"
+#include "StagedPipeline.hpp"
+#include "TraceLog.hpp"
+#include "Histogram.hpp"
+#include "Metrics.hpp"
+#include "gsthailodepth.hpp"
+#include "MultiSource.hpp"
+#include "ModelGroup.hpp"
+#include "ModelLadder.hpp"
 #include "hailo/hailort.hpp"
 #include "hailo/hailort_common.hpp" 
 
 
+#include <algorithm>
+#include <cstring>
 #include <fstream>
+#include <memory>
+#include <vector>
 
 static GMainLoop *g_loop = NULL;
 
@@ -28,121 +44,532 @@ void signal_handler(int signum) {
 }
 
 
+static void print_usage(const char *program) {
+    std::cout << "Usage: " << program << " [--config FILE] [--input FILE] [--output FILE.mp4]"
+              << " [--depth-raw FILE] [--no-video]\n"
+              << "  --config FILE     설정 파일 (기본 config.yaml)\n"
+              << "  --input FILE      카메라 대신 녹화 파일을 최대 속도로 처리 (드롭 없음, 창 없음)\n"
+              << "  --output FILE     깊이 영상 출력 파일 (video.output.file 대신)\n"
+              << "  --depth-raw FILE  프레임마다 int8 깊이 맵(model_width x model_height)을 이어 붙여 저장\n"
+              << "  --no-video        영상 인코딩 생략 (--depth-raw만 쓸 때)" << std::endl;
+}
+
+/**
+ * @brief Returns the value of "--name VALUE" in argv, or nullptr
+ */
+static const char *find_arg(int argc, char *argv[], const char *name) {
+    for (int i = 1; i + 1 < argc; i++) {
+        if (std::strcmp(argv[i], name) == 0) {
+            return argv[i + 1];
+        }
+    }
+    return nullptr;
+}
+
 /**
- * @brief Loads YAML configuration file and creates Config object
+ * @brief Applies command-line overrides on top of the YAML config
  *
- * @param[in] yaml_path Path to the YAML configuration file
- * @return Config object populated with loaded settings
+ * --input turns on unthrottled replay: filesrc ! decodebin, appsink drop=FALSE and a
+ * blocking appsrc, so every decoded frame is processed as fast as the pipeline allows.
+ * GStreamer options (--gst-*) are left for gst_init().
+ *
+ * @return false on an unknown option or a missing value
  */
-static Config load(const std::string& yaml_path) {
-        YAML::Node config = YAML::LoadFile(yaml_path);
-        Config cfg;
-        
-        // camera
-        cfg.device = config["device"].as<std::string>();
-        
-        // model
-        cfg.hef_path = config["model"]["hef_path"].as<std::string>();
-        cfg.model_width = config["model"]["input_size"]["width"].as<int>();
-        cfg.model_height = config["model"]["input_size"]["height"].as<int>();
-        
-        // video input size
-        cfg.video_inWidth = config["video"]["input"]["width"].as<int>();
-        cfg.video_inHeight = config["video"]["input"]["height"].as<int>();
-        
-        // video output size
-        cfg.video_outWidth = config["video"]["output"]["width"].as<int>();
-        cfg.video_outHeight = config["video"]["output"]["height"].as<int>();
-        cfg.output_name = config["video"]["output"]["file"].as<std::string>();
-        cfg.frame_rate = config["video"]["framerate"].as<int>();
-        
-        // encoder config
-        cfg.encode_speed = config["encoder"]["speed_preset"].as<int>();
-        cfg.tune = config["encoder"]["tune"].as<int>();
-        
-        // long file name
-        cfg.timing_log = config["logging"]["timing_log"].as<std::string>();
-        
-        return cfg;
+static bool apply_args(int argc, char *argv[], Config &cfg) {
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--config" && has_value) {
+            i++;  // main()에서 먼저 읽음
+        } else if (arg == "--input" && has_value) {
+            cfg.replay_file = argv[++i];
+            cfg.replay_rate = 0.0;
+            cfg.replay_display = false;
+            cfg.drop_policy = "block";  // staged 모드도 프레임을 버리지 않는다
+        } else if (arg == "--output" && has_value) {
+            cfg.output_name = argv[++i];
+            // 첫 파일 출력의 경로를 바꾸고, 파일 출력이 없으면 하나 추가
+            auto file = std::find_if(cfg.outputs.begin(), cfg.outputs.end(),
+                                     [](const OutputSink &sink) { return sink.type == "file"; });
+            if (file != cfg.outputs.end()) {
+                file->location = cfg.output_name;
+            } else {
+                cfg.outputs.push_back(OutputSink{"file", cfg.output_name});
+            }
+        } else if (arg == "--depth-raw" && has_value) {
+            cfg.depth_raw = argv[++i];
+        } else if (arg == "--no-video") {
+            cfg.write_video = false;
+        } else if (arg.compare(0, 6, "--gst-") == 0) {
+            continue;
+        } else {
+            std::cerr << "[ERROR] Unknown or incomplete option: " << arg << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// 주기적으로 출력할 측정값
+struct LatencyReport {
+    LatencyTracer *latency;         // capture → X 백분위
+    StageHistograms *histograms;    // 단계별 µs 히스토그램 (element 모드는 nullptr)
+    ModelGroup *models;             // 모델별 장치 점유 / 전환 비용 (models 목록이 없으면 nullptr)
+};
+
+// 주기적 지연 시간 백분위 출력 (메인 루프 타이머)
+static gboolean report_latency(gpointer data) {
+    LatencyReport *report = static_cast<LatencyReport*>(data);
+    if (report->histograms) {
+        report->histograms->report(std::cout, false);
+    }
+    report->latency->report(std::cout);
+    if (report->models) {
+        report->models->report(std::cout);
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+/**
+ * @brief Runs camera → hailodepth → display/file as one GStreamer pipeline
+ *
+ * @param[in] config Loaded configuration
+ * @return Process exit code
+ */
+static int run_element_pipeline(const Config &config, int argc, char *argv[]) {
+    gst_init(&argc, &argv);
+    if (!gst_hailo_depth_register_static()) {
+        std::cerr << "[ERROR] Failed to register hailodepth element" << std::endl;
+        return -1;
+    }
+    GstElement *pipeline = makeElementPipeline(config);
+    if (!pipeline) {
+        return -1;
+    }
+
+    // 한 파이프라인이라 모든 지점에서 base_time + PTS = 캡처 시각
+    LatencyTracer latency_tracer;
+    LatencyReport report = {&latency_tracer, nullptr, nullptr};
+    GstElement *depth = gst_bin_get_by_name(GST_BIN(pipeline), "depth");
+    // sink 패드는 리사이즈/전처리 전이라 infer-start가 아닌 element-in으로 기록
+    add_latency_probe(depth, "sink", LatencyTracer::ELEMENT_IN, &latency_tracer);
+    add_latency_probe(depth, "src", LatencyTracer::PUSH, &latency_tracer);
+    // (파일 출력이 없으면 인코더도 없음)
+    if (GstElement *encoder = gst_bin_get_by_name(GST_BIN(pipeline), "encoder")) {
+        add_latency_probe(encoder, "src", LatencyTracer::ENCODER_OUT, &latency_tracer);
+        gst_object_unref(encoder);
+    }
+
+    // 엘리먼트 모드는 depth 패드를 지나는 버퍼 수로 입출력을 센다
+    PipelineMetrics metrics;
+    MetricsServer metrics_server([&]() {
+        return render_metrics({&metrics, nullptr, &latency_tracer, nullptr, nullptr});
+    });
+    if (config.metrics_enabled) {
+        add_buffer_counter(depth, "sink", &metrics.frames_in);
+        add_buffer_counter(depth, "src", &metrics.frames_out);
+        metrics_server.start(config.metrics_bind, config.metrics_port);
+    }
+    gst_object_unref(depth);
+
+    GstBus *bus = gst_pipeline_get_bus(GST_PIPELINE(pipeline));
+    GMainLoop *loop = g_main_loop_new(NULL, FALSE);
+    g_loop = loop;
+    signal(SIGINT, signal_handler);
+    signal(SIGTERM, signal_handler);
+    gst_bus_add_signal_watch(bus);
+    g_signal_connect(bus, "message", G_CALLBACK(on_message), loop);
+
+    guint report_timer = 0;
+    if (config.latency_report_s > 0) {
+        report_timer = g_timeout_add(static_cast<guint>(config.latency_report_s * 1000), report_latency, &report);
+    }
+
+    gst_element_set_state(pipeline, GST_STATE_PLAYING);
+    g_main_loop_run(loop);
+    if (report_timer) {
+        g_source_remove(report_timer);
+    }
+    metrics_server.stop();
+
+    // EOS를 보내면 hailodepth가 in-flight 프레임을 모두 내보낸 뒤 mp4mux가 파일을 마무리
+    std::cout << "\n========== 종료 시작 ==========" << std::endl;
+    gst_element_send_event(pipeline, gst_event_new_eos());
+    GstMessage *msg = gst_bus_timed_pop_filtered(bus, 10 * GST_SECOND,
+                                (GstMessageType)(GST_MESSAGE_EOS | GST_MESSAGE_ERROR));
+    if (msg) {
+        std::cout << (GST_MESSAGE_TYPE(msg) == GST_MESSAGE_EOS ? "   ✓ EOS 완료 - 파일 저장됨!" : "   ✗ 에러로 종료") << std::endl;
+        gst_message_unref(msg);
+    } else {
+        std::cout << "   ✗ 타임아웃!" << std::endl;
+    }
+
+    gst_element_set_state(pipeline, GST_STATE_NULL);
+    gst_object_unref(bus);
+    gst_object_unref(pipeline);
+    g_main_loop_unref(loop);
+
+    std::cout << "========== 지연 시간 (캡처 기준) ==========" << std::endl;
+    latency_tracer.report(std::cout);
+    return 0;
+}
+
+// 해상도 사다리 QoS 평가 (메인 루프 타이머)
+static gboolean evaluate_qos(gpointer data) {
+    static_cast<QosController*>(data)->evaluate();
+    return G_SOURCE_CONTINUE;
+}
+
+// 소스별 한 줄 요약 (메인 루프 타이머)
+static gboolean report_sources(gpointer data) {
+    static_cast<MultiSourcePipeline*>(data)->report(std::cout);
+    return G_SOURCE_CONTINUE;
+}
+
+/**
+ * @brief Runs every configured source through one shared InferQueue
+ *
+ * @param[in] config Loaded configuration with a non-empty sources list
+ * @return Process exit code
+ */
+static int run_multi_source_pipeline(const Config &config, int argc, char *argv[]) {
+    if (config.element || config.staged || !config.replay_file.empty() || !config.models.empty() || !config.ladder.empty()) {
+        std::cerr << "[ERROR] sources cannot be combined with pipeline.element, pipeline.staged, --input, models or model.ladder" << std::endl;
+        return -1;
+    }
+    // 소스별 파이프라인에는 트레이스/타임라인/메트릭이 연결되지 않는다
+    if (config.metrics_enabled || !config.timeline_log.empty()) {
+        std::cerr << "[ERROR] sources cannot be combined with metrics.enabled or logging.timeline" << std::endl;
+        return -1;
+    }
+    if (!config.timing_log.empty()) {
+        std::cerr << "경고: logging.timing_log is not written with sources (per-source latency is printed instead)" << std::endl;
+    }
+    auto backend = create_backend(config);
+    if (!backend) {
+        std::cerr << "Failed to create inference backend (" << config.backend << "), status = " << backend.status() << std::endl;
+        return backend.status();
+    }
+    DepthColorizer colorizer(cv::COLORMAP_MAGMA, true);
+
+    gst_init(&argc, &argv);
+    GstClock *clock = gst_system_clock_obtain();
+    int ret = 0;
+    {
+        MultiSourcePipeline sources(config, *backend.value(), colorizer);
+        if (!sources.create(clock)) {
+            ret = -1;
+        } else {
+            GMainLoop *loop = g_main_loop_new(NULL, FALSE);
+            g_loop = loop;
+            signal(SIGINT, signal_handler);
+            signal(SIGTERM, signal_handler);
+
+            guint report_timer = 0;
+            if (config.latency_report_s > 0) {
+                report_timer = g_timeout_add(static_cast<guint>(config.latency_report_s * 1000), report_sources, &sources);
+            }
+            sources.start(loop);
+            g_main_loop_run(loop);
+            if (report_timer) {
+                g_source_remove(report_timer);
+            }
+
+            // 남은 프레임까지 추론한 뒤 소스마다 EOS → 파일 마무리
+            std::cout << "\n========== 종료 시작 ==========" << std::endl;
+            sources.stop();
+            g_loop = NULL;
+            g_main_loop_unref(loop);
+
+            std::cout << "========== 소스별 결과 (캡처 기준) ==========" << std::endl;
+            sources.summary(std::cout);
+        }
+    }
+    gst_object_unref(clock);
+    return ret;
 }
 
 int main(int argc, char *argv[]){
-    Config g_config = load("config.yaml");
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--help") == 0 || std::strcmp(argv[i], "-h") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        }
+    }
+    const char *config_path = find_arg(argc, argv, "--config");
+    Config g_config = load_config(config_path ? config_path : "config.yaml");
+    if (!apply_args(argc, argv, g_config)) {
+        print_usage(argv[0]);
+        return -1;
+    }
 
-    // ========== 1. 지역 변수로 로그 파일 열기 ==========
-    std::ofstream log_file(g_config.timing_log, std::ios::app);  // 지역 변수!
-    bool header_written = false;  // 지역 변수!
-    
-    if (!log_file.is_open()) {
-        std::cerr << "로그 파일 열기 실패: " << g_config.timing_log << std::endl;
+    // 멀티 소스 모드: 소스마다 캡처/출력 파이프라인, 추론 엔진은 하나를 나눠 쓴다
+    if (!g_config.sources.empty()) {
+        return run_multi_source_pipeline(g_config, argc, argv);
+    }
+
+    // 단일 파이프라인 모드: 전처리/추론/합성을 모두 hailodepth 엘리먼트가 처리
+    if (g_config.element) {
+        if (!g_config.models.empty() || !g_config.ladder.empty()) {
+            std::cerr << "[ERROR] models and model.ladder cannot be combined with pipeline.element" << std::endl;
+            return -1;
+        }
+        return run_element_pipeline(g_config, argc, argv);
+    }
+
+    // 해상도 사다리: 프레임마다 깊이 크기가 달라질 수 있어 고정 크기 출력과 함께 쓸 수 없다
+    if (!g_config.ladder.empty() &&
+        (!g_config.models.empty() || !g_config.depth_ring.empty() || !g_config.depth_raw.empty())) {
+        std::cerr << "[ERROR] model.ladder cannot be combined with models, depth_ring or depth_raw" << std::endl;
         return -1;
     }
 
-    //infer 초기화
-    auto vdevice = VDevice::create();
-    if (!vdevice) {
-        std::cerr << "Failed to create vdevice, status = " << vdevice.status() << std::endl;
-        return vdevice.status();
+    // ========== 1. 타이밍 트레이스 시작 ==========
+    // 프레임 경로는 lock-free 링에 기록만 하고, 파일 쓰기와 콘솔 요약(1초마다)은 flusher 스레드가 담당
+    LatencyTracer latency_tracer;
+    StageHistograms histograms;
+    LatencyReport report = {&latency_tracer, &histograms, nullptr};
+    TraceLog trace;
+    if (!trace.start(g_config.timing_log, &latency_tracer)) {
+        return -1;
     }
 
-    auto network_group = configure_network_group(*vdevice.value(),g_config);
-    if (!network_group) {
-        std::cerr << "Failed to configure network group " << g_config.hef_path << std::endl;
-        return network_group.status();
+    // 스레드별 단계 구간 타임라인 (꺼져 있으면 기록 지점마다 atomic load 한 번)
+    Timeline timeline;
+    if (!g_config.timeline_log.empty() && !timeline.start(g_config.timeline_log)) {
+        return -1;
     }
 
-    auto input_params = network_group.value()->make_input_vstream_params({}, FORMAT_TYPE, HAILO_DEFAULT_VSTREAM_TIMEOUT_MS, HAILO_DEFAULT_VSTREAM_QUEUE_SIZE);
-    if (!input_params) {
-        std::cerr << "Failed make_input_vstream_params " << input_params.status() << std::endl;
-        return input_params.status();
+    //infer 초기화: config의 backend에 따라 Hailo NPU 또는 CPU 시뮬레이션
+    // (models 목록이 있으면 depth와 추가 모델들을 한 장치에 올려 시분할,
+    //  model.ladder가 있으면 모든 해상도를 미리 구성해 두고 프레임마다 고른다)
+    std::unique_ptr<ModelGroup> models;
+    std::unique_ptr<InferenceBackend> backend;
+    LadderBackend *ladder = nullptr;
+    if (!g_config.ladder.empty()) {
+        auto created = LadderBackend::create(g_config);
+        if (!created) {
+            std::cerr << "Failed to configure model ladder (" << g_config.backend << "), status = " << created.status() << std::endl;
+            return created.status();
+        }
+        ladder = created.value().get();
+        backend = created.release();
+    } else if (g_config.models.empty()) {
+        auto created = create_backend(g_config);
+        if (!created) {
+            std::cerr << "Failed to create inference backend (" << g_config.backend << "), status = " << created.status() << std::endl;
+            return created.status();
+        }
+        backend = created.release();
+    } else {
+        auto group = ModelGroup::create(g_config);
+        if (!group) {
+            std::cerr << "Failed to configure models on one device (" << g_config.backend << "), status = " << group.status() << std::endl;
+            return group.status();
+        }
+        models = group.release();
+        backend = models->release_depth();
+        report.models = models.get();
     }
 
-    auto output_params = network_group.value()->make_output_vstream_params({}, FORMAT_TYPE, HAILO_DEFAULT_VSTREAM_TIMEOUT_MS, HAILO_DEFAULT_VSTREAM_QUEUE_SIZE);
-    if (!output_params) {
-        std::cerr << "Failed make_output_vstream_params " << output_params.status() << std::endl;
-        return output_params.status();
+    // 입출력 버퍼는 한 번만 준비하고 매 프레임 재사용
+    // (사다리는 작업 슬롯 버퍼로 해상도를 구분하므로 항상 엔진 경로, 세션 없음)
+    std::unique_ptr<InferSession> session;
+    if (!ladder) {
+        auto created = InferSession::create(*backend, g_config);
+        if (!created) {
+            std::cerr << "Failed to create inference session " << created.status() << std::endl;
+            return created.status();
+        }
+        session = created.release();
     }
 
-    auto pipeline = InferVStreams::create(*network_group.value(), input_params.value(), output_params.value());
-    if (!pipeline) {
-        std::cerr << "Failed to create inference pipeline " << pipeline.status() << std::endl;
-        return pipeline.status();
+    // batch_size > 1 이면 여러 프레임을 모아 한 번에 추론,
+    // frames_in_flight > 1 이면 비동기 엔진으로 쓰기/읽기를 별도 스레드에서 겹쳐 실행
+    // (staged 모드와 해상도 사다리는 엔진이 항상 필요)
+    std::unique_ptr<InferQueue> engine;
+    CallbackData cb_data;
+    auto on_complete = [&cb_data](InferJob &job) { on_infer_complete(job, &cb_data); };
+
+    if (g_config.batch_size > 1 || g_config.frames_in_flight > 1 || g_config.staged || ladder) {
+        auto queue = create_infer_queue(*backend, g_config, on_complete);
+        if (!queue) {
+            std::cerr << "Failed to start inference queue " << queue.status() << std::endl;
+            return queue.status();
+        }
+        if (g_config.batch_size > 1) {
+            std::cout << "배치 추론: " << g_config.batch_size << " 프레임, 마감 " << g_config.batch_timeout_ms << " ms" << std::endl;
+        } else {
+            std::cout << "비동기 추론: in-flight " << g_config.frames_in_flight << " 프레임" << std::endl;
+        }
+        engine = std::move(queue.value());
     }
+    std::vector<FrameContext> frame_contexts(engine ? engine->capacity() : 1);
+
+    // 전처리: 카메라 프레임 → 모델 입력 (필터 tap은 여기서 한 번만 계산)
+    ResizeMethod resize_method;
+    if (!parse_resize_method(g_config.preprocess, resize_method)) {
+        std::cerr << "[ERROR] Unknown preprocess method: " << g_config.preprocess
+                  << " (expected antialias, area or blur_resize)" << std::endl;
+        return -1;
+    }
+    FrameResizer resizer(cv::Size(g_config.video_inWidth, g_config.video_inHeight),
+                         cv::Size(g_config.model_width, g_config.model_height), resize_method);
+    std::cout << "전처리: " << resize_method_name(resize_method) << " (" << resize_kernel_path() << ")" << std::endl;
+
+    // 후처리 컬러맵 LUT (appsrc caps가 RGB라 RGB 순서로 바로 씀)
+    DepthColorizer colorizer(cv::COLORMAP_MAGMA, true);
 
     // GStreamer 초기화
     gst_init(&argc, &argv);
     GstElement *sink_pipeline = gst_pipeline_new("hailo-infersink");
     GstElement *src_pipeline = gst_pipeline_new("source_view");
 
+    // 두 파이프라인이 같은 clock을 써야 캡처 시각을 출력 쪽 PTS로 옮길 수 있다
+    GstClock *clock = gst_system_clock_obtain();
+    gst_pipeline_use_clock(GST_PIPELINE(sink_pipeline), clock);
+    gst_pipeline_use_clock(GST_PIPELINE(src_pipeline), clock);
+
     // ========== 2. config 전달 (수정!) ==========
-    makeSinkpipeline(sink_pipeline, g_config);
-    GstElement *appsrc = makeSrcPipeline(src_pipeline, g_config);
+    if (!makeSinkpipeline(sink_pipeline, g_config)) {
+        return -1;
+    }
+    // 출력 브랜치가 하나도 없으면 appsrc / 출력 풀 없이 깊이 계산만 한다 (metrics로 관찰)
+    const std::vector<OutputSink> outputs = active_outputs(g_config);
+    GstElement *appsrc = nullptr;
+    GstBufferPool *output_pool = nullptr;
+    if (outputs.empty()) {
+        std::cout << "출력 없음: 합성/push 생략" << std::endl;
+    } else {
+        appsrc = makeSrcPipeline(src_pipeline, g_config);
+        if (!appsrc) {
+            return -1;
+        }
+        // 출력 프레임은 미리 할당한 풀 버퍼에 바로 합성 (프레임마다 할당/복사 없음)
+        output_pool = makeOutputPool(g_config);
+        if (!output_pool) {
+            return -1;
+        }
+    }
 
     // appsink 생성 및 링크
+    // 제한 없는 재생은 드롭 없이 backpressure로 파일 읽기 속도를 맞춘다
+    const bool replay = !g_config.replay_file.empty();
+    const bool unthrottled = is_unthrottled_replay(g_config);
     GstElement *appsink = gst_element_factory_make("appsink", "app_sink");
     gst_bin_add(GST_BIN(sink_pipeline), appsink);
     g_object_set(appsink, 
-        "emit-signals", TRUE,
+        "emit-signals", g_config.staged ? FALSE : TRUE,  // staged 모드는 ingest 스레드가 직접 pull
         "sync", FALSE,
         "max-buffers", 1,
-        "drop", TRUE,
+        "drop", unthrottled ? FALSE : TRUE,
         NULL);
 
     GstElement *queue1 = gst_bin_get_by_name(GST_BIN(sink_pipeline), "queue1");
+    if (!queue1) {
+        return -1;
+    }
     gst_element_link(queue1, appsink);
+    if (Timeline::active()) {
+        // 프레임 ID는 appsink 뒤에서 매겨지므로 입력 쪽 instant에는 없다
+        add_timeline_probe(queue1, "src", TimelineSpan::Queue1Out, false);
+        add_timeline_probe(appsink, "sink", TimelineSpan::AppsinkIn, false);
+        if (appsrc) {
+            add_timeline_probe(appsrc, "src", TimelineSpan::AppsrcOut, true);
+        }
+    }
     gst_object_unref(queue1);
 
     // ========== 3. CallbackData에 config 추가 (수정!) ==========
-    CallbackData cb_data;
-    cb_data.infer_pipeline = &pipeline.value();
+    cb_data.infer_session = session.get();
+    cb_data.infer_engine = engine.get();
+    cb_data.frame_contexts = frame_contexts.data();
     cb_data.appsrc = appsrc;
+    cb_data.output_pool = output_pool;
     cb_data.config = &g_config;  // ← 추가!
-    cb_data.log_file = &log_file;              // ← 추가!
-    cb_data.header_written = &header_written;  // ← 추가!
+    cb_data.resizer = &resizer;
+    cb_data.staged = nullptr;
+    cb_data.colorizer = &colorizer;
+    cb_data.clock = clock;
+    cb_data.trace = &trace;
+    cb_data.histograms = &histograms;
+    cb_data.metrics = nullptr;
+    cb_data.depth_out = nullptr;
+    cb_data.depth_ring = nullptr;
+    cb_data.models = nullptr;
+    cb_data.qos = nullptr;
+
+    // 다른 프로세스용 깊이 링: 느린 reader가 있어도 가장 오래된 슬롯을 덮어쓸 뿐 기다리지 않는다
+    DepthRingWriter depth_ring;
+    if (!g_config.depth_ring.empty()) {
+        if (!depth_ring.create(g_config.depth_ring, g_config.model_width, g_config.model_height,
+                               static_cast<uint32_t>(std::max(g_config.depth_ring_slots, 2)), true)) {
+            return -1;
+        }
+        float scale, zero_point;
+        backend->output_quantization(scale, zero_point);
+        depth_ring.set_quantization(scale, zero_point);
+        cb_data.depth_ring = &depth_ring;
+    }
+
+    // raw 깊이 프레임: 후처리 스레드가 프레임 순서대로 이어 붙인다
+    std::ofstream depth_out;
+    if (!g_config.depth_raw.empty()) {
+        depth_out.open(g_config.depth_raw, std::ios::binary | std::ios::trunc);
+        if (!depth_out.is_open()) {
+            std::cerr << "[ERROR] Failed to open depth output: " << g_config.depth_raw << std::endl;
+            return -1;
+        }
+        cb_data.depth_out = &depth_out;
+    }
+
+    // 추가 모델: 프레임 경로는 목표 fps만큼 골라 복사만 하고, 추론은 모델마다 별도 스레드
+    if (models) {
+        if (!models->start()) {
+            return -1;
+        }
+        cb_data.models = models.get();
+    }
+
+    // appsink 패드 probe로 도착 수를 세면 drop=TRUE가 조용히 버린 프레임 수를 알 수 있다
+    // (QoS 컨트롤러도 이 카운터로 드롭률을 본다)
+    PipelineMetrics metrics;
+    if (g_config.metrics_enabled || replay || ladder) {
+        add_buffer_counter(appsink, "sink", &metrics.camera_frames);
+        cb_data.metrics = &metrics;
+    }
+
+    // QoS: 단계별 지연과 드롭률을 보고 프레임 사이에서 해상도를 바꾼다 (재구성 없음)
+    std::unique_ptr<QosController> qos;
+    if (ladder) {
+        qos.reset(new QosController(g_config, *ladder, resize_method, histograms, metrics));
+        if (!qos->open_log()) {
+            return -1;
+        }
+        cb_data.qos = qos.get();
+    }
 
     
-    // callback 연결
-    g_signal_connect(appsink, "new-sample", G_CALLBACK(new_sample_callback), &cb_data);
+    // callback 연결 (staged 모드: 단계별 스레드 + SPSC 큐)
+    std::unique_ptr<StagedPipeline> staged;
+    if (g_config.staged) {
+        DropPolicy drop_policy;
+        if (!parse_drop_policy(g_config.drop_policy, drop_policy)) {
+            std::cerr << "[ERROR] Unknown drop policy: " << g_config.drop_policy
+                      << " (expected block, drop or latest)" << std::endl;
+            return -1;
+        }
+        staged.reset(new StagedPipeline(cb_data, *engine, appsink, std::max(g_config.stage_queue_depth, 1),
+                                        drop_policy, g_config.stats_interval_s));
+        cb_data.staged = staged.get();
+        if (qos) {
+            qos->set_staged(staged.get());
+        }
+        staged->start();
+        std::cout << "단계별 파이프라인: 큐 " << g_config.stage_queue_depth << " / " << g_config.drop_policy << std::endl;
+    } else {
+        g_signal_connect(appsink, "new-sample", G_CALLBACK(new_sample_callback), &cb_data);
+    }
 
     // 버스 설정
     GstBus *sink_bus = gst_pipeline_get_bus(GST_PIPELINE(sink_pipeline));
@@ -158,11 +585,43 @@ int main(int argc, char *argv[]){
     g_signal_connect(sink_bus, "message", G_CALLBACK(on_message), loop);
     g_signal_connect(src_bus, "message", G_CALLBACK(on_message), loop);
 
+    // 캡처 → 인코더 출력 지연은 x264enc src 패드에서 측정
+    // (--no-video면 인코더가 없음)
+    if (GstElement *encoder = gst_bin_get_by_name(GST_BIN(src_pipeline), "encoder")) {
+        add_latency_probe(encoder, "src", LatencyTracer::ENCODER_OUT, &latency_tracer);
+        gst_object_unref(encoder);
+    }
+    guint report_timer = 0;
+    if (g_config.latency_report_s > 0) {
+        report_timer = g_timeout_add(static_cast<guint>(g_config.latency_report_s * 1000), report_latency, &report);
+    }
+    guint qos_timer = 0;
+    if (qos) {
+        qos_timer = g_timeout_add(static_cast<guint>(std::max(g_config.qos_interval_s, 0.1) * 1000), evaluate_qos, qos.get());
+    }
+
+    // /metrics는 별도 스레드에서 atomic 카운터만 읽는다 (프레임 경로와 무관)
+    MetricsServer metrics_server([&]() {
+        return render_metrics({&metrics, &histograms, &latency_tracer, staged.get(), &trace});
+    });
+    if (g_config.metrics_enabled) {
+        metrics_server.start(g_config.metrics_bind, g_config.metrics_port);
+    }
+
     // 파이프라인 시작
+    const auto t_run = std::chrono::steady_clock::now();
     gst_element_set_state(sink_pipeline, GST_STATE_PLAYING);
     gst_element_set_state(src_pipeline, GST_STATE_PLAYING);
     
     g_main_loop_run(loop);
+    const double run_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t_run).count();
+    if (report_timer) {
+        g_source_remove(report_timer);
+    }
+    if (qos_timer) {
+        g_source_remove(qos_timer);
+    }
+    metrics_server.stop();
  
 
     std::cout << "\n========== 종료 시작 ==========" << std::endl;
@@ -171,32 +630,44 @@ int main(int argc, char *argv[]){
     std::cout << "1. 카메라 입력 중지 중..." << std::endl;
     gst_element_set_state(sink_pipeline, GST_STATE_PAUSED);
     g_usleep(200000);  // 0.2초 대기
+    if (staged) {
+        staged->stop();  // 각 단계에 남은 프레임까지 appsrc로 내보낸 뒤 EOS
+    } else if (engine) {
+        engine->stop();  // in-flight 프레임을 모두 appsrc로 내보낸 뒤 EOS
+    }
+    if (models) {
+        models->stop();
+    }
 
-    // 2. appsrc에 EOS 신호 (이 부분 변경!)
-    std::cout << "2. appsrc EOS 전송..." << std::endl;
-    GstFlowReturn ret = gst_app_src_end_of_stream(GST_APP_SRC(appsrc));
-    std::cout << "   EOS 전송 결과: " << (ret == GST_FLOW_OK ? "성공" : "실패") << std::endl;
-
-    // 3. EOS 메시지 대기
-    std::cout << "3. EOS 메시지 대기 중... (최대 10초)" << std::endl;
-    GstMessage *msg = gst_bus_timed_pop_filtered(src_bus, 10 * GST_SECOND,
-                                (GstMessageType)(GST_MESSAGE_EOS | GST_MESSAGE_ERROR));
-
-    if (msg) {
-        if (GST_MESSAGE_TYPE(msg) == GST_MESSAGE_EOS) {
-            std::cout << "   ✓ EOS 완료 - 파일 저장됨!" << std::endl;
+    // 2. appsrc에 EOS 신호 (이 부분 변경!) - 출력 브랜치가 없으면 기다릴 EOS도 없다
+    if (appsrc) {
+        std::cout << "2. appsrc EOS 전송..." << std::endl;
+        GstFlowReturn ret = gst_app_src_end_of_stream(GST_APP_SRC(appsrc));
+        std::cout << "   EOS 전송 결과: " << (ret == GST_FLOW_OK ? "성공" : "실패") << std::endl;
+
+        // 3. EOS 메시지 대기
+        std::cout << "3. EOS 메시지 대기 중... (최대 10초)" << std::endl;
+        GstMessage *msg = gst_bus_timed_pop_filtered(src_bus, 10 * GST_SECOND,
+                                    (GstMessageType)(GST_MESSAGE_EOS | GST_MESSAGE_ERROR));
+
+        if (msg) {
+            if (GST_MESSAGE_TYPE(msg) == GST_MESSAGE_EOS) {
+                std::cout << "   ✓ EOS 완료 - 파일 저장됨!" << std::endl;
+            } else {
+                GError *err;
+                gchar *debug;
+                gst_message_parse_error(msg, &err, &debug);
+                std::cout << "   ✗ 에러: " << err->message << std::endl;
+                g_error_free(err);
+                g_free(debug);
+            }
+            gst_message_unref(msg);
         } else {
-            GError *err;
-            gchar *debug;
-            gst_message_parse_error(msg, &err, &debug);
-            std::cout << "   ✗ 에러: " << err->message << std::endl;
-            g_error_free(err);
-            g_free(debug);
+            std::cout << "   ✗ 타임아웃!" << std::endl;
         }
-        gst_message_unref(msg);
-    } else {
-        std::cout << "   ✗ 타임아웃!" << std::endl;
     }
+    // 벽시계 시간: PLAYING부터 마지막 프레임이 파일에 기록될 때까지
+    const double wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t_run).count();
 
     std::cout << "4. 파이프라인 정리..." << std::endl;
 
@@ -211,10 +682,67 @@ int main(int argc, char *argv[]){
     gst_object_unref(src_bus);
     gst_object_unref(sink_pipeline);
     gst_object_unref(src_pipeline);
+    if (output_pool) {
+        gst_buffer_pool_set_active(output_pool, FALSE);
+        gst_object_unref(output_pool);
+    }
+    gst_object_unref(clock);
     g_main_loop_unref(loop);
-    
-    // ========== 4. 로그 파일 닫기 (추가!) ==========
-    log_file.close();
+    if (depth_out.is_open()) {
+        depth_out.close();
+    }
+    if (cb_data.depth_ring) {
+        std::cout << "깊이 링: " << depth_ring.published() << " 프레임 게시" << std::endl;
+        depth_ring.close();  // reader는 closed 플래그를 본다
+    }
+
+    // ========== 4. 트레이스 마무리 (남은 기록까지 파일로) ==========
+    trace.stop();
+    timeline.stop();
+    std::cout << "트레이스: " << trace.frames() << " 프레임 → " << g_config.timing_log;
+    if (trace.dropped()) {
+        std::cout << " (" << trace.dropped() << " 프레임 링 가득 참으로 누락)";
+    }
+    std::cout << std::endl;
+
+    std::cout << "========== 지연 시간 (캡처 기준) ==========" << std::endl;
+    histograms.report(std::cout, true);
+    latency_tracer.report(std::cout);
+    if (models) {
+        std::cout << "========== 모델별 장치 사용 ==========" << std::endl;
+        models->report(std::cout);
+    }
+    if (qos) {
+        std::cout << "========== 해상도 사다리 (QoS) ==========" << std::endl;
+        qos->summary(std::cout);
+    }
+
+    if (replay) {
+        // 같은 파일 + 같은 지연 모델이면 변경 전후를 그대로 비교할 수 있다
+        const uint64_t decoded = metrics.camera_frames.load();
+        const uint64_t processed = metrics.frames_in.load();
+        const uint64_t output = metrics.frames_out.load();
+        const uint64_t dropped = decoded > processed ? decoded - processed : 0;
+        std::cout << "========== 재생 결과 ==========" << std::endl;
+        std::cout << "   파일: " << g_config.replay_file << " | 백엔드: " << g_config.backend
+                  << " | 속도: " << (unthrottled ? std::string("제한 없음") : std::to_string(g_config.replay_rate) + " fps")
+                  << std::endl;
+        std::cout << "   디코딩 " << decoded << " | 처리 " << processed << " | 출력 " << output
+                  << " | appsink 드롭 " << dropped << " (" << (decoded ? 100.0 * dropped / decoded : 0.0) << "%)"
+                  << " | 추론 실패 " << metrics.infer_failures.load() << std::endl;
+        std::cout << "   " << run_s << " s | 처리량 " << (run_s > 0 ? output / run_s : 0.0) << " fps" << std::endl;
+        std::cout << "   전체 " << wall_s << " s (출력 파일 마무리 포함) | " << (wall_s > 0 ? output / wall_s : 0.0)
+                  << " fps" << std::endl;
+        for (const OutputSink &sink : outputs) {
+            if (sink.type == "file") {
+                std::cout << "   깊이 영상: " << (sink.location.empty() ? g_config.output_name : sink.location) << std::endl;
+            }
+        }
+        if (!g_config.depth_raw.empty()) {
+            std::cout << "   raw 깊이: " << g_config.depth_raw << " (" << output << " x "
+                      << g_config.model_width << "x" << g_config.model_height << " int8)" << std::endl;
+        }
+    }
     
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+
+/**
+ * @brief Minimal assertions shared by the ctest executables
+ *
+ * CHECK() reports a failed condition and keeps going; main() returns
+ * test_result(), which is nonzero once any check failed.
+ */
+
+#include <atomic>
+#include <iostream>
+
+inline std::atomic<int> g_test_failures{0};  ///< Checks may run on worker threads
+
+#define CHECK(cond)                                                                          \
+    do {                                                                                     \
+        if (!(cond)) {                                                                       \
+            std::cerr << "[FAIL] " << __FILE__ << ":" << __LINE__ << ": " #cond << std::endl; \
+            g_test_failures++;                                                               \
+        }                                                                                    \
+    } while (0)
+
+#define CHECK_EQ(actual, expected)                                                          \
+    do {                                                                                     \
+        const auto check_actual_ = (actual);                                                 \
+        const auto check_expected_ = (expected);                                             \
+        if (!(check_actual_ == check_expected_)) {                                           \
+            std::cerr << "[FAIL] " << __FILE__ << ":" << __LINE__ << ": " #actual " == " #expected \
+                      << " (" << check_actual_ << " vs " << check_expected_ << ")" << std::endl; \
+            g_test_failures++;                                                               \
+        }                                                                                    \
+    } while (0)
+
+inline int test_result(const char *name)
+{
+    if (g_test_failures.load()) {
+        std::cerr << name << ": " << g_test_failures.load() << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << name << ": OK" << std::endl;
+    return 0;
+}
@@ -0,0 +1,170 @@
+/**
+ * @brief CpuBackend: output values, simulated latency, streaming order, abort
+ */
+#include "InferBackend.hpp"
+#include "TestCheck.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr int WIDTH = 16;
+constexpr int HEIGHT = 6;
+
+Config make_config(double latency_ms, double jitter_ms = 0.0)
+{
+    Config config{};
+    config.backend = "cpu";
+    config.model_width = WIDTH;
+    config.model_height = HEIGHT;
+    config.cpu_latency_ms = latency_ms;
+    config.cpu_jitter_ms = jitter_ms;
+    return config;
+}
+
+/// 입력이 전부 value인 프레임의 (x, y) 출력: 세로 ramp 3/4 + 휘도 1/4
+int8_t expected_depth(int y, uint8_t value)
+{
+    const int ramp = (y * 255) / (HEIGHT - 1);
+    return static_cast<int8_t>(((ramp * 3 + value) >> 2) - 128);
+}
+
+bool frame_matches(const uint8_t *output, uint8_t value)
+{
+    for (int y = 0; y < HEIGHT; y++) {
+        for (int x = 0; x < WIDTH; x++) {
+            if (static_cast<int8_t>(output[y * WIDTH + x]) != expected_depth(y, value)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void test_infer()
+{
+    auto backend = CpuBackend::create(make_config(5.0));
+    CHECK(backend);
+    if (!backend) {
+        return;
+    }
+    CpuBackend &cpu = *backend.value();
+    CHECK_EQ(cpu.input_frame_size(), size_t(WIDTH * HEIGHT * 3));
+    CHECK_EQ(cpu.output_frame_size(), size_t(WIDTH * HEIGHT));
+
+    std::vector<uint8_t> input(cpu.input_frame_size() * 2);
+    std::vector<uint8_t> output(cpu.output_frame_size() * 2);
+    std::memset(input.data(), 40, cpu.input_frame_size());
+    std::memset(input.data() + cpu.input_frame_size(), 200, cpu.input_frame_size());
+
+    // 두 프레임 배치는 직렬 장치에서 지연 2회
+    const auto start = std::chrono::steady_clock::now();
+    CHECK_EQ(cpu.infer(MemoryView(input.data(), input.size()), MemoryView(output.data(), output.size()), 2),
+             HAILO_SUCCESS);
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    CHECK(elapsed >= std::chrono::milliseconds(10));
+    CHECK(frame_matches(output.data(), 40));
+    CHECK(frame_matches(output.data() + cpu.output_frame_size(), 200));
+
+    CHECK_EQ(cpu.infer(MemoryView(input.data(), input.size()), MemoryView(output.data(), output.size()), 3),
+             HAILO_INVALID_ARGUMENT);
+}
+
+void test_streaming()
+{
+    auto backend = CpuBackend::create(make_config(1.0));
+    CHECK(backend);
+    if (!backend) {
+        return;
+    }
+    CpuBackend &cpu = *backend.value();
+
+    // 큐 깊이보다 많이 써서 write_input()의 backpressure도 지나간다
+    constexpr int FRAMES = 12;
+    std::thread writer([&] {
+        std::vector<uint8_t> input(cpu.input_frame_size());
+        for (int i = 0; i < FRAMES; i++) {
+            std::memset(input.data(), i * 20, input.size());
+            CHECK_EQ(cpu.write_input(MemoryView(input.data(), input.size())), HAILO_SUCCESS);
+        }
+    });
+
+    std::vector<uint8_t> output(cpu.output_frame_size());
+    for (int i = 0; i < FRAMES; i++) {
+        CHECK_EQ(cpu.read_output(MemoryView(output.data(), output.size())), HAILO_SUCCESS);
+        CHECK(frame_matches(output.data(), static_cast<uint8_t>(i * 20)));
+    }
+    writer.join();
+
+    std::vector<uint8_t> wrong(cpu.input_frame_size() - 1);
+    CHECK_EQ(cpu.write_input(MemoryView(wrong.data(), wrong.size())), HAILO_INVALID_ARGUMENT);
+}
+
+void test_concurrent_infer()
+{
+    // infer()와 스트리밍이 같은 지연 모델을 동시에 쓴다 (TSan 빌드에서 경쟁이 보인다)
+    auto backend = CpuBackend::create(make_config(0.2, 0.1));
+    CHECK(backend);
+    if (!backend) {
+        return;
+    }
+    CpuBackend &cpu = *backend.value();
+
+    constexpr int FRAMES = 20;
+    std::thread batch([&] {
+        std::vector<uint8_t> input(cpu.input_frame_size(), 7);
+        std::vector<uint8_t> output(cpu.output_frame_size());
+        for (int i = 0; i < FRAMES; i++) {
+            CHECK_EQ(cpu.infer(MemoryView(input.data(), input.size()), MemoryView(output.data(), output.size()), 1),
+                     HAILO_SUCCESS);
+            CHECK(frame_matches(output.data(), 7));
+        }
+    });
+    std::thread writer([&] {
+        std::vector<uint8_t> input(cpu.input_frame_size(), 9);
+        for (int i = 0; i < FRAMES; i++) {
+            CHECK_EQ(cpu.write_input(MemoryView(input.data(), input.size())), HAILO_SUCCESS);
+        }
+    });
+    std::vector<uint8_t> output(cpu.output_frame_size());
+    for (int i = 0; i < FRAMES; i++) {
+        CHECK_EQ(cpu.read_output(MemoryView(output.data(), output.size())), HAILO_SUCCESS);
+        CHECK(frame_matches(output.data(), 9));
+    }
+    writer.join();
+    batch.join();
+}
+
+void test_abort()
+{
+    auto backend = CpuBackend::create(make_config(0.0));
+    CHECK(backend);
+    if (!backend) {
+        return;
+    }
+    CpuBackend &cpu = *backend.value();
+
+    hailo_status status = HAILO_SUCCESS;
+    std::thread reader([&] {
+        std::vector<uint8_t> output(cpu.output_frame_size());
+        status = cpu.read_output(MemoryView(output.data(), output.size()));
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    cpu.abort();
+    reader.join();
+    CHECK_EQ(status, HAILO_STREAM_ABORT);
+}
+
+}  // namespace
+
+int main()
+{
+    test_infer();
+    test_streaming();
+    test_concurrent_infer();
+    test_abort();
+    return test_result("cpu_backend");
+}
@@ -0,0 +1,142 @@
+/**
+ * @brief DepthColorizer against a scalar reference of the normalize + LUT chain
+ *
+ * Runs whichever SIMD path the host selects (see depth_kernel_path()) on odd sizes,
+ * so the vector body and the scalar tail are both compared, and checks that a
+ * strided (ROI) depth map is normalized over the whole frame, not per row.
+ */
+#include "DepthKernels.hpp"
+#include "TestCheck.hpp"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace {
+
+uint8_t g_table[256][3];
+
+void init_table()
+{
+    for (int k = 0; k < 256; k++) {
+        g_table[k][0] = static_cast<uint8_t>(k);
+        g_table[k][1] = static_cast<uint8_t>(255 - k);
+        g_table[k][2] = static_cast<uint8_t>(k * 7);
+    }
+}
+
+/// NORM_MINMAX over [lo, hi], then the table (BGR order kept)
+void reference_pixel(int8_t value, int8_t lo, int8_t hi, uint8_t out[3])
+{
+    const int range = static_cast<int>(hi) - static_cast<int>(lo);
+    const float scale = range > 0 ? 255.0f / range : 0.0f;
+    const float shift = -(static_cast<int>(lo) + 128) * scale;
+    int level = cvRound((static_cast<int>(value) + 128) * scale + shift);
+    level = std::min(std::max(level, 0), 255);
+    out[0] = g_table[level][0];
+    out[1] = g_table[level][1];
+    out[2] = g_table[level][2];
+}
+
+bool pixels_match(const int8_t *src, size_t count, int8_t lo, int8_t hi, const uint8_t *dst)
+{
+    for (size_t i = 0; i < count; i++) {
+        uint8_t expected[3];
+        reference_pixel(src[i], lo, hi, expected);
+        if (dst[3 * i] != expected[0] || dst[3 * i + 1] != expected[1] || dst[3 * i + 2] != expected[2]) {
+            std::cerr << "pixel " << i << " (value " << int(src[i]) << ") differs" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+void test_minmax(std::mt19937 &rng)
+{
+    std::uniform_int_distribution<int> value(-128, 127);
+    for (size_t count : {size_t(1), size_t(15), size_t(16), size_t(33), size_t(1000)}) {
+        std::vector<int8_t> src(count);
+        for (auto &v : src) {
+            v = static_cast<int8_t>(value(rng));
+        }
+        int8_t lo = 0;
+        int8_t hi = 0;
+        depth_minmax(src.data(), count, &lo, &hi);
+        CHECK_EQ(int(lo), int(*std::min_element(src.begin(), src.end())));
+        CHECK_EQ(int(hi), int(*std::max_element(src.begin(), src.end())));
+    }
+}
+
+void test_pointer(const DepthColorizer &colorizer, std::mt19937 &rng)
+{
+    std::uniform_int_distribution<int> value(-90, 70);
+    for (size_t count : {size_t(1), size_t(7), size_t(17), size_t(1261)}) {
+        std::vector<int8_t> src(count);
+        for (auto &v : src) {
+            v = static_cast<int8_t>(value(rng));
+        }
+        std::vector<uint8_t> dst(count * 3);
+        colorizer.colorize(src.data(), count, dst.data());
+
+        const int8_t lo = *std::min_element(src.begin(), src.end());
+        const int8_t hi = *std::max_element(src.begin(), src.end());
+        CHECK(pixels_match(src.data(), count, lo, hi, dst.data()));
+    }
+
+    // 값이 하나뿐인 프레임: 범위 0 → 모두 level 0
+    std::vector<int8_t> flat(40, 12);
+    std::vector<uint8_t> dst(flat.size() * 3);
+    colorizer.colorize(flat.data(), flat.size(), dst.data());
+    CHECK(pixels_match(flat.data(), flat.size(), 12, 12, dst.data()));
+}
+
+void test_strided_mat(const DepthColorizer &colorizer, std::mt19937 &rng)
+{
+    constexpr int ROWS = 9;
+    constexpr int COLS = 45;
+    cv::Mat parent(ROWS, COLS + 10, CV_8SC1);
+    // 행마다 다른 범위: 행 단위로 정규화하면 결과가 달라진다
+    for (int y = 0; y < ROWS; y++) {
+        std::uniform_int_distribution<int> value(-100 + 10 * y, -60 + 20 * y);
+        int8_t *row = parent.ptr<int8_t>(y);
+        for (int x = 0; x < COLS + 10; x++) {
+            row[x] = static_cast<int8_t>(value(rng));
+        }
+    }
+    const cv::Mat roi = parent.colRange(4, 4 + COLS);
+    CHECK(!roi.isContinuous());
+
+    int8_t lo = 127;
+    int8_t hi = -128;
+    for (int y = 0; y < ROWS; y++) {
+        const int8_t *row = roi.ptr<int8_t>(y);
+        lo = std::min(lo, *std::min_element(row, row + COLS));
+        hi = std::max(hi, *std::max_element(row, row + COLS));
+    }
+
+    cv::Mat dst;
+    colorizer.colorize(roi, dst);
+    CHECK_EQ(dst.rows, ROWS);
+    CHECK_EQ(dst.cols, COLS);
+    bool match = true;
+    for (int y = 0; y < ROWS && match; y++) {
+        match = pixels_match(roi.ptr<int8_t>(y), COLS, lo, hi, dst.ptr<uint8_t>(y));
+    }
+    CHECK(match);
+}
+
+}  // namespace
+
+int main()
+{
+    init_table();
+    DepthColorizer colorizer;
+    colorizer.set_table(g_table, false);
+    std::mt19937 rng(7);
+
+    std::cout << "kernel path: " << depth_kernel_path() << std::endl;
+    test_minmax(rng);
+    test_pointer(colorizer, rng);
+    test_strided_mat(colorizer, rng);
+    return test_result("depth_kernels");
+}
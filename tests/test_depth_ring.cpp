@@ -0,0 +1,216 @@
+/**
+ * @brief DepthRing seqlock: publish / latest, overwrite detection, no torn copies
+ *
+ * Every byte of frame i is i & 0xff, so a frame that mixes two publishes is visible.
+ * test_forced_lap() makes the writer thread lap the ring while the reader is halfway
+ * through a zero-copy frame, every round, so valid() must reject each of those reads;
+ * test_no_torn_copies() then lets a writer flood a two-slot ring against an
+ * unsynchronized reader and checks that nothing torn is ever accepted.
+ */
+#include "DepthRing.hpp"
+#include "TestCheck.hpp"
+
+#include <unistd.h>
+
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr uint32_t WIDTH = 64;
+constexpr uint32_t HEIGHT = 48;
+constexpr size_t FRAME_SIZE = WIDTH * HEIGHT;
+
+std::string ring_name(const char *suffix)
+{
+    return "/hailodepth_test_" + std::to_string(getpid()) + "_" + suffix;
+}
+
+void test_publish_latest()
+{
+    const std::string name = ring_name("basic");
+    DepthRingReader reader;
+    CHECK(!reader.open(name));
+
+    DepthRingWriter writer;
+    CHECK(writer.create(name, WIDTH, HEIGHT, 4, true));
+    writer.set_quantization(0.5f, -3.0f);
+    CHECK(reader.open(name));
+    CHECK_EQ(reader.width(), WIDTH);
+    CHECK_EQ(reader.height(), HEIGHT);
+
+    DepthFrame frame;
+    CHECK(!reader.latest(frame));  // 아직 발행 없음
+
+    std::vector<uint8_t> data(FRAME_SIZE);
+    for (uint64_t i = 0; i < 3; i++) {
+        std::memset(data.data(), static_cast<int>(10 + i), data.size());
+        writer.publish(data.data(), 100 + i, 1000 + i);
+    }
+    CHECK(reader.latest(frame));
+    CHECK_EQ(frame.index, uint64_t(2));
+    CHECK_EQ(frame.frame_id, uint64_t(102));
+    CHECK_EQ(frame.capture_ns, uint64_t(1002));
+    CHECK_EQ(frame.scale, 0.5f);
+    CHECK_EQ(frame.zero_point, -3.0f);
+    CHECK(frame.is_signed);
+    CHECK_EQ(int(frame.data[0]), 12);
+    CHECK_EQ(int(frame.data[FRAME_SIZE - 1]), 12);
+    CHECK(reader.valid(frame));
+    CHECK(!reader.latest(frame));  // 같은 프레임은 한 번만
+
+    // 슬롯이 한 바퀴 돌아 다시 쓰이면 zero-copy 뷰는 무효
+    for (uint64_t i = 0; i < 4; i++) {
+        writer.publish(data.data(), 200 + i, 0);
+    }
+    CHECK(!reader.valid(frame));
+
+    CHECK(!reader.closed());
+    writer.close();
+    CHECK(reader.closed());
+    reader.close();
+    CHECK(!reader.open(name));
+}
+
+bool uniform(const uint8_t *data, size_t count, uint8_t expected)
+{
+    // volatile: 한 바이트씩 공유 메모리에서 다시 읽는다
+    const volatile uint8_t *p = data;
+    bool same = true;
+    for (size_t k = 0; k < count; k++) {
+        same &= p[k] == expected;
+    }
+    return same;
+}
+
+void test_forced_lap()
+{
+    const std::string name = ring_name("lap");
+    DepthRingWriter writer;
+    CHECK(writer.create(name, WIDTH, HEIGHT, 2, false));
+    DepthRingReader reader;
+    CHECK(reader.open(name));
+
+    // writer 스레드는 요청이 올 때마다 링을 한 바퀴 (2프레임) 돈다
+    constexpr int ROUNDS = 200;
+    std::atomic<int> requested{0};
+    std::atomic<int> lapped{0};
+    std::thread producer([&] {
+        std::vector<uint8_t> data(FRAME_SIZE);
+        uint64_t next = 0;
+        std::memset(data.data(), 0, data.size());
+        writer.publish(data.data(), next++, 0);
+        for (int round = 1; round <= ROUNDS; round++) {
+            while (requested.load(std::memory_order_acquire) < round) {
+                std::this_thread::yield();
+            }
+            for (int k = 0; k < 2; k++) {
+                std::memset(data.data(), static_cast<int>(next & 0xff), data.size());
+                writer.publish(data.data(), next++, 0);
+            }
+            lapped.store(round, std::memory_order_release);
+        }
+    });
+
+    int rejected = 0;
+    int torn = 0;
+    for (int round = 1; round <= ROUNDS; round++) {
+        DepthFrame frame;
+        while (!reader.latest(frame)) {
+            std::this_thread::yield();
+        }
+        const uint8_t expected = static_cast<uint8_t>(frame.frame_id & 0xff);
+        // 앞 절반을 읽은 뒤 writer가 이 슬롯을 덮어쓰게 하고 나머지 절반을 읽는다
+        const bool first_half = uniform(frame.data, FRAME_SIZE / 2, expected);
+        requested.store(round, std::memory_order_release);
+        while (lapped.load(std::memory_order_acquire) < round) {
+            std::this_thread::yield();
+        }
+        const bool second_half = uniform(frame.data + FRAME_SIZE / 2, FRAME_SIZE / 2, expected);
+        if (!reader.valid(frame)) {
+            rejected++;
+        } else if (!first_half || !second_half) {
+            torn++;  // 덮어쓴 슬롯을 valid()가 받아들였다
+        }
+    }
+    producer.join();
+
+    // 모든 라운드가 재시도 경로를 지나야 한다
+    CHECK_EQ(rejected, ROUNDS);
+    CHECK_EQ(torn, 0);
+    writer.close();
+}
+
+void test_no_torn_copies()
+{
+    const std::string name = ring_name("torn");
+    DepthRingWriter writer;
+    CHECK(writer.create(name, WIDTH, HEIGHT, 2, false));
+    DepthRingReader reader;
+    CHECK(reader.open(name));
+
+    // 프레임 i의 모든 바이트 = i & 0xff (미리 만들어 writer는 publish만 돈다)
+    std::vector<uint8_t> patterns(256 * FRAME_SIZE);
+    for (size_t v = 0; v < 256; v++) {
+        std::memset(&patterns[v * FRAME_SIZE], static_cast<int>(v), FRAME_SIZE);
+    }
+    std::atomic<bool> done{false};
+    std::thread producer([&] {
+        for (uint64_t i = 0; i < 300000; i++) {
+            writer.publish(&patterns[(i & 0xff) * FRAME_SIZE], i, 0);
+        }
+        done.store(true, std::memory_order_release);
+    });
+
+    std::vector<uint8_t> copy(FRAME_SIZE);
+    uint64_t accepted = 0;
+    uint64_t rejected = 0;
+    uint64_t torn = 0;
+    uint64_t last_index = 0;
+    bool ordered = true;
+    for (uint64_t round = 0; !done.load(std::memory_order_acquire); round++) {
+        DepthFrame frame;
+        bool ok = false;
+        if (round % 2) {
+            ok = reader.copy_latest(frame, copy.data()) && uniform(copy.data(), FRAME_SIZE, frame.frame_id & 0xff);
+            if (!ok && frame.data == copy.data()) {
+                torn++;  // 검증을 통과한 사본이 섞여 있다
+            }
+        } else if (reader.latest(frame)) {
+            const bool same = uniform(frame.data, FRAME_SIZE, frame.frame_id & 0xff);
+            ok = reader.valid(frame);
+            if (ok && !same) {
+                torn++;  // 읽는 동안 덮어썼는데 valid()가 못 잡았다
+            }
+            rejected += ok ? 0 : 1;
+        }
+        if (!ok) {
+            continue;
+        }
+        if (accepted > 0 && frame.index <= last_index) {
+            ordered = false;
+        }
+        last_index = frame.index;
+        accepted++;
+    }
+    producer.join();
+
+    std::cout << "accepted " << accepted << ", overwritten while reading " << rejected << std::endl;
+    CHECK(accepted > 0);
+    CHECK_EQ(torn, uint64_t(0));
+    CHECK(ordered);
+    writer.close();
+}
+
+}  // namespace
+
+int main()
+{
+    test_publish_latest();
+    test_forced_lap();
+    test_no_torn_copies();
+    return test_result("depth_ring");
+}
@@ -0,0 +1,218 @@
+/**
+ * @brief DepthServiceClient against a running depth_service (cpu backend)
+ *
+ * test_depth_service <depth_service binary> <config.yaml>
+ *
+ * Starts the service on a private shared-memory name, then checks the futex
+ * submit / wait round-trip, that a client killed without disconnect() has its
+ * channel reclaimed, and that connect() refuses a region smaller than its header says.
+ */
+#include "DepthService.hpp"
+#include "TestCheck.hpp"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+extern char **environ;
+
+namespace {
+
+constexpr int WAIT_MS = 2000;
+
+/// 입력이 전부 value인 프레임의 y = 0 출력 (cpu 백엔드: 세로 ramp 3/4 + 휘도 1/4, 첫 행 ramp 0)
+int8_t expected_first_row(uint8_t value)
+{
+    return static_cast<int8_t>((value >> 2) - 128);
+}
+
+/// Connects, retrying while the service starts up or reclaims a channel
+bool connect_within(DepthServiceClient &client, const std::string &name, int timeout_ms)
+{
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (!client.connect(name)) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    return true;
+}
+
+bool round_trip(DepthServiceClient &client, uint32_t slot, uint8_t value, uint64_t frame_id)
+{
+    std::memset(client.input(slot), value, client.input_size());
+    if (!client.submit(slot, frame_id)) {
+        return false;
+    }
+    const DepthServiceClient::Result result = client.wait(slot, WAIT_MS);
+    const bool ok = result == DepthServiceClient::Result::Done &&
+                    static_cast<int8_t>(client.output(slot)[0]) == expected_first_row(value);
+    client.release(slot);
+    return ok;
+}
+
+void test_round_trip(const std::string &name)
+{
+    DepthServiceClient client;
+    CHECK(connect_within(client, name, 10000));
+    if (!client.connected()) {
+        return;
+    }
+    CHECK_EQ(client.slots(), uint32_t(2));
+    CHECK_EQ(client.input_size(), size_t(client.width()) * client.height() * 3);
+    CHECK_EQ(client.output_size(), size_t(client.width()) * client.height());
+
+    CHECK(round_trip(client, 0, 40, 1));
+
+    // 두 슬롯을 함께 올려두고 순서대로 받는다; 끝나기 전 같은 슬롯 재제출은 거부
+    std::memset(client.input(0), 80, client.input_size());
+    std::memset(client.input(1), 160, client.input_size());
+    CHECK(client.submit(0, 2));
+    CHECK(client.submit(1, 3));
+    CHECK(!client.submit(0, 4));
+    CHECK(client.wait(0, WAIT_MS) == DepthServiceClient::Result::Done);
+    CHECK(client.wait(1, WAIT_MS) == DepthServiceClient::Result::Done);
+    CHECK_EQ(static_cast<int8_t>(client.output(0)[0]), expected_first_row(80));
+    CHECK_EQ(static_cast<int8_t>(client.output(1)[0]), expected_first_row(160));
+    client.release(0);
+    client.release(1);
+
+    // 서비스가 아무것도 안 했으면 futex 대기는 시간 초과로 끝난다
+    CHECK(client.wait(0, 50) == DepthServiceClient::Result::Timeout);
+}
+
+void test_dead_client_reclaim(const std::string &name)
+{
+    // 채널 2개: 이 프로세스가 하나, 자식이 하나를 잡으면 가득 찬다
+    DepthServiceClient holder;
+    CHECK(connect_within(holder, name, WAIT_MS));
+
+    int ready[2];
+    int release[2];
+    CHECK_EQ(pipe(ready), 0);
+    CHECK_EQ(pipe(release), 0);
+    const pid_t child = fork();
+    if (child == 0) {
+        // 자식: 채널을 잡고 프레임 하나를 올린 채 disconnect() 없이 종료 (소멸자도 건너뜀)
+        // (앞 테스트의 채널은 서비스가 회수할 때까지 잠시 CLOSING)
+        close(ready[0]);
+        close(release[1]);
+        DepthServiceClient *client = new DepthServiceClient();
+        char byte = connect_within(*client, name, WAIT_MS) ? 1 : 0;
+        if (byte) {
+            std::memset(client->input(0), 1, client->input_size());
+            client->submit(0, 99);
+        }
+        (void)!write(ready[1], &byte, 1);
+        (void)!read(release[0], &byte, 1);
+        _exit(0);
+    }
+    close(ready[1]);
+    close(release[0]);
+
+    char connected = 0;
+    CHECK_EQ(read(ready[0], &connected, 1), ssize_t(1));
+    CHECK_EQ(int(connected), 1);
+
+    DepthServiceClient late;
+    CHECK(!late.connect(name));  // 살아 있는 두 클라이언트가 채널을 모두 차지
+
+    close(release[1]);
+    int status = 0;
+    waitpid(child, &status, 0);
+    close(ready[0]);
+
+    // 서비스의 정리 주기(100 ms)에 죽은 pid를 보고 채널을 회수한다
+    CHECK(connect_within(late, name, WAIT_MS));
+    if (late.connected()) {
+        CHECK(round_trip(late, 0, 200, 7));
+    }
+    CHECK(round_trip(holder, 1, 120, 8));
+}
+
+void test_truncated_region()
+{
+    const std::string name = "/hailodepth_test_short_" + std::to_string(getpid());
+    const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    CHECK(fd >= 0);
+    if (fd < 0) {
+        return;
+    }
+    // 헤더는 채널 4개라고 하지만 영역에는 헤더와 채널 반 개뿐
+    const size_t stride = service_channel_stride(2, 64 * 64 * 3, 64 * 64);
+    const size_t size = sizeof(ServiceHeader) + stride / 2;
+    CHECK_EQ(ftruncate(fd, static_cast<off_t>(size)), 0);
+    void *base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    CHECK(base != MAP_FAILED);
+    if (base == MAP_FAILED) {
+        shm_unlink(name.c_str());
+        return;
+    }
+    ServiceHeader *header = new (base) ServiceHeader();
+    header->version = DEPTH_SERVICE_VERSION;
+    header->width = 64;
+    header->height = 64;
+    header->input_size = 64 * 64 * 3;
+    header->output_size = 64 * 64;
+    header->max_clients = 4;
+    header->slots = 2;
+    header->channel_stride = stride;
+    header->running.store(1);
+    header->magic.store(DEPTH_SERVICE_MAGIC, std::memory_order_release);
+
+    DepthServiceClient client;
+    CHECK(!client.connect(name));
+    CHECK(!client.connected());
+
+    munmap(base, size);
+    shm_unlink(name.c_str());
+}
+
+}  // namespace
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3) {
+        std::cerr << "usage: " << argv[0] << " <depth_service> <config.yaml>" << std::endl;
+        return 1;
+    }
+    test_truncated_region();
+
+    const std::string name = "/hailodepth_test_service_" + std::to_string(getpid());
+    std::vector<std::string> args = {argv[1], "--config", argv[2], "--backend", "cpu",
+                                     "--clients", "2", "--slots", "2", "--name", name};
+    std::vector<char*> service_argv;
+    for (std::string &arg : args) {
+        service_argv.push_back(&arg[0]);
+    }
+    service_argv.push_back(nullptr);
+    pid_t service = 0;
+    if (posix_spawn(&service, argv[1], nullptr, nullptr, service_argv.data(), environ) != 0) {
+        std::cerr << "failed to start " << argv[1] << std::endl;
+        return 1;
+    }
+
+    test_round_trip(name);
+    test_dead_client_reclaim(name);
+
+    // SIGTERM: 정상 종료 후에는 연결할 수 없다
+    kill(service, SIGTERM);
+    int status = 0;
+    waitpid(service, &status, 0);
+    CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    DepthServiceClient client;
+    CHECK(!client.connect(name));
+    return test_result("depth_service");
+}
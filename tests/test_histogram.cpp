@@ -0,0 +1,118 @@
+/**
+ * @brief LatencyHistogram bucket math and percentiles
+ */
+#include "Histogram.hpp"
+#include "TestCheck.hpp"
+
+#include <cmath>
+#include <thread>
+#include <vector>
+
+namespace {
+
+void test_buckets()
+{
+    using H = LatencyHistogram;
+
+    // 128 µs 미만은 값 그대로
+    for (uint64_t v = 0; v < H::SUB_BUCKETS; v++) {
+        CHECK_EQ(H::bucket_of(v), size_t(v));
+        CHECK_EQ(H::bucket_value(H::bucket_of(v)), v);
+    }
+
+    // 버킷은 값 순서대로 빈틈없이 이어지고, 대표값은 1/64 이내
+    size_t previous = H::bucket_of(0);
+    bool contiguous = true;
+    bool precise = true;
+    for (uint64_t v = 1; v < (uint64_t(1) << 22); v += 1 + v / 4096) {
+        const size_t bucket = H::bucket_of(v);
+        if (bucket < previous || bucket > previous + 1 + v / 4096) {
+            contiguous = false;
+        }
+        previous = bucket;
+        const double error = std::fabs(static_cast<double>(H::bucket_value(bucket)) - static_cast<double>(v));
+        if (error > static_cast<double>(v) / H::HALF_SUB_BUCKETS) {
+            precise = false;
+        }
+    }
+    CHECK(contiguous);
+    CHECK(precise);
+
+    // 2^k 경계: 2^k - 1과 2^k는 다른 버킷, 한 칸 차이
+    for (int k = H::SUB_BUCKET_BITS; k < H::MAX_VALUE_BITS; k++) {
+        const uint64_t edge = uint64_t(1) << k;
+        CHECK_EQ(H::bucket_of(edge), H::bucket_of(edge - 1) + 1);
+    }
+
+    // 범위를 넘는 값은 마지막 버킷으로
+    const size_t last = H::bucket_of((uint64_t(1) << H::MAX_VALUE_BITS) - 1);
+    CHECK(last < H::BUCKET_COUNT);
+    CHECK_EQ(H::bucket_of(uint64_t(1) << 40), last);
+    CHECK_EQ(H::bucket_of(UINT64_MAX), last);
+}
+
+void test_percentiles()
+{
+    LatencyHistogram histogram;
+    for (uint64_t v = 1; v <= 1000; v++) {
+        histogram.record(v);
+    }
+
+    const LatencyHistogram::Snapshot all = histogram.snapshot();
+    CHECK_EQ(all.count, uint64_t(1000));
+    CHECK_EQ(all.max_us, uint64_t(1000));
+    CHECK(std::fabs(all.mean_us - 500.5) < 1e-9);
+    CHECK(std::fabs(static_cast<double>(all.p50_us) - 500.0) <= 500.0 / 64);
+    CHECK(std::fabs(static_cast<double>(all.p90_us) - 900.0) <= 900.0 / 64);
+    CHECK(std::fabs(static_cast<double>(all.p99_us) - 990.0) <= 990.0 / 64);
+    CHECK(all.p999_us <= all.max_us);
+    CHECK_EQ(histogram.sum_us(), uint64_t(500500));
+
+    // interval()은 앞 호출 이후 기록만 본다
+    CHECK_EQ(histogram.interval().count, uint64_t(1000));
+    histogram.record(7);
+    histogram.record(9);
+    const LatencyHistogram::Snapshot window = histogram.interval();
+    CHECK_EQ(window.count, uint64_t(2));
+    CHECK_EQ(window.max_us, uint64_t(9));
+    CHECK_EQ(window.p50_us, uint64_t(7));
+    CHECK_EQ(histogram.interval().count, uint64_t(0));
+    CHECK_EQ(histogram.snapshot().count, uint64_t(1002));
+}
+
+void test_concurrent_record()
+{
+    LatencyHistogram histogram;
+    constexpr int THREADS = 4;
+    constexpr uint64_t PER_THREAD = 20000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; t++) {
+        threads.emplace_back([&histogram, t] {
+            for (uint64_t i = 0; i < PER_THREAD; i++) {
+                histogram.record(static_cast<uint64_t>(t) * 1000 + i % 500);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    const LatencyHistogram::Snapshot all = histogram.snapshot();
+    CHECK_EQ(all.count, THREADS * PER_THREAD);
+    CHECK_EQ(all.max_us, uint64_t(3499));
+    uint64_t total = 0;
+    for (uint64_t count : histogram.counts()) {
+        total += count;
+    }
+    CHECK_EQ(total, THREADS * PER_THREAD);
+}
+
+}  // namespace
+
+int main()
+{
+    test_buckets();
+    test_percentiles();
+    test_concurrent_record();
+    return test_result("histogram");
+}
@@ -0,0 +1,187 @@
+/**
+ * @brief Completion order of the inference queues
+ *
+ * Pushes frames tagged with their sequence number through a queue over the cpu
+ * backend (with latency jitter, so the I/O threads really interleave) and checks
+ * that every frame comes back once, in submit order, with its own output.
+ */
+#include "FrameBatcher.hpp"
+#include "InferBackend.hpp"
+#include "InferEngine.hpp"
+#include "TestCheck.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr size_t FRAMES = 64;
+
+struct Completion {
+    uint64_t sequence;  ///< user_data of the job
+    int8_t depth;       ///< First output value
+    hailo_status status;
+};
+
+Config make_config()
+{
+    Config config{};
+    config.backend = "cpu";
+    config.model_width = 32;
+    config.model_height = 8;
+    config.cpu_latency_ms = 0.3;
+    config.cpu_jitter_ms = 0.2;
+    return config;
+}
+
+/// cpu 백엔드의 첫 픽셀 출력: ramp 0, 휘도 = 입력 값
+int8_t expected_depth(uint64_t sequence)
+{
+    const int value = static_cast<int>(sequence % 64) * 4;
+    return static_cast<int8_t>((value >> 2) - 128);
+}
+
+/// Submits FRAMES frames from this thread and checks what the callback saw
+/// (pause_every > 0: the producer stalls after every pause_every frames)
+void check_order(const char *name, InferQueue &queue, std::mutex &mutex, std::vector<Completion> &done,
+                 uint64_t pause_every = 0)
+{
+    for (uint64_t i = 0; i < FRAMES; i++) {
+        if (pause_every && i % pause_every == pause_every - 1) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        InferJob *job = queue.acquire();
+        CHECK(job != nullptr);
+        if (!job) {
+            return;
+        }
+        std::memset(job->input, static_cast<int>(i % 64) * 4, job->input_size);
+        job->user_data = reinterpret_cast<void*>(static_cast<uintptr_t>(i));
+        CHECK_EQ(queue.submit(job), HAILO_SUCCESS);
+    }
+    queue.flush();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    CHECK_EQ(done.size(), FRAMES);
+    for (size_t i = 0; i < done.size(); i++) {
+        if (done[i].sequence != i || done[i].depth != expected_depth(i) || done[i].status != HAILO_SUCCESS) {
+            std::cerr << name << ": frame " << i << " completed as " << done[i].sequence
+                      << " (depth " << int(done[i].depth) << ", status " << done[i].status << ")" << std::endl;
+            g_test_failures++;
+            break;
+        }
+    }
+}
+
+void test_async_engine()
+{
+    const Config config = make_config();
+    auto backend = CpuBackend::create(config);
+    CHECK(backend);
+    if (!backend) {
+        return;
+    }
+
+    std::mutex mutex;
+    std::vector<Completion> done;
+    uint64_t last_frame_id = 0;
+    bool frame_ids_ok = true;
+    AsyncInferEngine engine(*backend.value(), 3, [&](InferJob &job) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (job.frame_id != done.size() || job.frame_id < last_frame_id) {
+            frame_ids_ok = false;
+        }
+        last_frame_id = job.frame_id;
+        done.push_back({reinterpret_cast<uintptr_t>(job.user_data),
+                        static_cast<int8_t>(job.output[0]), job.status});
+    });
+    CHECK_EQ(engine.start(), HAILO_SUCCESS);
+    CHECK_EQ(engine.capacity(), size_t(3));
+
+    check_order("AsyncInferEngine", engine, mutex, done);
+    CHECK(frame_ids_ok);
+    engine.stop();
+    CHECK(engine.acquire() == nullptr);
+}
+
+void test_frame_batcher()
+{
+    const Config config = make_config();
+    auto backend = CpuBackend::create(config);
+    CHECK(backend);
+    if (!backend) {
+        return;
+    }
+
+    std::mutex mutex;
+    std::vector<Completion> done;
+    std::vector<uint64_t> frame_ids;
+    FrameBatcher batcher(*backend.value(), 4, std::chrono::milliseconds(2), [&](InferJob &job) {
+        std::lock_guard<std::mutex> lock(mutex);
+        frame_ids.push_back(job.frame_id);
+        done.push_back({reinterpret_cast<uintptr_t>(job.user_data),
+                        static_cast<int8_t>(job.output[0]), job.status});
+    });
+    CHECK_EQ(batcher.start(), HAILO_SUCCESS);
+    CHECK_EQ(batcher.capacity(), size_t(8));
+
+    // 7프레임마다 멈춰서 마감 시간에 나가는 부분 배치도 섞는다
+    check_order("FrameBatcher", batcher, mutex, done, 7);
+    for (size_t i = 0; i < frame_ids.size(); i++) {
+        if (frame_ids[i] != i) {
+            std::cerr << "FrameBatcher: frame_id " << frame_ids[i] << " at position " << i << std::endl;
+            g_test_failures++;
+            break;
+        }
+    }
+    batcher.stop();
+}
+
+void test_batcher_deadline()
+{
+    const Config config = make_config();
+    auto backend = CpuBackend::create(config);
+    CHECK(backend);
+    if (!backend) {
+        return;
+    }
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    size_t delivered = 0;
+    FrameBatcher batcher(*backend.value(), 8, std::chrono::milliseconds(5), [&](InferJob &) {
+        std::lock_guard<std::mutex> lock(mutex);
+        delivered++;
+        cv.notify_all();
+    });
+    CHECK_EQ(batcher.start(), HAILO_SUCCESS);
+
+    // flush() 없이도 마감 시간이 지나면 한 프레임짜리 배치가 나간다
+    InferJob *job = batcher.acquire();
+    CHECK(job != nullptr);
+    if (!job) {
+        return;
+    }
+    std::memset(job->input, 0, job->input_size);
+    CHECK_EQ(batcher.submit(job), HAILO_SUCCESS);
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait_for(lock, std::chrono::seconds(2), [&] { return delivered == 1; });
+        CHECK_EQ(delivered, size_t(1));
+    }
+    batcher.stop();
+}
+
+}  // namespace
+
+int main()
+{
+    test_async_engine();
+    test_frame_batcher();
+    test_batcher_deadline();
+    return test_result("infer_queue");
+}
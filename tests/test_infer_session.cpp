@@ -0,0 +1,83 @@
+/**
+ * @brief InferSession steady state must not touch the heap
+ *
+ * Replaces the global operator new with a counting one, runs a few frames through
+ * InferSession::infer() on the CPU backend and checks that no frame after the
+ * first allocated anything.
+ */
+#include "Hailoinfer.hpp"
+#include "InferBackend.hpp"
+#include "TestCheck.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+namespace {
+
+std::atomic<bool> g_counting{false};
+std::atomic<uint64_t> g_allocations{0};
+
+void *counted_alloc(size_t size)
+{
+    if (g_counting.load(std::memory_order_relaxed)) {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (void *ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+}  // namespace
+
+void *operator new(size_t size) { return counted_alloc(size); }
+void *operator new[](size_t size) { return counted_alloc(size); }
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete[](void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, size_t) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, size_t) noexcept { std::free(ptr); }
+
+int main()
+{
+    Config config{};
+    config.backend = "cpu";
+    config.model_width = 64;
+    config.model_height = 48;
+    config.cpu_latency_ms = 0.0;
+    config.cpu_jitter_ms = 0.0;
+
+    auto backend = create_backend(config);
+    CHECK(backend);
+    if (!backend) {
+        return test_result("infer_session_alloc");
+    }
+    auto session = InferSession::create(*backend.value(), config);
+    CHECK(session);
+    if (!session) {
+        return test_result("infer_session_alloc");
+    }
+
+    cv::Mat input = session.value()->input_mat();
+    std::memset(input.data, 0x40, session.value()->input_frame_size());
+
+    // 첫 프레임은 워밍업 (지연 초기화가 있어도 허용)
+    CHECK(!session.value()->infer(input).empty());
+
+    constexpr int FRAMES = 8;
+    g_counting.store(true);
+    int failed = 0;
+    for (int i = 0; i < FRAMES; i++) {
+        input.data[i] = static_cast<uint8_t>(i);
+        cv::Mat depth = session.value()->infer(input);
+        if (depth.empty() || session.value()->bytes_copied() != 0) {
+            failed++;
+        }
+    }
+    g_counting.store(false);
+
+    CHECK_EQ(failed, 0);
+    CHECK_EQ(g_allocations.load(), uint64_t(0));
+    return test_result("infer_session_alloc");
+}
@@ -0,0 +1,89 @@
+/**
+ * @brief render_metrics(): Prometheus text of the counters and stage histograms
+ *
+ * Feeds known durations into one stage and checks the cumulative _bucket lines
+ * (bounds converted from ms to seconds), le="+Inf", _sum and _count.
+ */
+#include "Histogram.hpp"
+#include "Metrics.hpp"
+#include "TestCheck.hpp"
+
+#include <sstream>
+#include <string>
+
+namespace {
+
+/// Value of the sample line that starts with series, or -1 if there is none
+double sample(const std::string &text, const std::string &series)
+{
+    std::istringstream lines(text);
+    std::string line;
+    while (std::getline(lines, line)) {
+        if (line.compare(0, series.size() + 1, series + " ") == 0) {
+            return std::stod(line.substr(series.size() + 1));
+        }
+    }
+    return -1.0;
+}
+
+std::string bucket(const char *stage, const char *le)
+{
+    return std::string("hailodepth_stage_latency_seconds_bucket{stage=\"") + stage + "\",le=\"" + le + "\"}";
+}
+
+void test_histogram_families()
+{
+    StageHistograms histograms;
+    // µs: 경계(0.5, 1, 2, 5, 33, 1000 ms)에서 멀리 떨어진 값만 써서 버킷 해상도와 무관하게
+    for (uint64_t us : {300, 1500, 4000, 25000, 2000000}) {
+        histograms.stage(StageHistograms::INFER).record(us);
+    }
+    const std::string text = render_metrics({nullptr, &histograms, nullptr, nullptr, nullptr});
+
+    CHECK(text.find("# TYPE hailodepth_stage_latency_seconds histogram\n") != std::string::npos);
+
+    // 누적 개수, le는 초 단위
+    CHECK_EQ(sample(text, bucket("infer", "0.0005")), 1.0);
+    CHECK_EQ(sample(text, bucket("infer", "0.001")), 1.0);
+    CHECK_EQ(sample(text, bucket("infer", "0.002")), 2.0);
+    CHECK_EQ(sample(text, bucket("infer", "0.005")), 3.0);
+    CHECK_EQ(sample(text, bucket("infer", "0.02")), 3.0);
+    CHECK_EQ(sample(text, bucket("infer", "0.033")), 4.0);
+    CHECK_EQ(sample(text, bucket("infer", "1")), 4.0);
+    CHECK_EQ(sample(text, bucket("infer", "+Inf")), 5.0);
+
+    const double sum = sample(text, "hailodepth_stage_latency_seconds_sum{stage=\"infer\"}");
+    CHECK(sum > 2.03079 && sum < 2.03081);  // 2030800 µs
+    CHECK_EQ(sample(text, "hailodepth_stage_latency_seconds_count{stage=\"infer\"}"), 5.0);
+
+    // 기록 없는 단계도 0으로 나온다
+    CHECK_EQ(sample(text, bucket("preprocess", "+Inf")), 0.0);
+    CHECK_EQ(sample(text, "hailodepth_stage_latency_seconds_count{stage=\"total\"}"), 0.0);
+}
+
+void test_counters()
+{
+    PipelineMetrics metrics;
+    metrics.camera_frames = 10;
+    metrics.frames_in = 7;
+    metrics.frames_out = 6;
+    metrics.map_failures = 1;
+    const std::string text = render_metrics({&metrics, nullptr, nullptr, nullptr, nullptr});
+
+    CHECK(text.find("# TYPE hailodepth_frames_in_total counter\n") != std::string::npos);
+    CHECK_EQ(sample(text, "hailodepth_camera_frames_total"), 10.0);
+    CHECK_EQ(sample(text, "hailodepth_frames_in_total"), 7.0);
+    CHECK_EQ(sample(text, "hailodepth_frames_out_total"), 6.0);
+    CHECK_EQ(sample(text, "hailodepth_appsink_dropped_total"), 2.0);  // 10 − 7 − 대기 중 1
+    CHECK_EQ(sample(text, "hailodepth_map_failures_total"), 1.0);
+    CHECK(text.find("hailodepth_stage_latency_seconds") == std::string::npos);
+}
+
+}  // namespace
+
+int main()
+{
+    test_histogram_families();
+    test_counters();
+    return test_result("metrics");
+}
@@ -0,0 +1,186 @@
+/**
+ * @brief SourceScheduler: smooth weighted round-robin shares, drop policies, close
+ */
+#include "SourceScheduler.hpp"
+#include "TestCheck.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Scheduler = SourceScheduler<int>;
+
+void test_weighted_shares()
+{
+    const std::vector<int> weights = {1, 2, 3};
+    std::vector<SourcePolicy> policies;
+    for (int w : weights) {
+        policies.push_back({w, 1000, DropPolicy::Block});
+    }
+    Scheduler scheduler(policies, [](size_t, int &) {});
+    for (size_t s = 0; s < weights.size(); s++) {
+        for (int i = 0; i < 300; i++) {
+            scheduler.push(s, i);
+        }
+    }
+
+    // 모두 밀려 있는 동안: 몫은 w / sum(w), 어느 시점에서도 이상적인 횟수와 1 미만 차이 (몰아주기 없음)
+    std::vector<int> picks(weights.size(), 0);
+    std::vector<int> next(weights.size(), 0);
+    bool smooth = true;
+    bool fifo = true;
+    for (int n = 1; n <= 600; n++) {
+        size_t source = 0;
+        int item = -1;
+        CHECK(scheduler.pop(source, item));
+        fifo &= item == next[source]++;
+        picks[source]++;
+        for (size_t s = 0; s < weights.size(); s++) {
+            const double ideal = n * weights[s] / 6.0;
+            if (std::fabs(picks[s] - ideal) >= 1.0) {
+                smooth = false;
+            }
+        }
+    }
+    CHECK(smooth);
+    CHECK(fifo);
+    CHECK_EQ(picks[0], 100);
+    CHECK_EQ(picks[1], 200);
+    CHECK_EQ(picks[2], 300);
+    CHECK_EQ(scheduler.stats(2).scheduled, uint64_t(300));
+}
+
+void test_idle_source_banks_nothing()
+{
+    Scheduler scheduler({{1, 100, DropPolicy::Block}, {1, 100, DropPolicy::Block}}, [](size_t, int &) {});
+
+    // 소스 1이 쉬는 동안 소스 0만 뽑힌다
+    for (int i = 0; i < 50; i++) {
+        scheduler.push(0, i);
+        size_t source = 9;
+        int item = -1;
+        CHECK(scheduler.pop(source, item));
+        CHECK_EQ(source, size_t(0));
+    }
+
+    // 둘 다 밀리면 번갈아: 쉬던 소스가 몰아서 받지 않는다
+    for (int i = 0; i < 20; i++) {
+        scheduler.push(0, i);
+        scheduler.push(1, i);
+    }
+    size_t previous = 9;
+    int run = 0;
+    int longest = 0;
+    int from_idle = 0;
+    for (int i = 0; i < 20; i++) {
+        size_t source = 9;
+        int item = -1;
+        CHECK(scheduler.pop(source, item));
+        run = source == previous ? run + 1 : 1;
+        longest = std::max(longest, run);
+        previous = source;
+        from_idle += source == 1 ? 1 : 0;
+    }
+    CHECK_EQ(from_idle, 10);
+    CHECK_EQ(longest, 1);
+}
+
+void test_drop_policies()
+{
+    std::vector<std::pair<size_t, int>> dropped;
+    Scheduler scheduler({{1, 2, DropPolicy::Drop}, {1, 2, DropPolicy::Latest}},
+                        [&](size_t source, int &item) { dropped.push_back({source, item}); });
+
+    // drop: 가득 차면 새 프레임을 버린다; latest: 가장 오래된 프레임을 밀어낸다
+    for (int i = 0; i < 5; i++) {
+        scheduler.push(0, i);
+        scheduler.push(1, i);
+    }
+    CHECK_EQ(scheduler.stats(0).pushed, uint64_t(2));
+    CHECK_EQ(scheduler.stats(0).dropped, uint64_t(3));
+    CHECK_EQ(scheduler.stats(1).pushed, uint64_t(5));
+    CHECK_EQ(scheduler.stats(1).dropped, uint64_t(3));
+    CHECK_EQ(scheduler.stats(1).depth, size_t(2));
+    const std::vector<std::pair<size_t, int>> expected = {{0, 2}, {1, 0}, {0, 3}, {1, 1}, {0, 4}, {1, 2}};
+    CHECK(dropped == expected);
+
+    // latest 소스는 뽑힐 때 가장 새 프레임으로 건너뛴다
+    dropped.clear();
+    std::vector<int> latest_items;
+    size_t source = 0;
+    int item = -1;
+    while (scheduler.stats(0).depth + scheduler.stats(1).depth > 0) {
+        CHECK(scheduler.pop(source, item));
+        if (source == 1) {
+            latest_items.push_back(item);
+        }
+    }
+    CHECK(latest_items == std::vector<int>{4});
+    CHECK(dropped == (std::vector<std::pair<size_t, int>>{{1, 3}}));
+    CHECK_EQ(scheduler.stats(1).dropped, uint64_t(4));
+}
+
+void test_close_and_concurrency()
+{
+    constexpr int FRAMES = 2000;
+    std::atomic<int> dropped{0};
+    Scheduler scheduler({{1, 4, DropPolicy::Block}, {2, 4, DropPolicy::Block}, {3, 4, DropPolicy::Block}},
+                        [&](size_t, int &) { dropped++; });
+
+    std::vector<std::thread> producers;
+    for (size_t s = 0; s < 3; s++) {
+        producers.emplace_back([&scheduler, s] {
+            for (int i = 0; i < FRAMES; i++) {
+                scheduler.push(s, i);
+            }
+        });
+    }
+
+    // block: 아무것도 버리지 않고 소스마다 보낸 순서대로
+    std::vector<int> next(3, 0);
+    bool fifo = true;
+    size_t source = 0;
+    int item = -1;
+    for (int n = 0; n < 3 * FRAMES; n++) {
+        CHECK(scheduler.pop(source, item));
+        fifo &= item == next[source]++;
+    }
+    for (std::thread &producer : producers) {
+        producer.join();
+    }
+    CHECK(fifo);
+    CHECK_EQ(dropped.load(), 0);
+
+    // close(): 막힌 producer는 풀려나며 프레임을 버리고, pop()은 남은 것을 비운 뒤 false
+    scheduler.push(0, 1);
+    scheduler.push(0, 2);
+    scheduler.push(0, 3);
+    scheduler.push(0, 4);
+    std::thread blocked([&] { scheduler.push(0, 5); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    scheduler.close();
+    blocked.join();
+    CHECK_EQ(dropped.load(), 1);
+    int drained = 0;
+    while (scheduler.pop(source, item)) {
+        drained++;
+    }
+    CHECK_EQ(drained, 4);
+    scheduler.push(1, 0);  // 닫힌 뒤의 push는 바로 버려진다
+    CHECK_EQ(dropped.load(), 2);
+}
+
+}  // namespace
+
+int main()
+{
+    test_weighted_shares();
+    test_idle_source_banks_nothing();
+    test_drop_policies();
+    test_close_and_concurrency();
+    return test_result("source_scheduler");
+}
@@ -0,0 +1,180 @@
+/**
+ * @brief Offline converter for the binary timing trace written by TraceLog
+ *
+ * trace_convert <trace.bin> [--csv out.csv] [--stats]
+ *
+ * --csv writes one row per frame with the columns of the former timing_log.csv
+ * (so cpu backend latency replay keeps working), --stats prints per-stage
+ * count / mean / p50 / p95 / p99 / max. Without options --stats is assumed.
+ */
+#include "TraceLog.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr int STAGE_COUNT = static_cast<int>(TraceStage::Count);
+
+/// Stages of one frame collected while scanning the file
+struct FrameRow {
+    uint64_t frame_id = 0;
+    int64_t end_ns = 0;
+    double ms[STAGE_COUNT];
+    bool has[STAGE_COUNT] = {};
+    uint32_t bytes = 0;
+};
+
+void write_row(std::ofstream &csv, const FrameRow &row, const TraceFileHeader &session)
+{
+    auto cell = [&row](TraceStage stage) {
+        const int s = static_cast<int>(stage);
+        if (!row.has[s]) {
+            return std::string();
+        }
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(3) << row.ms[s];
+        return out.str();
+    };
+    const int64_t timestamp_ms = (session.wall_ns + (row.end_ns - session.clock_ns)) / 1000000;
+    csv << timestamp_ms << ","
+        << cell(TraceStage::Preprocess) << ","
+        << cell(TraceStage::Infer) << ","
+        << cell(TraceStage::Postprocess) << ","
+        << cell(TraceStage::Frame) << ","
+        << row.bytes << ","
+        << cell(TraceStage::CaptureToInfer) << ","
+        << cell(TraceStage::CaptureToPush) << "\n";
+}
+
+void print_stats(std::vector<double> (&samples)[STAGE_COUNT])
+{
+    std::cout << std::left << std::setw(18) << "stage" << std::right
+              << std::setw(9) << "count" << std::setw(10) << "mean" << std::setw(10) << "p50"
+              << std::setw(10) << "p95" << std::setw(10) << "p99" << std::setw(10) << "max" << "  (ms)" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    for (int s = 0; s < STAGE_COUNT; s++) {
+        std::vector<double> &v = samples[s];
+        if (v.empty()) {
+            continue;
+        }
+        std::sort(v.begin(), v.end());
+        double sum = 0.0;
+        for (double x : v) {
+            sum += x;
+        }
+        auto percentile = [&v](double p) {
+            size_t rank = static_cast<size_t>(p * v.size() + 0.999999);
+            return v[std::min(std::max(rank, static_cast<size_t>(1)), v.size()) - 1];
+        };
+        std::cout << std::left << std::setw(18) << trace_stage_name(static_cast<TraceStage>(s)) << std::right
+                  << std::setw(9) << v.size() << std::setw(10) << sum / v.size()
+                  << std::setw(10) << percentile(0.50) << std::setw(10) << percentile(0.95)
+                  << std::setw(10) << percentile(0.99) << std::setw(10) << v.back() << std::endl;
+    }
+}
+
+}  // namespace
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2) {
+        std::cerr << "usage: " << argv[0] << " <trace.bin> [--csv out.csv] [--stats]" << std::endl;
+        return 1;
+    }
+    std::string csv_path;
+    bool stats = false;
+    for (int i = 2; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg == "--csv" && i + 1 < argc) {
+            csv_path = argv[++i];
+        } else if (arg == "--stats") {
+            stats = true;
+        } else {
+            std::cerr << "[ERROR] Unknown option: " << arg << std::endl;
+            return 1;
+        }
+    }
+    if (csv_path.empty()) {
+        stats = true;
+    }
+
+    std::ifstream file(argv[1], std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "[ERROR] Failed to open trace: " << argv[1] << std::endl;
+        return 1;
+    }
+    std::ofstream csv;
+    if (!csv_path.empty()) {
+        csv.open(csv_path);
+        if (!csv.is_open()) {
+            std::cerr << "[ERROR] Failed to open CSV: " << csv_path << std::endl;
+            return 1;
+        }
+        csv << "Timestamp(ms),Preprocess(ms),Infer(ms),Postprocess(ms),Total(ms),Copied(bytes),"
+               "CaptureToInfer(ms),CaptureToPush(ms)\n";
+    }
+
+    std::vector<double> samples[STAGE_COUNT];
+    TraceFileHeader session = {};
+    bool have_session = false;
+    FrameRow row;
+    bool have_row = false;
+    uint64_t frames = 0;
+    uint64_t sessions = 0;
+
+    auto finish_row = [&]() {
+        if (have_row && csv.is_open()) {
+            write_row(csv, row, session);
+        }
+        frames += have_row ? 1 : 0;
+        have_row = false;
+    };
+
+    // 헤더와 이벤트는 모두 32바이트: 세션마다 헤더가 다시 나온다 (append 모드)
+    TraceEvent event;
+    while (file.read(reinterpret_cast<char*>(&event), sizeof(event))) {
+        if (std::memcmp(&event, "HDTR", 4) == 0) {
+            finish_row();
+            std::memcpy(&session, &event, sizeof(session));
+            if (session.version != TRACE_FILE_VERSION || session.event_size != sizeof(TraceEvent)) {
+                std::cerr << "[ERROR] Unsupported trace version " << session.version << std::endl;
+                return 1;
+            }
+            have_session = true;
+            sessions++;
+            continue;
+        }
+        if (!have_session || event.stage >= STAGE_COUNT) {
+            continue;  // 헤더 없는 앞부분 / 깨진 레코드
+        }
+        if (!have_row || event.frame_id != row.frame_id) {
+            finish_row();
+            row = FrameRow();
+            row.frame_id = event.frame_id;
+            have_row = true;
+        }
+        const int s = event.stage;
+        const double ms = (event.end_ns - event.begin_ns) / 1e6;
+        row.ms[s] = ms;
+        row.has[s] = true;
+        if (event.stage == static_cast<uint8_t>(TraceStage::Frame)) {
+            row.end_ns = event.end_ns;
+            row.bytes = event.value;
+        }
+        samples[s].push_back(ms);
+    }
+    finish_row();
+
+    std::cerr << frames << " frames in " << sessions << " session(s)" << std::endl;
+    if (stats) {
+        print_stats(samples);
+    }
+    return 0;
+}